@@ -6,8 +6,18 @@ import std;
 
 import Markets.DataStructures;
 
-int main()
+#include "../Markets.DataStructures/Benchmark.h"
+
+int main(int argc, char* argv[])
 {
+	std::vector<std::string_view> args(argv + 1, argv + argc);
+	if (std::ranges::contains(args, "--bench")) {
+		benchmarkRBTree();
+		benchmarkMap();
+		benchmarkSparseMatrix();
+		return 0;
+	}
+
 	std::println("Hello");
 	//std::println("Hello from Main");
 	//BSTree<int, int>* tree = new BSTree<int, int>();
@@ -0,0 +1,296 @@
+#pragma once
+
+import std;
+import Markets.DataStructures;
+
+#include "Map.h"
+#include "RedBlackTree.h"
+#include "SparseMatrix.h"
+
+/// <summary>
+/// Micro-benchmarks for the Markets.DataStructures containers.
+///    - Keys are synthetic tick timestamps (nanoseconds since the epoch,
+///      roughly one tick per millisecond with jitter), which is the access
+///      pattern the price indexes are built for.
+///    - Each benchmark prints one line per phase; run from
+///      Markets.App.Console with `--bench`.
+/// </summary>
+class Stopwatch
+{
+public:
+	Stopwatch() : start(std::chrono::steady_clock::now()) {}
+
+	double elapsedMilliseconds() const {
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	void restart() {
+		start = std::chrono::steady_clock::now();
+	}
+
+private:
+	std::chrono::steady_clock::time_point start;
+};
+
+inline std::vector<std::int64_t> makeTimestampKeys(std::size_t count, bool shuffled, std::uint64_t seed = 42)
+{
+	constexpr std::int64_t marketOpen = 1'700'000'000'000'000'000;
+	constexpr std::int64_t tickSpacing = 1'000'000;
+
+	std::mt19937_64 generator(seed);
+	std::uniform_int_distribution<std::int64_t> jitter(1, tickSpacing);
+
+	std::vector<std::int64_t> keys(count);
+	std::int64_t timestamp = marketOpen;
+	for (auto& key : keys) {
+		timestamp += jitter(generator);
+		key = timestamp;
+	}
+	if (shuffled) {
+		std::ranges::shuffle(keys, generator);
+	}
+	return keys;
+}
+
+inline void reportBenchmark(std::string_view container, std::string_view phase, std::size_t operations, double milliseconds)
+{
+	std::println("{:<12} {:<24} {:>10} ops {:>10.1f} ms {:>8.1f} ns/op",
+		container, phase, operations, milliseconds, milliseconds * 1e6 / static_cast<double>(operations));
+}
+
+/// Inserts `count` timestamp keys (in arrival order and shuffled) into an
+/// RBTree and a std::map, then range-scans the whole key space in one-second
+/// windows and runs `count` floor lookups against each.
+inline void benchmarkRBTree(std::size_t count = 10'000'000)
+{
+	constexpr std::int64_t window = 1'000'000'000;
+
+	for (bool shuffled : { false, true }) {
+		auto keys = makeTimestampKeys(count, shuffled);
+		auto [lo, hi] = std::ranges::minmax(keys);
+		std::string_view order = shuffled ? "shuffled" : "sorted";
+
+		std::uint64_t rbChecksum = 0;
+		std::uint64_t mapChecksum = 0;
+
+		{
+			RBTree<std::int64_t, std::uint32_t> tree;
+			tree.reserve(count);
+
+			Stopwatch stopwatch;
+			for (std::size_t i = 0; i < keys.size(); i++) {
+				tree.put(keys[i], static_cast<std::uint32_t>(i));
+			}
+			reportBenchmark("RBTree", std::format("insert ({})", order), count, stopwatch.elapsedMilliseconds());
+
+			stopwatch.restart();
+			for (std::int64_t start = lo; start <= hi; start += window) {
+				tree.scan(start, start + window - 1, [&](std::int64_t key, std::uint32_t value) {
+					rbChecksum += static_cast<std::uint64_t>(key) ^ value;
+				});
+			}
+			reportBenchmark("RBTree", "range scan (1s windows)", count, stopwatch.elapsedMilliseconds());
+
+			stopwatch.restart();
+			for (std::int64_t key : keys) {
+				rbChecksum += static_cast<std::uint64_t>(tree.floor(key - 1 < lo ? lo : key - 1));
+			}
+			reportBenchmark("RBTree", "floor", count, stopwatch.elapsedMilliseconds());
+		}
+
+		{
+			std::map<std::int64_t, std::uint32_t> map;
+
+			Stopwatch stopwatch;
+			for (std::size_t i = 0; i < keys.size(); i++) {
+				map.insert_or_assign(keys[i], static_cast<std::uint32_t>(i));
+			}
+			reportBenchmark("std::map", std::format("insert ({})", order), count, stopwatch.elapsedMilliseconds());
+
+			stopwatch.restart();
+			for (std::int64_t start = lo; start <= hi; start += window) {
+				auto last = map.upper_bound(start + window - 1);
+				for (auto it = map.lower_bound(start); it != last; ++it) {
+					mapChecksum += static_cast<std::uint64_t>(it->first) ^ it->second;
+				}
+			}
+			reportBenchmark("std::map", "range scan (1s windows)", count, stopwatch.elapsedMilliseconds());
+
+			stopwatch.restart();
+			for (std::int64_t key : keys) {
+				auto it = map.upper_bound(key - 1 < lo ? lo : key - 1);
+				mapChecksum += static_cast<std::uint64_t>(std::prev(it)->first);
+			}
+			reportBenchmark("std::map", "floor", count, stopwatch.elapsedMilliseconds());
+		}
+
+		if (rbChecksum != mapChecksum) {
+			std::println("benchmarkRBTree: checksum mismatch ({} != {})", rbChecksum, mapChecksum);
+		}
+	}
+}
+
+/// Compares the three ordered maps on the time-series workload: build from
+/// `count` timestamps (in arrival order and shuffled), `count` floor lookups
+/// and a full range scan in one-second windows. The BSTree is bulk loaded
+/// from the sorted keys, since inserting them one by one degenerates into a
+/// linked list.
+inline void benchmarkMap(std::size_t count = 10'000'000)
+{
+	constexpr std::int64_t window = 1'000'000'000;
+
+	for (bool shuffled : { false, true }) {
+		auto keys = makeTimestampKeys(count, shuffled);
+		auto [lo, hi] = std::ranges::minmax(keys);
+		std::string_view order = shuffled ? "shuffled" : "sorted";
+
+		std::uint64_t mapChecksum = 0;
+		std::uint64_t rbChecksum = 0;
+		std::uint64_t bstChecksum = 0;
+
+		{
+			Map<std::int64_t, std::uint32_t> map;
+			map.reserve(count);
+
+			Stopwatch stopwatch;
+			for (std::size_t i = 0; i < keys.size(); i++) {
+				map.put(keys[i], static_cast<std::uint32_t>(i));
+			}
+			reportBenchmark("Map", std::format("insert ({})", order), count, stopwatch.elapsedMilliseconds());
+
+			stopwatch.restart();
+			for (std::int64_t key : keys) {
+				mapChecksum += static_cast<std::uint64_t>(map.floor(key - 1 < lo ? lo : key - 1));
+			}
+			reportBenchmark("Map", "floor", count, stopwatch.elapsedMilliseconds());
+
+			stopwatch.restart();
+			for (std::int64_t start = lo; start <= hi; start += window) {
+				map.scan(start, start + window - 1, [&](std::int64_t key, std::uint32_t) {
+					mapChecksum += static_cast<std::uint64_t>(key);
+				});
+			}
+			reportBenchmark("Map", "range scan (1s windows)", count, stopwatch.elapsedMilliseconds());
+		}
+
+		{
+			RBTree<std::int64_t, std::uint32_t> tree;
+			tree.reserve(count);
+
+			Stopwatch stopwatch;
+			for (std::size_t i = 0; i < keys.size(); i++) {
+				tree.put(keys[i], static_cast<std::uint32_t>(i));
+			}
+			reportBenchmark("RBTree", std::format("insert ({})", order), count, stopwatch.elapsedMilliseconds());
+
+			stopwatch.restart();
+			for (std::int64_t key : keys) {
+				rbChecksum += static_cast<std::uint64_t>(tree.floor(key - 1 < lo ? lo : key - 1));
+			}
+			reportBenchmark("RBTree", "floor", count, stopwatch.elapsedMilliseconds());
+
+			stopwatch.restart();
+			for (std::int64_t start = lo; start <= hi; start += window) {
+				tree.scan(start, start + window - 1, [&](std::int64_t key, std::uint32_t) {
+					rbChecksum += static_cast<std::uint64_t>(key);
+				});
+			}
+			reportBenchmark("RBTree", "range scan (1s windows)", count, stopwatch.elapsedMilliseconds());
+		}
+
+		{
+			BSTree<std::int64_t, std::uint32_t> tree;
+
+			Stopwatch stopwatch;
+			if (shuffled) {
+				for (std::size_t i = 0; i < keys.size(); i++) {
+					tree.InsertNode(keys[i], static_cast<std::uint32_t>(i));
+				}
+				reportBenchmark("BSTree", "insert (shuffled)", count, stopwatch.elapsedMilliseconds());
+			}
+			else {
+				std::vector<std::pair<std::int64_t, std::uint32_t>> sorted(count);
+				for (std::size_t i = 0; i < keys.size(); i++) {
+					sorted[i] = { keys[i], static_cast<std::uint32_t>(i) };
+				}
+				tree.BuildFromSorted(sorted);
+				reportBenchmark("BSTree", "bulk load (sorted)", count, stopwatch.elapsedMilliseconds());
+			}
+
+			stopwatch.restart();
+			for (std::int64_t key : keys) {
+				auto it = tree.UpperBound(key - 1 < lo ? lo : key - 1);
+				bstChecksum += static_cast<std::uint64_t>(std::prev(it)->key);
+			}
+			reportBenchmark("BSTree", "floor", count, stopwatch.elapsedMilliseconds());
+
+			stopwatch.restart();
+			for (std::int64_t start = lo; start <= hi; start += window) {
+				tree.TraverseRange(start, start + window - 1, [&](BSTNode<std::int64_t, std::uint32_t>* node) {
+					bstChecksum += static_cast<std::uint64_t>(node->key);
+				});
+			}
+			reportBenchmark("BSTree", "range scan (1s windows)", count, stopwatch.elapsedMilliseconds());
+		}
+
+		if (mapChecksum != rbChecksum || mapChecksum != bstChecksum) {
+			std::println("benchmarkMap: checksum mismatch ({}, {}, {})", mapChecksum, rbChecksum, bstChecksum);
+		}
+	}
+}
+
+/// SpMV and SpMM (16 right-hand sides) on a random `dimension` x `dimension`
+/// ticker-relationship matrix with the given density, serial and parallel,
+/// in both CSR and CSC layouts.
+inline void benchmarkSparseMatrix(std::size_t dimension = 5'000, double density = 0.01, int repetitions = 200)
+{
+	constexpr std::size_t rightHandSides = 16;
+
+	std::mt19937_64 generator(42);
+	std::uniform_int_distribution<std::size_t> coordinate(0, dimension - 1);
+	std::uniform_real_distribution<double> correlation(-1.0, 1.0);
+
+	auto nonZeros = static_cast<std::size_t>(static_cast<double>(dimension) * static_cast<double>(dimension) * density);
+	SparseMatrixBuilder<double> builder(dimension, dimension);
+	builder.reserve(nonZeros);
+
+	Stopwatch stopwatch;
+	for (std::size_t i = 0; i < nonZeros; i++) {
+		builder.add(coordinate(generator), coordinate(generator), correlation(generator));
+	}
+	auto csr = builder.build(SparseLayout::CSR);
+	reportBenchmark("SparseMatrix", "COO -> CSR build", nonZeros, stopwatch.elapsedMilliseconds());
+
+	stopwatch.restart();
+	auto csc = csr.toCSC();
+	reportBenchmark("SparseMatrix", "CSR -> CSC", nonZeros, stopwatch.elapsedMilliseconds());
+
+	std::vector<double> x(dimension * rightHandSides);
+	for (auto& value : x) {
+		value = correlation(generator);
+	}
+	std::vector<double> y(dimension * rightHandSides);
+	std::span<const double> vector(x.data(), dimension);
+	std::span<double> result(y.data(), dimension);
+
+	auto run = [&](std::string_view phase, std::size_t flops, auto&& kernel) {
+		kernel();
+		Stopwatch timer;
+		for (int i = 0; i < repetitions; i++) {
+			kernel();
+		}
+		double milliseconds = timer.elapsedMilliseconds();
+		std::println("{:<12} {:<24} {:>10.3f} ms/op {:>8.2f} GFLOP/s", "SparseMatrix", phase,
+			milliseconds / repetitions, 2.0 * static_cast<double>(flops) * repetitions / (milliseconds * 1e6));
+	};
+
+	for (const auto* matrix : { &csr, &csc }) {
+		std::string_view name = matrix->layout() == SparseLayout::CSR ? "CSR" : "CSC";
+		run(std::format("SpMV {} seq", name), matrix->nonZeros(), [&] { matrix->multiply(vector, result); });
+		run(std::format("SpMV {} par", name), matrix->nonZeros(), [&] { matrix->multiply(std::execution::par, vector, result); });
+		run(std::format("SpMM {} seq (k={})", name, rightHandSides), matrix->nonZeros() * rightHandSides,
+			[&] { matrix->multiply(x, rightHandSides, y); });
+		run(std::format("SpMM {} par (k={})", name, rightHandSides), matrix->nonZeros() * rightHandSides,
+			[&] { matrix->multiply(std::execution::par, x, rightHandSides, y); });
+	}
+}
@@ -1 +1,691 @@
 #pragma once
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+import std;
+
+/// <summary>
+/// Map (B+-tree):
+///    - Ordered map for time-series indexes, where almost every lookup is a
+///      floor/ceiling on a timestamp and almost every insert is an append.
+///
+///    - Layout:
+///       - Inner nodes hold up to InnerKeys separator keys in one contiguous,
+///         cache-line aligned array. A child slot is found by counting the
+///         separators <= key over the whole array, which is branch free and
+///         compiles to a handful of vector compares (explicit AVX2 for
+///         64-bit keys when the target supports it).
+///       - Leaves hold up to LeafCapacity keys and values in two contiguous
+///         arrays and are chained in key order, so a range scan is a linear
+///         walk over memory rather than a pointer chase.
+///       - Nodes live in two vectors and refer to each other by 32-bit index
+///         (MapNil for none), as in RBTree.
+///       - A lookup costs about one cache miss per level; with the default
+///         widths a 10M-key map is five levels deep.
+///
+///    - Operations:
+///       - put/get/find/remove, plus minimum, maximum, floor, ceiling, range
+///         keys and range scan.
+///       - Splits at the right edge of the tree leave the left node full, so
+///         appending keys in ascending order packs leaves and inner nodes
+///         completely instead of half full.
+///       - remove() does not merge underfull nodes; it only frees a node once
+///         it is empty. Every leaf in the chain is therefore non-empty.
+/// </summary>
+using MapIndex = std::uint32_t;
+
+inline constexpr MapIndex MapNil = std::numeric_limits<MapIndex>::max();
+
+template <typename Key, typename DataType, std::size_t LeafCapacity = 64, std::size_t InnerKeys = 16>
+class Map
+{
+	static_assert(LeafCapacity >= 2 && InnerKeys >= 2);
+
+	struct Leaf
+	{
+		std::array<Key, LeafCapacity> keys{};
+		std::array<DataType, LeafCapacity> data{};
+		std::uint32_t count = 0;
+		MapIndex prev = MapNil;
+		MapIndex next = MapNil;
+	};
+
+	struct alignas(64) Inner
+	{
+		// keys[i] is the smallest key reachable through children[i + 1].
+		std::array<Key, InnerKeys> keys{};
+		std::array<MapIndex, InnerKeys + 1> children{};
+		std::uint32_t count = 0;
+	};
+
+	struct PathEntry
+	{
+		MapIndex node;
+		std::uint32_t slot;
+	};
+
+	static constexpr int MaxLevels = 32;
+
+private:
+	std::vector<Leaf> leaves;
+	std::vector<Inner> inners;
+	std::vector<MapIndex> freeLeaves;
+	std::vector<MapIndex> freeInners;
+
+	MapIndex root = MapNil;
+	MapIndex firstLeaf = MapNil;
+	MapIndex lastLeaf = MapNil;
+	int levels = 0;
+	std::size_t count = 0;
+
+	/***************************************************************************
+	*  Node search helpers.
+	***************************************************************************/
+	static std::uint32_t childSlot(const Inner& node, const Key& key);
+	static std::uint32_t lowerIndex(const Leaf& leaf, const Key& key);
+	static std::uint32_t upperIndex(const Leaf& leaf, const Key& key);
+
+	MapIndex descend(const Key& key, PathEntry* path, int& depth) const;
+	MapIndex descend(const Key& key) const;
+
+	/***************************************************************************
+	*  Node allocation and structural changes.
+	***************************************************************************/
+	MapIndex newLeaf();
+	MapIndex newInner();
+	void insertSeparator(PathEntry* path, int depth, Key separator, MapIndex child);
+	void removeChild(PathEntry* path, int depth);
+
+	bool checkIntegrity(MapIndex node, int level, const Key* min, const Key* max) const;
+
+public:
+	Map() = default;
+	Map(Map&&) noexcept = default;
+	Map& operator=(Map&&) noexcept = default;
+
+	bool isEmpty() const;
+	bool checkIntegrity() const;
+
+	/// Pre-allocates leaves for `count` keys (assuming half-full leaves).
+	void reserve(std::size_t count);
+
+	/***************************************************************************
+	*  Insertion, lookup and deletion.
+	***************************************************************************/
+	void put(Key key, DataType value);
+	DataType get(Key key) const;
+	const DataType* find(Key key) const;
+	bool contains(Key key) const;
+	void remove(Key key);
+	void clear();
+
+	/***************************************************************************
+	*  Utility functions.
+	***************************************************************************/
+	int height() const;
+	std::size_t size() const;
+
+	/***************************************************************************
+	*  Ordered symbol table methods.
+	***************************************************************************/
+	Key minimum() const;
+	Key maximum() const;
+	Key ceiling(Key key) const;
+	Key floor(Key key) const;
+
+	/***************************************************************************
+	*  Range search.
+	***************************************************************************/
+	std::vector<Key> keys() const;
+	std::vector<Key> keys(Key lo, Key hi) const;
+
+	/// Calls visitor(key, data) for every key in [lo, hi], in ascending order,
+	/// walking the leaf chain.
+	template <typename Visitor>
+	void scan(Key lo, Key hi, Visitor&& visitor) const;
+};
+
+
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+std::uint32_t Map<Key, DataType, LeafCapacity, InnerKeys>::childSlot(const Inner& node, const Key& key)
+{
+#if defined(__AVX2__)
+	if constexpr (std::is_same_v<Key, std::int64_t> && InnerKeys % 4 == 0) {
+		// Count separators > key in each 4-lane block and mask off the unused tail.
+		__m256i needle = _mm256_set1_epi64x(key);
+		std::uint64_t greater = 0;
+		for (std::size_t i = 0; i < InnerKeys; i += 4) {
+			__m256i block = _mm256_load_si256(reinterpret_cast<const __m256i*>(node.keys.data() + i));
+			auto mask = static_cast<std::uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(block, needle))));
+			greater |= static_cast<std::uint64_t>(mask) << i;
+		}
+		greater &= (std::uint64_t{ 1 } << node.count) - 1;
+		return node.count - static_cast<std::uint32_t>(std::popcount(greater));
+	}
+#endif
+	if constexpr (std::is_arithmetic_v<Key>) {
+		// Fixed trip count and no early exit, so the loop vectorizes.
+		std::uint32_t slot = 0;
+		for (std::uint32_t i = 0; i < InnerKeys; i++) {
+			slot += static_cast<std::uint32_t>((i < node.count) & !(key < node.keys[i]));
+		}
+		return slot;
+	}
+	else {
+		auto last = node.keys.begin() + node.count;
+		return static_cast<std::uint32_t>(std::upper_bound(node.keys.begin(), last, key) - node.keys.begin());
+	}
+}
+
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+std::uint32_t Map<Key, DataType, LeafCapacity, InnerKeys>::lowerIndex(const Leaf& leaf, const Key& key)
+{
+	auto last = leaf.keys.begin() + leaf.count;
+	return static_cast<std::uint32_t>(std::lower_bound(leaf.keys.begin(), last, key) - leaf.keys.begin());
+}
+
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+std::uint32_t Map<Key, DataType, LeafCapacity, InnerKeys>::upperIndex(const Leaf& leaf, const Key& key)
+{
+	auto last = leaf.keys.begin() + leaf.count;
+	return static_cast<std::uint32_t>(std::upper_bound(leaf.keys.begin(), last, key) - leaf.keys.begin());
+}
+
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+MapIndex Map<Key, DataType, LeafCapacity, InnerKeys>::descend(const Key& key, PathEntry* path, int& depth) const
+{
+	depth = 0;
+	MapIndex node = root;
+	for (int level = levels; level > 1; level--) {
+		const Inner& inner = inners[node];
+		std::uint32_t slot = childSlot(inner, key);
+		path[depth++] = { node, slot };
+		node = inner.children[slot];
+	}
+	return node;
+}
+
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+MapIndex Map<Key, DataType, LeafCapacity, InnerKeys>::descend(const Key& key) const
+{
+	MapIndex node = root;
+	for (int level = levels; level > 1; level--) {
+		const Inner& inner = inners[node];
+		node = inner.children[childSlot(inner, key)];
+	}
+	return node;
+}
+
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+MapIndex Map<Key, DataType, LeafCapacity, InnerKeys>::newLeaf()
+{
+	if (!freeLeaves.empty()) {
+		MapIndex index = freeLeaves.back();
+		freeLeaves.pop_back();
+		leaves[index] = Leaf{};
+		return index;
+	}
+	if (leaves.size() >= MapNil) {
+		throw std::length_error("Map: exhausted the 32-bit leaf index space");
+	}
+	leaves.emplace_back();
+	return static_cast<MapIndex>(leaves.size() - 1);
+}
+
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+MapIndex Map<Key, DataType, LeafCapacity, InnerKeys>::newInner()
+{
+	if (!freeInners.empty()) {
+		MapIndex index = freeInners.back();
+		freeInners.pop_back();
+		inners[index] = Inner{};
+		return index;
+	}
+	if (inners.size() >= MapNil) {
+		throw std::length_error("Map: exhausted the 32-bit inner node index space");
+	}
+	inners.emplace_back();
+	return static_cast<MapIndex>(inners.size() - 1);
+}
+
+/// Inserts `separator` and the new right sibling `child` into the parent at
+/// path[depth - 1], splitting upwards as needed.
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+void Map<Key, DataType, LeafCapacity, InnerKeys>::insertSeparator(PathEntry* path, int depth, Key separator, MapIndex child)
+{
+	while (depth > 0) {
+		auto [node, slot] = path[--depth];
+
+		if (inners[node].count < InnerKeys) {
+			Inner& inner = inners[node];
+			std::move_backward(inner.keys.begin() + slot, inner.keys.begin() + inner.count, inner.keys.begin() + inner.count + 1);
+			std::move_backward(inner.children.begin() + slot + 1, inner.children.begin() + inner.count + 1, inner.children.begin() + inner.count + 2);
+			inner.keys[slot] = std::move(separator);
+			inner.children[slot + 1] = child;
+			inner.count++;
+			return;
+		}
+
+		MapIndex sibling = newInner();
+		Inner& left = inners[node];
+		Inner& right = inners[sibling];
+
+		if (slot == InnerKeys) {
+			// Appending past the last separator: keep the left node full.
+			right.children[0] = child;
+			right.count = 0;
+		}
+		else {
+			std::array<Key, InnerKeys + 1> keys;
+			std::array<MapIndex, InnerKeys + 2> children;
+			std::move(left.keys.begin(), left.keys.begin() + slot, keys.begin());
+			keys[slot] = std::move(separator);
+			std::move(left.keys.begin() + slot, left.keys.end(), keys.begin() + slot + 1);
+			std::copy(left.children.begin(), left.children.begin() + slot + 1, children.begin());
+			children[slot + 1] = child;
+			std::copy(left.children.begin() + slot + 1, left.children.end(), children.begin() + slot + 2);
+
+			constexpr std::size_t mid = (InnerKeys + 1) / 2;
+			std::move(keys.begin(), keys.begin() + mid, left.keys.begin());
+			std::copy(children.begin(), children.begin() + mid + 1, left.children.begin());
+			left.count = static_cast<std::uint32_t>(mid);
+
+			separator = std::move(keys[mid]);
+			std::move(keys.begin() + mid + 1, keys.end(), right.keys.begin());
+			std::copy(children.begin() + mid + 1, children.end(), right.children.begin());
+			right.count = static_cast<std::uint32_t>(InnerKeys - mid);
+		}
+		child = sibling;
+	}
+
+	MapIndex newRoot = newInner();
+	Inner& top = inners[newRoot];
+	top.keys[0] = std::move(separator);
+	top.children[0] = root;
+	top.children[1] = child;
+	top.count = 1;
+	root = newRoot;
+	levels++;
+	if (levels > MaxLevels) {
+		throw std::length_error("Map: tree exceeded the maximum depth");
+	}
+}
+
+/// Removes the (now empty) child at path[depth - 1] from its parent, freeing
+/// parents that become empty in turn, then collapses single-child roots.
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+void Map<Key, DataType, LeafCapacity, InnerKeys>::removeChild(PathEntry* path, int depth)
+{
+	while (depth > 0) {
+		auto [node, slot] = path[--depth];
+		Inner& inner = inners[node];
+		if (inner.count > 0) {
+			std::uint32_t keySlot = slot == 0 ? 0 : slot - 1;
+			std::move(inner.keys.begin() + keySlot + 1, inner.keys.begin() + inner.count, inner.keys.begin() + keySlot);
+			std::copy(inner.children.begin() + slot + 1, inner.children.begin() + inner.count + 1, inner.children.begin() + slot);
+			inner.count--;
+			break;
+		}
+		// The inner node had only this child: it is empty now too.
+		freeInners.push_back(node);
+	}
+
+	while (levels > 1 && inners[root].count == 0) {
+		freeInners.push_back(root);
+		root = inners[root].children[0];
+		levels--;
+	}
+}
+
+
+/***************************************************************************
+*  Node helper methods.
+***************************************************************************/
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+bool Map<Key, DataType, LeafCapacity, InnerKeys>::isEmpty() const
+{
+	return count == 0;
+}
+
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+void Map<Key, DataType, LeafCapacity, InnerKeys>::reserve(std::size_t count)
+{
+	leaves.reserve(count / (LeafCapacity / 2) + 1);
+	inners.reserve(count / (LeafCapacity / 2) / (InnerKeys / 2) + 1);
+}
+
+/***************************************************************************
+*  Insertion, lookup and deletion.
+***************************************************************************/
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+void Map<Key, DataType, LeafCapacity, InnerKeys>::put(Key key, DataType value)
+{
+	if (root == MapNil) {
+		root = newLeaf();
+		firstLeaf = root;
+		lastLeaf = root;
+		levels = 1;
+	}
+
+	PathEntry path[MaxLevels];
+	int depth = 0;
+	MapIndex leafIndex = descend(key, path, depth);
+
+	std::uint32_t position = lowerIndex(leaves[leafIndex], key);
+	if (position < leaves[leafIndex].count && !(key < leaves[leafIndex].keys[position])) {
+		leaves[leafIndex].data[position] = std::move(value);
+		return;
+	}
+	count++;
+
+	if (leaves[leafIndex].count < LeafCapacity) {
+		Leaf& leaf = leaves[leafIndex];
+		std::move_backward(leaf.keys.begin() + position, leaf.keys.begin() + leaf.count, leaf.keys.begin() + leaf.count + 1);
+		std::move_backward(leaf.data.begin() + position, leaf.data.begin() + leaf.count, leaf.data.begin() + leaf.count + 1);
+		leaf.keys[position] = std::move(key);
+		leaf.data[position] = std::move(value);
+		leaf.count++;
+		return;
+	}
+
+	MapIndex siblingIndex = newLeaf();
+	Leaf& leaf = leaves[leafIndex];
+	Leaf& sibling = leaves[siblingIndex];
+
+	// Appends to the last leaf start a new leaf instead of splitting in half.
+	std::uint32_t split = (leafIndex == lastLeaf && position == LeafCapacity) ? LeafCapacity : LeafCapacity / 2;
+	std::move(leaf.keys.begin() + split, leaf.keys.end(), sibling.keys.begin());
+	std::move(leaf.data.begin() + split, leaf.data.end(), sibling.data.begin());
+	sibling.count = LeafCapacity - split;
+	leaf.count = split;
+
+	Leaf& target = position < split ? leaf : sibling;
+	std::uint32_t offset = position < split ? position : position - split;
+	std::move_backward(target.keys.begin() + offset, target.keys.begin() + target.count, target.keys.begin() + target.count + 1);
+	std::move_backward(target.data.begin() + offset, target.data.begin() + target.count, target.data.begin() + target.count + 1);
+	target.keys[offset] = std::move(key);
+	target.data[offset] = std::move(value);
+	target.count++;
+
+	sibling.prev = leafIndex;
+	sibling.next = leaf.next;
+	if (leaf.next != MapNil) {
+		leaves[leaf.next].prev = siblingIndex;
+	}
+	else {
+		lastLeaf = siblingIndex;
+	}
+	leaf.next = siblingIndex;
+
+	insertSeparator(path, depth, sibling.keys[0], siblingIndex);
+}
+
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+const DataType* Map<Key, DataType, LeafCapacity, InnerKeys>::find(Key key) const
+{
+	if (root == MapNil) {
+		return nullptr;
+	}
+	const Leaf& leaf = leaves[descend(key)];
+	std::uint32_t position = lowerIndex(leaf, key);
+	if (position < leaf.count && !(key < leaf.keys[position])) {
+		return &leaf.data[position];
+	}
+	return nullptr;
+}
+
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+DataType Map<Key, DataType, LeafCapacity, InnerKeys>::get(Key key) const
+{
+	const DataType* data = find(key);
+	if (data == nullptr) {
+		throw std::out_of_range("Map::get: key not found");
+	}
+	return *data;
+}
+
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+bool Map<Key, DataType, LeafCapacity, InnerKeys>::contains(Key key) const
+{
+	return find(key) != nullptr;
+}
+
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+void Map<Key, DataType, LeafCapacity, InnerKeys>::remove(Key key)
+{
+	if (root == MapNil) {
+		return;
+	}
+
+	PathEntry path[MaxLevels];
+	int depth = 0;
+	MapIndex leafIndex = descend(key, path, depth);
+	Leaf& leaf = leaves[leafIndex];
+
+	std::uint32_t position = lowerIndex(leaf, key);
+	if (position == leaf.count || key < leaf.keys[position]) {
+		return;
+	}
+	std::move(leaf.keys.begin() + position + 1, leaf.keys.begin() + leaf.count, leaf.keys.begin() + position);
+	std::move(leaf.data.begin() + position + 1, leaf.data.begin() + leaf.count, leaf.data.begin() + position);
+	leaf.count--;
+	count--;
+
+	if (count == 0) {
+		clear();
+		return;
+	}
+	if (leaf.count > 0) {
+		return;
+	}
+
+	if (leaf.prev != MapNil) {
+		leaves[leaf.prev].next = leaf.next;
+	}
+	else {
+		firstLeaf = leaf.next;
+	}
+	if (leaf.next != MapNil) {
+		leaves[leaf.next].prev = leaf.prev;
+	}
+	else {
+		lastLeaf = leaf.prev;
+	}
+	freeLeaves.push_back(leafIndex);
+	removeChild(path, depth);
+}
+
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+void Map<Key, DataType, LeafCapacity, InnerKeys>::clear()
+{
+	leaves.clear();
+	inners.clear();
+	freeLeaves.clear();
+	freeInners.clear();
+	root = MapNil;
+	firstLeaf = MapNil;
+	lastLeaf = MapNil;
+	levels = 0;
+	count = 0;
+}
+
+/***************************************************************************
+*  Utility functions.
+***************************************************************************/
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+int Map<Key, DataType, LeafCapacity, InnerKeys>::height() const
+{
+	return levels;
+}
+
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+std::size_t Map<Key, DataType, LeafCapacity, InnerKeys>::size() const
+{
+	return count;
+}
+
+/***************************************************************************
+*  Ordered symbol table methods.
+***************************************************************************/
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+Key Map<Key, DataType, LeafCapacity, InnerKeys>::minimum() const
+{
+	if (isEmpty()) {
+		throw std::out_of_range("Map::minimum: map is empty");
+	}
+	return leaves[firstLeaf].keys[0];
+}
+
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+Key Map<Key, DataType, LeafCapacity, InnerKeys>::maximum() const
+{
+	if (isEmpty()) {
+		throw std::out_of_range("Map::maximum: map is empty");
+	}
+	const Leaf& leaf = leaves[lastLeaf];
+	return leaf.keys[leaf.count - 1];
+}
+
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+Key Map<Key, DataType, LeafCapacity, InnerKeys>::floor(Key key) const
+{
+	if (!isEmpty()) {
+		MapIndex leafIndex = descend(key);
+		const Leaf& leaf = leaves[leafIndex];
+		std::uint32_t position = upperIndex(leaf, key);
+		if (position > 0) {
+			return leaf.keys[position - 1];
+		}
+		// Everything left of this leaf's range lives in the previous leaf.
+		if (leaf.prev != MapNil) {
+			const Leaf& prev = leaves[leaf.prev];
+			return prev.keys[prev.count - 1];
+		}
+	}
+	throw std::out_of_range("Map::floor: no key at or below the argument");
+}
+
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+Key Map<Key, DataType, LeafCapacity, InnerKeys>::ceiling(Key key) const
+{
+	if (!isEmpty()) {
+		MapIndex leafIndex = descend(key);
+		const Leaf& leaf = leaves[leafIndex];
+		std::uint32_t position = lowerIndex(leaf, key);
+		if (position < leaf.count) {
+			return leaf.keys[position];
+		}
+		if (leaf.next != MapNil) {
+			return leaves[leaf.next].keys[0];
+		}
+	}
+	throw std::out_of_range("Map::ceiling: no key at or above the argument");
+}
+
+/***************************************************************************
+*  Range search.
+***************************************************************************/
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+std::vector<Key> Map<Key, DataType, LeafCapacity, InnerKeys>::keys() const
+{
+	std::vector<Key> result;
+	result.reserve(count);
+	for (MapIndex leaf = firstLeaf; leaf != MapNil; leaf = leaves[leaf].next) {
+		result.insert(result.end(), leaves[leaf].keys.begin(), leaves[leaf].keys.begin() + leaves[leaf].count);
+	}
+	return result;
+}
+
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+std::vector<Key> Map<Key, DataType, LeafCapacity, InnerKeys>::keys(Key lo, Key hi) const
+{
+	std::vector<Key> result;
+	scan(lo, hi, [&](const Key& key, const DataType&) {
+		result.push_back(key);
+	});
+	return result;
+}
+
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+template <typename Visitor>
+void Map<Key, DataType, LeafCapacity, InnerKeys>::scan(Key lo, Key hi, Visitor&& visitor) const
+{
+	if (isEmpty() || hi < lo) {
+		return;
+	}
+	MapIndex leafIndex = descend(lo);
+	std::uint32_t position = lowerIndex(leaves[leafIndex], lo);
+	while (leafIndex != MapNil) {
+		const Leaf& leaf = leaves[leafIndex];
+		for (; position < leaf.count; position++) {
+			if (hi < leaf.keys[position]) {
+				return;
+			}
+			visitor(leaf.keys[position], leaf.data[position]);
+		}
+		leafIndex = leaf.next;
+		position = 0;
+	}
+}
+
+/***************************************************************************
+*  Check integrity of the B+-tree.
+***************************************************************************/
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+bool Map<Key, DataType, LeafCapacity, InnerKeys>::checkIntegrity() const
+{
+	if (root == MapNil) {
+		return count == 0 && levels == 0;
+	}
+	if (!checkIntegrity(root, levels, nullptr, nullptr)) {
+		return false;
+	}
+
+	// The leaf chain visits every key exactly once, in ascending order.
+	std::size_t seen = 0;
+	const Key* previous = nullptr;
+	MapIndex prevLeaf = MapNil;
+	for (MapIndex leaf = firstLeaf; leaf != MapNil; leaf = leaves[leaf].next) {
+		if (leaves[leaf].prev != prevLeaf || leaves[leaf].count == 0) {
+			return false;
+		}
+		for (std::uint32_t i = 0; i < leaves[leaf].count; i++) {
+			if (previous != nullptr && !(*previous < leaves[leaf].keys[i])) {
+				return false;
+			}
+			previous = &leaves[leaf].keys[i];
+		}
+		seen += leaves[leaf].count;
+		prevLeaf = leaf;
+	}
+	return prevLeaf == lastLeaf && seen == count;
+}
+
+/// Every key under `node` lies in [min, max).
+template <typename Key, typename DataType, std::size_t LeafCapacity, std::size_t InnerKeys>
+bool Map<Key, DataType, LeafCapacity, InnerKeys>::checkIntegrity(MapIndex node, int level, const Key* min, const Key* max) const
+{
+	if (level == 1) {
+		const Leaf& leaf = leaves[node];
+		for (std::uint32_t i = 0; i < leaf.count; i++) {
+			if ((min != nullptr && leaf.keys[i] < *min) || (max != nullptr && !(leaf.keys[i] < *max))) {
+				return false;
+			}
+		}
+		return true;
+	}
+	const Inner& inner = inners[node];
+	for (std::uint32_t i = 0; i <= inner.count; i++) {
+		const Key* lo = i == 0 ? min : &inner.keys[i - 1];
+		const Key* hi = i == inner.count ? max : &inner.keys[i];
+		if (i < inner.count && i > 0 && !(inner.keys[i - 1] < inner.keys[i])) {
+			return false;
+		}
+		if (!checkIntegrity(inner.children[i], level - 1, lo, hi)) {
+			return false;
+		}
+	}
+	return true;
+}
@@ -2,7 +2,6 @@
 module;
 
 // global module fragment area. Put #include directives here 
-#include <functional>
 
 export module Markets.DataStructures;
 
@@ -13,7 +12,7 @@ class NodeAddress {
 	int column;
 };
 
-template <typename KeyType>
+export template <typename KeyType>
 class IAddressableNode
 {
 public:
@@ -29,7 +28,7 @@ public:
 	}
 };
 
-template <typename KeyType, typename ValueType>
+export template <typename KeyType, typename ValueType>
 class BSTNode : public IAddressableNode<KeyType>
 {
 public:
@@ -46,22 +45,29 @@ public:
 	int GetRow() override;
 	int GetColumn() override;
 	KeyType GetElement() override;
+
+	// Parent-pointer navigation; none of these allocate or recurse.
+	BSTNode* Minimum();
+	BSTNode* Maximum();
+	BSTNode* Successor();
+	BSTNode* Predecessor();
 };
 
 template <typename KeyType, typename ValueType>
 auto defaultTraversalCallbackFn = [](BSTNode<KeyType, ValueType>* node) {
-	std::println("BSTNode.key: {}", node.key);
+	std::println("BSTNode.key: {}", node->key);
 };
 
 
 template <typename KeyType, typename ValueType>
-BSTNode<KeyType, ValueType>::BSTNode() : BSTNode(nullptr, nullptr) {}
+BSTNode<KeyType, ValueType>::BSTNode() : BSTNode(KeyType{}, ValueType{}) {}
 
 template <typename KeyType, typename ValueType>
 BSTNode<KeyType, ValueType>::BSTNode(KeyType key, ValueType value)
 {
-	this.key = key;
-	this.value = value;
+	this->key = key;
+	this->value = value;
+	this->parent = nullptr;
 	this->leftChild = nullptr;
 	this->rightChild = nullptr;
 }
@@ -69,10 +75,8 @@ BSTNode<KeyType, ValueType>::BSTNode(KeyType key, ValueType value)
 template <typename KeyType, typename ValueType>
 BSTNode<KeyType, ValueType>::~BSTNode()
 {
-	delete key;
-	delete value;
-	delete this->leftChild;
-	delete this->rightChild;
+	// Children are released by BSTree, iteratively, so that deleting a
+	// degenerate (list-shaped) tree does not recurse once per level.
 }
 
 template <typename KeyType, typename ValueType>
@@ -112,72 +116,277 @@ KeyType BSTNode<KeyType, ValueType>::GetElement()
 	return key;
 }
 
-enum TraversalKind {
+template <typename KeyType, typename ValueType>
+BSTNode<KeyType, ValueType>* BSTNode<KeyType, ValueType>::Minimum()
+{
+	BSTNode* node = this;
+	while (node->leftChild != nullptr) {
+		node = node->leftChild;
+	}
+	return node;
+}
+
+template <typename KeyType, typename ValueType>
+BSTNode<KeyType, ValueType>* BSTNode<KeyType, ValueType>::Maximum()
+{
+	BSTNode* node = this;
+	while (node->rightChild != nullptr) {
+		node = node->rightChild;
+	}
+	return node;
+}
+
+template <typename KeyType, typename ValueType>
+BSTNode<KeyType, ValueType>* BSTNode<KeyType, ValueType>::Successor()
+{
+	if (rightChild != nullptr) {
+		return rightChild->Minimum();
+	}
+	BSTNode* node = this;
+	BSTNode* up = parent;
+	while (up != nullptr && node == up->rightChild) {
+		node = up;
+		up = up->parent;
+	}
+	return up;
+}
+
+template <typename KeyType, typename ValueType>
+BSTNode<KeyType, ValueType>* BSTNode<KeyType, ValueType>::Predecessor()
+{
+	if (leftChild != nullptr) {
+		return leftChild->Maximum();
+	}
+	BSTNode* node = this;
+	BSTNode* up = parent;
+	while (up != nullptr && node == up->leftChild) {
+		node = up;
+		up = up->parent;
+	}
+	return up;
+}
+
+export enum TraversalKind {
 	PreOrder, PostOrder, InOrder, LevelOrder
 };
 
-enum RotationDirection {
+export enum RotationDirection {
 	Left, Right
 };
 
-template <typename KeyType, typename ValueType>
+export template <typename KeyType, typename ValueType>
+class BSTForwardIterator;
+
+export template <typename KeyType, typename ValueType>
+class BSTReverseIterator;
+
+export template <typename KeyType, typename ValueType>
 class BSTree
 {
 private:
 	BSTNode<KeyType, ValueType>* root;
 
-	BSTNode<KeyType, ValueType>* InsertNode(BSTNode<KeyType, ValueType>* parent, BSTNode<KeyType, ValueType>* node, KeyType key, ValueType value);
-	BSTNode<KeyType, ValueType>* RemoveNode(BSTNode<KeyType, ValueType>* node, KeyType key, ValueType value);
+	// Contiguous node arrays created by BuildFromSorted/Balance. Nodes in a
+	// block are not individually allocated, so they are never deleted one by
+	// one; the block goes away as a whole in Clear().
+	std::vector<std::pair<std::unique_ptr<BSTNode<KeyType, ValueType>[]>, std::size_t>> nodeBlocks;
+
+	BSTNode<KeyType, ValueType>* RemoveNode(BSTNode<KeyType, ValueType>* node, KeyType key);
 	BSTNode<KeyType, ValueType>* Search(BSTNode<KeyType, ValueType>* node, KeyType key);
-	void Traverse(BSTNode<KeyType, ValueType>* node, TraversalKind traversalMethod, std::function<void(BSTNode<KeyType, ValueType>*)> traversalCallbackFn);
 
 
 	BSTNode<KeyType, ValueType>* RotateLeft(BSTNode<KeyType, ValueType>* node);
 	BSTNode<KeyType, ValueType>* RotateRight(BSTNode<KeyType, ValueType>* node);
+	void ReplaceChild(BSTNode<KeyType, ValueType>* parent, BSTNode<KeyType, ValueType>* oldChild, BSTNode<KeyType, ValueType>* newChild);
 
 
 	BSTNode<KeyType, ValueType>* GetSuccessor(BSTNode<KeyType, ValueType>* node);
 
+	bool OwnsNode(const BSTNode<KeyType, ValueType>* node) const;
+	void ReleaseNode(BSTNode<KeyType, ValueType>* node);
+	void AdoptBlock(std::unique_ptr<BSTNode<KeyType, ValueType>[]> block, std::size_t count);
+	static BSTNode<KeyType, ValueType>* LinkBalanced(BSTNode<KeyType, ValueType>* nodes, std::size_t lo, std::size_t hi, BSTNode<KeyType, ValueType>* parent);
+
+	// Stackless traversal steps: first node and successor in each order.
+	static BSTNode<KeyType, ValueType>* PreOrderNext(BSTNode<KeyType, ValueType>* node);
+	static BSTNode<KeyType, ValueType>* PostOrderFirst(BSTNode<KeyType, ValueType>* node);
+	static BSTNode<KeyType, ValueType>* PostOrderNext(BSTNode<KeyType, ValueType>* node);
+	static BSTNode<KeyType, ValueType>* DepthFirst(BSTNode<KeyType, ValueType>* node, int depth);
+	static BSTNode<KeyType, ValueType>* DepthNext(BSTNode<KeyType, ValueType>* node, int depth);
+
 public:
+	using iterator = BSTForwardIterator<KeyType, ValueType>;
+	using reverse_iterator = BSTReverseIterator<KeyType, ValueType>;
+
 	BSTree();
 	~BSTree();
+	BSTree(const BSTree&) = delete;
+	BSTree& operator=(const BSTree&) = delete;
+
 	void InsertNode(KeyType key, ValueType value);
 	void RemoveNode(KeyType key);
 
+	/// Replaces the contents of the tree with the (key, value) pairs of
+	/// `sorted`, which must be ordered by ascending key (equal keys collapse,
+	/// last value wins). Builds a perfectly balanced tree in O(n) into one
+	/// contiguous node array.
+	template <std::ranges::input_range R>
+	void BuildFromSorted(R&& sorted);
+
+	void Clear();
+
 	BSTNode<KeyType, ValueType>* Search(KeyType obj);
 
-	void Traverse(TraversalKind traversalMethod, std::function<void(BSTNode<KeyType, ValueType>*)> traversalCallbackFn);
+	/// Calls visitor(node) for every node in the given order. The visitor is
+	/// a template parameter, so the call is inlined rather than dispatched
+	/// through std::function, and no traversal allocates.
+	template <typename Visitor>
+	void Traverse(TraversalKind traversalMethod, Visitor&& visitor);
+	void Traverse(TraversalKind traversalMethod);
+
+	/// Calls visitor(node) for every node with lo <= key <= hi, in key order.
+	template <typename Visitor>
+	void TraverseRange(KeyType lo, KeyType hi, Visitor&& visitor);
+
 	BSTNode<KeyType, ValueType>* Rotate(BSTNode<KeyType, ValueType>* node, RotationDirection direction);
 
+	/// Rebuilds the tree perfectly balanced, in O(n), into one contiguous
+	/// node array laid out in key order. Invalidates node pointers and iterators.
 	void Balance();
 
+	/// Number of levels (0 for an empty tree, 1 for a lone root).
 	int Height();
 
 	bool IsEmpty();
+
+	iterator begin() const;
+	iterator end() const;
+	reverse_iterator rbegin() const;
+	reverse_iterator rend() const;
+
+	/// First node with key >= `key` (or end()).
+	iterator LowerBound(KeyType key) const;
+	/// First node with key > `key` (or end()).
+	iterator UpperBound(KeyType key) const;
+	/// In-order view of the nodes with lo <= key <= hi.
+	std::ranges::subrange<iterator> Range(KeyType lo, KeyType hi) const;
 };
 
 
+/// <summary>
+/// In-order iterator over a BSTree. Stepping follows parent pointers, so the
+/// iterator is two pointers wide and never allocates. The tree root is kept
+/// so that end() can be decremented back onto the maximum node.
+/// </summary>
 template <typename KeyType, typename ValueType>
-class BSTReverseIterator
+class BSTForwardIterator
 {
 public:
-	BSTReverseIterator(BSTNode<KeyType, ValueType>* root);
-	~BSTReverseIterator();
+	using iterator_concept = std::bidirectional_iterator_tag;
+	using iterator_category = std::bidirectional_iterator_tag;
+	using value_type = BSTNode<KeyType, ValueType>;
+	using difference_type = std::ptrdiff_t;
+	using pointer = value_type*;
+	using reference = value_type&;
+
+	BSTForwardIterator() = default;
+	BSTForwardIterator(BSTNode<KeyType, ValueType>* node, BSTNode<KeyType, ValueType>* root) : node(node), root(root) {}
+
+	reference operator*() const { return *node; }
+	pointer operator->() const { return node; }
+
+	BSTForwardIterator& operator++() {
+		node = node->Successor();
+		return *this;
+	}
 
-	virtual BSTNode<KeyType, ValueType>* curr();
-	virtual BSTNode<KeyType, ValueType>* prev();
-	virtual bool isEnd();
+	BSTForwardIterator operator++(int) {
+		BSTForwardIterator other = *this;
+		++*this;
+		return other;
+	}
+
+	BSTForwardIterator& operator--() {
+		node = node == nullptr ? root->Maximum() : node->Predecessor();
+		return *this;
+	}
+
+	BSTForwardIterator operator--(int) {
+		BSTForwardIterator other = *this;
+		--*this;
+		return other;
+	}
+
+	bool operator==(const BSTForwardIterator& other) const { return node == other.node; }
+
+	BSTNode<KeyType, ValueType>* curr() { return node; }
+	BSTNode<KeyType, ValueType>* next() { return (++*this).node; }
+	bool isEnd() { return node == nullptr; }
+
+private:
+	BSTNode<KeyType, ValueType>* node = nullptr;
+	BSTNode<KeyType, ValueType>* root = nullptr;
 };
 
+/// <summary>
+/// Reverse in-order (descending key) iterator over a BSTree; the mirror image
+/// of BSTForwardIterator.
+/// </summary>
 template <typename KeyType, typename ValueType>
-class BSTForwardIterator
+class BSTReverseIterator
 {
 public:
-	virtual BSTNode<KeyType, ValueType>* curr();
-	virtual BSTNode<KeyType, ValueType>* next();
-	bool isEnd();
+	using iterator_concept = std::bidirectional_iterator_tag;
+	using iterator_category = std::bidirectional_iterator_tag;
+	using value_type = BSTNode<KeyType, ValueType>;
+	using difference_type = std::ptrdiff_t;
+	using pointer = value_type*;
+	using reference = value_type&;
+
+	BSTReverseIterator() = default;
+	BSTReverseIterator(BSTNode<KeyType, ValueType>* root) : BSTReverseIterator(root == nullptr ? nullptr : root->Maximum(), root) {}
+	BSTReverseIterator(BSTNode<KeyType, ValueType>* node, BSTNode<KeyType, ValueType>* root) : node(node), root(root) {}
+
+	reference operator*() const { return *node; }
+	pointer operator->() const { return node; }
+
+	BSTReverseIterator& operator++() {
+		node = node->Predecessor();
+		return *this;
+	}
+
+	BSTReverseIterator operator++(int) {
+		BSTReverseIterator other = *this;
+		++*this;
+		return other;
+	}
+
+	BSTReverseIterator& operator--() {
+		node = node == nullptr ? root->Minimum() : node->Successor();
+		return *this;
+	}
+
+	BSTReverseIterator operator--(int) {
+		BSTReverseIterator other = *this;
+		--*this;
+		return other;
+	}
+
+	bool operator==(const BSTReverseIterator& other) const { return node == other.node; }
+
+	BSTNode<KeyType, ValueType>* curr() { return node; }
+	BSTNode<KeyType, ValueType>* prev() { return (++*this).node; }
+	bool isEnd() { return node == nullptr; }
+
+private:
+	BSTNode<KeyType, ValueType>* node = nullptr;
+	BSTNode<KeyType, ValueType>* root = nullptr;
 };
 
+static_assert(std::bidirectional_iterator<BSTForwardIterator<int, int>>);
+static_assert(std::bidirectional_iterator<BSTReverseIterator<int, int>>);
+static_assert(std::ranges::bidirectional_range<BSTree<int, int>>);
+
 ///
 /// Implementation
 /// 
@@ -193,44 +402,166 @@ BSTree<KeyType, ValueType>::BSTree()
 template <typename KeyType, typename ValueType>
 BSTree<KeyType, ValueType>::~BSTree()
 {
-	delete root;
+	Clear();
+}
+
+template <typename KeyType, typename ValueType>
+void BSTree<KeyType, ValueType>::Clear()
+{
+	// Post-order, so every node is freed after its children.
+	BSTNode<KeyType, ValueType>* node = root == nullptr ? nullptr : PostOrderFirst(root);
+	while (node != nullptr) {
+		BSTNode<KeyType, ValueType>* next = PostOrderNext(node);
+		ReleaseNode(node);
+		node = next;
+	}
+	root = nullptr;
+	nodeBlocks.clear();
 }
 
 
 template <typename KeyType, typename ValueType>
 void BSTree<KeyType, ValueType>::InsertNode(KeyType key, ValueType value)
 {
-	BSTNode<KeyType, ValueType>* newNode = new BSTNode<KeyType, ValueType>();
-	newNode->key = key;
-	newNode->value = value;
-	newNode->leftChild = nullptr;
-	newNode->rightChild = nullptr;
+	BSTNode<KeyType, ValueType>* parent = nullptr;
+	BSTNode<KeyType, ValueType>** link = &root;
+	while (*link != nullptr) {
+		parent = *link;
+		if (key < parent->key) {
+			// left insertion
+			link = &parent->leftChild;
+		}
+		else if (parent->key < key) {
+			// Right insertion
+			link = &parent->rightChild;
+		}
+		else {
+			parent->value = value;
+			return;
+		}
+	}
+	*link = new BSTNode<KeyType, ValueType>(key, value);
+	(*link)->parent = parent;
+}
 
-	if (root == nullptr) {
-		root = newNode;
-		return;
+template <typename KeyType, typename ValueType>
+template <std::ranges::input_range R>
+void BSTree<KeyType, ValueType>::BuildFromSorted(R&& sorted)
+{
+	if constexpr (!std::ranges::sized_range<R>) {
+		// Count first, so the node array is allocated exactly once.
+		std::vector<std::pair<KeyType, ValueType>> buffered;
+		for (auto&& [key, value] : sorted) {
+			buffered.emplace_back(key, value);
+		}
+		BuildFromSorted(buffered);
 	}
 	else {
-		InsertNode(newNode, key, value);
+		std::size_t capacity = static_cast<std::size_t>(std::ranges::size(sorted));
+		auto block = std::make_unique<BSTNode<KeyType, ValueType>[]>(capacity);
+		std::size_t count = 0;
+		for (auto&& [key, value] : sorted) {
+			if (count > 0 && key < block[count - 1].key) {
+				throw std::invalid_argument("BSTree::BuildFromSorted: input is not sorted by key");
+			}
+			if (count > 0 && !(block[count - 1].key < key)) {
+				block[count - 1].value = value;
+				continue;
+			}
+			block[count].key = key;
+			block[count].value = value;
+			count++;
+		}
+		Clear();
+		AdoptBlock(std::move(block), count);
 	}
 }
 
 template <typename KeyType, typename ValueType>
-BSTNode<KeyType, ValueType>* BSTree<KeyType, ValueType>::InsertNode(BSTNode<KeyType, ValueType>* parent, BSTNode<KeyType, ValueType>* node, KeyType key, ValueType value)
+void BSTree<KeyType, ValueType>::Balance()
 {
-	if (node == nullptr) {
-		auto newNode = new BSTNode(key, value);
-		newNode->parent = parent;
-		return newNode;
+	std::size_t count = static_cast<std::size_t>(std::ranges::distance(*this));
+	if (count == 0) {
+		return;
 	}
-	if (node->key > key) {
-		// Right insertion
-		node->rightChild = InsertNode(node, node->rightChild, key, value);
+	auto block = std::make_unique<BSTNode<KeyType, ValueType>[]>(count);
+	std::size_t i = 0;
+	for (auto& node : *this) {
+		block[i].key = std::move(node.key);
+		block[i].value = std::move(node.value);
+		i++;
 	}
-	else {
-		// left insertion
-		node->leftChild = InsertNode(node, node->leftChild, key, value);
+	Clear();
+	AdoptBlock(std::move(block), count);
+}
+
+template <typename KeyType, typename ValueType>
+int BSTree<KeyType, ValueType>::Height()
+{
+	int height = 0;
+	int depth = 1;
+	auto node = root;
+	while (node != nullptr) {
+		height = std::max(height, depth);
+		if (node->leftChild != nullptr) {
+			node = node->leftChild;
+			depth++;
+		}
+		else if (node->rightChild != nullptr) {
+			node = node->rightChild;
+			depth++;
+		}
+		else {
+			// Back up to the nearest unvisited right subtree.
+			while (node->parent != nullptr && (node == node->parent->rightChild || node->parent->rightChild == nullptr)) {
+				node = node->parent;
+				depth--;
+			}
+			node = node->parent == nullptr ? nullptr : node->parent->rightChild;
+		}
 	}
+	return height;
+}
+
+template <typename KeyType, typename ValueType>
+bool BSTree<KeyType, ValueType>::OwnsNode(const BSTNode<KeyType, ValueType>* node) const
+{
+	for (auto& [block, count] : nodeBlocks) {
+		if (!std::less<>{}(node, block.get()) && std::less<>{}(node, block.get() + count)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+template <typename KeyType, typename ValueType>
+void BSTree<KeyType, ValueType>::ReleaseNode(BSTNode<KeyType, ValueType>* node)
+{
+	if (!OwnsNode(node)) {
+		delete node;
+	}
+}
+
+template <typename KeyType, typename ValueType>
+void BSTree<KeyType, ValueType>::AdoptBlock(std::unique_ptr<BSTNode<KeyType, ValueType>[]> block, std::size_t count)
+{
+	root = LinkBalanced(block.get(), 0, count, nullptr);
+	nodeBlocks.emplace_back(std::move(block), count);
+}
+
+// Links nodes[lo, hi) (already in key order) into a perfectly balanced subtree.
+template <typename KeyType, typename ValueType>
+BSTNode<KeyType, ValueType>* BSTree<KeyType, ValueType>::LinkBalanced(BSTNode<KeyType, ValueType>* nodes, std::size_t lo, std::size_t hi, BSTNode<KeyType, ValueType>* parent)
+{
+	if (lo == hi) {
+		return nullptr;
+	}
+	std::size_t mid = lo + (hi - lo) / 2;
+	BSTNode<KeyType, ValueType>* node = &nodes[mid];
+	node->parent = parent;
+	node->leftChild = LinkBalanced(nodes, lo, mid, node);
+	node->rightChild = LinkBalanced(nodes, mid + 1, hi, node);
+	return node;
 }
 
 template <typename KeyType, typename ValueType>
@@ -240,35 +571,37 @@ void BSTree<KeyType, ValueType>::RemoveNode(KeyType key)
 		return;
 	}
 	else {
-		RemoveNode(root, key);
+		root = RemoveNode(root, key);
 	}
 }
 
 template <typename KeyType, typename ValueType>
-BSTNode<KeyType, ValueType>* BSTree<KeyType, ValueType>::RemoveNode(BSTNode<KeyType, ValueType>* node, KeyType key, ValueType value)
+BSTNode<KeyType, ValueType>* BSTree<KeyType, ValueType>::RemoveNode(BSTNode<KeyType, ValueType>* node, KeyType key)
 {
+	if (node == nullptr) {
+		return nullptr;
+	}
 	if (node->key < key) {
 		node->rightChild = RemoveNode(node->rightChild, key);
 	}
-	else if (node->key > key) {
+	else if (key < node->key) {
 		node->leftChild = RemoveNode(node->leftChild, key);
 	}
 	else {
 		// Remove node
-		if (node->leftChild == nullptr) {
-			BSTNode<KeyType, ValueType>* temp = node->rightChild;
-			delete node;
-			return temp;
-		}
-		if (node->rightChild == nullptr) {
-			BSTNode<KeyType, ValueType>* temp = node->leftChild;
-			delete node;
+		if (node->leftChild == nullptr || node->rightChild == nullptr) {
+			BSTNode<KeyType, ValueType>* temp = node->leftChild == nullptr ? node->rightChild : node->leftChild;
+			if (temp != nullptr) {
+				temp->parent = node->parent;
+			}
+			ReleaseNode(node);
 			return temp;
 		}
 
-		BSTNode<KeyType, ValueType>* successor = GetSuccessor(root);
+		BSTNode<KeyType, ValueType>* successor = GetSuccessor(node);
 		node->key = successor->key;
-		node->right = RemoveNode(node->right, successor->key);
+		node->value = successor->value;
+		node->rightChild = RemoveNode(node->rightChild, successor->key);
 	}
 	return node;
 }
@@ -277,73 +610,176 @@ BSTNode<KeyType, ValueType>* BSTree<KeyType, ValueType>::RemoveNode(BSTNode<KeyT
 template <typename KeyType, typename ValueType>
 BSTNode<KeyType, ValueType>* BSTree<KeyType, ValueType>::Search(KeyType key)
 {
-	if (root == nullptr) {
-		return;
-	}
-	else {
-		return Search(root, key);
-	}
+	return Search(root, key);
 }
 
 
 template <typename KeyType, typename ValueType>
 BSTNode<KeyType, ValueType>* BSTree<KeyType, ValueType>::Search(BSTNode<KeyType, ValueType>* node, KeyType key)
 {
-	if (node->key < key) {
-		Search(node->rightChild, key);
-	}
-	else if (node->key > key) {
-		Search(node->leftChild, key);
-	}
-	else {
-		return node;
+	while (node != nullptr) {
+		if (node->key < key) {
+			node = node->rightChild;
+		}
+		else if (key < node->key) {
+			node = node->leftChild;
+		}
+		else {
+			return node;
+		}
 	}
+	return nullptr;
 }
 
 template <typename KeyType, typename ValueType>
-void BSTree<KeyType, ValueType>::Traverse(TraversalKind traversalMethod, std::function<void(BSTNode<KeyType, ValueType>*)> traversalCallbackFn) {
-	if (traversalCallbackFn == NULL) {
-		traversalCallbackFn = defaultTraversalCallbackFn;
-	}
-	Traverse(root, traversalMethod, traversalCallbackFn);
+void BSTree<KeyType, ValueType>::Traverse(TraversalKind traversalMethod) {
+	Traverse(traversalMethod, defaultTraversalCallbackFn<KeyType, ValueType>);
 }
 
 template <typename KeyType, typename ValueType>
-void BSTree<KeyType, ValueType>::Traverse(BSTNode<KeyType, ValueType>* node, TraversalKind traversalMethod, std::function<void(BSTNode<KeyType, ValueType>*)> traversalCallbackFn) {
+template <typename Visitor>
+void BSTree<KeyType, ValueType>::Traverse(TraversalKind traversalMethod, Visitor&& visitor) {
+	if (root == nullptr) {
+		return;
+	}
 	if (traversalMethod == PreOrder) {
-		traversalCallbackFn(node);
-		Traverse(node->leftChild, traversalMethod, traversalCallbackFn);
-		Traverse(node->rightChild, traversalMethod, traversalCallbackFn);
+		for (auto node = root; node != nullptr; node = PreOrderNext(node)) {
+			visitor(node);
+		}
 	}
 	else if (traversalMethod == PostOrder) {
-		Traverse(node->leftChild, traversalMethod, traversalCallbackFn);
-		Traverse(node->rightChild, traversalMethod, traversalCallbackFn);
-		traversalCallbackFn(node);
+		for (auto node = PostOrderFirst(root); node != nullptr; node = PostOrderNext(node)) {
+			visitor(node);
+		}
 	}
 	else if (traversalMethod == InOrder) {
-		Traverse(node->leftChild, traversalMethod, traversalCallbackFn);
-		traversalCallbackFn(node);
-		Traverse(node->rightChild, traversalMethod, traversalCallbackFn);
+		for (auto node = root->Minimum(); node != nullptr; node = node->Successor()) {
+			visitor(node);
+		}
 	}
 	else if (traversalMethod == LevelOrder) {
-		auto nodes = new std::queue<BSTNode<KeyType, ValueType>*>();
-		auto queue = new std::queue<BSTNode<KeyType, ValueType>*>();
-		queue.enqueue(root);
-		while (!queue.isEmpty()) {
-			auto x = queue.dequeue();
-			if (x == nullptr)
-				continue;
+		// One left-to-right sweep per depth instead of a queue: O(n) extra
+		// steps per level in the worst case, but no allocation at all.
+		for (int depth = 0;; depth++) {
+			auto node = DepthFirst(root, depth);
+			if (node == nullptr) {
+				break;
+			}
+			for (; node != nullptr; node = DepthNext(node, depth)) {
+				visitor(node);
+			}
+		}
+	}
+}
+
+template <typename KeyType, typename ValueType>
+template <typename Visitor>
+void BSTree<KeyType, ValueType>::TraverseRange(KeyType lo, KeyType hi, Visitor&& visitor) {
+	for (auto&& node : Range(lo, hi)) {
+		visitor(&node);
+	}
+}
 
-			nodes.enqueue(x);
-			queue.enqueue(x.leftChild);
-			queue.enqueue(x.rightChild);
+template <typename KeyType, typename ValueType>
+BSTNode<KeyType, ValueType>* BSTree<KeyType, ValueType>::PreOrderNext(BSTNode<KeyType, ValueType>* node) {
+	if (node->leftChild != nullptr) {
+		return node->leftChild;
+	}
+	if (node->rightChild != nullptr) {
+		return node->rightChild;
+	}
+	// Climb until we leave a left subtree whose parent has a right subtree.
+	while (node->parent != nullptr) {
+		auto parent = node->parent;
+		if (node == parent->leftChild && parent->rightChild != nullptr) {
+			return parent->rightChild;
 		}
-		for (auto n : nodes) {
-			traversalCallbackFn(n);
+		node = parent;
+	}
+	return nullptr;
+}
+
+template <typename KeyType, typename ValueType>
+BSTNode<KeyType, ValueType>* BSTree<KeyType, ValueType>::PostOrderFirst(BSTNode<KeyType, ValueType>* node) {
+	while (true) {
+		if (node->leftChild != nullptr) {
+			node = node->leftChild;
+		}
+		else if (node->rightChild != nullptr) {
+			node = node->rightChild;
+		}
+		else {
+			return node;
 		}
 	}
 }
 
+template <typename KeyType, typename ValueType>
+BSTNode<KeyType, ValueType>* BSTree<KeyType, ValueType>::PostOrderNext(BSTNode<KeyType, ValueType>* node) {
+	auto parent = node->parent;
+	if (parent == nullptr) {
+		return nullptr;
+	}
+	if (node == parent->leftChild && parent->rightChild != nullptr) {
+		return PostOrderFirst(parent->rightChild);
+	}
+	return parent;
+}
+
+// Leftmost node exactly `depth` levels below `top`, searching only inside the
+// subtree rooted at `top`, or nullptr.
+template <typename KeyType, typename ValueType>
+BSTNode<KeyType, ValueType>* BSTree<KeyType, ValueType>::DepthFirst(BSTNode<KeyType, ValueType>* top, int depth) {
+	auto node = top;
+	int level = 0;
+	while (true) {
+		if (level == depth) {
+			return node;
+		}
+		if (node->leftChild != nullptr) {
+			node = node->leftChild;
+			level++;
+			continue;
+		}
+		if (node->rightChild != nullptr) {
+			node = node->rightChild;
+			level++;
+			continue;
+		}
+		// Dead end above the target depth: back up to the nearest unvisited right subtree.
+		while (true) {
+			if (node == top) {
+				return nullptr;
+			}
+			auto parent = node->parent;
+			if (node == parent->leftChild && parent->rightChild != nullptr) {
+				node = parent->rightChild;
+				break;
+			}
+			node = parent;
+			level--;
+		}
+	}
+}
+
+// Next node to the right of `node` on the same level (`depth` below the root), or nullptr.
+template <typename KeyType, typename ValueType>
+BSTNode<KeyType, ValueType>* BSTree<KeyType, ValueType>::DepthNext(BSTNode<KeyType, ValueType>* node, int depth) {
+	int level = depth;
+	while (node->parent != nullptr) {
+		auto parent = node->parent;
+		level--;
+		if (node == parent->leftChild && parent->rightChild != nullptr) {
+			auto found = DepthFirst(parent->rightChild, depth - level - 1);
+			if (found != nullptr) {
+				return found;
+			}
+		}
+		node = parent;
+	}
+	return nullptr;
+}
+
 template <typename KeyType, typename ValueType>
 BSTNode<KeyType, ValueType>* BSTree<KeyType, ValueType>::Rotate(BSTNode<KeyType, ValueType>* node, RotationDirection direction) {
 	if (direction == Left) {
@@ -353,19 +789,40 @@ BSTNode<KeyType, ValueType>* BSTree<KeyType, ValueType>::Rotate(BSTNode<KeyType,
 		return RotateRight(node);
 	}
 	else {
-		// TODO: Error, throw exception?
+		throw std::invalid_argument("BSTree::Rotate: unknown rotation direction");
 	}
 }
 
 
+template <typename KeyType, typename ValueType>
+void BSTree<KeyType, ValueType>::ReplaceChild(BSTNode<KeyType, ValueType>* parent, BSTNode<KeyType, ValueType>* oldChild, BSTNode<KeyType, ValueType>* newChild) {
+	if (parent == nullptr) {
+		root = newChild;
+	}
+	else if (parent->leftChild == oldChild) {
+		parent->leftChild = newChild;
+	}
+	else {
+		parent->rightChild = newChild;
+	}
+	if (newChild != nullptr) {
+		newChild->parent = parent;
+	}
+}
+
 template <typename KeyType, typename ValueType>
 BSTNode<KeyType, ValueType>* BSTree<KeyType, ValueType>::RotateLeft(BSTNode<KeyType, ValueType>* node) {
 	auto y = node->rightChild;
 	auto T2 = y->leftChild;
 
 	// Perform rotation
-	y->left = node;
-	node->right = T2;
+	ReplaceChild(node->parent, node, y);
+	y->leftChild = node;
+	node->parent = y;
+	node->rightChild = T2;
+	if (T2 != nullptr) {
+		T2->parent = node;
+	}
 
 	return y;
 }
@@ -375,8 +832,13 @@ BSTNode<KeyType, ValueType>* BSTree<KeyType, ValueType>::RotateRight(BSTNode<Key
 	auto T2 = x->rightChild;
 
 	// Perform rotation
+	ReplaceChild(node->parent, node, x);
 	x->rightChild = node;
+	node->parent = x;
 	node->leftChild = T2;
+	if (T2 != nullptr) {
+		T2->parent = node;
+	}
 
 	return x;
 }
@@ -397,10 +859,60 @@ BSTNode<KeyType, ValueType>* BSTree<KeyType, ValueType>::GetSuccessor(BSTNode<Ke
 	return node;
 }
 
-// TODO: -- Traversal methods...
-auto inorderTraversal = []() {};
+template <typename KeyType, typename ValueType>
+BSTForwardIterator<KeyType, ValueType> BSTree<KeyType, ValueType>::begin() const {
+	return iterator(root == nullptr ? nullptr : root->Minimum(), root);
+}
 
-auto preorderTraversal = []() {};
+template <typename KeyType, typename ValueType>
+BSTForwardIterator<KeyType, ValueType> BSTree<KeyType, ValueType>::end() const {
+	return iterator(nullptr, root);
+}
 
-auto postorderTraversal = []() {};
+template <typename KeyType, typename ValueType>
+BSTReverseIterator<KeyType, ValueType> BSTree<KeyType, ValueType>::rbegin() const {
+	return reverse_iterator(root);
+}
 
+template <typename KeyType, typename ValueType>
+BSTReverseIterator<KeyType, ValueType> BSTree<KeyType, ValueType>::rend() const {
+	return reverse_iterator(nullptr, root);
+}
+
+template <typename KeyType, typename ValueType>
+BSTForwardIterator<KeyType, ValueType> BSTree<KeyType, ValueType>::LowerBound(KeyType key) const {
+	BSTNode<KeyType, ValueType>* best = nullptr;
+	for (auto node = root; node != nullptr;) {
+		if (node->key < key) {
+			node = node->rightChild;
+		}
+		else {
+			best = node;
+			node = node->leftChild;
+		}
+	}
+	return iterator(best, root);
+}
+
+template <typename KeyType, typename ValueType>
+BSTForwardIterator<KeyType, ValueType> BSTree<KeyType, ValueType>::UpperBound(KeyType key) const {
+	BSTNode<KeyType, ValueType>* best = nullptr;
+	for (auto node = root; node != nullptr;) {
+		if (key < node->key) {
+			best = node;
+			node = node->leftChild;
+		}
+		else {
+			node = node->rightChild;
+		}
+	}
+	return iterator(best, root);
+}
+
+template <typename KeyType, typename ValueType>
+std::ranges::subrange<BSTForwardIterator<KeyType, ValueType>> BSTree<KeyType, ValueType>::Range(KeyType lo, KeyType hi) const {
+	if (hi < lo) {
+		return { end(), end() };
+	}
+	return { LowerBound(lo), UpperBound(hi) };
+}
@@ -5,115 +5,201 @@ import std;
 /// <summary>
 /// Red-Black Tree:
 ///    - Extra Color information for rebalancing on insert.
-/// 
+///
 ///    - Requirements:
 ///       - Every node is either red or black.
-///       
+///
 ///       - All NIL nodes(figure 1) are considered black.
-/// 
+///
 ///       - A red node does not have a red child.
-/// 
-///       - Every path from a given node to any of its descendant 
+///
+///       - Every path from a given node to any of its descendant
 ///			NIL nodes goes through the same number of black nodes.
-/// 
-///       - (Conclusion)If a node N has exactly one child, the child 
-///			must be red, because if it were black, its NIL descendants 
-///			would sit at a different black depth than N's NIL child, 
+///
+///       - (Conclusion)If a node N has exactly one child, the child
+///			must be red, because if it were black, its NIL descendants
+///			would sit at a different black depth than N's NIL child,
 ///			violating requirement 4.
-/// 
+///
 ///    - Operations:
-///       -  
-/// 
-///    - Balancing Rule:
-///    - Non-branching Node:
-///    - Path:
-///    - Simple Path:
-///    - Descendant:
-///    - Adjacent: 
-/// 
+///       - Left-leaning red-black (2-3) tree: put/get/delete, plus the
+///         ordered symbol table operations (minimum, maximum, floor,
+///         ceiling, rank, select, range size and range keys).
+///
+///    - Layout:
+///       - Nodes are handed out by an RBNodePool slab allocator and refer
+///         to each other by 32-bit index (RBNil for a NIL link) instead
+///         of by pointer, which halves the link overhead and keeps nodes
+///         packed into contiguous slabs.
+///       - Every node records the size of its subtree, so rank, select
+///         and size(lo, hi) run in O(log n).
+///
 ///    - Red-Black Balancing Rules:
-/// 
+///       - Red links lean left.
+///       - No node has two red links connected to it.
+///       - Every path from the root to a NIL link has the same number
+///         of black links.
+///
 /// </summary>
-enum class RBColor {
+enum class RBColor : std::uint8_t {
 	Red,
 	Black
 };
 
-template <typename DataType>
+using RBIndex = std::uint32_t;
+
+inline constexpr RBIndex RBNil = std::numeric_limits<RBIndex>::max();
+
+template <typename Key, typename DataType>
 class RBNode
 {
 public:
-	RBNode& parent;
-	RBNode& left;
-	RBNode& right;
+	Key key;
+	DataType data;
+	RBIndex left;
+	RBIndex right;
+	std::uint32_t size;
 	RBColor color;
-	DataType& data;
+};
+
+/// <summary>
+/// Slab allocator for tree nodes addressed by 32-bit index.
+///    - Nodes live in fixed-size slabs that are never moved, so an index
+///      (and a reference obtained from it) stays valid while the pool grows.
+///    - Released nodes are recycled through a free list threaded through
+///      the node's `left` link.
+/// </summary>
+template <typename Node>
+class RBNodePool
+{
+public:
+	static constexpr std::uint32_t SlabShift = 12;
+	static constexpr std::uint32_t SlabSize = 1u << SlabShift;
+	static constexpr std::uint32_t SlabMask = SlabSize - 1;
+
+	Node& operator[](RBIndex index) {
+		return slabs[index >> SlabShift][index & SlabMask];
+	}
+
+	const Node& operator[](RBIndex index) const {
+		return slabs[index >> SlabShift][index & SlabMask];
+	}
+
+	RBIndex allocate() {
+		if (freeList != RBNil) {
+			RBIndex index = freeList;
+			freeList = (*this)[index].left;
+			return index;
+		}
+		if (next == RBNil) {
+			throw std::length_error("RBNodePool: exhausted the 32-bit node index space");
+		}
+		if ((next >> SlabShift) == slabs.size()) {
+			slabs.push_back(std::make_unique<Node[]>(SlabSize));
+		}
+		return next++;
+	}
+
+	void release(RBIndex index) {
+		(*this)[index].left = freeList;
+		freeList = index;
+	}
+
+	void reserve(std::size_t count) {
+		std::size_t slabCount = (count + SlabMask) >> SlabShift;
+		slabs.reserve(slabCount);
+		while (slabs.size() < slabCount) {
+			slabs.push_back(std::make_unique<Node[]>(SlabSize));
+		}
+	}
+
+	void clear() {
+		slabs.clear();
+		next = 0;
+		freeList = RBNil;
+	}
+
+private:
+	std::vector<std::unique_ptr<Node[]>> slabs;
+	RBIndex next = 0;
+	RBIndex freeList = RBNil;
 };
 
 template <typename Key, typename DataType>
 class RBTree {
 
 private:
-	RBNode<DataType>& root;
-
-	RBNode<DataType>& put(RBNode<DataType>& node, Key key, DataType value);
-	DataType& get(RBNode<DataType>& node, Key key);
-	RBNode<DataType>& deleteMin(RBNode<DataType>& node);
-	RBNode<DataType>& deleteMax(RBNode<DataType>& node);
-	RBNode<DataType>& deleteNode(RBNode<DataType>& node, Key key);
-	int height(RBNode<DataType>& node);
-	
-	RBNode<DataType>& minimum(RBNode<DataType>& node);
-	RBNode<DataType>& maximum(RBNode<DataType>& node);
-	RBNode<DataType>& ceiling(RBNode<DataType>& node, Key key);
-	RBNode<DataType>& floor(RBNode<DataType>& node, Key key);
-	Key select(RBNode<DataType>& node, int rank);
-	int rank(Key key, RBNode<DataType>& node);
-
-
-	RBNode<DataType>& rotateRight(RBNode<DataType>& node);
-	RBNode<DataType>& rotateLeft(RBNode<DataType>& node);
-	void flipColors();
-	RBNode<DataType>& moveRedLeft(RBNode<DataType>& node);
-	RBNode<DataType>& moveRedRight(RBNode<DataType>& node);
-	RBNode<DataType>& balance(RBNode<DataType>& node);
+	using Node = RBNode<Key, DataType>;
+
+	RBNodePool<Node> pool;
+	RBIndex root;
+
+	RBIndex newNode(Key key, DataType value);
+	std::uint32_t size(RBIndex node) const;
+
+	RBIndex put(RBIndex node, const Key& key, DataType& value);
+	RBIndex get(RBIndex node, Key key) const;
+	RBIndex deleteMin(RBIndex node);
+	RBIndex deleteMax(RBIndex node);
+	RBIndex deleteNode(RBIndex node, Key key);
+	int height(RBIndex node) const;
+
+	RBIndex minimum(RBIndex node) const;
+	RBIndex maximum(RBIndex node) const;
+	RBIndex ceiling(RBIndex node, Key key) const;
+	RBIndex floor(RBIndex node, Key key) const;
+	RBIndex select(RBIndex node, std::size_t rank) const;
+	std::size_t rank(Key key, RBIndex node) const;
+
+
+	RBIndex rotateRight(RBIndex node);
+	RBIndex rotateLeft(RBIndex node);
+	void flipColors(RBIndex node);
+	RBIndex moveRedLeft(RBIndex node);
+	RBIndex moveRedRight(RBIndex node);
+	RBIndex balance(RBIndex node);
 
 	/***************************************************************************
 	*  Check integrity of red-black tree data structure.
 	***************************************************************************/
-	bool checkIntegrity();
-	bool isEmpty();
-
-	bool isBST();
-	bool isBST(RBNode<DataType>& node, Key min, Key max);
-	bool isSizeConsistent();
-	bool isSizeConsistent(RBNode<DataType>& node);
-	bool isRankConsistent();
-	bool isBalanced();
-	bool isBalanced(RBNode<DataType>& node, int black);
+	bool isBST() const;
+	bool isBST(RBIndex node, const Key* min, const Key* max) const;
+	bool isSizeConsistent() const;
+	bool isSizeConsistent(RBIndex node) const;
+	bool isRankConsistent() const;
+	bool isBalanced() const;
+	bool isBalanced(RBIndex node, int black) const;
 
-	bool is23();
-	bool is23(RBNode<DataType>& node);
+	bool is23() const;
+	bool is23(RBIndex node) const;
 
-	std::vector<Key> keys(RBNode<DataType>& node, std::queue<Key> queue, Key lo, Key hi);
+	template <typename Visitor>
+	void keys(RBIndex node, Visitor& visitor, const Key& lo, const Key& hi) const;
 
 public:
 	RBTree();
 	~RBTree();
-	
+	RBTree(RBTree&&) noexcept = default;
+	RBTree& operator=(RBTree&&) noexcept = default;
+
 	/***************************************************************************
 	*  Node helper methods.
 	***************************************************************************/
-	bool isRed(RBNode<DataType>& node);
+	bool isRed(RBIndex node) const;
+	bool isEmpty() const;
+	bool checkIntegrity() const;
+
+	/// Pre-allocates slabs for `count` nodes so a bulk load does not grow the pool.
+	void reserve(std::size_t count);
 
 	/***************************************************************************
 	*  Red-black tree insertion.
 	***************************************************************************/
 	void put(Key key, DataType value);
-	DataType get(Key key);
-	bool contains(Key key);
-	void search(DataType data);
-	void traverse();
+	DataType get(Key key) const;
+	const DataType* find(Key key) const;
+	bool contains(Key key) const;
+	void traverse() const;
 
 	/***************************************************************************
 	*  Red-black tree deletion.
@@ -121,228 +207,537 @@ public:
 	void deleteMin();
 	void deleteMax();
 	void deleteNode(Key key);
+	void clear();
 
 	/***************************************************************************
 	*  Utility functions.
 	***************************************************************************/
-	int height();
+	int height() const;
 
 	/***************************************************************************
 	*  Ordered symbol table methods.
 	***************************************************************************/
-	RBNode<DataType>& minimum();
-	RBNode<DataType>& maximum();
-	Key ceiling(Key key);
-	Key floor(Key key);
-	Key select(int rank);
-	int rank(Key key);
+	Key minimum() const;
+	Key maximum() const;
+	Key ceiling(Key key) const;
+	Key floor(Key key) const;
+	Key select(std::size_t rank) const;
+	std::size_t rank(Key key) const;
 
-	int size();
-	int size(Key lo, Key hi);
+	std::size_t size() const;
+	std::size_t size(Key lo, Key hi) const;
 
 	/***************************************************************************
 	*  Range count and range search.
 	***************************************************************************/
-	std::vector<Key> keys();
-	std::vector<Key> keys(Key lo, Key hi);
+	std::vector<Key> keys() const;
+	std::vector<Key> keys(Key lo, Key hi) const;
+
+	/// Calls visitor(key, data) for every key in [lo, hi], in ascending order,
+	/// without materializing the keys.
+	template <typename Visitor>
+	void scan(Key lo, Key hi, Visitor&& visitor) const;
 };
 
 
 template <typename Key, typename DataType>
-RBNode<DataType>& RBTree<Key, DataType>::put(RBNode<DataType>& node, Key key, DataType value)
+RBIndex RBTree<Key, DataType>::newNode(Key key, DataType value)
 {
-	return nullptr;
+	RBIndex index = pool.allocate();
+	Node& node = pool[index];
+	node.key = std::move(key);
+	node.data = std::move(value);
+	node.left = RBNil;
+	node.right = RBNil;
+	node.size = 1;
+	node.color = RBColor::Red;
+	return index;
 }
 
-
 template <typename Key, typename DataType>
-DataType& RBTree<Key, DataType>::get(RBNode<DataType>& node, Key key)
+std::uint32_t RBTree<Key, DataType>::size(RBIndex node) const
 {
-	return nullptr;
+	return node == RBNil ? 0 : pool[node].size;
 }
 
 template <typename Key, typename DataType>
-RBNode<DataType>& RBTree<Key, DataType>::deleteMin(RBNode<DataType>& node)
+RBIndex RBTree<Key, DataType>::put(RBIndex node, const Key& key, DataType& value)
 {
-	return nullptr;
-}
+	if (node == RBNil) {
+		return newNode(key, std::move(value));
+	}
 
-template <typename Key, typename DataType>
-RBNode<DataType>& RBTree<Key, DataType>::deleteMax(RBNode<DataType>& node)
-{
-	return nullptr;
+	Node* h = &pool[node];
+	if (key < h->key) {
+		h->left = put(h->left, key, value);
+	}
+	else if (h->key < key) {
+		h->right = put(h->right, key, value);
+	}
+	else {
+		h->data = std::move(value);
+		return node;
+	}
+
+	// fix-up any right-leaning links
+	if (isRed(h->right) && !isRed(h->left)) {
+		node = rotateLeft(node);
+		h = &pool[node];
+	}
+	if (isRed(h->left) && isRed(pool[h->left].left)) {
+		node = rotateRight(node);
+		h = &pool[node];
+	}
+	if (isRed(h->left) && isRed(h->right)) {
+		flipColors(node);
+	}
+	h->size = size(h->left) + size(h->right) + 1;
+	return node;
 }
 
+
 template <typename Key, typename DataType>
-RBNode<DataType>& RBTree<Key, DataType>::deleteNode(RBNode<DataType>& node, Key key)
+RBIndex RBTree<Key, DataType>::get(RBIndex node, Key key) const
 {
-	return nullptr;
+	while (node != RBNil) {
+		const Node& h = pool[node];
+		if (key < h.key) {
+			node = h.left;
+		}
+		else if (h.key < key) {
+			node = h.right;
+		}
+		else {
+			return node;
+		}
+	}
+	return RBNil;
 }
 
 template <typename Key, typename DataType>
-int RBTree<Key, DataType>::height(RBNode<DataType>& node)
+RBIndex RBTree<Key, DataType>::deleteMin(RBIndex node)
 {
-	return 0;
+	if (pool[node].left == RBNil) {
+		pool.release(node);
+		return RBNil;
+	}
+
+	if (!isRed(pool[node].left) && !isRed(pool[pool[node].left].left)) {
+		node = moveRedLeft(node);
+	}
+
+	pool[node].left = deleteMin(pool[node].left);
+	return balance(node);
 }
 
 template <typename Key, typename DataType>
-RBNode<DataType>& RBTree<Key, DataType>::minimum(RBNode<DataType>& node)
+RBIndex RBTree<Key, DataType>::deleteMax(RBIndex node)
 {
-	return nullptr;
+	if (isRed(pool[node].left)) {
+		node = rotateRight(node);
+	}
+
+	if (pool[node].right == RBNil) {
+		pool.release(node);
+		return RBNil;
+	}
+
+	if (!isRed(pool[node].right) && !isRed(pool[pool[node].right].left)) {
+		node = moveRedRight(node);
+	}
+
+	pool[node].right = deleteMax(pool[node].right);
+	return balance(node);
 }
 
 template <typename Key, typename DataType>
-RBNode<DataType>& RBTree<Key, DataType>::maximum(RBNode<DataType>& node)
+RBIndex RBTree<Key, DataType>::deleteNode(RBIndex node, Key key)
 {
-	return nullptr;
+	if (key < pool[node].key) {
+		if (!isRed(pool[node].left) && !isRed(pool[pool[node].left].left)) {
+			node = moveRedLeft(node);
+		}
+		pool[node].left = deleteNode(pool[node].left, key);
+	}
+	else {
+		if (isRed(pool[node].left)) {
+			node = rotateRight(node);
+		}
+		if (!(key < pool[node].key) && !(pool[node].key < key) && pool[node].right == RBNil) {
+			pool.release(node);
+			return RBNil;
+		}
+		if (!isRed(pool[node].right) && !isRed(pool[pool[node].right].left)) {
+			node = moveRedRight(node);
+		}
+		if (!(key < pool[node].key) && !(pool[node].key < key)) {
+			const Node& successor = pool[minimum(pool[node].right)];
+			pool[node].key = successor.key;
+			pool[node].data = successor.data;
+			pool[node].right = deleteMin(pool[node].right);
+		}
+		else {
+			pool[node].right = deleteNode(pool[node].right, key);
+		}
+	}
+	return balance(node);
 }
 
 template <typename Key, typename DataType>
-RBNode<DataType>& RBTree<Key, DataType>::ceiling(RBNode<DataType>& node, Key key)
+int RBTree<Key, DataType>::height(RBIndex node) const
 {
-	return nullptr;
+	if (node == RBNil) {
+		return -1;
+	}
+	return 1 + std::max(height(pool[node].left), height(pool[node].right));
 }
 
 template <typename Key, typename DataType>
-RBNode<DataType>& RBTree<Key, DataType>::floor(RBNode<DataType>& node, Key key)
+RBIndex RBTree<Key, DataType>::minimum(RBIndex node) const
+{
+	while (pool[node].left != RBNil) {
+		node = pool[node].left;
+	}
+	return node;
+}
+
+template <typename Key, typename DataType>
+RBIndex RBTree<Key, DataType>::maximum(RBIndex node) const
 {
-	return nullptr;
+	while (pool[node].right != RBNil) {
+		node = pool[node].right;
+	}
+	return node;
 }
 
 template <typename Key, typename DataType>
-Key RBTree<Key, DataType>::select(RBNode<DataType>& node, int rank)
+RBIndex RBTree<Key, DataType>::ceiling(RBIndex node, Key key) const
 {
-	return nullptr;
+	RBIndex best = RBNil;
+	while (node != RBNil) {
+		const Node& h = pool[node];
+		if (h.key < key) {
+			node = h.right;
+		}
+		else if (key < h.key) {
+			best = node;
+			node = h.left;
+		}
+		else {
+			return node;
+		}
+	}
+	return best;
 }
 
 template <typename Key, typename DataType>
-int RBTree<Key, DataType>::rank(Key key, RBNode<DataType>& node)
+RBIndex RBTree<Key, DataType>::floor(RBIndex node, Key key) const
 {
-	return nullptr;
+	RBIndex best = RBNil;
+	while (node != RBNil) {
+		const Node& h = pool[node];
+		if (key < h.key) {
+			node = h.left;
+		}
+		else if (h.key < key) {
+			best = node;
+			node = h.right;
+		}
+		else {
+			return node;
+		}
+	}
+	return best;
 }
 
 template <typename Key, typename DataType>
-RBNode<DataType>& RBTree<Key, DataType>::rotateRight(RBNode<DataType>& node)
-{
-	return nullptr;
+RBIndex RBTree<Key, DataType>::select(RBIndex node, std::size_t rank) const
+{
+	while (node != RBNil) {
+		const Node& h = pool[node];
+		std::size_t leftSize = size(h.left);
+		if (rank < leftSize) {
+			node = h.left;
+		}
+		else if (rank > leftSize) {
+			rank -= leftSize + 1;
+			node = h.right;
+		}
+		else {
+			return node;
+		}
+	}
+	return RBNil;
 }
 
 template <typename Key, typename DataType>
-RBNode<DataType>& RBTree<Key, DataType>::rotateLeft(RBNode<DataType>& node)
+std::size_t RBTree<Key, DataType>::rank(Key key, RBIndex node) const
 {
-	return nullptr;
+	std::size_t rank = 0;
+	while (node != RBNil) {
+		const Node& h = pool[node];
+		if (key < h.key) {
+			node = h.left;
+		}
+		else if (h.key < key) {
+			rank += size(h.left) + 1;
+			node = h.right;
+		}
+		else {
+			return rank + size(h.left);
+		}
+	}
+	return rank;
 }
 
 template <typename Key, typename DataType>
-void RBTree<Key, DataType>::flipColors()
+RBIndex RBTree<Key, DataType>::rotateRight(RBIndex node)
 {
-	return nullptr;
+	Node& h = pool[node];
+	RBIndex x = h.left;
+	Node& xn = pool[x];
+	h.left = xn.right;
+	xn.right = node;
+	xn.color = h.color;
+	h.color = RBColor::Red;
+	xn.size = h.size;
+	h.size = size(h.left) + size(h.right) + 1;
+	return x;
 }
-
+
 template <typename Key, typename DataType>
-RBNode<DataType>& RBTree<Key, DataType>::moveRedLeft(RBNode<DataType>& node)
+RBIndex RBTree<Key, DataType>::rotateLeft(RBIndex node)
+{
+	Node& h = pool[node];
+	RBIndex x = h.right;
+	Node& xn = pool[x];
+	h.right = xn.left;
+	xn.left = node;
+	xn.color = h.color;
+	h.color = RBColor::Red;
+	xn.size = h.size;
+	h.size = size(h.left) + size(h.right) + 1;
+	return x;
+}
+
+template <typename Key, typename DataType>
+void RBTree<Key, DataType>::flipColors(RBIndex node)
 {
-	return nullptr;
+	auto flip = [](RBColor color) {
+		return color == RBColor::Red ? RBColor::Black : RBColor::Red;
+	};
+	Node& h = pool[node];
+	h.color = flip(h.color);
+	pool[h.left].color = flip(pool[h.left].color);
+	pool[h.right].color = flip(pool[h.right].color);
+}
+
+template <typename Key, typename DataType>
+RBIndex RBTree<Key, DataType>::moveRedLeft(RBIndex node)
+{
+	// Assuming that node is red and both node.left and node.left.left
+	// are black, make node.left or one of its children red.
+	flipColors(node);
+	if (isRed(pool[pool[node].right].left)) {
+		pool[node].right = rotateRight(pool[node].right);
+		node = rotateLeft(node);
+		flipColors(node);
+	}
+	return node;
 }
 
 template <typename Key, typename DataType>
-RBNode<DataType>& RBTree<Key, DataType>::moveRedRight(RBNode<DataType>& node)
+RBIndex RBTree<Key, DataType>::moveRedRight(RBIndex node)
 {
-	return nullptr;
+	// Assuming that node is red and both node.right and node.right.left
+	// are black, make node.right or one of its children red.
+	flipColors(node);
+	if (isRed(pool[pool[node].left].left)) {
+		node = rotateRight(node);
+		flipColors(node);
+	}
+	return node;
 }
 
 template <typename Key, typename DataType>
-RBNode<DataType>& RBTree<Key, DataType>::balance(RBNode<DataType>& node)
+RBIndex RBTree<Key, DataType>::balance(RBIndex node)
 {
-	return nullptr;
+	if (isRed(pool[node].right) && !isRed(pool[node].left)) {
+		node = rotateLeft(node);
+	}
+	if (isRed(pool[node].left) && isRed(pool[pool[node].left].left)) {
+		node = rotateRight(node);
+	}
+	if (isRed(pool[node].left) && isRed(pool[node].right)) {
+		flipColors(node);
+	}
+	Node& h = pool[node];
+	h.size = size(h.left) + size(h.right) + 1;
+	return node;
 }
 
 /***************************************************************************
 *  Check integrity of red-black tree data structure.
 ***************************************************************************/
 template <typename Key, typename DataType>
-bool RBTree<Key, DataType>::checkIntegrity()
+bool RBTree<Key, DataType>::checkIntegrity() const
 {
-	return false;
+	return isBST() && isSizeConsistent() && isRankConsistent() && is23() && isBalanced();
 }
 
 template <typename Key, typename DataType>
-bool RBTree<Key, DataType>::isEmpty()
+bool RBTree<Key, DataType>::isEmpty() const
 {
-	return false;
+	return root == RBNil;
 }
 
 template <typename Key, typename DataType>
-bool RBTree<Key, DataType>::isBST()
+bool RBTree<Key, DataType>::isBST() const
 {
-	return false;
+	return isBST(root, nullptr, nullptr);
 }
 
+// Is the tree rooted at node a BST with all keys strictly between min and max
+// (a null bound means no constraint)?
 template <typename Key, typename DataType>
-bool RBTree<Key, DataType>::isBST(RBNode<DataType>& node, Key min, Key max)
+bool RBTree<Key, DataType>::isBST(RBIndex node, const Key* min, const Key* max) const
 {
-	return false;
+	if (node == RBNil) {
+		return true;
+	}
+	const Node& h = pool[node];
+	if (min != nullptr && !(*min < h.key)) {
+		return false;
+	}
+	if (max != nullptr && !(h.key < *max)) {
+		return false;
+	}
+	return isBST(h.left, min, &h.key) && isBST(h.right, &h.key, max);
 }
 
 template <typename Key, typename DataType>
-bool RBTree<Key, DataType>::isSizeConsistent()
+bool RBTree<Key, DataType>::isSizeConsistent() const
 {
-	return false;
+	return isSizeConsistent(root);
 }
 
 template <typename Key, typename DataType>
-bool RBTree<Key, DataType>::isSizeConsistent(RBNode<DataType>& node)
+bool RBTree<Key, DataType>::isSizeConsistent(RBIndex node) const
 {
+	if (node == RBNil) {
+		return true;
+	}
+	const Node& h = pool[node];
+	if (h.size != size(h.left) + size(h.right) + 1) {
+		return false;
+	}
+	return isSizeConsistent(h.left) && isSizeConsistent(h.right);
 }
 
 template <typename Key, typename DataType>
-bool RBTree<Key, DataType>::isRankConsistent()
+bool RBTree<Key, DataType>::isRankConsistent() const
 {
+	for (std::size_t i = 0; i < size(); i++) {
+		if (i != rank(select(i))) {
+			return false;
+		}
+	}
+	for (const Key& key : keys()) {
+		if (!(key == select(rank(key)))) {
+			return false;
+		}
+	}
+	return true;
 }
 
 template <typename Key, typename DataType>
-bool RBTree<Key, DataType>::isBalanced()
+bool RBTree<Key, DataType>::isBalanced() const
 {
+	// number of black links on path from root to min
+	int black = 0;
+	for (RBIndex node = root; node != RBNil; node = pool[node].left) {
+		if (!isRed(node)) {
+			black++;
+		}
+	}
+	return isBalanced(root, black);
 }
 
+// Does every path from the root to a leaf have the given number of black links?
 template <typename Key, typename DataType>
-bool RBTree<Key, DataType>::isBalanced(RBNode<DataType>& node, int black)
+bool RBTree<Key, DataType>::isBalanced(RBIndex node, int black) const
 {
+	if (node == RBNil) {
+		return black == 0;
+	}
+	if (!isRed(node)) {
+		black--;
+	}
+	return isBalanced(pool[node].left, black) && isBalanced(pool[node].right, black);
 }
 
 template <typename Key, typename DataType>
-bool RBTree<Key, DataType>::is23()
+bool RBTree<Key, DataType>::is23() const
 {
+	return is23(root);
 }
 
+// Does the tree have no red right links, and at most one (left)
+// red links in a row on any path?
 template <typename Key, typename DataType>
-bool RBTree<Key, DataType>::is23(RBNode<DataType>& node)
+bool RBTree<Key, DataType>::is23(RBIndex node) const
 {
+	if (node == RBNil) {
+		return true;
+	}
+	const Node& h = pool[node];
+	if (isRed(h.right)) {
+		return false;
+	}
+	if (node != root && isRed(node) && isRed(h.left)) {
+		return false;
+	}
+	return is23(h.left) && is23(h.right);
 }
 
 template <typename Key, typename DataType>
-std::vector<Key> RBTree<Key, DataType>::keys(RBNode<DataType>& node, std::queue<Key> queue, Key lo, Key hi)
+template <typename Visitor>
+void RBTree<Key, DataType>::keys(RBIndex node, Visitor& visitor, const Key& lo, const Key& hi) const
 {
-	return nullptr;
+	if (node == RBNil) {
+		return;
+	}
+	const Node& h = pool[node];
+	if (lo < h.key) {
+		keys(h.left, visitor, lo, hi);
+	}
+	if (!(h.key < lo) && !(hi < h.key)) {
+		visitor(h.key, h.data);
+	}
+	if (h.key < hi) {
+		keys(h.right, visitor, lo, hi);
+	}
 }
 
 
 template <typename Key, typename DataType>
-RBTree<Key, DataType>::RBTree()
+RBTree<Key, DataType>::RBTree() : root(RBNil)
 {
-	return nullptr;
 }
 
 template <typename Key, typename DataType>
-RBTree<Key, DataType>::~RBTree()
+RBTree<Key, DataType>::~RBTree() = default;
+
+template <typename Key, typename DataType>
+bool RBTree<Key, DataType>::isRed(RBIndex node) const
 {
-	return nullptr;
+	return node != RBNil && pool[node].color == RBColor::Red;
 }
 
 template <typename Key, typename DataType>
-bool RBTree<Key, DataType>::isRed(RBNode<DataType>& node)
+void RBTree<Key, DataType>::reserve(std::size_t count)
 {
-	return nullptr;
+	pool.reserve(count);
 }
 
 /***************************************************************************
@@ -351,31 +746,42 @@ bool RBTree<Key, DataType>::isRed(RBNode<DataType>& node)
 template <typename Key, typename DataType>
 void RBTree<Key, DataType>::put(Key key, DataType value)
 {
-	return nullptr;
+	root = put(root, key, value);
+	pool[root].color = RBColor::Black;
 }
 
 template <typename Key, typename DataType>
-DataType RBTree<Key, DataType>::get(Key key)
+DataType RBTree<Key, DataType>::get(Key key) const
 {
-	return nullptr;
+	RBIndex node = get(root, key);
+	if (node == RBNil) {
+		throw std::out_of_range("RBTree::get: key not found");
+	}
+	return pool[node].data;
 }
 
 template <typename Key, typename DataType>
-bool RBTree<Key, DataType>::contains(Key key)
+const DataType* RBTree<Key, DataType>::find(Key key) const
 {
-	return nullptr;
+	RBIndex node = get(root, key);
+	return node == RBNil ? nullptr : &pool[node].data;
 }
 
 template <typename Key, typename DataType>
-void RBTree<Key, DataType>::search(DataType data)
+bool RBTree<Key, DataType>::contains(Key key) const
 {
-	return nullptr;
+	return get(root, key) != RBNil;
 }
 
 template <typename Key, typename DataType>
-void RBTree<Key, DataType>::traverse()
+void RBTree<Key, DataType>::traverse() const
 {
-	return nullptr;
+	if (isEmpty()) {
+		return;
+	}
+	scan(minimum(), maximum(), [](const Key& key, const DataType&) {
+		std::println("RBNode.key: {}", key);
+	});
 }
 
 /***************************************************************************
@@ -384,19 +790,62 @@ void RBTree<Key, DataType>::traverse()
 template <typename Key, typename DataType>
 void RBTree<Key, DataType>::deleteMin()
 {
-	return nullptr;
+	if (isEmpty()) {
+		throw std::out_of_range("RBTree::deleteMin: tree is empty");
+	}
+
+	// if both children of root are black, set root to red
+	if (!isRed(pool[root].left) && !isRed(pool[root].right)) {
+		pool[root].color = RBColor::Red;
+	}
+
+	root = deleteMin(root);
+	if (!isEmpty()) {
+		pool[root].color = RBColor::Black;
+	}
 }
 
 template <typename Key, typename DataType>
 void RBTree<Key, DataType>::deleteMax()
 {
-	return nullptr;
+	if (isEmpty()) {
+		throw std::out_of_range("RBTree::deleteMax: tree is empty");
+	}
+
+	// if both children of root are black, set root to red
+	if (!isRed(pool[root].left) && !isRed(pool[root].right)) {
+		pool[root].color = RBColor::Red;
+	}
+
+	root = deleteMax(root);
+	if (!isEmpty()) {
+		pool[root].color = RBColor::Black;
+	}
 }
 
 template <typename Key, typename DataType>
 void RBTree<Key, DataType>::deleteNode(Key key)
 {
-	return nullptr;
+	if (!contains(key)) {
+		return;
+	}
+
+	// if both children of root are black, set root to red
+	if (!isRed(pool[root].left) && !isRed(pool[root].right)) {
+		pool[root].color = RBColor::Red;
+	}
+
+	root = deleteNode(root, key);
+	if (!isEmpty()) {
+		pool[root].color = RBColor::Black;
+	}
+}
+
+template <typename Key, typename DataType>
+void RBTree<Key, DataType>::clear()
+{
+	pool.clear();
+	root = RBNil;
 }
 
 
@@ -404,9 +853,9 @@ void RBTree<Key, DataType>::deleteNode(Key key)
 *  Utility functions.
 ***************************************************************************/
 template <typename Key, typename DataType>
-int RBTree<Key, DataType>::height()
+int RBTree<Key, DataType>::height() const
 {
-	return nullptr;
+	return height(root);
 }
 
 
@@ -414,64 +863,99 @@ int RBTree<Key, DataType>::height()
 *  Ordered symbol table methods.
 ***************************************************************************/
 template <typename Key, typename DataType>
-RBNode<DataType>& RBTree<Key, DataType>::minimum()
+Key RBTree<Key, DataType>::minimum() const
 {
-	return nullptr;
+	if (isEmpty()) {
+		throw std::out_of_range("RBTree::minimum: tree is empty");
+	}
+	return pool[minimum(root)].key;
 }
 
 template <typename Key, typename DataType>
-RBNode<DataType>& RBTree<Key, DataType>::maximum()
+Key RBTree<Key, DataType>::maximum() const
 {
-	return nullptr;
+	if (isEmpty()) {
+		throw std::out_of_range("RBTree::maximum: tree is empty");
+	}
+	return pool[maximum(root)].key;
 }
 
 template <typename Key, typename DataType>
-Key RBTree<Key, DataType>::ceiling(Key key)
+Key RBTree<Key, DataType>::ceiling(Key key) const
 {
-	return nullptr;
+	RBIndex node = ceiling(root, key);
+	if (node == RBNil) {
+		throw std::out_of_range("RBTree::ceiling: no key at or above the argument");
+	}
+	return pool[node].key;
 }
 
 template <typename Key, typename DataType>
-Key RBTree<Key, DataType>::floor(Key key)
+Key RBTree<Key, DataType>::floor(Key key) const
 {
-	return nullptr;
+	RBIndex node = floor(root, key);
+	if (node == RBNil) {
+		throw std::out_of_range("RBTree::floor: no key at or below the argument");
+	}
+	return pool[node].key;
 }
 
 template <typename Key, typename DataType>
-Key RBTree<Key, DataType>::select(int rank)
+Key RBTree<Key, DataType>::select(std::size_t rank) const
 {
-	return nullptr;
+	if (rank >= size()) {
+		throw std::out_of_range("RBTree::select: rank is out of range");
+	}
+	return pool[select(root, rank)].key;
 }
 
 template <typename Key, typename DataType>
-int RBTree<Key, DataType>::rank(Key key)
+std::size_t RBTree<Key, DataType>::rank(Key key) const
 {
-	return nullptr;
+	return rank(key, root);
 }
 
 template <typename Key, typename DataType>
-int RBTree<Key, DataType>::size()
+std::size_t RBTree<Key, DataType>::size() const
 {
-	return nullptr;
+	return size(root);
 }
 
 template <typename Key, typename DataType>
-int RBTree<Key, DataType>::size(Key lo, Key hi)
+std::size_t RBTree<Key, DataType>::size(Key lo, Key hi) const
 {
-	return nullptr;
+	if (hi < lo) {
+		return 0;
+	}
+	return rank(hi) - rank(lo) + (contains(hi) ? 1 : 0);
 }
 
 /***************************************************************************
 *  Range count and range search.
 ***************************************************************************/
 template <typename Key, typename DataType>
-std::vector<Key> RBTree<Key, DataType>::keys()
+std::vector<Key> RBTree<Key, DataType>::keys() const
+{
+	if (isEmpty()) {
+		return {};
+	}
+	return keys(minimum(), maximum());
+}
+
+template <typename Key, typename DataType>
+std::vector<Key> RBTree<Key, DataType>::keys(Key lo, Key hi) const
 {
-	return nullptr;
+	std::vector<Key> result;
+	result.reserve(size(lo, hi));
+	scan(lo, hi, [&result](const Key& key, const DataType&) {
+		result.push_back(key);
+	});
+	return result;
 }
 
 template <typename Key, typename DataType>
-std::vector<Key> RBTree<Key, DataType>::keys(Key lo, Key hi)
+template <typename Visitor>
+void RBTree<Key, DataType>::scan(Key lo, Key hi, Visitor&& visitor) const
 {
-	return nullptr;
+	keys(root, visitor, lo, hi);
 }
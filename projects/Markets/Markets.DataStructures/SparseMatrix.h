@@ -1 +1,477 @@
 #pragma once
+
+import std;
+
+/// <summary>
+/// Sparse Matrix:
+///    - Compressed sparse storage for the cross-ticker relationship matrices
+///      (correlation, covariance, lead/lag), which are mostly empty once
+///      thresholded.
+///
+///    - Layout:
+///       - CSR (compressed sparse row) or CSC (compressed sparse column).
+///         `offsets` has one entry per row (CSR) or column (CSC) plus one,
+///         and [offsets[i], offsets[i + 1]) indexes the `indices`/`values`
+///         of that row or column, sorted by the other coordinate.
+///       - Offsets are std::size_t so nnz is unbounded; the per-entry index
+///         type defaults to 32 bits to halve the index traffic.
+///
+///    - Operations:
+///       - SpMV (y = A x) and SpMM (C = A B for a dense row-major B), serial
+///         or with a std::execution policy. Work is split into blocks with
+///         roughly equal nonzero counts, not equal row counts, so a few
+///         dense rows (index members, sector ETFs) do not serialize a block.
+///       - CSR <-> CSC conversion by counting sort in O(nnz + rows + cols).
+///       - SparseMatrixBuilder assembles from unordered (row, column, value)
+///         triples and sums duplicates.
+///       - fromGrb() copies any rgri grb::matrix (or view) into this layout.
+/// </summary>
+enum class SparseLayout : std::uint8_t { CSR, CSC };
+
+template <typename T, typename Index = std::uint32_t>
+class SparseMatrix
+{
+private:
+	std::size_t rowCount = 0;
+	std::size_t colCount = 0;
+	SparseLayout storage = SparseLayout::CSR;
+	std::vector<std::size_t> offsets_ = { 0 };
+	std::vector<Index> indices_;
+	std::vector<T> values_;
+
+	struct Block
+	{
+		std::size_t first;
+		std::size_t last;
+		std::size_t slot;
+	};
+
+	std::size_t outerCount() const;
+	std::vector<Block> partition(std::size_t blocks) const;
+
+	template <typename ExecutionPolicy>
+	static constexpr bool isSequential();
+
+	void multiplyRows(std::size_t first, std::size_t last, std::span<const T> b, std::size_t k, std::span<T> c) const;
+	void scatterColumns(std::size_t first, std::size_t last, std::span<const T> b, std::size_t k, std::span<T> c) const;
+
+public:
+	SparseMatrix() = default;
+	SparseMatrix(std::size_t rows, std::size_t cols, SparseLayout layout = SparseLayout::CSR);
+	SparseMatrix(std::size_t rows, std::size_t cols, SparseLayout layout,
+		std::vector<std::size_t> offsets, std::vector<Index> indices, std::vector<T> values);
+
+	std::size_t rows() const { return rowCount; }
+	std::size_t cols() const { return colCount; }
+	std::size_t nonZeros() const { return values_.size(); }
+	SparseLayout layout() const { return storage; }
+
+	std::span<const std::size_t> offsets() const { return offsets_; }
+	std::span<const Index> indices() const { return indices_; }
+	std::span<const T> values() const { return values_; }
+
+	/// Value at (row, col), or T{} when the entry is not stored.
+	T at(std::size_t row, std::size_t col) const;
+
+	/***************************************************************************
+	*  Layout conversion.
+	***************************************************************************/
+	SparseMatrix toCSR() const;
+	SparseMatrix toCSC() const;
+	/// The transpose shares this matrix's arrays reinterpreted in the other
+	/// layout (CSR of A is CSC of A^T), so it is a copy, not a re-sort.
+	SparseMatrix transpose() const;
+
+	/***************************************************************************
+	*  Products.
+	***************************************************************************/
+	/// y = A x.
+	void multiply(std::span<const T> x, std::span<T> y) const;
+	template <typename ExecutionPolicy>
+		requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+	void multiply(ExecutionPolicy&& policy, std::span<const T> x, std::span<T> y) const;
+
+	/// C = A B, with B (cols x k) and C (rows x k) dense and row-major.
+	void multiply(std::span<const T> b, std::size_t k, std::span<T> c) const;
+	template <typename ExecutionPolicy>
+		requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+	void multiply(ExecutionPolicy&& policy, std::span<const T> b, std::size_t k, std::span<T> c) const;
+
+	/***************************************************************************
+	*  rgri interop.
+	***************************************************************************/
+	/// Copies a grb::matrix (anything with shape() that iterates
+	/// ((row, col), value) entries) into the given layout.
+	template <typename GrbMatrix>
+	static SparseMatrix fromGrb(const GrbMatrix& matrix, SparseLayout layout = SparseLayout::CSR);
+};
+
+
+/// <summary>
+/// COO (coordinate) builder for SparseMatrix: collects (row, col, value)
+/// triples in any order, then compresses them with a counting sort on the
+/// outer coordinate and a sort of each row/column. Duplicates are summed.
+/// </summary>
+template <typename T, typename Index = std::uint32_t>
+class SparseMatrixBuilder
+{
+private:
+	std::size_t rowCount;
+	std::size_t colCount;
+	std::vector<Index> rowIndices;
+	std::vector<Index> colIndices;
+	std::vector<T> entries;
+
+public:
+	SparseMatrixBuilder(std::size_t rows, std::size_t cols);
+
+	void reserve(std::size_t count);
+	void add(std::size_t row, std::size_t col, T value);
+	std::size_t size() const { return entries.size(); }
+	void clear();
+
+	SparseMatrix<T, Index> build(SparseLayout layout = SparseLayout::CSR) const;
+};
+
+
+template <typename T, typename Index>
+SparseMatrix<T, Index>::SparseMatrix(std::size_t rows, std::size_t cols, SparseLayout layout)
+	: rowCount(rows), colCount(cols), storage(layout)
+{
+	offsets_.assign(outerCount() + 1, 0);
+}
+
+template <typename T, typename Index>
+SparseMatrix<T, Index>::SparseMatrix(std::size_t rows, std::size_t cols, SparseLayout layout,
+	std::vector<std::size_t> offsets, std::vector<Index> indices, std::vector<T> values)
+	: rowCount(rows), colCount(cols), storage(layout),
+	offsets_(std::move(offsets)), indices_(std::move(indices)), values_(std::move(values))
+{
+	std::size_t inner = layout == SparseLayout::CSR ? cols : rows;
+	if (offsets_.size() != outerCount() + 1 || offsets_.front() != 0 || offsets_.back() != values_.size()
+		|| indices_.size() != values_.size() || !std::ranges::is_sorted(offsets_)) {
+		throw std::invalid_argument("SparseMatrix: offsets, indices and values are inconsistent");
+	}
+	if (std::ranges::any_of(indices_, [inner](Index index) { return static_cast<std::size_t>(index) >= inner; })) {
+		throw std::out_of_range("SparseMatrix: index outside the matrix");
+	}
+}
+
+template <typename T, typename Index>
+std::size_t SparseMatrix<T, Index>::outerCount() const
+{
+	return storage == SparseLayout::CSR ? rowCount : colCount;
+}
+
+template <typename T, typename Index>
+T SparseMatrix<T, Index>::at(std::size_t row, std::size_t col) const
+{
+	if (row >= rowCount || col >= colCount) {
+		throw std::out_of_range("SparseMatrix::at: index outside the matrix");
+	}
+	std::size_t outer = storage == SparseLayout::CSR ? row : col;
+	std::size_t inner = storage == SparseLayout::CSR ? col : row;
+	auto first = indices_.begin() + offsets_[outer];
+	auto last = indices_.begin() + offsets_[outer + 1];
+	auto it = std::lower_bound(first, last, static_cast<Index>(inner));
+	if (it == last || *it != static_cast<Index>(inner)) {
+		return T{};
+	}
+	return values_[static_cast<std::size_t>(it - indices_.begin())];
+}
+
+/***************************************************************************
+*  Layout conversion.
+***************************************************************************/
+template <typename T, typename Index>
+SparseMatrix<T, Index> SparseMatrix<T, Index>::transpose() const
+{
+	SparseLayout flipped = storage == SparseLayout::CSR ? SparseLayout::CSC : SparseLayout::CSR;
+	return SparseMatrix(colCount, rowCount, flipped, offsets_, indices_, values_);
+}
+
+template <typename T, typename Index>
+SparseMatrix<T, Index> SparseMatrix<T, Index>::toCSR() const
+{
+	if (storage == SparseLayout::CSR) {
+		return *this;
+	}
+	// The CSC arrays of A are the CSR arrays of A^T; re-compress them.
+	return transpose().toCSC().transpose();
+}
+
+template <typename T, typename Index>
+SparseMatrix<T, Index> SparseMatrix<T, Index>::toCSC() const
+{
+	if (storage == SparseLayout::CSC) {
+		return *this;
+	}
+
+	// Counting sort on the column index. Rows are visited in order, so every
+	// column comes out sorted by row without a second pass.
+	std::vector<std::size_t> offsets(colCount + 1, 0);
+	for (Index col : indices_) {
+		offsets[static_cast<std::size_t>(col) + 1]++;
+	}
+	std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+	std::vector<std::size_t> cursor(offsets.begin(), offsets.end() - 1);
+	std::vector<Index> indices(values_.size());
+	std::vector<T> values(values_.size());
+	for (std::size_t row = 0; row < rowCount; row++) {
+		for (std::size_t p = offsets_[row]; p < offsets_[row + 1]; p++) {
+			std::size_t slot = cursor[indices_[p]]++;
+			indices[slot] = static_cast<Index>(row);
+			values[slot] = values_[p];
+		}
+	}
+	return SparseMatrix(rowCount, colCount, SparseLayout::CSC, std::move(offsets), std::move(indices), std::move(values));
+}
+
+/***************************************************************************
+*  Products.
+***************************************************************************/
+
+/// Splits the outer dimension into at most `blocks` contiguous ranges with
+/// roughly equal nonzero counts.
+template <typename T, typename Index>
+std::vector<typename SparseMatrix<T, Index>::Block> SparseMatrix<T, Index>::partition(std::size_t blocks) const
+{
+	std::size_t outer = outerCount();
+	blocks = std::max<std::size_t>(1, std::min(blocks, outer));
+
+	std::vector<Block> result;
+	result.reserve(blocks);
+	std::size_t first = 0;
+	for (std::size_t b = 1; b <= blocks && first < outer; b++) {
+		std::size_t last = outer;
+		if (b < blocks) {
+			std::size_t target = nonZeros() * b / blocks;
+			auto it = std::upper_bound(offsets_.begin() + first + 1, offsets_.end() - 1, target);
+			last = static_cast<std::size_t>(it - offsets_.begin());
+		}
+		if (last > first) {
+			result.push_back({ first, last, result.size() });
+			first = last;
+		}
+	}
+	return result;
+}
+
+template <typename T, typename Index>
+template <typename ExecutionPolicy>
+constexpr bool SparseMatrix<T, Index>::isSequential()
+{
+	return std::is_same_v<std::remove_cvref_t<ExecutionPolicy>, std::execution::sequenced_policy>;
+}
+
+template <typename T, typename Index>
+void SparseMatrix<T, Index>::multiplyRows(std::size_t first, std::size_t last, std::span<const T> b, std::size_t k, std::span<T> c) const
+{
+	if (k == 1) {
+		for (std::size_t row = first; row < last; row++) {
+			T sum{};
+			for (std::size_t p = offsets_[row]; p < offsets_[row + 1]; p++) {
+				sum += values_[p] * b[indices_[p]];
+			}
+			c[row] = sum;
+		}
+		return;
+	}
+	for (std::size_t row = first; row < last; row++) {
+		T* out = c.data() + row * k;
+		std::fill(out, out + k, T{});
+		for (std::size_t p = offsets_[row]; p < offsets_[row + 1]; p++) {
+			const T value = values_[p];
+			const T* in = b.data() + static_cast<std::size_t>(indices_[p]) * k;
+			for (std::size_t j = 0; j < k; j++) {
+				out[j] += value * in[j];
+			}
+		}
+	}
+}
+
+/// Accumulates the contribution of columns [first, last) into c (which the
+/// caller zeroes).
+template <typename T, typename Index>
+void SparseMatrix<T, Index>::scatterColumns(std::size_t first, std::size_t last, std::span<const T> b, std::size_t k, std::span<T> c) const
+{
+	for (std::size_t col = first; col < last; col++) {
+		const T* in = b.data() + col * k;
+		for (std::size_t p = offsets_[col]; p < offsets_[col + 1]; p++) {
+			const T value = values_[p];
+			T* out = c.data() + static_cast<std::size_t>(indices_[p]) * k;
+			for (std::size_t j = 0; j < k; j++) {
+				out[j] += value * in[j];
+			}
+		}
+	}
+}
+
+template <typename T, typename Index>
+void SparseMatrix<T, Index>::multiply(std::span<const T> x, std::span<T> y) const
+{
+	multiply(std::execution::seq, x, 1, y);
+}
+
+template <typename T, typename Index>
+template <typename ExecutionPolicy>
+	requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+void SparseMatrix<T, Index>::multiply(ExecutionPolicy&& policy, std::span<const T> x, std::span<T> y) const
+{
+	multiply(std::forward<ExecutionPolicy>(policy), x, 1, y);
+}
+
+template <typename T, typename Index>
+void SparseMatrix<T, Index>::multiply(std::span<const T> b, std::size_t k, std::span<T> c) const
+{
+	multiply(std::execution::seq, b, k, c);
+}
+
+template <typename T, typename Index>
+template <typename ExecutionPolicy>
+	requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+void SparseMatrix<T, Index>::multiply(ExecutionPolicy&& policy, std::span<const T> b, std::size_t k, std::span<T> c) const
+{
+	if (k == 0 || b.size() != colCount * k || c.size() != rowCount * k) {
+		throw std::invalid_argument("SparseMatrix::multiply: operand sizes do not match the matrix");
+	}
+
+	// A few blocks per thread, so nnz skew between blocks evens out.
+	std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+	auto blocks = partition(isSequential<ExecutionPolicy>() ? 1 : threads * 4);
+
+	if (storage == SparseLayout::CSR) {
+		if (blocks.empty()) {
+			std::fill(c.begin(), c.end(), T{});
+		}
+		std::for_each(policy, blocks.begin(), blocks.end(), [&](const Block& block) {
+			multiplyRows(block.first, block.last, b, k, c);
+		});
+		return;
+	}
+
+	// CSC scatters into arbitrary rows, so every block but the first gets a
+	// private output, summed into c afterwards.
+	blocks = partition(isSequential<ExecutionPolicy>() ? 1 : threads);
+	std::fill(c.begin(), c.end(), T{});
+	std::vector<std::vector<T>> partials(blocks.empty() ? 0 : blocks.size() - 1, std::vector<T>(c.size()));
+	std::for_each(policy, blocks.begin(), blocks.end(), [&](const Block& block) {
+		std::span<T> out = block.slot == 0 ? c : std::span<T>(partials[block.slot - 1]);
+		scatterColumns(block.first, block.last, b, k, out);
+	});
+	if (!partials.empty()) {
+		std::vector<Block> rowBlocks;
+		std::size_t step = (rowCount + blocks.size() - 1) / blocks.size();
+		for (std::size_t first = 0; first < rowCount; first += step) {
+			rowBlocks.push_back({ first, std::min(first + step, rowCount), rowBlocks.size() });
+		}
+		std::for_each(policy, rowBlocks.begin(), rowBlocks.end(), [&](const Block& block) {
+			for (auto& partial : partials) {
+				for (std::size_t j = block.first * k; j < block.last * k; j++) {
+					c[j] += partial[j];
+				}
+			}
+		});
+	}
+}
+
+/***************************************************************************
+*  rgri interop.
+***************************************************************************/
+template <typename T, typename Index>
+template <typename GrbMatrix>
+SparseMatrix<T, Index> SparseMatrix<T, Index>::fromGrb(const GrbMatrix& matrix, SparseLayout layout)
+{
+	auto shape = matrix.shape();
+	SparseMatrixBuilder<T, Index> builder(static_cast<std::size_t>(shape[0]), static_cast<std::size_t>(shape[1]));
+	builder.reserve(static_cast<std::size_t>(matrix.size()));
+	for (auto&& entry : matrix) {
+		auto&& [index, value] = entry;
+		builder.add(static_cast<std::size_t>(index[0]), static_cast<std::size_t>(index[1]), static_cast<T>(value));
+	}
+	return builder.build(layout);
+}
+
+
+template <typename T, typename Index>
+SparseMatrixBuilder<T, Index>::SparseMatrixBuilder(std::size_t rows, std::size_t cols)
+	: rowCount(rows), colCount(cols)
+{
+	if (rows > std::numeric_limits<Index>::max() || cols > std::numeric_limits<Index>::max()) {
+		throw std::length_error("SparseMatrixBuilder: dimensions exceed the index type");
+	}
+}
+
+template <typename T, typename Index>
+void SparseMatrixBuilder<T, Index>::reserve(std::size_t count)
+{
+	rowIndices.reserve(count);
+	colIndices.reserve(count);
+	entries.reserve(count);
+}
+
+template <typename T, typename Index>
+void SparseMatrixBuilder<T, Index>::add(std::size_t row, std::size_t col, T value)
+{
+	if (row >= rowCount || col >= colCount) {
+		throw std::out_of_range("SparseMatrixBuilder::add: index outside the matrix");
+	}
+	rowIndices.push_back(static_cast<Index>(row));
+	colIndices.push_back(static_cast<Index>(col));
+	entries.push_back(std::move(value));
+}
+
+template <typename T, typename Index>
+void SparseMatrixBuilder<T, Index>::clear()
+{
+	rowIndices.clear();
+	colIndices.clear();
+	entries.clear();
+}
+
+template <typename T, typename Index>
+SparseMatrix<T, Index> SparseMatrixBuilder<T, Index>::build(SparseLayout layout) const
+{
+	const bool byRow = layout == SparseLayout::CSR;
+	const std::vector<Index>& outer = byRow ? rowIndices : colIndices;
+	const std::vector<Index>& inner = byRow ? colIndices : rowIndices;
+	std::size_t outerCount = byRow ? rowCount : colCount;
+
+	// Counting sort on the outer coordinate.
+	std::vector<std::size_t> offsets(outerCount + 1, 0);
+	for (Index index : outer) {
+		offsets[static_cast<std::size_t>(index) + 1]++;
+	}
+	std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+	std::vector<std::size_t> cursor(offsets.begin(), offsets.end() - 1);
+	std::vector<std::pair<Index, T>> sorted(entries.size());
+	for (std::size_t i = 0; i < entries.size(); i++) {
+		sorted[cursor[outer[i]]++] = { inner[i], entries[i] };
+	}
+
+	// Sort each row/column and sum duplicates, compacting in place.
+	std::vector<Index> indices;
+	std::vector<T> values;
+	indices.reserve(sorted.size());
+	values.reserve(sorted.size());
+	std::vector<std::size_t> compressed(outerCount + 1, 0);
+	for (std::size_t o = 0; o < outerCount; o++) {
+		auto first = sorted.begin() + offsets[o];
+		auto last = sorted.begin() + offsets[o + 1];
+		std::stable_sort(first, last, [](const auto& a, const auto& b) { return a.first < b.first; });
+		for (auto it = first; it != last; ++it) {
+			if (indices.size() > compressed[o] && indices.back() == it->first) {
+				values.back() += it->second;
+			}
+			else {
+				indices.push_back(it->first);
+				values.push_back(it->second);
+			}
+		}
+		compressed[o + 1] = indices.size();
+	}
+
+	return SparseMatrix<T, Index>(rowCount, colCount, layout, std::move(compressed), std::move(indices), std::move(values));
+}
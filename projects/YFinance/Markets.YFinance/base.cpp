@@ -1,27 +1,76 @@
 
 #include <algorithm>
 #include <map>
+#include <memory>
+#include <optional>
 #include <string>
 
+#include "cache.h"
+#include "data.h"
+#include "fundamentals.h"
+#include "history.h"
+
 using namespace std;
 
 class TickerBase {
 public:
 
-    TickerBase(string ticker, void* session, void* proxy) {
+    // `session` is borrowed; when null the ticker opens its own YfData
+    // against the default base URL.
+    TickerBase(string ticker, YfData* session = nullptr, void* proxy = nullptr) {
         transform(ticker.begin(), ticker.end(), ticker.begin(), ::toupper);
         this->ticker = ticker;
+		if (session == nullptr) {
+			_own_session = make_unique<YfData>();
+			session = _own_session.get();
+		}
 		this->session = session;
 		this->proxy = proxy;
     }
 
-	void _lazy_load_price_history() {
+	PriceHistory& _lazy_load_price_history() {
+		if (_price_history == nullptr) {
+			_price_history = make_unique<PriceHistory>(*session, ticker);
+		}
+		return *_price_history;
+	}
+
+	Financials& _lazy_load_financials() {
+		if (_financials == nullptr) {
+			_financials = make_unique<Financials>(*session, ticker);
+		}
+		return *_financials;
+	}
+
+	const PriceColumns& history(const string& period = "1mo", const string& interval = "1d", bool prepost = false) {
+		const PriceColumns& bars = _lazy_load_price_history().history(period, interval, prepost);
+		if (_tz.empty()) {
+			_tz = bars.metadata().exchange_timezone_name;
+		}
+		return bars;
 	}
 	
-	void _get_ticker_tz() {
+	string _get_ticker_tz() {
+		if (!_tz.empty()) {
+			return _tz;
+		}
+		shared_ptr<ICache> cache = _TzCacheManager::get_tz_cache();
+		if (optional<string> tz = cache->lookup(ticker)) {
+			_tz = *tz;
+			return _tz;
+		}
+		_tz = _fetch_ticker_tz();
+		if (!_tz.empty()) {
+			cache->store(ticker, _tz);
+		}
+		return _tz;
 	}
 	
-	void _fetch_ticker_tz() {
+	string _fetch_ticker_tz() {
+		// A one-bar chart request is the cheapest call that returns the exchange timezone.
+		PriceColumns bars = PriceColumns::parse_chart_json(session->get("/v8/finance/chart/" + YfData::url_encode(ticker), {
+			{ "range", "1d" }, { "interval", "1d" } }));
+		return bars.metadata().exchange_timezone_name;
 	}
 	
 	void get_recommendations(void* proxy = nullptr, bool as_dict = false) {
@@ -79,22 +128,28 @@ public:
 	}
 	void get_earnings(void* proxy = nullptr, bool as_dict = false, string freq = "yearly") {
 	}
-	void get_income_stmt(void* proxy = nullptr, bool as_dict = false, bool pretty = false, string freq = "yearly") {
+	const FinancialStatement& get_income_stmt(void* proxy = nullptr, bool as_dict = false, bool pretty = false, string freq = "yearly") {
+		return _lazy_load_financials().get_income_time_series(freq);
 	}
-	void get_incomestmt(void* proxy = nullptr, bool as_dict = false, bool pretty = false, string freq = "yearly") {
+	const FinancialStatement& get_incomestmt(void* proxy = nullptr, bool as_dict = false, bool pretty = false, string freq = "yearly") {
+		return get_income_stmt(proxy, as_dict, pretty, freq);
 	}
-	void get_financials(void* proxy = nullptr, bool as_dict = false, bool pretty = false, string freq = "yearly") {
+	const FinancialStatement& get_financials(void* proxy = nullptr, bool as_dict = false, bool pretty = false, string freq = "yearly") {
+		return get_income_stmt(proxy, as_dict, pretty, freq);
 	}
-	void get_balance_sheet(void* proxy = nullptr, bool as_dict = false, bool pretty = false, string freq = "yearly") {
+	const FinancialStatement& get_balance_sheet(void* proxy = nullptr, bool as_dict = false, bool pretty = false, string freq = "yearly") {
+		return _lazy_load_financials().get_balance_sheet_time_series(freq);
 	}
-	void get_balancesheet(void* proxy = nullptr, bool as_dict = false, bool pretty = false, string freq = "yearly") {
+	const FinancialStatement& get_balancesheet(void* proxy = nullptr, bool as_dict = false, bool pretty = false, string freq = "yearly") {
+		return get_balance_sheet(proxy, as_dict, pretty, freq);
 	}
 
-	map<void*, void*> get_cash_flow(void* proxy = nullptr, bool as_dict = false, bool pretty = false, string freq = "yearly") {
-		return {};
+	const FinancialStatement& get_cash_flow(void* proxy = nullptr, bool as_dict = false, bool pretty = false, string freq = "yearly") {
+		return _lazy_load_financials().get_cash_flow_time_series(freq);
 	}
 
-	void get_cashflow(void* proxy = nullptr, bool as_dict = false, bool pretty = false, string freq = "yearly") {
+	const FinancialStatement& get_cashflow(void* proxy = nullptr, bool as_dict = false, bool pretty = false, string freq = "yearly") {
+		return get_cash_flow(proxy, as_dict, pretty, freq);
 	}
 	
 	//->pd.Series
@@ -109,24 +164,30 @@ public:
 	void get_isin(void* proxy = nullptr) {}
 	void get_news(void* proxy = nullptr) {}
 	void get_earnings_dates(int limit = 12, void* proxy = nullptr) {}
-	void get_history_metadata(void* proxy = nullptr) {}
+	PriceHistoryMetadata get_history_metadata(void* proxy = nullptr) {
+		if (_price_history == nullptr || _price_history->get_history_cache().empty()) {
+			history("1mo");
+		}
+		return _price_history->get_history_metadata();
+	}
 	void get_funds_data(void* proxy = nullptr) {}
 
 
 
 private:
     string ticker;
-    void* session;
+    YfData* session;
     void* proxy;
-	//   _tz;
+	unique_ptr<YfData> _own_session;
+	string _tz;
 	//_isin;
 	//_news;
 	//_shares;
 	//_earnings_dates;
 	//_earnings;
-	//_financials;
+	unique_ptr<Financials> _financials;
 	//_data;
-	//_price_history;
+	unique_ptr<PriceHistory> _price_history;
 	//_analysis;
 	//_holders;
 	//_quote;
@@ -1,69 +1,499 @@
+#include "cache.h"
 
-#include <string>
-#include <memory>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 
-class ICache {
-public:
-	virtual void* lookup(string key);
-	virtual void store(string key, void* obj);
+namespace {
+
+constexpr char tz_cache_magic[8] = { 'Y', 'F', 'T', 'Z', 'C', 'A', 'C', 'H' };
+constexpr uint32_t tz_cache_version = 1;
+// Log bytes reserved per slot; a ticker/timezone record is ~32 bytes and the
+// table is at most half full, so updates have room before the next growth.
+constexpr uint64_t log_bytes_per_slot = 48;
+
+struct TzCacheHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t capacity;
+	uint64_t generation;
+	uint64_t log_capacity;
+	uint64_t log_size;
+	uint32_t count;
+	uint32_t retired;
+	uint8_t reserved[16];
+};
+static_assert(sizeof(TzCacheHeader) == 64);
+
+struct TzRecordHeader {
+	uint16_t key_length;
+	uint16_t value_length;
 };
 
-class _TzCacheDummy : public ICache {
+uint64_t fnv1a(string_view text) {
+	uint64_t hash = 14695981039346656037ull;
+	for (unsigned char c : text) {
+		hash ^= c;
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+uint64_t align8(uint64_t n) {
+	return (n + 7) & ~uint64_t{ 7 };
+}
+
+uint64_t file_size_for(uint32_t capacity) {
+	return sizeof(TzCacheHeader) + uint64_t{ capacity } * sizeof(uint64_t) + uint64_t{ capacity } * log_bytes_per_slot;
+}
+
+filesystem::path generation_path(const filesystem::path& dir, uint64_t generation) {
+	return dir / ("tkr-tz." + to_string(generation) + ".bin");
+}
+
+}
+
+// A read/write shared mapping of a whole file plus an exclusive advisory
+// lock on it (LockFileEx / flock), used to serialize writers across processes.
+class MappedFile {
 public:
-	void* lookup(string key) {
-		return nullptr;
+	MappedFile(const filesystem::path& path, uint64_t create_size) : _path(path) {
+#ifdef _WIN32
+		_handle = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+			nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (_handle == INVALID_HANDLE_VALUE) {
+			throw _TzCacheException("cannot open " + path.string());
+		}
+		lock();
+		LARGE_INTEGER size{};
+		GetFileSizeEx(_handle, &size);
+		_created = size.QuadPart == 0;
+		if (_created) {
+			size.QuadPart = static_cast<LONGLONG>(create_size);
+			SetFilePointerEx(_handle, size, nullptr, FILE_BEGIN);
+			SetEndOfFile(_handle);
+		}
+		_size = static_cast<uint64_t>(size.QuadPart);
+		HANDLE mapping = CreateFileMappingW(_handle, nullptr, PAGE_READWRITE, 0, 0, nullptr);
+		_data = mapping == nullptr ? nullptr : static_cast<std::byte*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+		if (mapping != nullptr) {
+			CloseHandle(mapping);
+		}
+#else
+		_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+		if (_fd < 0) {
+			throw _TzCacheException("cannot open " + path.string());
+		}
+		lock();
+		struct stat st {};
+		fstat(_fd, &st);
+		_created = st.st_size == 0;
+		if (_created && ftruncate(_fd, static_cast<off_t>(create_size)) != 0) {
+			unlock();
+			::close(_fd);
+			throw _TzCacheException("cannot size " + path.string());
+		}
+		_size = _created ? create_size : static_cast<uint64_t>(st.st_size);
+		void* data = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+		_data = data == MAP_FAILED ? nullptr : static_cast<std::byte*>(data);
+#endif
+		if (_data == nullptr) {
+			unlock();
+			close();
+			throw _TzCacheException("cannot map " + path.string());
+		}
+		// Stays locked: the opener initializes or validates, then unlocks.
 	}
-	
-	void store(string key, void* obj) {
+
+	~MappedFile() {
+		close();
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	void lock() {
+#ifdef _WIN32
+		OVERLAPPED overlapped{};
+		LockFileEx(_handle, LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD, MAXDWORD, &overlapped);
+#else
+		while (flock(_fd, LOCK_EX) != 0 && errno == EINTR) {
+		}
+#endif
 	}
 
-	void* tz_db() {
-		return nullptr;
+	void unlock() {
+#ifdef _WIN32
+		OVERLAPPED overlapped{};
+		UnlockFileEx(_handle, 0, MAXDWORD, MAXDWORD, &overlapped);
+#else
+		flock(_fd, LOCK_UN);
+#endif
 	}
-};
 
-class _TzCache : public ICache {
+	const filesystem::path& path() const { return _path; }
+	bool created() const { return _created; }
+	uint64_t size() const { return _size; }
+
+	TzCacheHeader& header() const { return *reinterpret_cast<TzCacheHeader*>(_data); }
+	uint64_t* slots() const { return reinterpret_cast<uint64_t*>(_data + sizeof(TzCacheHeader)); }
+	std::byte* log() const { return _data + sizeof(TzCacheHeader) + uint64_t{ header().capacity } * sizeof(uint64_t); }
+
 private:
-	void* db = nullptr;
-	bool dummy = false;
+	filesystem::path _path;
+	std::byte* _data = nullptr;
+	uint64_t _size = 0;
+	bool _created = false;
+#ifdef _WIN32
+	HANDLE _handle = INVALID_HANDLE_VALUE;
+#else
+	int _fd = -1;
+#endif
 
-public:
-	void* lookup(string key) {
-		return nullptr;
+	void close() {
+#ifdef _WIN32
+		if (_data != nullptr) {
+			UnmapViewOfFile(_data);
+		}
+		if (_handle != INVALID_HANDLE_VALUE) {
+			CloseHandle(_handle);
+		}
+		_handle = INVALID_HANDLE_VALUE;
+#else
+		if (_data != nullptr) {
+			munmap(_data, _size);
+		}
+		if (_fd >= 0) {
+			::close(_fd);
+		}
+		_fd = -1;
+#endif
+		_data = nullptr;
+	}
+};
+
+namespace {
+
+struct FileLock {
+	explicit FileLock(MappedFile& file) : file(file) {
+		file.lock();
 	}
-	void store(string key, void* obj) {
+	~FileLock() {
+		file.unlock();
 	}
+	MappedFile& file;
 };
 
+atomic_ref<uint64_t> slot_at(const MappedFile& file, uint32_t index) {
+	return atomic_ref<uint64_t>(file.slots()[index]);
+}
 
-//private:
-//	int initialised = -1;
-//	void* db = nullptr;
-//	bool dummy = false;
-//
-//public:
-//	get_db() {}
-//
-//	initialise() {}
-//
-//	lookup() {}
-//
-//	store() {}
-//}
-
-class _TzCacheManager {
-private:
-	static shared_ptr<ICache> tz_cache;
+// Reads the record a published slot word points to; false when the offset is
+// out of range (a torn or foreign file).
+bool read_record(const MappedFile& file, uint64_t word, string_view& key, string_view& value) {
+	uint64_t offset = (word & 0xFFFFFFFFu) - 1;
+	const TzCacheHeader& header = file.header();
+	if (offset + sizeof(TzRecordHeader) > header.log_capacity) {
+		return false;
+	}
+	TzRecordHeader record;
+	memcpy(&record, file.log() + offset, sizeof(record));
+	if (offset + sizeof(record) + record.key_length + record.value_length > header.log_capacity) {
+		return false;
+	}
+	const char* text = reinterpret_cast<const char*>(file.log() + offset + sizeof(record));
+	key = string_view(text, record.key_length);
+	value = string_view(text + record.key_length, record.value_length);
+	return true;
+}
 
-public:
-	static ICache get_tz_cache() {
+// Probes for `key`: returns the slot holding it, or the empty slot where it
+// would go. Returns capacity when the table is full and has no such key.
+uint32_t probe(const MappedFile& file, string_view key, uint64_t hash, uint64_t& word) {
+	uint32_t capacity = file.header().capacity;
+	uint32_t mask = capacity - 1;
+	uint64_t tag = hash >> 32;
+	uint32_t index = static_cast<uint32_t>(hash) & mask;
+	for (uint32_t probes = 0; probes < capacity; probes++, index = (index + 1) & mask) {
+		word = slot_at(file, index).load(memory_order_acquire);
+		if (word == 0) {
+			return index;
+		}
+		string_view stored_key;
+		string_view stored_value;
+		if ((word >> 32) == tag && read_record(file, word, stored_key, stored_value) && stored_key == key) {
+			return index;
+		}
+	}
+	word = 0;
+	return capacity;
+}
+
+// Appends a record and publishes it in `slot`. The caller holds the file lock
+// and has checked that the log has room.
+void publish(MappedFile& file, uint32_t slot, string_view key, string_view value, uint64_t hash, bool is_new) {
+	TzCacheHeader& header = file.header();
+	atomic_ref<uint64_t> log_size(header.log_size);
+	uint64_t offset = log_size.load(memory_order_relaxed);
+
+	TzRecordHeader record{ static_cast<uint16_t>(key.size()), static_cast<uint16_t>(value.size()) };
+	std::byte* out = file.log() + offset;
+	memcpy(out, &record, sizeof(record));
+	memcpy(out + sizeof(record), key.data(), key.size());
+	memcpy(out + sizeof(record) + key.size(), value.data(), value.size());
+	log_size.store(offset + align8(sizeof(record) + key.size() + value.size()), memory_order_release);
+
+	slot_at(file, slot).store(((hash >> 32) << 32) | (offset + 1), memory_order_release);
+	if (is_new) {
+		atomic_ref<uint32_t>(header.count).fetch_add(1, memory_order_relaxed);
+	}
+}
+
+#ifdef _WIN32
+string environment_variable(const char* name) {
+	char* value = nullptr;
+	size_t length = 0;
+	string result;
+	if (_dupenv_s(&value, &length, name) == 0 && value != nullptr) {
+		result = value;
+	}
+	free(value);
+	return result;
+}
+#else
+string environment_variable(const char* name) {
+	const char* value = getenv(name);
+	return value == nullptr ? string() : string(value);
+}
+#endif
+
+filesystem::path default_cache_dir() {
+#ifdef _WIN32
+	filesystem::path base = environment_variable("LOCALAPPDATA");
+#else
+	filesystem::path base = environment_variable("XDG_CACHE_HOME");
+	if (base.empty() && !environment_variable("HOME").empty()) {
+		base = filesystem::path(environment_variable("HOME")) / ".cache";
+	}
+#endif
+	if (base.empty()) {
+		base = filesystem::temp_directory_path();
+	}
+	return base / "cpp-yfinance";
+}
+
+}
+
+
+_TzCache::_TzCache(filesystem::path cache_dir, uint32_t initial_capacity)
+	: _dir(std::move(cache_dir)), _initial_capacity(bit_ceil(max<uint32_t>(initial_capacity, 16))) {
+	error_code error;
+	filesystem::create_directories(_dir, error);
+	if (!filesystem::is_directory(_dir)) {
+		throw _TzCacheException("cannot create cache directory " + _dir.string());
+	}
+	open_latest();
+}
+
+_TzCache::~_TzCache() = default;
+
+// The constructor of MappedFile leaves the file locked, so a new file is
+// fully initialized before any other process can look at it.
+shared_ptr<MappedFile> _TzCache::open_generation(uint64_t generation, uint32_t capacity) {
+	auto file = make_shared<MappedFile>(generation_path(_dir, generation), file_size_for(capacity));
+	TzCacheHeader& header = file->header();
+	if (file->created()) {
+		memcpy(header.magic, tz_cache_magic, sizeof(tz_cache_magic));
+		header.version = tz_cache_version;
+		header.capacity = capacity;
+		header.generation = generation;
+		header.log_capacity = uint64_t{ capacity } * log_bytes_per_slot;
+	}
+	else if (memcmp(header.magic, tz_cache_magic, sizeof(tz_cache_magic)) != 0 || header.version != tz_cache_version
+		|| !has_single_bit(header.capacity) || file_size_for(header.capacity) != file->size()) {
+		file->unlock();
+		throw _TzCacheException("not a timezone cache file: " + file->path().string());
+	}
+	file->unlock();
+	return file;
+}
 
+// Maps the newest generation in the directory, removing superseded ones
+// (best effort: another process may still have them mapped).
+void _TzCache::open_latest() {
+	lock_guard<mutex> guard(_remap_mutex);
+
+	uint64_t latest = 0;
+	vector<uint64_t> generations;
+	error_code error;
+	for (const auto& entry : filesystem::directory_iterator(_dir, error)) {
+		string name = entry.path().filename().string();
+		if (name.starts_with("tkr-tz.") && name.ends_with(".bin")) {
+			string number = name.substr(7, name.size() - 11);
+			if (!number.empty() && all_of(number.begin(), number.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+				generations.push_back(stoull(number));
+				latest = max(latest, generations.back());
+			}
+		}
+	}
+
+	auto current = _file.load();
+	if (current != nullptr && current->header().generation == latest) {
+		return;
+	}
+	_file.store(open_generation(max<uint64_t>(latest, 1), _initial_capacity));
+
+	for (uint64_t generation : generations) {
+		if (generation < latest) {
+			filesystem::remove(generation_path(_dir, generation), error);
+		}
 	}
-	static void _initialise() {
-		if (tz_cache == nullptr) {
-			tz_cache = make_shared<_TzCache>();
+}
+
+optional<string> _TzCache::lookup(const string& key) {
+	for (int attempt = 0; attempt < 2; attempt++) {
+		shared_ptr<MappedFile> file = _file.load();
+		uint64_t hash = fnv1a(key);
+		uint64_t word = 0;
+		uint32_t slot = probe(*file, key, hash, word);
+		string_view stored_key;
+		string_view stored_value;
+		if (slot < file->header().capacity && word != 0 && read_record(*file, word, stored_key, stored_value)) {
+			return string(stored_value);
+		}
+		if (atomic_ref<uint32_t>(file->header().retired).load(memory_order_acquire) == 0) {
+			break;
 		}
+		open_latest();
+	}
+	return nullopt;
+}
+
+void _TzCache::store(const string& key, const string& value) {
+	if (key.size() > 0xFFFF || value.size() > 0xFFFF) {
+		throw invalid_argument("_TzCache::store: key or value too long");
+	}
+	lock_guard<mutex> guard(_write_mutex);
+
+	while (true) {
+		shared_ptr<MappedFile> file = _file.load();
+		FileLock lock(*file);
+		TzCacheHeader& header = file->header();
+		if (atomic_ref<uint32_t>(header.retired).load(memory_order_acquire) != 0) {
+			open_latest();
+			continue;
+		}
+
+		uint64_t hash = fnv1a(key);
+		uint64_t word = 0;
+		uint32_t slot = probe(*file, key, hash, word);
+		bool is_new = word == 0;
+		string_view stored_key;
+		string_view stored_value;
+		if (!is_new && read_record(*file, word, stored_key, stored_value) && stored_value == value) {
+			return;
+		}
+
+		uint64_t record_size = align8(sizeof(TzRecordHeader) + key.size() + value.size());
+		bool table_full = is_new && (uint64_t{ header.count } + 1) * 2 > header.capacity;
+		bool log_full = atomic_ref<uint64_t>(header.log_size).load(memory_order_relaxed) + record_size > header.log_capacity;
+		if (slot == header.capacity || table_full || log_full) {
+			grow(*file);
+			continue;
+		}
+		publish(*file, slot, key, value, hash, is_new);
+		return;
+	}
+}
+
+// Copies the live entries into the next generation at twice the capacity and
+// retires `file`. The caller holds `file`'s lock.
+void _TzCache::grow(MappedFile& file) {
+	const TzCacheHeader& header = file.header();
+	uint32_t capacity = header.capacity;
+	while ((uint64_t{ header.count } + 1) * 2 > capacity || file_size_for(capacity) <= file.size()) {
+		capacity *= 2;
+	}
+
+	filesystem::path next_path = generation_path(_dir, header.generation + 1);
+	error_code error;
+	// A leftover from a writer that died mid-grow is never published; start over.
+	filesystem::remove(next_path, error);
+	auto next = open_generation(header.generation + 1, capacity);
+	{
+		FileLock next_lock(*next);
+		for (uint32_t i = 0; i < header.capacity; i++) {
+			uint64_t word = slot_at(file, i).load(memory_order_acquire);
+			string_view key;
+			string_view value;
+			if (word == 0 || !read_record(file, word, key, value)) {
+				continue;
+			}
+			uint64_t hash = fnv1a(key);
+			uint64_t existing = 0;
+			uint32_t slot = probe(*next, key, hash, existing);
+			publish(*next, slot, key, value, hash, existing == 0);
+		}
+	}
+
+	atomic_ref<uint32_t>(file.header().retired).store(1, memory_order_release);
+	_file.store(next);
+	filesystem::remove(file.path(), error);
+}
+
+size_t _TzCache::size() const {
+	shared_ptr<MappedFile> file = _file.load();
+	return atomic_ref<uint32_t>(file->header().count).load(memory_order_relaxed);
+}
+
+uint32_t _TzCache::capacity() const {
+	return _file.load()->header().capacity;
+}
+
+filesystem::path _TzCache::path() const {
+	return _file.load()->path();
+}
+
+
+shared_ptr<ICache> _TzCacheManager::tz_cache;
+filesystem::path _TzCacheManager::cache_dir;
+mutex _TzCacheManager::mutex;
+
+shared_ptr<ICache> _TzCacheManager::get_tz_cache() {
+	lock_guard<std::mutex> guard(mutex);
+	if (tz_cache == nullptr) {
+		_initialise();
+	}
+	return tz_cache;
+}
+
+void _TzCacheManager::set_tz_cache_location(const filesystem::path& dir) {
+	lock_guard<std::mutex> guard(mutex);
+	cache_dir = dir;
+	tz_cache = nullptr;
+}
+
+void _TzCacheManager::_initialise() {
+	try {
+		tz_cache = make_shared<_TzCache>(cache_dir.empty() ? default_cache_dir() : cache_dir);
+	}
+	catch (const exception&) {
+		tz_cache = make_shared<_TzCacheDummy>();
 	}
-};
\ No newline at end of file
+}
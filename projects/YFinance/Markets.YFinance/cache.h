@@ -0,0 +1,102 @@
+#pragma once
+
+// Description: Ticker -> exchange timezone cache (port of yfinance's
+// cache.py _TzCache / _TzCacheManager).
+//
+// The Python original keeps this in SQLite. Here it is a memory-mapped,
+// open-addressing hash table backed by a file, so opening the cache costs
+// one mmap and no parsing:
+//
+//     [header][slots: capacity x 8 bytes][append-only record log]
+//
+//   - A record (key, value) is appended to the log once and never changed.
+//   - A slot is one 64-bit word, (hash tag << 32) | (record offset + 1),
+//     written with a release store after its record is complete. Readers
+//     only do acquire loads, so lookups take no lock, in this process or
+//     any other process mapping the same file.
+//   - Writers (store) are serialized by an in-process mutex plus an
+//     exclusive lock on the file. Updating a key appends a new record and
+//     swaps the slot; readers see either the old or the new value.
+//   - When the table passes half full, or the log runs out, the writer
+//     copies the live entries into the next generation file (twice the
+//     size), then marks the old file retired. Mappings of a retired file
+//     still work; a reader that misses on one switches to the newest file.
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+class ICache {
+public:
+	virtual ~ICache() = default;
+	virtual std::optional<std::string> lookup(const std::string& key) = 0;
+	virtual void store(const std::string& key, const std::string& value) = 0;
+};
+
+class _TzCacheDummy : public ICache {
+public:
+	std::optional<std::string> lookup(const std::string& key) override {
+		return std::nullopt;
+	}
+
+	void store(const std::string& key, const std::string& value) override {
+	}
+};
+
+class _TzCacheException : public std::runtime_error {
+public:
+	using std::runtime_error::runtime_error;
+};
+
+class MappedFile;
+
+class _TzCache : public ICache {
+public:
+	// Opens (or creates) the cache in `cache_dir`. Throws _TzCacheException
+	// if the directory or file cannot be used.
+	explicit _TzCache(std::filesystem::path cache_dir, std::uint32_t initial_capacity = 4096);
+	~_TzCache() override;
+
+	std::optional<std::string> lookup(const std::string& key) override;
+	void store(const std::string& key, const std::string& value) override;
+
+	std::size_t size() const;
+	std::uint32_t capacity() const;
+	// File currently backing the cache (changes when the table grows).
+	std::filesystem::path path() const;
+
+private:
+	std::filesystem::path _dir;
+	std::uint32_t _initial_capacity;
+
+	// Swapped atomically when the file is superseded; a lookup holds its own
+	// reference, so an old mapping outlives every reader still using it.
+	std::atomic<std::shared_ptr<MappedFile>> _file;
+	std::mutex _remap_mutex;
+	std::mutex _write_mutex;
+
+	void open_latest();
+	std::shared_ptr<MappedFile> open_generation(std::uint64_t generation, std::uint32_t capacity);
+	void grow(MappedFile& file);
+};
+
+class _TzCacheManager {
+private:
+	static std::shared_ptr<ICache> tz_cache;
+	static std::filesystem::path cache_dir;
+	static std::mutex mutex;
+
+public:
+	// Falls back to a no-op cache if the cache file cannot be opened, as the
+	// Python original does.
+	static std::shared_ptr<ICache> get_tz_cache();
+	static void set_tz_cache_location(const std::filesystem::path& dir);
+
+private:
+	static void _initialise();
+};
@@ -1,7 +1,12 @@
 
 // Description: Constants for Yahoo Finance API
+#include "const.h"
+#include "perfect_hash.h"
+
+#include <array>
 #include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 
 using namespace std;
@@ -10,429 +15,462 @@ const string& _QUERY1_URL_ = "https://query1.finance.yahoo.com";
 const string& _BASE_URL_ = "https://query2.finance.yahoo.com";
 const string& _ROOT_URL_ = "https://finance.yahoo.com";
 
-const map<string, vector<string>> fundamentals_keys = {
-    {"financials", 
-        {
-            "TaxEffectOfUnusualItems", 
-            "TaxRateForCalcs", 
-            "NormalizedEBITDA", 
-            "NormalizedDilutedEPS",
-            "NormalizedBasicEPS", 
-            "TotalUnusualItems", 
-            "TotalUnusualItemsExcludingGoodwill",
-            "NetIncomeFromContinuingOperationNetMinorityInterest", 
-            "ReconciledDepreciation",
-            "ReconciledCostOfRevenue", 
-            "EBITDA", 
-            "EBIT", 
-            "NetInterestIncome", 
-            "InterestExpense",
-            "InterestIncome", 
-            "ContinuingAndDiscontinuedDilutedEPS", 
-            "ContinuingAndDiscontinuedBasicEPS",
-            "NormalizedIncome", 
-            "NetIncomeFromContinuingAndDiscontinuedOperation", 
-            "TotalExpenses",
-            "RentExpenseSupplemental", 
-            "ReportedNormalizedDilutedEPS", 
-            "ReportedNormalizedBasicEPS",
-            "TotalOperatingIncomeAsReported", 
-            "DividendPerShare", 
-            "DilutedAverageShares", 
-            "BasicAverageShares",
-            "DilutedEPS", 
-            "DilutedEPSOtherGainsLosses", 
-            "TaxLossCarryforwardDilutedEPS",
-            "DilutedAccountingChange", 
-            "DilutedExtraordinary", 
-            "DilutedDiscontinuousOperations",
-            "DilutedContinuousOperations", 
-            "BasicEPS", 
-            "BasicEPSOtherGainsLosses", 
-            "TaxLossCarryforwardBasicEPS",
-            "BasicAccountingChange", 
-            "BasicExtraordinary", 
-            "BasicDiscontinuousOperations",
-            "BasicContinuousOperations", 
-            "DilutedNIAvailtoComStockholders", 
-            "AverageDilutionEarnings",
-            "NetIncomeCommonStockholders", 
-            "OtherunderPreferredStockDividend", 
-            "PreferredStockDividends",
-            "NetIncome", 
-            "MinorityInterests", 
-            "NetIncomeIncludingNoncontrollingInterests",
-            "NetIncomeFromTaxLossCarryforward", 
-            "NetIncomeExtraordinary", 
-            "NetIncomeDiscontinuousOperations",
-            "NetIncomeContinuousOperations", 
-            "EarningsFromEquityInterestNetOfTax", 
-            "TaxProvision",
-            "PretaxIncome", 
-            "OtherIncomeExpense", 
-            "OtherNonOperatingIncomeExpenses", 
-            "SpecialIncomeCharges",
-            "GainOnSaleOfPPE", 
-            "GainOnSaleOfBusiness", 
-            "OtherSpecialCharges", 
-            "WriteOff",
-            "ImpairmentOfCapitalAssets", 
-            "RestructuringAndMergernAcquisition", 
-            "SecuritiesAmortization",
-            "EarningsFromEquityInterest", 
-            "GainOnSaleOfSecurity", 
-            "NetNonOperatingInterestIncomeExpense",
-            "TotalOtherFinanceCost", 
-            "InterestExpenseNonOperating", 
-            "InterestIncomeNonOperating",
-            "OperatingIncome", 
-            "OperatingExpense", 
-            "OtherOperatingExpenses", 
-            "OtherTaxes",
-            "ProvisionForDoubtfulAccounts", 
-            "DepreciationAmortizationDepletionIncomeStatement",
-            "DepletionIncomeStatement", 
-            "DepreciationAndAmortizationInIncomeStatement", 
-            "Amortization",
-            "AmortizationOfIntangiblesIncomeStatement", 
-            "DepreciationIncomeStatement", 
-            "ResearchAndDevelopment",
-            "SellingGeneralAndAdministration", 
-            "SellingAndMarketingExpense", 
-            "GeneralAndAdministrativeExpense",
-            "OtherGandA", 
-            "InsuranceAndClaims", 
-            "RentAndLandingFees", 
-            "SalariesAndWages", 
-            "GrossProfit",
-            "CostOfRevenue", 
-            "TotalRevenue", 
-            "ExciseTaxes", 
-            "OperatingRevenue", 
-            "LossAdjustmentExpense",
-            "NetPolicyholderBenefitsAndClaims", 
-            "PolicyholderBenefitsGross", 
-            "PolicyholderBenefitsCeded",
-            "OccupancyAndEquipment", 
-            "ProfessionalExpenseAndContractServicesExpense", 
-            "OtherNonInterestExpense"
-        }
-    },
-    {"balance-sheet", 
-        {
-            "TreasurySharesNumber", 
-            "PreferredSharesNumber", 
-            "OrdinarySharesNumber", 
-            "ShareIssued", 
-            "NetDebt",
-            "TotalDebt", 
-            "TangibleBookValue", 
-            "InvestedCapital", 
-            "WorkingCapital", 
-            "NetTangibleAssets",
-            "CapitalLeaseObligations", 
-            "CommonStockEquity", 
-            "PreferredStockEquity", 
-            "TotalCapitalization",
-            "TotalEquityGrossMinorityInterest", 
-            "MinorityInterest", 
-            "StockholdersEquity",
-            "OtherEquityInterest", 
-            "GainsLossesNotAffectingRetainedEarnings", 
-            "OtherEquityAdjustments",
-            "FixedAssetsRevaluationReserve", 
-            "ForeignCurrencyTranslationAdjustments",
-            "MinimumPensionLiabilities", 
-            "UnrealizedGainLoss", 
-            "TreasuryStock", 
-            "RetainedEarnings",
-            "AdditionalPaidInCapital", 
-            "CapitalStock", 
-            "OtherCapitalStock", 
-            "CommonStock", 
-            "PreferredStock",
-            "TotalPartnershipCapital", 
-            "GeneralPartnershipCapital", 
-            "LimitedPartnershipCapital",
-            "TotalLiabilitiesNetMinorityInterest", 
-            "TotalNonCurrentLiabilitiesNetMinorityInterest",
-            "OtherNonCurrentLiabilities", 
-            "LiabilitiesHeldforSaleNonCurrent", 
-            "RestrictedCommonStock",
-            "PreferredSecuritiesOutsideStockEquity", 
-            "DerivativeProductLiabilities", 
-            "EmployeeBenefits",
-            "NonCurrentPensionAndOtherPostretirementBenefitPlans", 
-            "NonCurrentAccruedExpenses",
-            "DuetoRelatedPartiesNonCurrent", 
-            "TradeandOtherPayablesNonCurrent",
-            "NonCurrentDeferredLiabilities", 
-            "NonCurrentDeferredRevenue",
-            "NonCurrentDeferredTaxesLiabilities", 
-            "LongTermDebtAndCapitalLeaseObligation",
-            "LongTermCapitalLeaseObligation", 
-            "LongTermDebt", 
-            "LongTermProvisions", 
-            "CurrentLiabilities",
-            "OtherCurrentLiabilities", 
-            "CurrentDeferredLiabilities", 
-            "CurrentDeferredRevenue",
-            "CurrentDeferredTaxesLiabilities", 
-            "CurrentDebtAndCapitalLeaseObligation",
-            "CurrentCapitalLeaseObligation", 
-            "CurrentDebt", 
-            "OtherCurrentBorrowings", 
-            "LineOfCredit",
-            "CommercialPaper", 
-            "CurrentNotesPayable", 
-            "PensionandOtherPostRetirementBenefitPlansCurrent",
-            "CurrentProvisions", 
-            "PayablesAndAccruedExpenses", 
-            "CurrentAccruedExpenses", 
-            "InterestPayable",
-            "Payables", 
-            "OtherPayable", 
-            "DuetoRelatedPartiesCurrent", 
-            "DividendsPayable", 
-            "TotalTaxPayable",
-            "IncomeTaxPayable", 
-            "AccountsPayable", 
-            "TotalAssets", 
-            "TotalNonCurrentAssets",
-            "OtherNonCurrentAssets", 
-            "DefinedPensionBenefit", 
-            "NonCurrentPrepaidAssets",
-            "NonCurrentDeferredAssets", 
-            "NonCurrentDeferredTaxesAssets", 
-            "DuefromRelatedPartiesNonCurrent",
-            "NonCurrentNoteReceivables", 
-            "NonCurrentAccountsReceivable", 
-            "FinancialAssets",
-            "InvestmentsAndAdvances", 
-            "OtherInvestments", 
-            "InvestmentinFinancialAssets",
-            "HeldToMaturitySecurities", 
-            "AvailableForSaleSecurities",
-            "FinancialAssetsDesignatedasFairValueThroughProfitorLossTotal", 
-            "TradingSecurities",
-            "LongTermEquityInvestment", 
-            "InvestmentsinJointVenturesatCost",
-            "InvestmentsInOtherVenturesUnderEquityMethod", 
-            "InvestmentsinAssociatesatCost",
-            "InvestmentsinSubsidiariesatCost", 
-            "InvestmentProperties", 
-            "GoodwillAndOtherIntangibleAssets",
-            "OtherIntangibleAssets", 
-            "Goodwill", 
-            "NetPPE", 
-            "AccumulatedDepreciation", 
-            "GrossPPE", 
-            "Leases",
-            "ConstructionInProgress", 
-            "OtherProperties", 
-            "MachineryFurnitureEquipment",
-            "BuildingsAndImprovements", 
-            "LandAndImprovements", 
-            "Properties", 
-            "CurrentAssets",
-            "OtherCurrentAssets", 
-            "HedgingAssetsCurrent", 
-            "AssetsHeldForSaleCurrent", 
-            "CurrentDeferredAssets",
-            "CurrentDeferredTaxesAssets", 
-            "RestrictedCash", 
-            "PrepaidAssets", 
-            "Inventory",
-            "InventoriesAdjustmentsAllowances", 
-            "OtherInventories", 
-            "FinishedGoods", 
-            "WorkInProcess",
-            "RawMaterials", 
-            "Receivables", 
-            "ReceivablesAdjustmentsAllowances", 
-            "OtherReceivables",
-            "DuefromRelatedPartiesCurrent", 
-            "TaxesReceivable", 
-            "AccruedInterestReceivable", 
-            "NotesReceivable",
-            "LoansReceivable", 
-            "AccountsReceivable", 
-            "AllowanceForDoubtfulAccountsReceivable",
-            "GrossAccountsReceivable", 
-            "CashCashEquivalentsAndShortTermInvestments",
-            "OtherShortTermInvestments", 
-            "CashAndCashEquivalents", 
-            "CashEquivalents", 
-            "CashFinancial",
-            "CashCashEquivalentsAndFederalFundsSold"
-        }
-    },
-    {"cash-flow",
-        {
-            "ForeignSales", 
-            "DomesticSales", 
-            "AdjustedGeographySegmentData", 
-            "FreeCashFlow",
-            "RepurchaseOfCapitalStock", 
-            "RepaymentOfDebt", 
-            "IssuanceOfDebt", 
-            "IssuanceOfCapitalStock",
-            "CapitalExpenditure", 
-            "InterestPaidSupplementalData", 
-            "IncomeTaxPaidSupplementalData",
-            "EndCashPosition", 
-            "OtherCashAdjustmentOutsideChangeinCash", 
-            "BeginningCashPosition",
-            "EffectOfExchangeRateChanges", 
-            "ChangesInCash", 
-            "OtherCashAdjustmentInsideChangeinCash",
-            "CashFlowFromDiscontinuedOperation", 
-            "FinancingCashFlow", 
-            "CashFromDiscontinuedFinancingActivities",
-            "CashFlowFromContinuingFinancingActivities", 
-            "NetOtherFinancingCharges", 
-            "InterestPaidCFF",
-            "ProceedsFromStockOptionExercised", 
-            "CashDividendsPaid", 
-            "PreferredStockDividendPaid",
-            "CommonStockDividendPaid", 
-            "NetPreferredStockIssuance", 
-            "PreferredStockPayments",
-            "PreferredStockIssuance", 
-            "NetCommonStockIssuance", 
-            "CommonStockPayments", 
-            "CommonStockIssuance",
-            "NetIssuancePaymentsOfDebt", 
-            "NetShortTermDebtIssuance", 
-            "ShortTermDebtPayments",
-            "ShortTermDebtIssuance", 
-            "NetLongTermDebtIssuance", 
-            "LongTermDebtPayments", 
-            "LongTermDebtIssuance",
-            "InvestingCashFlow", 
-            "CashFromDiscontinuedInvestingActivities",
-            "CashFlowFromContinuingInvestingActivities", 
-            "NetOtherInvestingChanges", 
-            "InterestReceivedCFI",
-            "DividendsReceivedCFI", 
-            "NetInvestmentPurchaseAndSale", 
-            "SaleOfInvestment", 
-            "PurchaseOfInvestment",
-            "NetInvestmentPropertiesPurchaseAndSale", 
-            "SaleOfInvestmentProperties",
-            "PurchaseOfInvestmentProperties", 
-            "NetBusinessPurchaseAndSale", 
-            "SaleOfBusiness",
-            "PurchaseOfBusiness", 
-            "NetIntangiblesPurchaseAndSale", 
-            "SaleOfIntangibles", 
-            "PurchaseOfIntangibles",
-            "NetPPEPurchaseAndSale", 
-            "SaleOfPPE", 
-            "PurchaseOfPPE", 
-            "CapitalExpenditureReported",
-            "OperatingCashFlow", 
-            "CashFromDiscontinuedOperatingActivities",
-            "CashFlowFromContinuingOperatingActivities", 
-            "TaxesRefundPaid", 
-            "InterestReceivedCFO",
-            "InterestPaidCFO", 
-            "DividendReceivedCFO", 
-            "DividendPaidCFO", 
-            "ChangeInWorkingCapital",
-            "ChangeInOtherWorkingCapital", 
-            "ChangeInOtherCurrentLiabilities", 
-            "ChangeInOtherCurrentAssets",
-            "ChangeInPayablesAndAccruedExpense", 
-            "ChangeInAccruedExpense", 
-            "ChangeInInterestPayable",
-            "ChangeInPayable", 
-            "ChangeInDividendPayable", 
-            "ChangeInAccountPayable", 
-            "ChangeInTaxPayable",
-            "ChangeInIncomeTaxPayable", 
-            "ChangeInPrepaidAssets", 
-            "ChangeInInventory", 
-            "ChangeInReceivables",
-            "ChangesInAccountReceivables", 
-            "OtherNonCashItems", 
-            "ExcessTaxBenefitFromStockBasedCompensation",
-            "StockBasedCompensation", 
-            "UnrealizedGainLossOnInvestmentSecurities", 
-            "ProvisionandWriteOffofAssets",
-            "AssetImpairmentCharge", 
-            "AmortizationOfSecurities", 
-            "DeferredTax", 
-            "DeferredIncomeTax",
-            "DepreciationAmortizationDepletion", 
-            "Depletion", 
-            "DepreciationAndAmortization",
-            "AmortizationCashFlow", 
-            "AmortizationOfIntangibles", 
-            "Depreciation", 
-            "OperatingGainsLosses",
-            "PensionAndEmployeeBenefitExpense", 
-            "EarningsLossesFromEquityInvestments",
-            "GainLossOnInvestmentSecurities", 
-            "NetForeignCurrencyExchangeGainLoss", 
-            "GainLossOnSaleOfPPE",
-            "GainLossOnSaleOfBusiness", 
-            "NetIncomeFromContinuingOperations",
-            "CashFlowsfromusedinOperatingActivitiesDirect", 
-            "TaxesRefundPaidDirect", 
-            "InterestReceivedDirect",
-            "InterestPaidDirect", 
-            "DividendsReceivedDirect", 
-            "DividendsPaidDirect", 
-            "ClassesofCashPayments",
-            "OtherCashPaymentsfromOperatingActivities", 
-            "PaymentsonBehalfofEmployees",
-            "PaymentstoSuppliersforGoodsandServices", 
-            "ClassesofCashReceiptsfromOperatingActivities",
-            "OtherCashReceiptsfromOperatingActivities", 
-            "ReceiptsfromGovernmentGrants", 
-            "ReceiptsfromCustomers"
-        }
-    }
-};
+// fundamentals_keys: line items of the fundamentals-timeseries endpoint, by
+// statement type. Perfect-hash sets (perfect_hash.h), so validating a key
+// neither allocates nor costs anything at startup.
+constexpr StaticStringSet _FINANCIALS_KEYS_(to_array<string_view>({
+    "TaxEffectOfUnusualItems", 
+    "TaxRateForCalcs", 
+    "NormalizedEBITDA", 
+    "NormalizedDilutedEPS",
+    "NormalizedBasicEPS", 
+    "TotalUnusualItems", 
+    "TotalUnusualItemsExcludingGoodwill",
+    "NetIncomeFromContinuingOperationNetMinorityInterest", 
+    "ReconciledDepreciation",
+    "ReconciledCostOfRevenue", 
+    "EBITDA", 
+    "EBIT", 
+    "NetInterestIncome", 
+    "InterestExpense",
+    "InterestIncome", 
+    "ContinuingAndDiscontinuedDilutedEPS", 
+    "ContinuingAndDiscontinuedBasicEPS",
+    "NormalizedIncome", 
+    "NetIncomeFromContinuingAndDiscontinuedOperation", 
+    "TotalExpenses",
+    "RentExpenseSupplemental", 
+    "ReportedNormalizedDilutedEPS", 
+    "ReportedNormalizedBasicEPS",
+    "TotalOperatingIncomeAsReported", 
+    "DividendPerShare", 
+    "DilutedAverageShares", 
+    "BasicAverageShares",
+    "DilutedEPS", 
+    "DilutedEPSOtherGainsLosses", 
+    "TaxLossCarryforwardDilutedEPS",
+    "DilutedAccountingChange", 
+    "DilutedExtraordinary", 
+    "DilutedDiscontinuousOperations",
+    "DilutedContinuousOperations", 
+    "BasicEPS", 
+    "BasicEPSOtherGainsLosses", 
+    "TaxLossCarryforwardBasicEPS",
+    "BasicAccountingChange", 
+    "BasicExtraordinary", 
+    "BasicDiscontinuousOperations",
+    "BasicContinuousOperations", 
+    "DilutedNIAvailtoComStockholders", 
+    "AverageDilutionEarnings",
+    "NetIncomeCommonStockholders", 
+    "OtherunderPreferredStockDividend", 
+    "PreferredStockDividends",
+    "NetIncome", 
+    "MinorityInterests", 
+    "NetIncomeIncludingNoncontrollingInterests",
+    "NetIncomeFromTaxLossCarryforward", 
+    "NetIncomeExtraordinary", 
+    "NetIncomeDiscontinuousOperations",
+    "NetIncomeContinuousOperations", 
+    "EarningsFromEquityInterestNetOfTax", 
+    "TaxProvision",
+    "PretaxIncome", 
+    "OtherIncomeExpense", 
+    "OtherNonOperatingIncomeExpenses", 
+    "SpecialIncomeCharges",
+    "GainOnSaleOfPPE", 
+    "GainOnSaleOfBusiness", 
+    "OtherSpecialCharges", 
+    "WriteOff",
+    "ImpairmentOfCapitalAssets", 
+    "RestructuringAndMergernAcquisition", 
+    "SecuritiesAmortization",
+    "EarningsFromEquityInterest", 
+    "GainOnSaleOfSecurity", 
+    "NetNonOperatingInterestIncomeExpense",
+    "TotalOtherFinanceCost", 
+    "InterestExpenseNonOperating", 
+    "InterestIncomeNonOperating",
+    "OperatingIncome", 
+    "OperatingExpense", 
+    "OtherOperatingExpenses", 
+    "OtherTaxes",
+    "ProvisionForDoubtfulAccounts", 
+    "DepreciationAmortizationDepletionIncomeStatement",
+    "DepletionIncomeStatement", 
+    "DepreciationAndAmortizationInIncomeStatement", 
+    "Amortization",
+    "AmortizationOfIntangiblesIncomeStatement", 
+    "DepreciationIncomeStatement", 
+    "ResearchAndDevelopment",
+    "SellingGeneralAndAdministration", 
+    "SellingAndMarketingExpense", 
+    "GeneralAndAdministrativeExpense",
+    "OtherGandA", 
+    "InsuranceAndClaims", 
+    "RentAndLandingFees", 
+    "SalariesAndWages", 
+    "GrossProfit",
+    "CostOfRevenue", 
+    "TotalRevenue", 
+    "ExciseTaxes", 
+    "OperatingRevenue", 
+    "LossAdjustmentExpense",
+    "NetPolicyholderBenefitsAndClaims", 
+    "PolicyholderBenefitsGross", 
+    "PolicyholderBenefitsCeded",
+    "OccupancyAndEquipment", 
+    "ProfessionalExpenseAndContractServicesExpense", 
+    "OtherNonInterestExpense"
+}));
+
+constexpr StaticStringSet _BALANCE_SHEET_KEYS_(to_array<string_view>({
+    "TreasurySharesNumber", 
+    "PreferredSharesNumber", 
+    "OrdinarySharesNumber", 
+    "ShareIssued", 
+    "NetDebt",
+    "TotalDebt", 
+    "TangibleBookValue", 
+    "InvestedCapital", 
+    "WorkingCapital", 
+    "NetTangibleAssets",
+    "CapitalLeaseObligations", 
+    "CommonStockEquity", 
+    "PreferredStockEquity", 
+    "TotalCapitalization",
+    "TotalEquityGrossMinorityInterest", 
+    "MinorityInterest", 
+    "StockholdersEquity",
+    "OtherEquityInterest", 
+    "GainsLossesNotAffectingRetainedEarnings", 
+    "OtherEquityAdjustments",
+    "FixedAssetsRevaluationReserve", 
+    "ForeignCurrencyTranslationAdjustments",
+    "MinimumPensionLiabilities", 
+    "UnrealizedGainLoss", 
+    "TreasuryStock", 
+    "RetainedEarnings",
+    "AdditionalPaidInCapital", 
+    "CapitalStock", 
+    "OtherCapitalStock", 
+    "CommonStock", 
+    "PreferredStock",
+    "TotalPartnershipCapital", 
+    "GeneralPartnershipCapital", 
+    "LimitedPartnershipCapital",
+    "TotalLiabilitiesNetMinorityInterest", 
+    "TotalNonCurrentLiabilitiesNetMinorityInterest",
+    "OtherNonCurrentLiabilities", 
+    "LiabilitiesHeldforSaleNonCurrent", 
+    "RestrictedCommonStock",
+    "PreferredSecuritiesOutsideStockEquity", 
+    "DerivativeProductLiabilities", 
+    "EmployeeBenefits",
+    "NonCurrentPensionAndOtherPostretirementBenefitPlans", 
+    "NonCurrentAccruedExpenses",
+    "DuetoRelatedPartiesNonCurrent", 
+    "TradeandOtherPayablesNonCurrent",
+    "NonCurrentDeferredLiabilities", 
+    "NonCurrentDeferredRevenue",
+    "NonCurrentDeferredTaxesLiabilities", 
+    "LongTermDebtAndCapitalLeaseObligation",
+    "LongTermCapitalLeaseObligation", 
+    "LongTermDebt", 
+    "LongTermProvisions", 
+    "CurrentLiabilities",
+    "OtherCurrentLiabilities", 
+    "CurrentDeferredLiabilities", 
+    "CurrentDeferredRevenue",
+    "CurrentDeferredTaxesLiabilities", 
+    "CurrentDebtAndCapitalLeaseObligation",
+    "CurrentCapitalLeaseObligation", 
+    "CurrentDebt", 
+    "OtherCurrentBorrowings", 
+    "LineOfCredit",
+    "CommercialPaper", 
+    "CurrentNotesPayable", 
+    "PensionandOtherPostRetirementBenefitPlansCurrent",
+    "CurrentProvisions", 
+    "PayablesAndAccruedExpenses", 
+    "CurrentAccruedExpenses", 
+    "InterestPayable",
+    "Payables", 
+    "OtherPayable", 
+    "DuetoRelatedPartiesCurrent", 
+    "DividendsPayable", 
+    "TotalTaxPayable",
+    "IncomeTaxPayable", 
+    "AccountsPayable", 
+    "TotalAssets", 
+    "TotalNonCurrentAssets",
+    "OtherNonCurrentAssets", 
+    "DefinedPensionBenefit", 
+    "NonCurrentPrepaidAssets",
+    "NonCurrentDeferredAssets", 
+    "NonCurrentDeferredTaxesAssets", 
+    "DuefromRelatedPartiesNonCurrent",
+    "NonCurrentNoteReceivables", 
+    "NonCurrentAccountsReceivable", 
+    "FinancialAssets",
+    "InvestmentsAndAdvances", 
+    "OtherInvestments", 
+    "InvestmentinFinancialAssets",
+    "HeldToMaturitySecurities", 
+    "AvailableForSaleSecurities",
+    "FinancialAssetsDesignatedasFairValueThroughProfitorLossTotal", 
+    "TradingSecurities",
+    "LongTermEquityInvestment", 
+    "InvestmentsinJointVenturesatCost",
+    "InvestmentsInOtherVenturesUnderEquityMethod", 
+    "InvestmentsinAssociatesatCost",
+    "InvestmentsinSubsidiariesatCost", 
+    "InvestmentProperties", 
+    "GoodwillAndOtherIntangibleAssets",
+    "OtherIntangibleAssets", 
+    "Goodwill", 
+    "NetPPE", 
+    "AccumulatedDepreciation", 
+    "GrossPPE", 
+    "Leases",
+    "ConstructionInProgress", 
+    "OtherProperties", 
+    "MachineryFurnitureEquipment",
+    "BuildingsAndImprovements", 
+    "LandAndImprovements", 
+    "Properties", 
+    "CurrentAssets",
+    "OtherCurrentAssets", 
+    "HedgingAssetsCurrent", 
+    "AssetsHeldForSaleCurrent", 
+    "CurrentDeferredAssets",
+    "CurrentDeferredTaxesAssets", 
+    "RestrictedCash", 
+    "PrepaidAssets", 
+    "Inventory",
+    "InventoriesAdjustmentsAllowances", 
+    "OtherInventories", 
+    "FinishedGoods", 
+    "WorkInProcess",
+    "RawMaterials", 
+    "Receivables", 
+    "ReceivablesAdjustmentsAllowances", 
+    "OtherReceivables",
+    "DuefromRelatedPartiesCurrent", 
+    "TaxesReceivable", 
+    "AccruedInterestReceivable", 
+    "NotesReceivable",
+    "LoansReceivable", 
+    "AccountsReceivable", 
+    "AllowanceForDoubtfulAccountsReceivable",
+    "GrossAccountsReceivable", 
+    "CashCashEquivalentsAndShortTermInvestments",
+    "OtherShortTermInvestments", 
+    "CashAndCashEquivalents", 
+    "CashEquivalents", 
+    "CashFinancial",
+    "CashCashEquivalentsAndFederalFundsSold"
+}));
+
+constexpr StaticStringSet _CASH_FLOW_KEYS_(to_array<string_view>({
+    "ForeignSales", 
+    "DomesticSales", 
+    "AdjustedGeographySegmentData", 
+    "FreeCashFlow",
+    "RepurchaseOfCapitalStock", 
+    "RepaymentOfDebt", 
+    "IssuanceOfDebt", 
+    "IssuanceOfCapitalStock",
+    "CapitalExpenditure", 
+    "InterestPaidSupplementalData", 
+    "IncomeTaxPaidSupplementalData",
+    "EndCashPosition", 
+    "OtherCashAdjustmentOutsideChangeinCash", 
+    "BeginningCashPosition",
+    "EffectOfExchangeRateChanges", 
+    "ChangesInCash", 
+    "OtherCashAdjustmentInsideChangeinCash",
+    "CashFlowFromDiscontinuedOperation", 
+    "FinancingCashFlow", 
+    "CashFromDiscontinuedFinancingActivities",
+    "CashFlowFromContinuingFinancingActivities", 
+    "NetOtherFinancingCharges", 
+    "InterestPaidCFF",
+    "ProceedsFromStockOptionExercised", 
+    "CashDividendsPaid", 
+    "PreferredStockDividendPaid",
+    "CommonStockDividendPaid", 
+    "NetPreferredStockIssuance", 
+    "PreferredStockPayments",
+    "PreferredStockIssuance", 
+    "NetCommonStockIssuance", 
+    "CommonStockPayments", 
+    "CommonStockIssuance",
+    "NetIssuancePaymentsOfDebt", 
+    "NetShortTermDebtIssuance", 
+    "ShortTermDebtPayments",
+    "ShortTermDebtIssuance", 
+    "NetLongTermDebtIssuance", 
+    "LongTermDebtPayments", 
+    "LongTermDebtIssuance",
+    "InvestingCashFlow", 
+    "CashFromDiscontinuedInvestingActivities",
+    "CashFlowFromContinuingInvestingActivities", 
+    "NetOtherInvestingChanges", 
+    "InterestReceivedCFI",
+    "DividendsReceivedCFI", 
+    "NetInvestmentPurchaseAndSale", 
+    "SaleOfInvestment", 
+    "PurchaseOfInvestment",
+    "NetInvestmentPropertiesPurchaseAndSale", 
+    "SaleOfInvestmentProperties",
+    "PurchaseOfInvestmentProperties", 
+    "NetBusinessPurchaseAndSale", 
+    "SaleOfBusiness",
+    "PurchaseOfBusiness", 
+    "NetIntangiblesPurchaseAndSale", 
+    "SaleOfIntangibles", 
+    "PurchaseOfIntangibles",
+    "NetPPEPurchaseAndSale", 
+    "SaleOfPPE", 
+    "PurchaseOfPPE", 
+    "CapitalExpenditureReported",
+    "OperatingCashFlow", 
+    "CashFromDiscontinuedOperatingActivities",
+    "CashFlowFromContinuingOperatingActivities", 
+    "TaxesRefundPaid", 
+    "InterestReceivedCFO",
+    "InterestPaidCFO", 
+    "DividendReceivedCFO", 
+    "DividendPaidCFO", 
+    "ChangeInWorkingCapital",
+    "ChangeInOtherWorkingCapital", 
+    "ChangeInOtherCurrentLiabilities", 
+    "ChangeInOtherCurrentAssets",
+    "ChangeInPayablesAndAccruedExpense", 
+    "ChangeInAccruedExpense", 
+    "ChangeInInterestPayable",
+    "ChangeInPayable", 
+    "ChangeInDividendPayable", 
+    "ChangeInAccountPayable", 
+    "ChangeInTaxPayable",
+    "ChangeInIncomeTaxPayable", 
+    "ChangeInPrepaidAssets", 
+    "ChangeInInventory", 
+    "ChangeInReceivables",
+    "ChangesInAccountReceivables", 
+    "OtherNonCashItems", 
+    "ExcessTaxBenefitFromStockBasedCompensation",
+    "StockBasedCompensation", 
+    "UnrealizedGainLossOnInvestmentSecurities", 
+    "ProvisionandWriteOffofAssets",
+    "AssetImpairmentCharge", 
+    "AmortizationOfSecurities", 
+    "DeferredTax", 
+    "DeferredIncomeTax",
+    "DepreciationAmortizationDepletion", 
+    "Depletion", 
+    "DepreciationAndAmortization",
+    "AmortizationCashFlow", 
+    "AmortizationOfIntangibles", 
+    "Depreciation", 
+    "OperatingGainsLosses",
+    "PensionAndEmployeeBenefitExpense", 
+    "EarningsLossesFromEquityInvestments",
+    "GainLossOnInvestmentSecurities", 
+    "NetForeignCurrencyExchangeGainLoss", 
+    "GainLossOnSaleOfPPE",
+    "GainLossOnSaleOfBusiness", 
+    "NetIncomeFromContinuingOperations",
+    "CashFlowsfromusedinOperatingActivitiesDirect", 
+    "TaxesRefundPaidDirect", 
+    "InterestReceivedDirect",
+    "InterestPaidDirect", 
+    "DividendsReceivedDirect", 
+    "DividendsPaidDirect", 
+    "ClassesofCashPayments",
+    "OtherCashPaymentsfromOperatingActivities", 
+    "PaymentsonBehalfofEmployees",
+    "PaymentstoSuppliersforGoodsandServices", 
+    "ClassesofCashReceiptsfromOperatingActivities",
+    "OtherCashReceiptsfromOperatingActivities", 
+    "ReceiptsfromGovernmentGrants", 
+    "ReceiptsfromCustomers"
+}));
 
 const vector<string> _PRICE_COLNAMES_ = { "Open", "High", "Low", "Close", "Adj Close" };
 
-// quote_summary_valid_modules = (
-//     "summaryProfile",  # contains general information about the company
-//     "summaryDetail",  # prices + volume + market cap + etc
-//     "assetProfile",  # summaryProfile + company officers
-//     "fundProfile",
-//     "price",  # current prices
-//     "quoteType",  # quoteType
-//     "esgScores",  # Environmental, social, and governance (ESG) scores, sustainability and ethical performance of companies
-//     "incomeStatementHistory",
-//     "incomeStatementHistoryQuarterly",
-//     "balanceSheetHistory",
-//     "balanceSheetHistoryQuarterly",
-//     "cashFlowStatementHistory",
-//     "cashFlowStatementHistoryQuarterly",
-//     "defaultKeyStatistics",  # KPIs (PE, enterprise value, EPS, EBITA, and more)
-//     "financialData",  # Financial KPIs (revenue, gross margins, operating cash flow, free cash flow, and more)
-//     "calendarEvents",  # future earnings date
-//     "secFilings",  # SEC filings, such as 10K and 10Q reports
-//     "upgradeDowngradeHistory",  # upgrades and downgrades that analysts have given a company's stock
-//     "institutionOwnership",  # institutional ownership, holders and shares outstanding
-//     "fundOwnership",  # mutual fund ownership, holders and shares outstanding
-//     "majorDirectHolders",
-//     "majorHoldersBreakdown",
-//     "insiderTransactions",  # insider transactions, such as the number of shares bought and sold by company executives
-//     "insiderHolders",  # insider holders, such as the number of shares held by company executives
-//     "netSharePurchaseActivity",  # net share purchase activity, such as the number of shares bought and sold by company executives
-//     "earnings",  # earnings history
-//     "earningsHistory",
-//     "earningsTrend",  # earnings trend
-//     "industryTrend",
-//     "indexTrend",
-//     "sectorTrend",
-//     "recommendationTrend",
-//     "futuresChain",
-// )
+constexpr StaticStringSet _QUOTE_SUMMARY_VALID_MODULES_(to_array<string_view>({
+    "summaryProfile",  // contains general information about the company
+    "summaryDetail",  // prices + volume + market cap + etc
+    "assetProfile",  // summaryProfile + company officers
+    "fundProfile",
+    "price",  // current prices
+    "quoteType",  // quoteType
+    "esgScores",  // Environmental, social, and governance (ESG) scores, sustainability and ethical performance of companies
+    "incomeStatementHistory",
+    "incomeStatementHistoryQuarterly",
+    "balanceSheetHistory",
+    "balanceSheetHistoryQuarterly",
+    "cashFlowStatementHistory",
+    "cashFlowStatementHistoryQuarterly",
+    "defaultKeyStatistics",  // KPIs (PE, enterprise value, EPS, EBITA, and more)
+    "financialData",  // Financial KPIs (revenue, gross margins, operating cash flow, free cash flow, and more)
+    "calendarEvents",  // future earnings date
+    "secFilings",  // SEC filings, such as 10K and 10Q reports
+    "upgradeDowngradeHistory",  // upgrades and downgrades that analysts have given a company's stock
+    "institutionOwnership",  // institutional ownership, holders and shares outstanding
+    "fundOwnership",  // mutual fund ownership, holders and shares outstanding
+    "majorDirectHolders",
+    "majorHoldersBreakdown",
+    "insiderTransactions",  // insider transactions, such as the number of shares bought and sold by company executives
+    "insiderHolders",  // insider holders, such as the number of shares held by company executives
+    "netSharePurchaseActivity",  // net share purchase activity, such as the number of shares bought and sold by company executives
+    "earnings",  // earnings history
+    "earningsHistory",
+    "earningsTrend",  // earnings trend
+    "industryTrend",
+    "indexTrend",
+    "sectorTrend",
+    "recommendationTrend",
+    "futuresChain"
+}));
+
+
+optional<FundamentalsType> fundamentals_type(string_view name) {
+    if (name == "financials") return FundamentalsType::financials;
+    if (name == "balance-sheet") return FundamentalsType::balance_sheet;
+    if (name == "cash-flow") return FundamentalsType::cash_flow;
+    return nullopt;
+}
+
+span<const string_view> fundamentals_keys(FundamentalsType type) {
+    switch (type) {
+    case FundamentalsType::financials: return _FINANCIALS_KEYS_.keys();
+    case FundamentalsType::balance_sheet: return _BALANCE_SHEET_KEYS_.keys();
+    default: return _CASH_FLOW_KEYS_.keys();
+    }
+}
+
+optional<size_t> fundamentals_key_index(FundamentalsType type, string_view key) {
+    switch (type) {
+    case FundamentalsType::financials: return _FINANCIALS_KEYS_.index_of(key);
+    case FundamentalsType::balance_sheet: return _BALANCE_SHEET_KEYS_.index_of(key);
+    default: return _CASH_FLOW_KEYS_.index_of(key);
+    }
+}
+
+bool is_fundamentals_key(FundamentalsType type, string_view key) {
+    return fundamentals_key_index(type, key).has_value();
+}
+
+span<const string_view> quote_summary_valid_modules() {
+    return _QUOTE_SUMMARY_VALID_MODULES_.keys();
+}
+
+bool is_quote_summary_module(string_view module) {
+    return _QUOTE_SUMMARY_VALID_MODULES_.contains(module);
+}
 
 
 // # map last updated as of 2024.09.18
@@ -759,7 +797,7 @@ const map<string, vector<string>> EQUITY_SCREENER_EQ_MAP = {
     },
 };
 
-const vector<string> EQUITY_SCREENER_FIELDS = {
+constexpr StaticStringSet _EQUITY_SCREENER_FIELDS_(to_array<string_view>({
     // EQ Fields
     "region",
     "sector",
@@ -844,7 +882,7 @@ const vector<string> EQUITY_SCREENER_FIELDS = {
     "ebitdamargin.lasttwelvemonths",
     "ebit.lasttwelvemonths",
     "basicepscontinuingoperations.lasttwelvemonths",
-    "netepsbasic.lasttwelvemonths"
+    "netepsbasic.lasttwelvemonths",
     "netepsdiluted.lasttwelvemonths",
 
     // balance sheet
@@ -859,7 +897,6 @@ const vector<string> EQUITY_SCREENER_FIELDS = {
     "totalsharesoutstanding",
 
     // cash flow
-    "forward_dividend_yield",
     "leveredfreecashflow.lasttwelvemonths",
     "capitalexpenditure.lasttwelvemonths",
     "cashfromoperations.lasttwelvemonths",
@@ -872,7 +909,15 @@ const vector<string> EQUITY_SCREENER_FIELDS = {
     "governance_score",
     "social_score",
     "highest_controversy"
-};
+}));
+
+span<const string_view> equity_screener_fields() {
+    return _EQUITY_SCREENER_FIELDS_.keys();
+}
+
+bool is_equity_screener_field(string_view field) {
+    return _EQUITY_SCREENER_FIELDS_.contains(field);
+}
 
 //
 //map<string, map<>> PREDEFINED_SCREENER_BODY_MAP = {
@@ -0,0 +1,33 @@
+#pragma once
+
+// Description: Lookups into the Yahoo Finance constants in const.cpp.
+//
+// The name sets behind these (fundamentals line items, quote-summary modules,
+// screener fields) are compile-time perfect-hash tables: a check is O(1),
+// allocation-free, and the tables need no static initialization.
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string_view>
+
+enum class FundamentalsType {
+	financials,
+	balance_sheet,
+	cash_flow
+};
+
+// Parses Yahoo's statement names: "financials", "balance-sheet", "cash-flow".
+std::optional<FundamentalsType> fundamentals_type(std::string_view name);
+
+// Line items of a statement, in yfinance's order (fundamentals_keys[type]).
+std::span<const std::string_view> fundamentals_keys(FundamentalsType type);
+// Position of `key` in fundamentals_keys(type), if it is a line item of it.
+std::optional<std::size_t> fundamentals_key_index(FundamentalsType type, std::string_view key);
+bool is_fundamentals_key(FundamentalsType type, std::string_view key);
+
+std::span<const std::string_view> quote_summary_valid_modules();
+bool is_quote_summary_module(std::string_view module);
+
+std::span<const std::string_view> equity_screener_fields();
+bool is_equity_screener_field(std::string_view field);
@@ -0,0 +1,383 @@
+#include "data.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+constexpr intptr_t invalid_socket = -1;
+
+#ifdef _WIN32
+using native_socket = SOCKET;
+#else
+using native_socket = int;
+#endif
+
+native_socket native(intptr_t s) {
+	return static_cast<native_socket>(s);
+}
+
+#ifdef _WIN32
+struct WinsockInit {
+	WinsockInit() {
+		WSADATA wsa;
+		WSAStartup(MAKEWORD(2, 2), &wsa);
+	}
+	~WinsockInit() {
+		WSACleanup();
+	}
+};
+
+void close_socket(intptr_t s) {
+	closesocket(native(s));
+}
+#else
+void close_socket(intptr_t s) {
+	::close(native(s));
+}
+#endif
+
+bool starts_with_nocase(const string& text, const string& prefix) {
+	if (text.size() < prefix.size()) {
+		return false;
+	}
+	for (size_t i = 0; i < prefix.size(); i++) {
+		if (tolower(static_cast<unsigned char>(text[i])) != tolower(static_cast<unsigned char>(prefix[i]))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+string trim(const string& text) {
+	size_t first = text.find_first_not_of(" \t");
+	size_t last = text.find_last_not_of(" \t\r");
+	return first == string::npos ? string() : text.substr(first, last - first + 1);
+}
+
+}
+
+YfData::YfData(string base_url) : _base_url(std::move(base_url)), _socket(invalid_socket) {
+#ifdef _WIN32
+	static WinsockInit winsock;
+#endif
+	while (!_base_url.empty() && _base_url.back() == '/') {
+		_base_url.pop_back();
+	}
+
+	if (starts_with_nocase(_base_url, "file://")) {
+		_scheme = Scheme::file;
+		_fixture_root = filesystem::path(_base_url.substr(7));
+		return;
+	}
+	if (starts_with_nocase(_base_url, "https://")) {
+		throw invalid_argument("YfData: https is not supported by the built-in client; use an http:// mirror or a file:// fixture directory");
+	}
+	if (!starts_with_nocase(_base_url, "http://")) {
+		throw invalid_argument("YfData: unsupported base URL " + _base_url);
+	}
+
+	_scheme = Scheme::http;
+	string authority = _base_url.substr(7);
+	size_t slash = authority.find('/');
+	if (slash != string::npos) {
+		_prefix = authority.substr(slash);
+		authority.resize(slash);
+	}
+	size_t colon = authority.rfind(':');
+	if (colon != string::npos) {
+		_host = authority.substr(0, colon);
+		_port = authority.substr(colon + 1);
+	}
+	else {
+		_host = authority;
+		_port = "80";
+	}
+}
+
+YfData::~YfData() {
+	disconnect();
+}
+
+string YfData::url_encode(const string& value) {
+	static const char hex[] = "0123456789ABCDEF";
+	string encoded;
+	encoded.reserve(value.size());
+	for (unsigned char c : value) {
+		if (isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
+			encoded.push_back(static_cast<char>(c));
+		}
+		else {
+			encoded.push_back('%');
+			encoded.push_back(hex[c >> 4]);
+			encoded.push_back(hex[c & 0xF]);
+		}
+	}
+	return encoded;
+}
+
+string YfData::get(const string& path, const YfParams& params) {
+	if (_scheme == Scheme::file) {
+		return read_fixture(path);
+	}
+
+	string target = path;
+	char separator = target.find('?') == string::npos ? '?' : '&';
+	for (auto& [name, value] : params) {
+		target += separator;
+		target += url_encode(name);
+		target += '=';
+		target += url_encode(value);
+		separator = '&';
+	}
+	return http_get(target);
+}
+
+string YfData::read_fixture(const string& path) const {
+	string relative = path.substr(0, path.find('?'));
+	while (!relative.empty() && relative.front() == '/') {
+		relative.erase(relative.begin());
+	}
+	filesystem::path file = _fixture_root / (relative + ".json");
+
+	ifstream in(file, ios::binary);
+	if (!in) {
+		throw YfHttpError("YfData: no fixture at " + file.string(), 404);
+	}
+	ostringstream contents;
+	contents << in.rdbuf();
+	return contents.str();
+}
+
+string YfData::http_get(const string& target) {
+	string body;
+	int status = 0;
+	// A kept-alive connection may have been closed by the server since the
+	// last request; reconnect and retry once before giving up.
+	for (int attempt = 0; attempt < 2; attempt++) {
+		if (_socket == invalid_socket) {
+			connect();
+		}
+		if (try_http_get(target, body, status)) {
+			if (status != 200) {
+				throw YfHttpError("YfData: HTTP " + to_string(status) + " for " + target, status);
+			}
+			return body;
+		}
+		disconnect();
+	}
+	throw YfHttpError("YfData: connection to " + _host + ":" + _port + " failed");
+}
+
+bool YfData::try_http_get(const string& target, string& body, int& status) {
+	_buffer.erase(0, _buffer_pos);
+	_buffer_pos = 0;
+
+	string request = "GET " + _prefix + target + " HTTP/1.1\r\n"
+		"Host: " + _host + "\r\n"
+		"User-Agent: Mozilla/5.0\r\n"
+		"Accept: application/json\r\n"
+		"Connection: keep-alive\r\n\r\n";
+	if (!send_all(request)) {
+		return false;
+	}
+
+	string line;
+	if (!read_line(line) || !starts_with_nocase(line, "HTTP/")) {
+		return false;
+	}
+	size_t space = line.find(' ');
+	if (space == string::npos) {
+		return false;
+	}
+	from_chars(line.data() + space + 1, line.data() + line.size(), status);
+
+	bool chunked = false;
+	bool close_after = false;
+	size_t content_length = string::npos;
+	while (read_line(line) && !line.empty()) {
+		size_t colon = line.find(':');
+		if (colon == string::npos) {
+			continue;
+		}
+		string name = line.substr(0, colon);
+		string value = trim(line.substr(colon + 1));
+		if (starts_with_nocase(name, "content-length") && name.size() == 14) {
+			content_length = stoull(value);
+		}
+		else if (starts_with_nocase(name, "transfer-encoding") && starts_with_nocase(value, "chunked")) {
+			chunked = true;
+		}
+		else if (starts_with_nocase(name, "connection") && starts_with_nocase(value, "close")) {
+			close_after = true;
+		}
+	}
+
+	body.clear();
+	if (chunked) {
+		while (true) {
+			if (!read_line(line)) {
+				throw YfHttpError("YfData: truncated chunked response");
+			}
+			size_t size = 0;
+			from_chars(line.data(), line.data() + line.size(), size, 16);
+			if (size == 0) {
+				while (read_line(line) && !line.empty()) {
+				}
+				break;
+			}
+			if (!read_exact(size, body) || !read_line(line)) {
+				throw YfHttpError("YfData: truncated chunked response");
+			}
+		}
+	}
+	else if (content_length != string::npos) {
+		if (!read_exact(content_length, body)) {
+			throw YfHttpError("YfData: truncated response");
+		}
+	}
+	else {
+		// No length: the body runs until the server closes the connection.
+		body.append(_buffer, _buffer_pos);
+		_buffer.clear();
+		_buffer_pos = 0;
+		while (fill_buffer()) {
+			body += _buffer;
+			_buffer.clear();
+		}
+		close_after = true;
+	}
+
+	if (close_after) {
+		disconnect();
+	}
+	return true;
+}
+
+void YfData::connect() {
+	addrinfo hints{};
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	addrinfo* addresses = nullptr;
+	if (getaddrinfo(_host.c_str(), _port.c_str(), &hints, &addresses) != 0) {
+		throw YfHttpError("YfData: cannot resolve " + _host);
+	}
+
+	for (addrinfo* address = addresses; address != nullptr; address = address->ai_next) {
+		auto s = static_cast<intptr_t>(::socket(address->ai_family, address->ai_socktype, address->ai_protocol));
+		if (s == invalid_socket) {
+			continue;
+		}
+		if (::connect(native(s), address->ai_addr, static_cast<int>(address->ai_addrlen)) == 0) {
+			int nodelay = 1;
+			setsockopt(native(s), IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&nodelay), sizeof(nodelay));
+#ifdef _WIN32
+			DWORD timeout = 30000;
+#else
+			timeval timeout{ 30, 0 };
+#endif
+			setsockopt(native(s), SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+			_socket = s;
+			break;
+		}
+		close_socket(s);
+	}
+	freeaddrinfo(addresses);
+
+	if (_socket == invalid_socket) {
+		throw YfHttpError("YfData: cannot connect to " + _host + ":" + _port);
+	}
+	_connections_opened++;
+	_buffer.clear();
+	_buffer_pos = 0;
+}
+
+void YfData::disconnect() {
+	if (_socket != invalid_socket) {
+		close_socket(_socket);
+		_socket = invalid_socket;
+	}
+	_buffer.clear();
+	_buffer_pos = 0;
+}
+
+bool YfData::send_all(const string& data) {
+	size_t sent = 0;
+	while (sent < data.size()) {
+#ifdef _WIN32
+		int n = ::send(native(_socket), data.data() + sent, static_cast<int>(data.size() - sent), 0);
+#else
+		auto n = ::send(native(_socket), data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+#endif
+		if (n <= 0) {
+			return false;
+		}
+		sent += static_cast<size_t>(n);
+	}
+	return true;
+}
+
+// Appends the next read to _buffer; false once the peer has closed.
+bool YfData::fill_buffer() {
+	if (_socket == invalid_socket) {
+		return false;
+	}
+	char chunk[16384];
+#ifdef _WIN32
+	int n = ::recv(native(_socket), chunk, sizeof(chunk), 0);
+#else
+	auto n = ::recv(native(_socket), chunk, sizeof(chunk), 0);
+#endif
+	if (n <= 0) {
+		return false;
+	}
+	if (_buffer_pos > 0 && _buffer_pos == _buffer.size()) {
+		_buffer.clear();
+		_buffer_pos = 0;
+	}
+	_buffer.append(chunk, static_cast<size_t>(n));
+	return true;
+}
+
+bool YfData::read_line(string& line) {
+	while (true) {
+		size_t end = _buffer.find("\r\n", _buffer_pos);
+		if (end != string::npos) {
+			line.assign(_buffer, _buffer_pos, end - _buffer_pos);
+			_buffer_pos = end + 2;
+			return true;
+		}
+		if (!fill_buffer()) {
+			return false;
+		}
+	}
+}
+
+bool YfData::read_exact(size_t count, string& out) {
+	while (_buffer.size() - _buffer_pos < count) {
+		if (!fill_buffer()) {
+			return false;
+		}
+	}
+	out.append(_buffer, _buffer_pos, count);
+	_buffer_pos += count;
+	return true;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+// Description: HTTP transport for Yahoo Finance requests (port of yfinance's
+// data.py YfData).
+//
+// One YfData owns one keep-alive connection and is not thread safe; give each
+// worker its own instance. The base URL decides where requests go:
+//
+//     http://host[:port]   plain HTTP/1.1, e.g. a local mirror or mock server
+//                          serving recorded Yahoo responses.
+//     file:///some/dir     fixtures on disk: "/v8/finance/chart/AAPL?..." is
+//                          read from "/some/dir/v8/finance/chart/AAPL.json".
+//
+// https:// URLs are rejected: the built-in client does not do TLS.
+
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+class YfHttpError : public std::runtime_error {
+public:
+	YfHttpError(const std::string& message, int status = 0)
+		: std::runtime_error(message), status(status) {
+	}
+
+	int status;
+};
+
+using YfParams = std::vector<std::pair<std::string, std::string>>;
+
+class YfData {
+public:
+	explicit YfData(std::string base_url = "https://query2.finance.yahoo.com");
+	~YfData();
+
+	YfData(const YfData&) = delete;
+	YfData& operator=(const YfData&) = delete;
+
+	const std::string& base_url() const { return _base_url; }
+
+	// GET base_url + path with the url-encoded params; returns the body.
+	// Throws YfHttpError on a transport failure or a non-200 status.
+	std::string get(const std::string& path, const YfParams& params = {});
+
+	// Number of TCP connections opened so far (keep-alive reuses one).
+	std::size_t connections_opened() const { return _connections_opened; }
+
+	static std::string url_encode(const std::string& value);
+
+private:
+	enum class Scheme { http, file };
+
+	std::string _base_url;
+	Scheme _scheme;
+	std::string _host;
+	std::string _port;
+	std::string _prefix;
+	std::filesystem::path _fixture_root;
+
+	std::intptr_t _socket;
+	std::size_t _connections_opened = 0;
+	std::string _buffer;
+	std::size_t _buffer_pos = 0;
+
+	std::string read_fixture(const std::string& path) const;
+	std::string http_get(const std::string& target);
+	bool try_http_get(const std::string& target, std::string& body, int& status);
+
+	void connect();
+	void disconnect();
+	bool send_all(const std::string& data);
+	bool fill_buffer();
+	bool read_line(std::string& line);
+	bool read_exact(std::size_t count, std::string& out);
+};
@@ -0,0 +1,301 @@
+#include "fundamentals.h"
+
+#include "data.h"
+#include "json.h"
+#include "multi.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <exception>
+#include <initializer_list>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+constexpr size_t no_series = numeric_limits<size_t>::max();
+
+// "2023-09-30" -> seconds since the epoch at UTC midnight.
+optional<int64_t> parse_as_of_date(string_view text) {
+	int y = 0;
+	unsigned m = 0;
+	unsigned d = 0;
+	if (text.size() != 10 || text[4] != '-' || text[7] != '-'
+		|| from_chars(text.data(), text.data() + 4, y).ptr != text.data() + 4
+		|| from_chars(text.data() + 5, text.data() + 7, m).ptr != text.data() + 7
+		|| from_chars(text.data() + 8, text.data() + 10, d).ptr != text.data() + 10) {
+		return nullopt;
+	}
+	chrono::year_month_day date{ chrono::year{ y }, chrono::month{ m }, chrono::day{ d } };
+	if (!date.ok()) {
+		return nullopt;
+	}
+	return chrono::duration_cast<chrono::seconds>(chrono::sys_days{ date }.time_since_epoch()).count();
+}
+
+string timescale_prefix(FundamentalsType type, const string& freq) {
+	if (freq == "yearly") {
+		return "annual";
+	}
+	if (freq == "quarterly") {
+		return "quarterly";
+	}
+	if (freq == "trailing" && type != FundamentalsType::balance_sheet) {
+		return "trailing";
+	}
+	throw invalid_argument("Financials: unsupported freq '" + freq + "' for this statement");
+}
+
+}
+
+// SAX handler for fundamentals-timeseries responses:
+//
+//     {"timeseries": {"result": [
+//         {"meta": {...}, "timestamp": [...],
+//          "annualTotalRevenue": [{"asOfDate": "2023-09-30", "currencyCode": "USD",
+//                                  "reportedValue": {"raw": 383285000000, "fmt": "383.29B"}}, null, ...]},
+//         ...]}}
+//
+// A series array is matched to its matrix column once, when it opens; each
+// point is written when its object closes.
+class TimeseriesJsonHandler {
+public:
+	TimeseriesJsonHandler(FinancialStatement& statement, string_view prefix) : statement(statement), prefix(prefix) {
+	}
+
+	std::string error;
+
+	void start_object() {
+		frames.push_back({ false, {} });
+		if (in_point()) {
+			point_date.reset();
+			point_value.reset();
+		}
+	}
+
+	void end_object() {
+		if (in_point() && point_date && point_value) {
+			statement.set(*point_date, series, *point_value);
+		}
+		frames.pop_back();
+	}
+
+	void start_array() {
+		if (series == no_series && !frames.empty() && !frames.back().is_array) {
+			const std::string& name = frames.back().key;
+			if (name.starts_with(prefix) && path_is({ "timeseries", "result", name })) {
+				if (optional<size_t> column = fundamentals_key_index(statement._type, string_view(name).substr(prefix.size()))) {
+					series = *column;
+					series_depth = frames.size();
+				}
+			}
+		}
+		frames.push_back({ true, {} });
+	}
+
+	void end_array() {
+		frames.pop_back();
+		if (series != no_series && frames.size() == series_depth) {
+			series = no_series;
+		}
+	}
+
+	void key(string_view name) {
+		frames.back().key.assign(name);
+	}
+
+	void string(string_view value) {
+		if (in_point()) {
+			const std::string& name = frames.back().key;
+			if (name == "asOfDate") {
+				point_date = parse_as_of_date(value);
+			}
+			else if (name == "currencyCode" && statement._currency.empty()) {
+				statement._currency = value;
+			}
+		}
+		else if (series == no_series && !frames.empty() && !frames.back().is_array
+			&& (path_is({ "timeseries", "error", "description" }) || path_is({ "finance", "error", "description" }))) {
+			error = value;
+		}
+	}
+
+	void number(double value) {
+		// {"reportedValue": {"raw": ...}} directly inside a point.
+		if (series != no_series && frames.size() == series_depth + 3 && frames.back().key == "raw"
+			&& frames[series_depth + 1].key == "reportedValue") {
+			point_value = value;
+		}
+	}
+
+	void boolean(bool) {
+	}
+
+	void null() {
+	}
+
+private:
+	struct Frame {
+		bool is_array;
+		std::string key;
+	};
+
+	FinancialStatement& statement;
+	string_view prefix;
+	vector<Frame> frames;
+
+	// Column of the series being read and the index of its array frame.
+	size_t series = no_series;
+	size_t series_depth = 0;
+	optional<int64_t> point_date;
+	optional<double> point_value;
+
+	bool in_point() const {
+		return series != no_series && frames.size() == series_depth + 2;
+	}
+
+	// True when the keys of the enclosing objects (ignoring arrays) are
+	// exactly `keys`, outermost first.
+	bool path_is(initializer_list<string_view> keys) const {
+		auto expected = keys.begin();
+		for (const Frame& frame : frames) {
+			if (frame.is_array) {
+				continue;
+			}
+			if (expected == keys.end() || frame.key != *expected) {
+				return false;
+			}
+			++expected;
+		}
+		return expected == keys.end();
+	}
+};
+
+FinancialStatement::FinancialStatement(FundamentalsType type) : _type(type) {
+}
+
+double FinancialStatement::at(size_t row, string_view line_item) const {
+	optional<size_t> column = fundamentals_key_index(_type, line_item);
+	return column ? at(row, *column) : numeric_limits<double>::quiet_NaN();
+}
+
+void FinancialStatement::set(int64_t period, size_t line_item, double value) {
+	size_t columns = line_items().size();
+	// A statement has a handful of periods; a scan beats any index.
+	auto found = find(_periods.rbegin(), _periods.rend(), period);
+	size_t row;
+	if (found == _periods.rend()) {
+		row = _periods.size();
+		_periods.push_back(period);
+		_values.resize(_values.size() + columns, numeric_limits<double>::quiet_NaN());
+	}
+	else {
+		row = static_cast<size_t>(_periods.rend() - found) - 1;
+	}
+	_values[row * columns + line_item] = value;
+}
+
+void FinancialStatement::sort_periods() {
+	size_t columns = line_items().size();
+	vector<size_t> order(_periods.size());
+	iota(order.begin(), order.end(), size_t{ 0 });
+	sort(order.begin(), order.end(), [&](size_t a, size_t b) { return _periods[a] > _periods[b]; });
+	if (is_sorted(order.begin(), order.end())) {
+		return;
+	}
+
+	vector<int64_t> periods(order.size());
+	vector<double> values(_values.size());
+	for (size_t row = 0; row < order.size(); row++) {
+		periods[row] = _periods[order[row]];
+		copy_n(_values.begin() + order[row] * columns, columns, values.begin() + row * columns);
+	}
+	_periods = std::move(periods);
+	_values = std::move(values);
+}
+
+FinancialStatement FinancialStatement::parse_timeseries_json(string_view json, FundamentalsType type, string_view prefix) {
+	FinancialStatement statement(type);
+	TimeseriesJsonHandler handler(statement, prefix);
+	json_sax_parse(json, handler);
+	if (!handler.error.empty()) {
+		throw runtime_error("Yahoo timeseries error: " + handler.error);
+	}
+	statement.sort_periods();
+	return statement;
+}
+
+
+Financials::Financials(YfData& data, string symbol) : _data(data), _symbol(std::move(symbol)) {
+}
+
+const FinancialStatement& Financials::get_income_time_series(const string& freq) {
+	return get(FundamentalsType::financials, freq);
+}
+
+const FinancialStatement& Financials::get_balance_sheet_time_series(const string& freq) {
+	return get(FundamentalsType::balance_sheet, freq);
+}
+
+const FinancialStatement& Financials::get_cash_flow_time_series(const string& freq) {
+	return get(FundamentalsType::cash_flow, freq);
+}
+
+const FinancialStatement& Financials::get(FundamentalsType type, const string& freq) {
+	auto key = make_pair(type, freq);
+	auto found = _cache.find(key);
+	if (found == _cache.end()) {
+		found = _cache.emplace(key, fetch(_data, _symbol, type, freq)).first;
+	}
+	return found->second;
+}
+
+FinancialStatement Financials::fetch(YfData& data, const string& symbol, FundamentalsType type, const string& freq) {
+	string prefix = timescale_prefix(type, freq);
+	string types;
+	for (string_view key : fundamentals_keys(type)) {
+		if (!types.empty()) {
+			types += ',';
+		}
+		types += prefix;
+		types += key;
+	}
+
+	// Same window as yfinance: from the end of 2016 until now.
+	int64_t period1 = 1483142400;
+	int64_t period2 = chrono::duration_cast<chrono::seconds>(chrono::system_clock::now().time_since_epoch()).count();
+	string body = data.get("/ws/fundamentals-timeseries/v1/finance/timeseries/" + YfData::url_encode(symbol), {
+		{ "symbol", symbol }, { "type", types }, { "period1", to_string(period1) }, { "period2", to_string(period2) } });
+	return FinancialStatement::parse_timeseries_json(body, type, prefix);
+}
+
+
+FinancialsBatch download_financials(const vector<string>& tickers, FundamentalsType type, const string& freq,
+	const string& base_url, size_t threads) {
+	// Validate freq once, up front, rather than failing every symbol.
+	timescale_prefix(type, freq);
+
+	FinancialsBatch batch;
+	batch.symbols = normalize_symbols(tickers);
+	batch.statements.assign(batch.symbols.size(), FinancialStatement(type));
+	vector<string> errors(batch.symbols.size());
+	run_session_workers(batch.symbols.size(), threads, base_url, [&](YfData& data, size_t i) {
+		try {
+			batch.statements[i] = Financials::fetch(data, batch.symbols[i], type, freq);
+		}
+		catch (const exception& e) {
+			errors[i] = e.what();
+		}
+	});
+
+	for (size_t i = 0; i < batch.symbols.size(); i++) {
+		if (!errors[i].empty()) {
+			batch.errors.emplace(batch.symbols[i], std::move(errors[i]));
+		}
+	}
+	return batch;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+// Description: Financial statements (port of yfinance's
+// scrapers/fundamentals.py Financials).
+//
+// Statements come from the fundamentals-timeseries endpoint, which returns
+// one series per requested line item ("annualTotalRevenue", ...), each a list
+// of {asOfDate, reportedValue} points. The decoder streams the JSON (json.h)
+// and writes every point straight into a dense period x line-item matrix of
+// doubles; there is no intermediate document. Columns follow
+// fundamentals_keys(type) order, so a line item's column index comes from
+// the perfect-hash table in const.h. Line items Yahoo did not report are NaN.
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "const.h"
+
+class YfData;
+
+class FinancialStatement {
+public:
+	explicit FinancialStatement(FundamentalsType type = FundamentalsType::financials);
+
+	FundamentalsType type() const { return _type; }
+	bool empty() const { return _periods.empty(); }
+	// Currency of the reported values (e.g. "USD"), empty if none were reported.
+	const std::string& currency() const { return _currency; }
+
+	// Matrix columns: the statement's line items.
+	std::span<const std::string_view> line_items() const { return fundamentals_keys(_type); }
+	// Matrix rows: as-of dates (UTC midnight, seconds since the epoch), newest first.
+	std::span<const std::int64_t> periods() const { return _periods; }
+
+	// Row-major values, periods().size() x line_items().size().
+	std::span<const double> values() const { return _values; }
+	std::span<const double> period(std::size_t row) const {
+		return std::span<const double>(_values).subspan(row * line_items().size(), line_items().size());
+	}
+	double at(std::size_t row, std::size_t line_item) const { return _values[row * line_items().size() + line_item]; }
+	// NaN when `line_item` is not part of this statement or was not reported.
+	double at(std::size_t row, std::string_view line_item) const;
+
+	// Decodes a fundamentals-timeseries response for series named
+	// `prefix` + line item ("annual", "quarterly" or "trailing"). Series of
+	// other statements or timescales are skipped. Throws JsonParseError on
+	// malformed JSON and std::runtime_error when Yahoo reports an error.
+	static FinancialStatement parse_timeseries_json(std::string_view json, FundamentalsType type, std::string_view prefix);
+
+private:
+	friend class TimeseriesJsonHandler;
+
+	FundamentalsType _type;
+	std::string _currency;
+	std::vector<std::int64_t> _periods;
+	std::vector<double> _values;
+
+	void set(std::int64_t period, std::size_t line_item, double value);
+	void sort_periods();
+};
+
+class Financials {
+public:
+	Financials(YfData& data, std::string symbol);
+
+	// `freq` is "yearly", "quarterly" or "trailing" (income and cash flow
+	// only), as in yfinance. Results are cached per statement and freq.
+	const FinancialStatement& get_income_time_series(const std::string& freq = "yearly");
+	const FinancialStatement& get_balance_sheet_time_series(const std::string& freq = "yearly");
+	const FinancialStatement& get_cash_flow_time_series(const std::string& freq = "yearly");
+
+	// Fetches and decodes one statement without caching.
+	static FinancialStatement fetch(YfData& data, const std::string& symbol, FundamentalsType type, const std::string& freq);
+
+private:
+	YfData& _data;
+	std::string _symbol;
+	std::map<std::pair<FundamentalsType, std::string>, FinancialStatement> _cache;
+
+	const FinancialStatement& get(FundamentalsType type, const std::string& freq);
+};
+
+struct FinancialsBatch {
+	std::vector<std::string> symbols;
+	// statements[i] belongs to symbols[i]; empty when it failed.
+	std::vector<FinancialStatement> statements;
+	// Symbol -> reason, for symbols that could not be fetched or decoded.
+	std::map<std::string, std::string> errors;
+};
+
+// Fetches one statement for many tickers, `threads` requests at a time.
+FinancialsBatch download_financials(const std::vector<std::string>& tickers, FundamentalsType type,
+	const std::string& freq = "yearly", const std::string& base_url = "https://query2.finance.yahoo.com", std::size_t threads = 8);
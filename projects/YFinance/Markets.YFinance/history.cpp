@@ -0,0 +1,248 @@
+#include "history.h"
+
+#include "data.h"
+#include "json.h"
+
+#include <fstream>
+#include <initializer_list>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+// SAX handler for /v8/finance/chart responses. Each array is bound to its
+// destination column once, when it opens, so elements are appended without
+// any per-value key lookups.
+class ChartJsonHandler {
+public:
+	explicit ChartJsonHandler(PriceColumns& columns) : columns(columns) {
+	}
+
+	std::string error;
+
+	void start_object() {
+		frames.push_back({ false, {}, nullptr, nullptr });
+	}
+
+	void end_object() {
+		frames.pop_back();
+	}
+
+	void start_array() {
+		Frame frame{ true, {}, nullptr, nullptr };
+		if (!frames.empty() && !frames.back().is_array) {
+			const std::string& name = frames.back().key;
+			if (path_is({ "chart", "result", "timestamp" })) {
+				frame.integers = &columns._timestamp;
+			}
+			else if (path_is({ "chart", "result", "indicators", "quote", name })) {
+				if (name == "open") frame.doubles = &columns._open;
+				else if (name == "high") frame.doubles = &columns._high;
+				else if (name == "low") frame.doubles = &columns._low;
+				else if (name == "close") frame.doubles = &columns._close;
+				else if (name == "volume") frame.integers = &columns._volume;
+			}
+			else if (path_is({ "chart", "result", "indicators", "adjclose", "adjclose" })) {
+				frame.doubles = &columns._adj_close;
+			}
+		}
+		frames.push_back(std::move(frame));
+	}
+
+	void end_array() {
+		frames.pop_back();
+	}
+
+	void key(string_view name) {
+		frames.back().key.assign(name);
+	}
+
+	void string(string_view value) {
+		if (frames.empty() || frames.back().is_array) {
+			return;
+		}
+		const std::string& name = frames.back().key;
+		if (path_is({ "chart", "result", "meta", name })) {
+			PriceHistoryMetadata& meta = columns._metadata;
+			if (name == "symbol") meta.symbol = value;
+			else if (name == "currency") meta.currency = value;
+			else if (name == "exchangeName") meta.exchange_name = value;
+			else if (name == "exchangeTimezoneName") meta.exchange_timezone_name = value;
+			else if (name == "instrumentType") meta.instrument_type = value;
+			else if (name == "dataGranularity") meta.data_granularity = value;
+			else if (name == "range") meta.range = value;
+		}
+		else if (path_is({ "chart", "error", "description" }) || path_is({ "finance", "error", "description" })) {
+			error = value;
+		}
+	}
+
+	void number(double value) {
+		if (frames.empty()) {
+			return;
+		}
+		Frame& frame = frames.back();
+		if (frame.doubles != nullptr) {
+			frame.doubles->push_back(value);
+		}
+		else if (frame.integers != nullptr) {
+			frame.integers->push_back(static_cast<int64_t>(value));
+		}
+		else if (!frame.is_array && path_is({ "chart", "result", "meta", frame.key })) {
+			if (frame.key == "gmtoffset") columns._metadata.gmtoffset = static_cast<int64_t>(value);
+			else if (frame.key == "regularMarketPrice") columns._metadata.regular_market_price = value;
+		}
+	}
+
+	void boolean(bool) {
+	}
+
+	void null() {
+		if (frames.empty()) {
+			return;
+		}
+		Frame& frame = frames.back();
+		if (frame.doubles != nullptr) {
+			frame.doubles->push_back(numeric_limits<double>::quiet_NaN());
+		}
+		else if (frame.integers != nullptr) {
+			frame.integers->push_back(0);
+		}
+	}
+
+private:
+	struct Frame {
+		bool is_array;
+		std::string key;
+		vector<double>* doubles;
+		vector<int64_t>* integers;
+	};
+
+	PriceColumns& columns;
+	vector<Frame> frames;
+
+	// True when the keys of the enclosing objects (ignoring arrays) are
+	// exactly `keys`, outermost first.
+	bool path_is(initializer_list<string_view> keys) const {
+		auto expected = keys.begin();
+		for (const Frame& frame : frames) {
+			if (frame.is_array) {
+				continue;
+			}
+			if (expected == keys.end() || frame.key != *expected) {
+				return false;
+			}
+			++expected;
+		}
+		return expected == keys.end();
+	}
+};
+
+void PriceColumns::reserve(size_t rows) {
+	_timestamp.reserve(rows);
+	_open.reserve(rows);
+	_high.reserve(rows);
+	_low.reserve(rows);
+	_close.reserve(rows);
+	_adj_close.reserve(rows);
+	_volume.reserve(rows);
+}
+
+void PriceColumns::clear() {
+	_timestamp.clear();
+	_open.clear();
+	_high.clear();
+	_low.clear();
+	_close.clear();
+	_adj_close.clear();
+	_volume.clear();
+	_metadata = {};
+}
+
+void PriceColumns::append(int64_t timestamp, double open, double high, double low, double close, double adj_close, int64_t volume) {
+	_timestamp.push_back(timestamp);
+	_open.push_back(open);
+	_high.push_back(high);
+	_low.push_back(low);
+	_close.push_back(close);
+	_adj_close.push_back(adj_close);
+	_volume.push_back(volume);
+}
+
+void PriceColumns::append(const PriceColumns& other) {
+	_timestamp.insert(_timestamp.end(), other._timestamp.begin(), other._timestamp.end());
+	_open.insert(_open.end(), other._open.begin(), other._open.end());
+	_high.insert(_high.end(), other._high.begin(), other._high.end());
+	_low.insert(_low.end(), other._low.begin(), other._low.end());
+	_close.insert(_close.end(), other._close.begin(), other._close.end());
+	_adj_close.insert(_adj_close.end(), other._adj_close.begin(), other._adj_close.end());
+	_volume.insert(_volume.end(), other._volume.begin(), other._volume.end());
+}
+
+void PriceColumns::complete_columns() {
+	// Quotes without a value for a field come back without that array at all;
+	// intraday charts have no adjclose (it equals close).
+	size_t rows = _timestamp.size();
+	if (_adj_close.empty()) {
+		_adj_close = _close;
+	}
+	for (vector<double>* column : { &_open, &_high, &_low, &_close, &_adj_close }) {
+		if (column->empty()) {
+			column->assign(rows, numeric_limits<double>::quiet_NaN());
+		}
+		if (column->size() != rows) {
+			throw runtime_error("Yahoo chart response: price column length does not match the timestamps");
+		}
+	}
+	if (_volume.empty()) {
+		_volume.assign(rows, 0);
+	}
+	if (_volume.size() != rows) {
+		throw runtime_error("Yahoo chart response: volume column length does not match the timestamps");
+	}
+}
+
+PriceColumns PriceColumns::parse_chart_json(string_view json) {
+	PriceColumns columns;
+	ChartJsonHandler handler(columns);
+	json_sax_parse(json, handler);
+	if (!handler.error.empty()) {
+		throw runtime_error("Yahoo chart error: " + handler.error);
+	}
+
+	columns.complete_columns();
+	return columns;
+}
+
+PriceColumns PriceColumns::load_chart_file(const filesystem::path& path) {
+	ifstream in(path, ios::binary);
+	if (!in) {
+		throw runtime_error("cannot open chart file " + path.string());
+	}
+	ostringstream contents;
+	contents << in.rdbuf();
+	return parse_chart_json(contents.str());
+}
+
+
+PriceHistory::PriceHistory(YfData& data, string ticker) : _data(data), _ticker(std::move(ticker)) {
+}
+
+const PriceColumns& PriceHistory::history(const string& period, const string& interval, bool prepost) {
+	return fetch({ { "range", period } }, interval, prepost);
+}
+
+const PriceColumns& PriceHistory::history(int64_t start, int64_t end, const string& interval, bool prepost) {
+	return fetch({ { "period1", to_string(start) }, { "period2", to_string(end) } }, interval, prepost);
+}
+
+const PriceColumns& PriceHistory::fetch(vector<pair<string, string>> params, const string& interval, bool prepost) {
+	params.emplace_back("interval", interval);
+	params.emplace_back("includePrePost", prepost ? "true" : "false");
+	params.emplace_back("events", "div,splits,capitalGains");
+
+	string body = _data.get("/v8/finance/chart/" + YfData::url_encode(_ticker), params);
+	_history = PriceColumns::parse_chart_json(body);
+	return _history;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+// Description: Price history (port of yfinance's scrapers/history.py).
+//
+// Bars are stored column-wise: one contiguous array per field rather than a
+// row of fields per bar, so an indicator that only needs closes streams over
+// a single dense array of doubles (and vectorizes). Columns are exposed as
+// read-only std::span views over the store; they are invalidated by anything
+// that grows or clears it.
+//
+// Missing prices in Yahoo's chart JSON (null entries) are stored as NaN and
+// missing volumes as 0.
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class YfData;
+
+struct PriceHistoryMetadata {
+	std::string symbol;
+	std::string currency;
+	std::string exchange_name;
+	std::string exchange_timezone_name;
+	std::string instrument_type;
+	std::string data_granularity;
+	std::string range;
+	std::int64_t gmtoffset = 0;
+	double regular_market_price = 0.0;
+};
+
+class PriceColumns {
+public:
+	std::size_t size() const { return _timestamp.size(); }
+	bool empty() const { return _timestamp.empty(); }
+
+	// Bar open time, seconds since the Unix epoch (UTC).
+	std::span<const std::int64_t> timestamp() const { return _timestamp; }
+	std::span<const double> open() const { return _open; }
+	std::span<const double> high() const { return _high; }
+	std::span<const double> low() const { return _low; }
+	std::span<const double> close() const { return _close; }
+	std::span<const double> adj_close() const { return _adj_close; }
+	std::span<const std::int64_t> volume() const { return _volume; }
+
+	const PriceHistoryMetadata& metadata() const { return _metadata; }
+	PriceHistoryMetadata& metadata() { return _metadata; }
+
+	void reserve(std::size_t rows);
+	void clear();
+	void append(std::int64_t timestamp, double open, double high, double low, double close, double adj_close, std::int64_t volume);
+	// Appends all rows of `other` (metadata is left unchanged).
+	void append(const PriceColumns& other);
+
+	// Decodes a /v8/finance/chart response. Throws JsonParseError on malformed
+	// JSON and std::runtime_error when Yahoo reports an error or the columns
+	// disagree in length.
+	static PriceColumns parse_chart_json(std::string_view json);
+	static PriceColumns load_chart_file(const std::filesystem::path& path);
+
+private:
+	friend class ChartJsonHandler;
+	friend class SparkJsonHandler;
+
+	// Fills columns Yahoo omitted and checks they all match the timestamps.
+	void complete_columns();
+
+	std::vector<std::int64_t> _timestamp;
+	std::vector<double> _open;
+	std::vector<double> _high;
+	std::vector<double> _low;
+	std::vector<double> _close;
+	std::vector<double> _adj_close;
+	std::vector<std::int64_t> _volume;
+	PriceHistoryMetadata _metadata;
+};
+
+class PriceHistory {
+public:
+	PriceHistory(YfData& data, std::string ticker);
+
+	// Fetches bars for a Yahoo range ("1d", "5d", "1mo", ..., "max") and
+	// interval ("1m", ..., "1d", "1wk", "1mo") and caches them.
+	const PriceColumns& history(const std::string& period = "1mo", const std::string& interval = "1d", bool prepost = false);
+	// Same, for [start, end) in seconds since the epoch.
+	const PriceColumns& history(std::int64_t start, std::int64_t end, const std::string& interval = "1d", bool prepost = false);
+
+	// Last result of history(), empty before the first call.
+	const PriceColumns& get_history_cache() const { return _history; }
+	const PriceHistoryMetadata& get_history_metadata() const { return _history.metadata(); }
+
+private:
+	YfData& _data;
+	std::string _ticker;
+	PriceColumns _history;
+
+	const PriceColumns& fetch(std::vector<std::pair<std::string, std::string>> params, const std::string& interval, bool prepost);
+};
@@ -0,0 +1,271 @@
+#pragma once
+
+// Description: SAX-style JSON reader for Yahoo Finance responses.
+//
+// The parser walks the text once and reports each token to a handler, so
+// callers decode straight into their own storage without building a DOM.
+// A handler provides:
+//
+//     void start_object();  void end_object();
+//     void start_array();   void end_array();
+//     void key(std::string_view name);
+//     void string(std::string_view value);
+//     void number(double value);
+//     void boolean(bool value);
+//     void null();
+//
+// String views point into the input when the string has no escapes and into
+// a scratch buffer otherwise; either way they are only valid for the
+// duration of the callback.
+
+#include <charconv>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+class JsonParseError : public std::runtime_error {
+public:
+	JsonParseError(const std::string& message, std::size_t offset)
+		: std::runtime_error("JSON parse error at offset " + std::to_string(offset) + ": " + message), offset(offset) {
+	}
+
+	std::size_t offset;
+};
+
+template <typename Handler>
+class JsonSaxParser {
+public:
+	JsonSaxParser(std::string_view text, Handler& handler) : text(text), handler(handler) {
+	}
+
+	void parse() {
+		skip_whitespace();
+		parse_value(0);
+		skip_whitespace();
+		if (pos != text.size()) {
+			fail("trailing characters after the document");
+		}
+	}
+
+private:
+	static constexpr int max_depth = 512;
+
+	std::string_view text;
+	Handler& handler;
+	std::size_t pos = 0;
+	std::string scratch;
+
+	[[noreturn]] void fail(const char* message) const {
+		throw JsonParseError(message, pos);
+	}
+
+	void skip_whitespace() {
+		while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\n' || text[pos] == '\r' || text[pos] == '\t')) {
+			pos++;
+		}
+	}
+
+	bool consume(char c) {
+		skip_whitespace();
+		if (pos < text.size() && text[pos] == c) {
+			pos++;
+			return true;
+		}
+		return false;
+	}
+
+	void expect_literal(std::string_view literal) {
+		if (text.substr(pos, literal.size()) != literal) {
+			fail("invalid literal");
+		}
+		pos += literal.size();
+	}
+
+	void parse_value(int depth) {
+		if (depth > max_depth) {
+			fail("nesting too deep");
+		}
+		skip_whitespace();
+		if (pos >= text.size()) {
+			fail("unexpected end of input");
+		}
+		switch (text[pos]) {
+		case '{':
+			parse_object(depth);
+			break;
+		case '[':
+			parse_array(depth);
+			break;
+		case '"':
+			handler.string(parse_string());
+			break;
+		case 't':
+			expect_literal("true");
+			handler.boolean(true);
+			break;
+		case 'f':
+			expect_literal("false");
+			handler.boolean(false);
+			break;
+		case 'n':
+			expect_literal("null");
+			handler.null();
+			break;
+		default:
+			parse_number();
+			break;
+		}
+	}
+
+	void parse_object(int depth) {
+		pos++;
+		handler.start_object();
+		if (consume('}')) {
+			handler.end_object();
+			return;
+		}
+		do {
+			skip_whitespace();
+			if (pos >= text.size() || text[pos] != '"') {
+				fail("expected an object key");
+			}
+			handler.key(parse_string());
+			if (!consume(':')) {
+				fail("expected ':' after an object key");
+			}
+			parse_value(depth + 1);
+		} while (consume(','));
+		if (!consume('}')) {
+			fail("expected ',' or '}' in an object");
+		}
+		handler.end_object();
+	}
+
+	void parse_array(int depth) {
+		pos++;
+		handler.start_array();
+		if (consume(']')) {
+			handler.end_array();
+			return;
+		}
+		do {
+			parse_value(depth + 1);
+		} while (consume(','));
+		if (!consume(']')) {
+			fail("expected ',' or ']' in an array");
+		}
+		handler.end_array();
+	}
+
+	void parse_number() {
+		const char* first = text.data() + pos;
+		const char* last = text.data() + text.size();
+		if (*first != '-' && (*first < '0' || *first > '9')) {
+			fail("unexpected character");
+		}
+		double value = 0;
+		auto [end, error] = std::from_chars(first, last, value);
+		if (error == std::errc::invalid_argument) {
+			fail("invalid number");
+		}
+		// Out-of-range numbers still advance `end`; keep the saturated value.
+		pos += static_cast<std::size_t>(end - first);
+		handler.number(value);
+	}
+
+	std::string_view parse_string() {
+		std::size_t start = ++pos;
+		while (pos < text.size() && text[pos] != '"' && text[pos] != '\\') {
+			pos++;
+		}
+		if (pos >= text.size()) {
+			fail("unterminated string");
+		}
+		if (text[pos] == '"') {
+			return text.substr(start, pos++ - start);
+		}
+
+		// Escaped string: decode into the scratch buffer.
+		scratch.assign(text.substr(start, pos - start));
+		while (pos < text.size() && text[pos] != '"') {
+			char c = text[pos++];
+			if (c != '\\') {
+				scratch.push_back(c);
+				continue;
+			}
+			if (pos >= text.size()) {
+				fail("unterminated escape");
+			}
+			switch (text[pos++]) {
+			case '"': scratch.push_back('"'); break;
+			case '\\': scratch.push_back('\\'); break;
+			case '/': scratch.push_back('/'); break;
+			case 'b': scratch.push_back('\b'); break;
+			case 'f': scratch.push_back('\f'); break;
+			case 'n': scratch.push_back('\n'); break;
+			case 'r': scratch.push_back('\r'); break;
+			case 't': scratch.push_back('\t'); break;
+			case 'u': append_utf8(parse_code_point()); break;
+			default: fail("invalid escape");
+			}
+		}
+		if (pos >= text.size()) {
+			fail("unterminated string");
+		}
+		pos++;
+		return scratch;
+	}
+
+	std::uint32_t parse_hex4() {
+		if (pos + 4 > text.size()) {
+			fail("truncated \\u escape");
+		}
+		std::uint32_t value = 0;
+		auto [end, error] = std::from_chars(text.data() + pos, text.data() + pos + 4, value, 16);
+		if (error != std::errc{} || end != text.data() + pos + 4) {
+			fail("invalid \\u escape");
+		}
+		pos += 4;
+		return value;
+	}
+
+	std::uint32_t parse_code_point() {
+		std::uint32_t code = parse_hex4();
+		if (code >= 0xD800 && code <= 0xDBFF && text.substr(pos, 2) == "\\u") {
+			pos += 2;
+			std::uint32_t low = parse_hex4();
+			if (low < 0xDC00 || low > 0xDFFF) {
+				fail("invalid surrogate pair");
+			}
+			code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+		}
+		return code;
+	}
+
+	void append_utf8(std::uint32_t code) {
+		if (code < 0x80) {
+			scratch.push_back(static_cast<char>(code));
+		}
+		else if (code < 0x800) {
+			scratch.push_back(static_cast<char>(0xC0 | (code >> 6)));
+			scratch.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+		}
+		else if (code < 0x10000) {
+			scratch.push_back(static_cast<char>(0xE0 | (code >> 12)));
+			scratch.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+			scratch.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+		}
+		else {
+			scratch.push_back(static_cast<char>(0xF0 | (code >> 18)));
+			scratch.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+			scratch.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+			scratch.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+		}
+	}
+};
+
+template <typename Handler>
+void json_sax_parse(std::string_view text, Handler& handler) {
+	JsonSaxParser<Handler>(text, handler).parse();
+}
@@ -0,0 +1,372 @@
+#include "multi.h"
+
+#include "data.h"
+#include "json.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+
+using namespace std;
+
+// SAX handler for /v7/finance/spark responses:
+//
+//     {"spark": {"result": [{"symbol": "AAPL", "response": [<chart result>]}, ...]}}
+//
+// Each result gets its own PriceColumns; only the timestamps, closes and the
+// chart metadata are present.
+class SparkJsonHandler {
+public:
+	struct Result {
+		std::string symbol;
+		PriceColumns columns;
+		std::string error;
+	};
+
+	vector<Result> results;
+	std::string error;
+
+	void start_object() {
+		if (!frames.empty() && frames.back().is_array && path_is({ "spark", "result" })) {
+			results.emplace_back();
+		}
+		frames.push_back({ false, {}, nullptr, nullptr });
+	}
+
+	void end_object() {
+		frames.pop_back();
+		if (!frames.empty() && frames.back().is_array && path_is({ "spark", "result" })) {
+			Result& result = results.back();
+			try {
+				result.columns.complete_columns();
+			}
+			catch (const exception& e) {
+				result.error = e.what();
+				result.columns.clear();
+			}
+		}
+	}
+
+	void start_array() {
+		Frame frame{ true, {}, nullptr, nullptr };
+		if (!results.empty() && !frames.empty() && !frames.back().is_array) {
+			PriceColumns& columns = results.back().columns;
+			if (path_is({ "spark", "result", "response", "timestamp" })) {
+				frame.integers = &columns._timestamp;
+			}
+			else if (path_is({ "spark", "result", "response", "indicators", "quote", "close" })) {
+				frame.doubles = &columns._close;
+			}
+			else if (path_is({ "spark", "result", "response", "indicators", "adjclose", "adjclose" })) {
+				frame.doubles = &columns._adj_close;
+			}
+		}
+		frames.push_back(std::move(frame));
+	}
+
+	void end_array() {
+		frames.pop_back();
+	}
+
+	void key(string_view name) {
+		frames.back().key.assign(name);
+	}
+
+	void string(string_view value) {
+		if (frames.empty() || frames.back().is_array) {
+			return;
+		}
+		const std::string& name = frames.back().key;
+		if (!results.empty() && path_is({ "spark", "result", "symbol" })) {
+			results.back().symbol = value;
+		}
+		else if (!results.empty() && path_is({ "spark", "result", "response", "meta", name })) {
+			PriceHistoryMetadata& meta = results.back().columns._metadata;
+			if (name == "symbol") meta.symbol = value;
+			else if (name == "currency") meta.currency = value;
+			else if (name == "exchangeName") meta.exchange_name = value;
+			else if (name == "exchangeTimezoneName") meta.exchange_timezone_name = value;
+			else if (name == "instrumentType") meta.instrument_type = value;
+			else if (name == "dataGranularity") meta.data_granularity = value;
+			else if (name == "range") meta.range = value;
+		}
+		else if (path_is({ "spark", "error", "description" }) || path_is({ "finance", "error", "description" })) {
+			error = value;
+		}
+	}
+
+	void number(double value) {
+		if (frames.empty()) {
+			return;
+		}
+		Frame& frame = frames.back();
+		if (frame.doubles != nullptr) {
+			frame.doubles->push_back(value);
+		}
+		else if (frame.integers != nullptr) {
+			frame.integers->push_back(static_cast<int64_t>(value));
+		}
+		else if (!frame.is_array && !results.empty() && path_is({ "spark", "result", "response", "meta", frame.key })) {
+			PriceHistoryMetadata& meta = results.back().columns._metadata;
+			if (frame.key == "gmtoffset") meta.gmtoffset = static_cast<int64_t>(value);
+			else if (frame.key == "regularMarketPrice") meta.regular_market_price = value;
+		}
+	}
+
+	void boolean(bool) {
+	}
+
+	void null() {
+		if (frames.empty()) {
+			return;
+		}
+		Frame& frame = frames.back();
+		if (frame.doubles != nullptr) {
+			frame.doubles->push_back(numeric_limits<double>::quiet_NaN());
+		}
+		else if (frame.integers != nullptr) {
+			frame.integers->push_back(0);
+		}
+	}
+
+private:
+	struct Frame {
+		bool is_array;
+		std::string key;
+		vector<double>* doubles;
+		vector<int64_t>* integers;
+	};
+
+	vector<Frame> frames;
+
+	// True when the keys of the enclosing objects (ignoring arrays) are
+	// exactly `keys`, outermost first.
+	bool path_is(initializer_list<string_view> keys) const {
+		auto expected = keys.begin();
+		for (const Frame& frame : frames) {
+			if (frame.is_array) {
+				continue;
+			}
+			if (expected == keys.end() || frame.key != *expected) {
+				return false;
+			}
+			++expected;
+		}
+		return expected == keys.end();
+	}
+};
+
+namespace {
+
+YfParams chart_params(const DownloadOptions& options) {
+	YfParams params;
+	if (options.end > options.start) {
+		params.emplace_back("period1", to_string(options.start));
+		params.emplace_back("period2", to_string(options.end));
+	}
+	else {
+		params.emplace_back("range", options.period);
+	}
+	params.emplace_back("interval", options.interval);
+	params.emplace_back("includePrePost", options.prepost ? "true" : "false");
+	return params;
+}
+
+// Fetches one batch into bars/errors at the symbols' indices; a worker only
+// touches the indices of its own batch, so no locking is needed.
+void fetch_batch(YfData& data, const DownloadOptions& options, const vector<string>& symbols, size_t first, size_t last,
+	vector<PriceColumns>& bars, vector<string>& errors) {
+	YfParams params = chart_params(options);
+	if (!options.close_only) {
+		params.emplace_back("events", "div,splits,capitalGains");
+		try {
+			bars[first] = PriceColumns::parse_chart_json(data.get("/v8/finance/chart/" + YfData::url_encode(symbols[first]), params));
+		}
+		catch (const exception& e) {
+			errors[first] = e.what();
+		}
+		return;
+	}
+
+	string joined;
+	for (size_t i = first; i < last; i++) {
+		joined += (i == first ? "" : ",") + symbols[i];
+	}
+	params.insert(params.begin(), { "symbols", joined });
+	try {
+		string body = data.get("/v7/finance/spark", params);
+		SparkJsonHandler handler;
+		json_sax_parse(body, handler);
+		if (!handler.error.empty()) {
+			throw runtime_error("Yahoo spark error: " + handler.error);
+		}
+		for (SparkJsonHandler::Result& result : handler.results) {
+			auto found = find(symbols.begin() + first, symbols.begin() + last, result.symbol);
+			if (found == symbols.begin() + last) {
+				continue;
+			}
+			size_t index = static_cast<size_t>(found - symbols.begin());
+			bars[index] = std::move(result.columns);
+			errors[index] = std::move(result.error);
+		}
+		for (size_t i = first; i < last; i++) {
+			if (bars[i].empty() && errors[i].empty()) {
+				errors[i] = "No data found, symbol may be delisted";
+			}
+		}
+	}
+	catch (const exception& e) {
+		for (size_t i = first; i < last; i++) {
+			errors[i] = e.what();
+		}
+	}
+}
+
+}
+
+vector<string> normalize_symbols(const vector<string>& tickers) {
+	vector<string> symbols;
+	unordered_set<string> seen;
+	symbols.reserve(tickers.size());
+	for (string ticker : tickers) {
+		transform(ticker.begin(), ticker.end(), ticker.begin(), ::toupper);
+		if (!ticker.empty() && seen.insert(ticker).second) {
+			symbols.push_back(std::move(ticker));
+		}
+	}
+	return symbols;
+}
+
+void run_session_workers(size_t count, size_t threads, const string& base_url, const function<void(YfData&, size_t)>& task) {
+	// Sessions are created here so an unsupported base URL throws to the
+	// caller instead of inside a thread.
+	threads = min(max<size_t>(threads, 1), count);
+	vector<unique_ptr<YfData>> sessions;
+	for (size_t t = 0; t < threads; t++) {
+		sessions.push_back(make_unique<YfData>(base_url));
+	}
+
+	atomic<size_t> next{ 0 };
+	auto worker = [&](YfData& data) {
+		for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+			task(data, i);
+		}
+	};
+	vector<thread> pool;
+	pool.reserve(threads);
+	for (size_t t = 1; t < threads; t++) {
+		pool.emplace_back(worker, ref(*sessions[t]));
+	}
+	if (threads > 0) {
+		worker(*sessions[0]);
+	}
+	for (thread& t : pool) {
+		t.join();
+	}
+}
+
+optional<size_t> PricePanel::column(string_view symbol) const {
+	auto found = find(_symbols.begin(), _symbols.end(), symbol);
+	if (found == _symbols.end()) {
+		return nullopt;
+	}
+	return static_cast<size_t>(found - _symbols.begin());
+}
+
+PricePanel PricePanel::merge(vector<string> symbols, const vector<PriceColumns>& bars, map<string, string> errors) {
+	if (symbols.size() != bars.size()) {
+		throw invalid_argument("PricePanel::merge: one PriceColumns per symbol is required");
+	}
+	PricePanel panel;
+	panel._symbols = std::move(symbols);
+	panel._errors = std::move(errors);
+
+	size_t total = 0;
+	for (const PriceColumns& columns : bars) {
+		total += columns.size();
+	}
+	panel._timestamp.reserve(total);
+	for (const PriceColumns& columns : bars) {
+		panel._timestamp.insert(panel._timestamp.end(), columns.timestamp().begin(), columns.timestamp().end());
+	}
+	sort(panel._timestamp.begin(), panel._timestamp.end());
+	panel._timestamp.erase(unique(panel._timestamp.begin(), panel._timestamp.end()), panel._timestamp.end());
+
+	size_t rows = panel._timestamp.size();
+	size_t cells = rows * bars.size();
+	double nan = numeric_limits<double>::quiet_NaN();
+	for (vector<double>* values : { &panel._open, &panel._high, &panel._low, &panel._close, &panel._adj_close }) {
+		values->assign(cells, nan);
+	}
+	panel._volume.assign(cells, 0);
+	panel._metadata.reserve(bars.size());
+
+	for (size_t c = 0; c < bars.size(); c++) {
+		const PriceColumns& columns = bars[c];
+		panel._metadata.push_back(columns.metadata());
+		// Both timestamp lists are sorted: walk them together.
+		size_t row = 0;
+		size_t base = c * rows;
+		for (size_t i = 0; i < columns.size(); i++) {
+			row = static_cast<size_t>(lower_bound(panel._timestamp.begin() + row, panel._timestamp.end(), columns.timestamp()[i]) - panel._timestamp.begin());
+			panel._open[base + row] = columns.open()[i];
+			panel._high[base + row] = columns.high()[i];
+			panel._low[base + row] = columns.low()[i];
+			panel._close[base + row] = columns.close()[i];
+			panel._adj_close[base + row] = columns.adj_close()[i];
+			panel._volume[base + row] = columns.volume()[i];
+		}
+	}
+	return panel;
+}
+
+PricePanel download(const vector<string>& tickers, const DownloadOptions& options, const string& base_url) {
+	vector<string> symbols = normalize_symbols(tickers);
+	size_t batch = options.close_only ? max<size_t>(options.batch_size, 1) : 1;
+	size_t batches = (symbols.size() + batch - 1) / batch;
+
+	vector<PriceColumns> bars(symbols.size());
+	vector<string> errors(symbols.size());
+	run_session_workers(batches, options.threads, base_url, [&](YfData& data, size_t b) {
+		fetch_batch(data, options, symbols, b * batch, min(symbols.size(), (b + 1) * batch), bars, errors);
+	});
+
+	map<string, string> failed;
+	for (size_t i = 0; i < symbols.size(); i++) {
+		if (!errors[i].empty()) {
+			failed.emplace(symbols[i], std::move(errors[i]));
+		}
+	}
+	return PricePanel::merge(std::move(symbols), bars, std::move(failed));
+}
+
+
+Tickers::Tickers(const string& tickers, string base_url) : _base_url(std::move(base_url)) {
+	vector<string> parts;
+	size_t pos = 0;
+	while (pos < tickers.size()) {
+		size_t first = tickers.find_first_not_of(" ,", pos);
+		if (first == string::npos) {
+			break;
+		}
+		size_t last = tickers.find_first_of(" ,", first);
+		parts.push_back(tickers.substr(first, last == string::npos ? string::npos : last - first));
+		pos = last == string::npos ? tickers.size() : last;
+	}
+	_symbols = normalize_symbols(parts);
+}
+
+Tickers::Tickers(vector<string> tickers, string base_url) : _symbols(normalize_symbols(tickers)), _base_url(std::move(base_url)) {
+}
+
+PricePanel Tickers::history(const DownloadOptions& options) const {
+	return ::download(_symbols, options, _base_url);
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+// Description: Multi-ticker download (port of yfinance's multi.py download()
+// and tickers.py Tickers).
+//
+// Symbols are fetched by a bounded pool of worker threads. Each worker owns
+// one YfData, so its requests reuse a single keep-alive connection, and pulls
+// the next batch of symbols from a shared counter until none are left:
+//
+//   - Full bars come from /v8/finance/chart, which takes one symbol per
+//     request, so each batch is one symbol.
+//   - With close_only, symbols are batched through /v7/finance/spark, which
+//     returns closes for up to batch_size symbols per request.
+//
+// The results are merged into one PricePanel: the union of all bar times as
+// the row index and, per field, one contiguous column per symbol. Symbols
+// that failed (or had no bars at a time) read as NaN prices and 0 volume;
+// the reason is kept in errors(), like yfinance's shared._ERRORS.
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "history.h"
+
+class YfData;
+
+struct DownloadOptions {
+	std::string period = "1mo";
+	std::string interval = "1d";
+	// Used instead of period when end > start (seconds since the epoch).
+	std::int64_t start = 0;
+	std::int64_t end = 0;
+	bool prepost = false;
+
+	// Fetch closes only, batching symbols through the spark endpoint.
+	bool close_only = false;
+	std::size_t batch_size = 20;
+	// Worker threads; each opens its own connection.
+	std::size_t threads = 8;
+};
+
+class PricePanel {
+public:
+	const std::vector<std::string>& symbols() const { return _symbols; }
+	std::size_t rows() const { return _timestamp.size(); }
+	// Column index of `symbol`, if it was requested.
+	std::optional<std::size_t> column(std::string_view symbol) const;
+
+	std::span<const std::int64_t> timestamp() const { return _timestamp; }
+	std::span<const double> open(std::size_t column) const { return field(_open, column); }
+	std::span<const double> high(std::size_t column) const { return field(_high, column); }
+	std::span<const double> low(std::size_t column) const { return field(_low, column); }
+	std::span<const double> close(std::size_t column) const { return field(_close, column); }
+	std::span<const double> adj_close(std::size_t column) const { return field(_adj_close, column); }
+	std::span<const std::int64_t> volume(std::size_t column) const {
+		return std::span<const std::int64_t>(_volume).subspan(column * rows(), rows());
+	}
+
+	const PriceHistoryMetadata& metadata(std::size_t column) const { return _metadata[column]; }
+	// Symbol -> reason, for symbols that returned no data.
+	const std::map<std::string, std::string>& errors() const { return _errors; }
+
+	// Aligns per-symbol bars on the union of their timestamps. `bars[i]`
+	// belongs to `symbols[i]`; each must be sorted by time.
+	static PricePanel merge(std::vector<std::string> symbols, const std::vector<PriceColumns>& bars, std::map<std::string, std::string> errors = {});
+
+private:
+	std::vector<std::string> _symbols;
+	std::vector<std::int64_t> _timestamp;
+	// Symbol-major: column c occupies [c * rows(), (c + 1) * rows()).
+	std::vector<double> _open;
+	std::vector<double> _high;
+	std::vector<double> _low;
+	std::vector<double> _close;
+	std::vector<double> _adj_close;
+	std::vector<std::int64_t> _volume;
+	std::vector<PriceHistoryMetadata> _metadata;
+	std::map<std::string, std::string> _errors;
+
+	std::span<const double> field(const std::vector<double>& values, std::size_t column) const {
+		return std::span<const double>(values).subspan(column * rows(), rows());
+	}
+};
+
+// Upper-cases `tickers` and drops empty and repeated entries, keeping order.
+std::vector<std::string> normalize_symbols(const std::vector<std::string>& tickers);
+
+// Calls task(session, i) for every i in [0, count) from up to `threads`
+// worker threads. Each worker has its own YfData for `base_url`, so its
+// requests share one keep-alive connection. `task` must not throw.
+void run_session_workers(std::size_t count, std::size_t threads, const std::string& base_url,
+	const std::function<void(YfData&, std::size_t)>& task);
+
+// Downloads `tickers` (upper-cased, duplicates dropped) from `base_url`.
+// Per-symbol failures are reported in PricePanel::errors(), not thrown.
+PricePanel download(const std::vector<std::string>& tickers, const DownloadOptions& options = {},
+	const std::string& base_url = "https://query2.finance.yahoo.com");
+
+class Tickers {
+public:
+	// `tickers` is separated by spaces and/or commas, e.g. "aapl msft,goog".
+	explicit Tickers(const std::string& tickers, std::string base_url = "https://query2.finance.yahoo.com");
+	explicit Tickers(std::vector<std::string> tickers, std::string base_url = "https://query2.finance.yahoo.com");
+
+	const std::vector<std::string>& symbols() const { return _symbols; }
+
+	PricePanel history(const DownloadOptions& options = {}) const;
+	PricePanel download(const DownloadOptions& options = {}) const { return history(options); }
+
+private:
+	std::vector<std::string> _symbols;
+	std::string _base_url;
+};
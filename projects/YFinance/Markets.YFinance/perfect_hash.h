@@ -0,0 +1,144 @@
+#pragma once
+
+// Description: Compile-time perfect hashing for fixed sets of names (field
+// names, module names) that are validated on every request.
+//
+// StaticStringSet is built by a consteval constructor using hash-and-
+// displace (CHD): keys are grouped into buckets by one half of a 64-bit
+// hash, and each bucket gets a small seed that sends all of its keys to
+// free slots of a table twice the key count. A lookup is one string hash,
+// two array reads and one string comparison; nothing is allocated and the
+// whole table is constant data, so there is no static initialization.
+//
+//     constexpr StaticStringSet modules(std::to_array<std::string_view>({ "price", "earnings" }));
+//     static_assert(modules.contains("price"));
+//
+// Duplicate keys fail compilation.
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+constexpr std::uint64_t perfect_hash_fnv1a(std::string_view text) {
+	std::uint64_t hash = 14695981039346656037ull;
+	for (char c : text) {
+		hash ^= static_cast<unsigned char>(c);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+// Re-mixes a key hash with a bucket seed (splitmix64 finalizer).
+constexpr std::uint64_t perfect_hash_mix(std::uint64_t hash, std::uint32_t seed) {
+	std::uint64_t x = hash + 0x9E3779B97F4A7C15ull * (seed + 1ull);
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+	return x ^ (x >> 31);
+}
+
+template <std::size_t N>
+class StaticStringSet {
+public:
+	static_assert(N > 0 && N < 0xFFFF, "StaticStringSet holds 1 to 65534 keys");
+
+	static constexpr std::size_t table_size = std::bit_ceil(2 * N);
+	static constexpr std::size_t bucket_count = (N + 3) / 4;
+
+	consteval explicit StaticStringSet(const std::array<std::string_view, N>& keys) : _keys(keys), _seeds{}, _slots{} {
+		std::array<std::uint64_t, N> hashes{};
+		std::array<std::size_t, N> bucket_of{};
+		std::array<std::size_t, bucket_count + 1> bucket_start{};
+		for (std::size_t i = 0; i < N; i++) {
+			hashes[i] = perfect_hash_fnv1a(keys[i]);
+			bucket_of[i] = bucket(hashes[i]);
+			bucket_start[bucket_of[i] + 1]++;
+		}
+
+		// Counting sort of the keys by bucket.
+		std::size_t largest = 0;
+		for (std::size_t b = 0; b < bucket_count; b++) {
+			largest = bucket_start[b + 1] > largest ? bucket_start[b + 1] : largest;
+			bucket_start[b + 1] += bucket_start[b];
+		}
+		std::array<std::size_t, N> members{};
+		std::array<std::size_t, bucket_count + 1> fill = bucket_start;
+		for (std::size_t i = 0; i < N; i++) {
+			members[fill[bucket_of[i]]++] = i;
+		}
+
+		// Largest buckets first, while the table is still mostly empty.
+		for (std::size_t size = largest; size > 0; size--) {
+			for (std::size_t b = 0; b < bucket_count; b++) {
+				if (bucket_start[b + 1] - bucket_start[b] == size) {
+					place_bucket(b, members, bucket_start, hashes);
+				}
+			}
+		}
+	}
+
+	static constexpr std::size_t size() { return N; }
+	constexpr const std::array<std::string_view, N>& keys() const { return _keys; }
+	constexpr std::string_view operator[](std::size_t index) const { return _keys[index]; }
+	constexpr auto begin() const { return _keys.begin(); }
+	constexpr auto end() const { return _keys.end(); }
+
+	// Position of `key` in the array the set was built from.
+	constexpr std::optional<std::size_t> index_of(std::string_view key) const {
+		std::uint64_t hash = perfect_hash_fnv1a(key);
+		std::uint16_t entry = _slots[slot(hash, _seeds[bucket(hash)])];
+		if (entry == 0 || _keys[entry - 1] != key) {
+			return std::nullopt;
+		}
+		return entry - 1;
+	}
+
+	constexpr bool contains(std::string_view key) const {
+		return index_of(key).has_value();
+	}
+
+private:
+	std::array<std::string_view, N> _keys;
+	std::array<std::uint16_t, bucket_count> _seeds;
+	// Key index + 1; 0 marks an empty slot.
+	std::array<std::uint16_t, table_size> _slots;
+
+	static constexpr std::size_t bucket(std::uint64_t hash) {
+		return static_cast<std::size_t>((hash >> 32) % bucket_count);
+	}
+
+	static constexpr std::size_t slot(std::uint64_t hash, std::uint32_t seed) {
+		return static_cast<std::size_t>(perfect_hash_mix(hash, seed) & (table_size - 1));
+	}
+
+	constexpr void place_bucket(std::size_t b, const std::array<std::size_t, N>& members,
+		const std::array<std::size_t, bucket_count + 1>& bucket_start, const std::array<std::uint64_t, N>& hashes) {
+		for (std::uint32_t seed = 0; seed <= 0xFFFF; seed++) {
+			bool fits = true;
+			for (std::size_t m = bucket_start[b]; fits && m < bucket_start[b + 1]; m++) {
+				std::size_t target = slot(hashes[members[m]], seed);
+				fits = _slots[target] == 0;
+				// Two keys of the same bucket must not share a slot either.
+				for (std::size_t other = bucket_start[b]; fits && other < m; other++) {
+					if (slot(hashes[members[other]], seed) == target) {
+						if (_keys[members[other]] == _keys[members[m]]) {
+							throw std::invalid_argument("StaticStringSet: duplicate key");
+						}
+						fits = false;
+					}
+				}
+			}
+			if (fits) {
+				_seeds[b] = static_cast<std::uint16_t>(seed);
+				for (std::size_t m = bucket_start[b]; m < bucket_start[b + 1]; m++) {
+					_slots[slot(hashes[members[m]], seed)] = static_cast<std::uint16_t>(members[m] + 1);
+				}
+				return;
+			}
+		}
+		throw std::invalid_argument("StaticStringSet: no displacement found");
+	}
+};
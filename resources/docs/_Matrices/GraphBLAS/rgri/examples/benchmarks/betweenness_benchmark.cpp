@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <execution>
+#include <grb/grb.hpp>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Betweenness centrality from a sample of sources on R-MAT graphs: Brandes'
+// algorithm one source at a time with vector products (the approach
+// examples/algorithms/betweenness_centrality.cpp used to take) against
+// grb::betweenness_centrality, which runs a batch of sources as one sparse
+// frontier matrix, sequentially and in parallel.
+//
+// Usage: betweenness_benchmark [max rmat scale] [edge factor] [sources]
+
+template <typename F>
+double median_seconds(F&& f, std::size_t runs = 3) {
+  // Untimed warm-up run.
+  f();
+
+  std::vector<double> times;
+  for (std::size_t run = 0; run < runs; run++) {
+    auto begin = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    times.push_back(std::chrono::duration<double>(end - begin).count());
+  }
+  std::sort(times.begin(), times.end());
+  return times[times.size() / 2];
+}
+
+// Dependencies on the paths from one source, with a masked vector product
+// per BFS level and per step back.
+template <typename M>
+auto per_source_brandes(M& a, std::size_t source) {
+  grb::vector<double> delta(a.shape()[0]);
+  std::vector<grb::vector<double>> sigma;
+
+  grb::vector<double> q(a.shape()[0]);
+  q[source] = 1;
+  grb::vector<double> p = q;
+  q = grb::multiply(grb::transpose(a), q, grb::plus{}, grb::take_right{},
+                    grb::complement_view(p));
+
+  while (!q.empty()) {
+    sigma.push_back(q);
+    p = grb::ewise_union(p, q, grb::plus{});
+    q = grb::multiply(grb::transpose(a), q, grb::plus{}, grb::take_right{},
+                      grb::complement_view(p));
+  }
+
+  for (std::size_t i = sigma.size(); i-- > 1;) {
+    auto w = grb::ewise_intersection(sigma[i], sigma[i], grb::take_left{});
+    for (auto&& [index, value] : w) {
+      auto iter = delta.find(index);
+      double d = iter == delta.end() ? 0 : double(grb::get<1>(*iter));
+      value = (1 + d) / value;
+    }
+    auto sum = grb::multiply(a, w, grb::plus{}, grb::take_right{});
+    auto update = grb::ewise_intersection(sigma[i - 1], sum, grb::times{});
+    delta = grb::ewise_union(delta, update, grb::plus{});
+  }
+  return delta;
+}
+
+int main(int argc, char** argv) {
+  std::size_t max_scale = argc > 1 ? std::stoul(argv[1]) : 16;
+  std::size_t edge_factor = argc > 2 ? std::stoul(argv[2]) : 16;
+  std::size_t num_sources = argc > 3 ? std::stoul(argv[3]) : 64;
+
+  std::cout << std::setw(6) << "scale" << std::setw(12) << "nnz"
+            << std::setw(18) << "per-source (ms)" << std::setw(16)
+            << "batch seq (ms)" << std::setw(16) << "batch par (ms)"
+            << std::setw(8) << "match" << "\n";
+
+  for (std::size_t scale = 10; scale <= max_scale; scale += 2) {
+    auto a = grb::generate_rmat<int, int>(scale, edge_factor, scale);
+    std::size_t n = a.shape()[0];
+
+    std::vector<std::size_t> sources;
+    for (std::size_t k = 0; k < num_sources; k++) {
+      sources.push_back(k * n / num_sources);
+    }
+
+    auto per_source = [&] {
+      std::vector<double> c(n, 0);
+      for (auto s : sources) {
+        for (auto&& [index, d] : per_source_brandes(a, s)) {
+          c[index] += d;
+        }
+      }
+      return c;
+    };
+
+    auto reference = per_source();
+    auto batched = grb::betweenness_centrality(a, sources);
+    bool match = true;
+    for (auto&& [index, value] : batched) {
+      match = match && std::abs(value - reference[index]) <=
+                           1e-9 * std::max(1.0, reference[index]);
+    }
+
+    auto slow = median_seconds(per_source, 1);
+    auto seq =
+        median_seconds([&] { grb::betweenness_centrality(a, sources); });
+    auto par = median_seconds([&] {
+      grb::betweenness_centrality(std::execution::par, a, sources);
+    });
+
+    std::cout << std::fixed << std::setprecision(2) << std::setw(6) << scale
+              << std::setw(12) << a.size() << std::setw(18) << slow * 1000
+              << std::setw(16) << seq * 1000 << std::setw(16) << par * 1000
+              << std::setw(8) << (match ? "yes" : "NO") << "\n";
+  }
+
+  return 0;
+}
@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <chrono>
+#include <grb/grb.hpp>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Push-style breadth-first search on an R-MAT graph, keeping the frontier in
+// a `grb::vector` with each storage hint.  A dense frontier costs O(n) per
+// level to allocate and scan; sparse and bitmap frontiers cost time in
+// proportion to the frontier, and the adaptive one switches to a bitmap
+// only for the few wide levels in the middle of the search.
+//
+// Usage: bfs_frontier [rmat scale] [edge factor]
+
+template <typename Hint, typename M>
+std::vector<double> bfs_level_times(M&& a, std::vector<std::size_t>& sizes) {
+  using I = grb::matrix_index_t<M>;
+  auto&& csr = a.backend();
+  auto rowptr = csr.rowptr();
+  auto colind = csr.colind();
+
+  I n = a.shape()[0];
+  std::vector<bool> visited(n, false);
+
+  grb::vector<int, I, Hint> frontier(n);
+  frontier[0] = 1;
+  visited[0] = true;
+
+  std::vector<double> times;
+  sizes.clear();
+  while (!frontier.empty()) {
+    sizes.push_back(frontier.size());
+    auto begin = std::chrono::steady_clock::now();
+
+    grb::vector<int, I, Hint> next(n);
+    for (auto&& [i, _] : frontier) {
+      for (I ptr = rowptr[i]; ptr < rowptr[i + 1]; ptr++) {
+        I j = colind[ptr];
+        if (!visited[j]) {
+          visited[j] = true;
+          next.insert({j, 1});
+        }
+      }
+    }
+    frontier = std::move(next);
+
+    auto end = std::chrono::steady_clock::now();
+    times.push_back(std::chrono::duration<double, std::micro>(end - begin)
+                        .count());
+  }
+  return times;
+}
+
+int main(int argc, char** argv) {
+  std::size_t scale = argc > 1 ? std::stoul(argv[1]) : 18;
+  std::size_t edge_factor = argc > 2 ? std::stoul(argv[2]) : 8;
+
+  auto a = grb::generate_rmat<float, std::uint32_t>(scale, edge_factor);
+  std::cout << "R-MAT scale " << scale << ": " << a.shape()[0] << " vertices, "
+            << a.size() << " edges\n";
+
+  std::vector<std::size_t> sizes;
+  auto dense = bfs_level_times<grb::dense>(a, sizes);
+  auto sparse = bfs_level_times<grb::sparse>(a, sizes);
+  auto bitmap = bfs_level_times<grb::bitmap>(a, sizes);
+  auto adaptive =
+      bfs_level_times<grb::compose<grb::sparse, grb::bitmap>>(a, sizes);
+
+  std::cout << std::setw(6) << "level" << std::setw(10) << "frontier"
+            << std::setw(14) << "dense (us)" << std::setw(14) << "sparse (us)"
+            << std::setw(14) << "bitmap (us)" << std::setw(16)
+            << "adaptive (us)" << "\n";
+
+  double totals[4] = {};
+  for (std::size_t level = 0; level < sizes.size(); level++) {
+    std::cout << std::fixed << std::setprecision(1) << std::setw(6) << level
+              << std::setw(10) << sizes[level] << std::setw(14) << dense[level]
+              << std::setw(14) << sparse[level] << std::setw(14)
+              << bitmap[level] << std::setw(16) << adaptive[level] << "\n";
+    totals[0] += dense[level];
+    totals[1] += sparse[level];
+    totals[2] += bitmap[level];
+    totals[3] += adaptive[level];
+  }
+  std::cout << std::setw(16) << "total" << std::setw(14) << totals[0]
+            << std::setw(14) << totals[1] << std::setw(14) << totals[2]
+            << std::setw(16) << totals[3] << "\n";
+
+  return 0;
+}
@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <execution>
+#include <grb/grb.hpp>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Matrix-vector multiplication with a dense vector, on R-MAT graphs and on
+// banded matrices stored with 64-bit indices.  The row structure is read
+// from the CSR arrays, from a compact index with 32-bit column indices, and
+// from a delta-encoded one.  Shows the bytes of row structure per element,
+// and the time of the sequential (pull) and parallel kernels.
+//
+// Usage: compact_spmv [max rmat scale] [edge factor]
+
+template <typename F>
+double median_seconds(F&& f, std::size_t runs = 7) {
+  // Untimed warm-up run.
+  f();
+
+  std::vector<double> times;
+  for (std::size_t run = 0; run < runs; run++) {
+    auto begin = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    times.push_back(std::chrono::duration<double>(end - begin).count());
+  }
+  std::sort(times.begin(), times.end());
+  return times[times.size() / 2];
+}
+
+// `2^scale` rows with `edge_factor` random columns each, within 1024 of
+// the diagonal: a matrix with good locality, as after a bandwidth-reducing
+// reordering.
+template <typename T, typename I>
+grb::matrix<T, I> banded(std::size_t scale, std::size_t edge_factor) {
+  I n = I(1) << scale;
+  grb::matrix<T, I> a({n, n});
+  std::mt19937 gen(scale);
+  std::uniform_int_distribution<I> offset(0, 2047);
+  for (I i = 0; i < n; i++) {
+    for (std::size_t k = 0; k < edge_factor; k++) {
+      I j = std::clamp<I>(i + offset(gen), 1024, n + 1023) - 1024;
+      a[{i, j}] = 1;
+    }
+  }
+  a.wait();
+  return a;
+}
+
+template <typename M>
+void benchmark(const std::string& name, std::size_t scale, M& a) {
+  double nnz = a.size();
+
+  grb::vector<float, std::size_t> x(a.shape()[1]);
+  for (std::size_t j = 0; j < a.shape()[1]; j++) {
+    x[j] = 1;
+  }
+
+  for (std::string format : {"csr", "narrow", "delta"}) {
+    auto&& backend = a.backend();
+    double bytes = (backend.rowptr().size() + backend.colind().size()) *
+                   sizeof(std::size_t);
+    if (format == "csr") {
+      backend.clear_compact_index();
+    } else {
+      backend.build_compact_index(format == "narrow"
+                                      ? grb::index_compression::narrow
+                                      : grb::index_compression::delta);
+      bytes = std::visit(
+          [](auto&& rows) -> double {
+            if constexpr (requires { rows.nbytes(); }) {
+              return rows.nbytes();
+            } else {
+              return 0;
+            }
+          },
+          backend.compact_index());
+    }
+
+    auto seq = median_seconds([&] { grb::multiply(a, x); });
+    auto par =
+        median_seconds([&] { grb::multiply(std::execution::par, a, x); });
+
+    std::cout << std::fixed << std::setw(6) << name << std::setw(6) << scale
+              << std::setw(10) << format << std::setw(14)
+              << std::setprecision(2) << bytes / nnz << std::setw(12)
+              << std::setprecision(3) << seq * 1000 << std::setw(12)
+              << par * 1000 << "\n";
+  }
+}
+
+int main(int argc, char** argv) {
+  std::size_t max_scale = argc > 1 ? std::stoul(argv[1]) : 20;
+  std::size_t edge_factor = argc > 2 ? std::stoul(argv[2]) : 16;
+
+  std::cout << std::setw(6) << "matrix" << std::setw(6) << "scale"
+            << std::setw(10) << "format" << std::setw(14) << "bytes/nnz"
+            << std::setw(12) << "seq (ms)" << std::setw(12) << "par (ms)"
+            << "\n";
+
+  for (std::size_t scale = 16; scale <= max_scale; scale += 2) {
+    auto rmat = grb::generate_rmat<float, std::size_t>(scale, edge_factor);
+    benchmark("rmat", scale, rmat);
+
+    auto band = banded<float, std::size_t>(scale, edge_factor);
+    benchmark("band", scale, band);
+  }
+
+  return 0;
+}
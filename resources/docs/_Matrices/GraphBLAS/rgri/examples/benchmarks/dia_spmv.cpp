@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <chrono>
+#include <execution>
+#include <grb/grb.hpp>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Banded Toeplitz-like matrices (lags -k..k, as in a distributed-lag model)
+// stored as CSR and as DIA.  Times the matrix-vector product with a dense
+// vector, sequentially and in parallel, and the product of the matrix with
+// itself, and shows what grb::prefers_diagonal_storage() picks.
+//
+// Usage: dia_spmv [max scale] [lags on each side]
+
+template <typename F>
+double median_seconds(F&& f, std::size_t runs = 7) {
+  // Untimed warm-up run.
+  f();
+
+  std::vector<double> times;
+  for (std::size_t run = 0; run < runs; run++) {
+    auto begin = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    times.push_back(std::chrono::duration<double>(end - begin).count());
+  }
+  std::sort(times.begin(), times.end());
+  return times[times.size() / 2];
+}
+
+// Builds `a` with one value per lag, down every diagonal.
+template <typename M>
+void fill_lags(M& a, std::size_t n, int lags) {
+  std::mt19937 gen(lags);
+  std::uniform_real_distribution<float> coefficient(-1, 1);
+  std::vector<float> weights;
+  for (int k = -lags; k <= lags; k++) {
+    weights.push_back(coefficient(gen));
+  }
+  for (std::size_t i = 0; i < n; i++) {
+    for (int k = -lags; k <= lags; k++) {
+      std::ptrdiff_t j = std::ptrdiff_t(i) + k;
+      if (j >= 0 && std::size_t(j) < n) {
+        a[{int(i), int(j)}] = weights[k + lags];
+      }
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  std::size_t max_scale = argc > 1 ? std::stoul(argv[1]) : 22;
+  int lags = argc > 2 ? std::stoi(argv[2]) : 4;
+
+  std::cout << std::setw(6) << "scale" << std::setw(12) << "nnz"
+            << std::setw(10) << "picks" << std::setw(14) << "CSR mxv"
+            << std::setw(14) << "DIA mxv" << std::setw(14) << "CSR par"
+            << std::setw(14) << "DIA par" << std::setw(14) << "CSR mxm"
+            << std::setw(14) << "DIA mxm" << "   (ms)\n";
+
+  for (std::size_t scale = 16; scale <= max_scale; scale += 2) {
+    std::size_t n = std::size_t(1) << scale;
+    grb::matrix<float, int> csr({int(n), int(n)});
+    grb::matrix<float, int, grb::diagonal> dia({int(n), int(n)});
+    fill_lags(csr, n, lags);
+    fill_lags(dia, n, lags);
+    csr.wait();
+
+    grb::vector<float, int> x(n);
+    for (std::size_t j = 0; j < n; j++) {
+      x[j] = float(j % 13);
+    }
+
+    auto csr_mxv = median_seconds([&] { grb::multiply(csr, x); });
+    auto dia_mxv = median_seconds([&] { grb::multiply(dia, x); });
+    auto csr_par =
+        median_seconds([&] { grb::multiply(std::execution::par, csr, x); });
+    auto dia_par =
+        median_seconds([&] { grb::multiply(std::execution::par, dia, x); });
+    auto csr_mxm = median_seconds([&] { grb::multiply(csr, csr); }, 3);
+    auto dia_mxm = median_seconds([&] { grb::multiply(dia, dia); }, 3);
+
+    std::cout << std::fixed << std::setprecision(2) << std::setw(6) << scale
+              << std::setw(12) << csr.size() << std::setw(10)
+              << (grb::prefers_diagonal_storage(csr) ? "DIA" : "CSR")
+              << std::setw(14) << csr_mxv * 1000 << std::setw(14)
+              << dia_mxv * 1000 << std::setw(14) << csr_par * 1000
+              << std::setw(14) << dia_par * 1000 << std::setw(14)
+              << csr_mxm * 1000 << std::setw(14) << dia_mxm * 1000 << "\n";
+  }
+
+  return 0;
+}
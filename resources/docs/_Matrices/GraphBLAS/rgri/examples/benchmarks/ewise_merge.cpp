@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <grb/grb.hpp>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Sorted-set intersection of column index lists, the inner loop of
+// ewise_intersection, at several list lengths and overlaps: a binary search
+// of each element (as a find()-based merge does), the scalar merge, and the
+// kernel intersect_sorted() dispatches to (SIMD when built with AVX2 or
+// AVX-512, e.g. with -march=native).  Then end-to-end ewise_intersection and
+// ewise_union on random matrices of increasing density.
+//
+// Usage: ewise_merge [matrix dimension] [repetitions]
+
+template <typename F>
+double median_seconds(F&& f, std::size_t runs = 5) {
+  // Untimed warm-up run.
+  f();
+
+  std::vector<double> times;
+  for (std::size_t run = 0; run < runs; run++) {
+    auto begin = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    times.push_back(std::chrono::duration<double>(end - begin).count());
+  }
+  std::sort(times.begin(), times.end());
+  return times[times.size() / 2];
+}
+
+std::vector<std::uint32_t> sorted_sample(std::size_t size, std::size_t range,
+                                         std::mt19937& gen) {
+  std::uniform_int_distribution<std::uint32_t> value(0, range - 1);
+  std::vector<std::uint32_t> sample;
+  while (sample.size() < size) {
+    sample.push_back(value(gen));
+    if (sample.size() == size) {
+      std::sort(sample.begin(), sample.end());
+      sample.erase(std::unique(sample.begin(), sample.end()), sample.end());
+    }
+  }
+  return sample;
+}
+
+int main(int argc, char** argv) {
+  std::size_t n = argc > 1 ? std::stoul(argv[1]) : 20000;
+  std::size_t repetitions = argc > 2 ? std::stoul(argv[2]) : 1600;
+
+#if defined(__AVX512F__)
+  std::cout << "intersect_sorted: AVX-512 kernel\n";
+#elif defined(__AVX2__)
+  std::cout << "intersect_sorted: AVX2 kernel\n";
+#else
+  std::cout << "intersect_sorted: scalar kernel (build with -march=native "
+               "for SIMD)\n";
+#endif
+
+  std::cout << std::setw(8) << "|a|" << std::setw(8) << "|b|" << std::setw(8)
+            << "range" << std::setw(9) << "matches" << std::setw(14)
+            << "search (ns)" << std::setw(14) << "merge (ns)" << std::setw(14)
+            << "dispatch (ns)" << "\n";
+
+  std::mt19937 gen(0);
+  struct lists {
+    std::size_t a_size, b_size, range;
+  };
+  for (auto [a_size, b_size, range] :
+       {lists{64, 64, 128}, lists{64, 64, 1024}, lists{256, 256, 512},
+        lists{256, 256, 65536}, lists{1024, 1024, 4096},
+        lists{1024, 1024, 1 << 20}, lists{16, 4096, 8192},
+        lists{4, 16384, 1 << 20}}) {
+    // Several pairs, so repetitions cannot be folded together.
+    constexpr std::size_t pairs = 16;
+    std::vector<std::vector<std::uint32_t>> a(pairs);
+    std::vector<std::vector<std::uint32_t>> b(pairs);
+    for (std::size_t p = 0; p < pairs; p++) {
+      a[p] = sorted_sample(a_size, range, gen);
+      b[p] = sorted_sample(b_size, range, gen);
+    }
+
+    std::size_t matches = 0;
+    auto count = [&](std::size_t, std::size_t) { matches++; };
+
+    auto search = median_seconds([&] {
+      for (std::size_t r = 0; r < repetitions; r++) {
+        auto&& x = a[r % pairs];
+        auto&& y = b[r % pairs];
+        for (auto v : x) {
+          matches += std::binary_search(y.begin(), y.end(), v);
+        }
+      }
+    });
+    auto merge = median_seconds([&] {
+      for (std::size_t r = 0; r < repetitions; r++) {
+        auto&& x = a[r % pairs];
+        auto&& y = b[r % pairs];
+        grb::__detail::intersect_sorted_scalar(x.data(), x.size(), y.data(),
+                                               y.size(), count);
+      }
+    });
+    auto dispatch = median_seconds([&] {
+      for (std::size_t r = 0; r < repetitions; r++) {
+        auto&& x = a[r % pairs];
+        auto&& y = b[r % pairs];
+        grb::__detail::intersect_sorted(x.data(), x.size(), y.data(),
+                                        y.size(), count);
+      }
+    });
+
+    std::size_t expected = 0;
+    for (std::size_t p = 0; p < pairs; p++) {
+      grb::__detail::intersect_sorted_scalar(
+          a[p].data(), a[p].size(), b[p].data(), b[p].size(),
+          [&](std::size_t, std::size_t) { expected++; });
+    }
+
+    // Keep the kernels from being optimized away.
+    if (matches == 0 && expected != 0) {
+      std::cout << matches << std::endl;
+    }
+
+    double scale = 1e9 / repetitions;
+    std::cout << std::fixed << std::setprecision(0) << std::setw(8) << a_size
+              << std::setw(8) << b_size << std::setw(8) << range << std::setw(9)
+              << expected / pairs << std::setw(14) << search * scale
+              << std::setw(14) << merge * scale << std::setw(14)
+              << dispatch * scale << "\n";
+  }
+
+  std::cout << "\n"
+            << std::setw(10) << "density" << std::setw(12) << "nnz(A)"
+            << std::setw(18) << "intersect (ms)" << std::setw(14)
+            << "union (ms)" << "\n";
+
+  for (double density : {0.0001, 0.001, 0.005, 0.01}) {
+    auto a = grb::generate_random<float, std::uint32_t>(
+        {std::uint32_t(n), std::uint32_t(n)}, density, 1);
+    auto b = grb::generate_random<float, std::uint32_t>(
+        {std::uint32_t(n), std::uint32_t(n)}, density, 2);
+
+    auto intersect = median_seconds(
+        [&] { grb::ewise_intersection(a, b, grb::plus{}); });
+    auto merged =
+        median_seconds([&] { grb::ewise_union(a, b, grb::plus{}); });
+
+    std::cout << std::setprecision(4) << std::setw(10) << density
+              << std::setw(12) << a.size() << std::setprecision(2)
+              << std::setw(18) << intersect * 1000 << std::setw(14)
+              << merged * 1000 << "\n";
+  }
+
+  return 0;
+}
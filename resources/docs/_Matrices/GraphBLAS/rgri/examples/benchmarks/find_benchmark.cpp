@@ -0,0 +1,93 @@
+#include <chrono>
+#include <grb/grb.hpp>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Random find() calls on R-MAT graphs, whose rows follow a power-law degree
+// distribution.  Lookups pick rows in proportion to their length (as masked
+// kernels do), and half of them miss.  Compares a linear scan of the row,
+// the default binary search, and the optional per-row hash index.
+//
+// Usage: find_benchmark [max rmat scale] [edge factor] [lookups]
+
+template <typename F>
+double nanoseconds_per_call(F&& f, std::size_t calls) {
+  auto begin = std::chrono::steady_clock::now();
+  std::size_t found = f();
+  auto end = std::chrono::steady_clock::now();
+
+  // Keep the lookups from being optimized away.
+  if (found > calls) {
+    std::cout << found << std::endl;
+  }
+  return std::chrono::duration<double, std::nano>(end - begin).count() / calls;
+}
+
+int main(int argc, char** argv) {
+  std::size_t max_scale = argc > 1 ? std::stoul(argv[1]) : 18;
+  std::size_t edge_factor = argc > 2 ? std::stoul(argv[2]) : 16;
+  std::size_t lookups = argc > 3 ? std::stoul(argv[3]) : 1000000;
+
+  std::cout << std::setw(6) << "scale" << std::setw(10) << "max row"
+            << std::setw(14) << "linear (ns)" << std::setw(14) << "binary (ns)"
+            << std::setw(14) << "hashed (ns)" << "\n";
+
+  for (std::size_t scale = 10; scale <= max_scale; scale += 2) {
+    auto a = grb::generate_rmat<float, std::uint32_t>(scale, edge_factor);
+    auto&& csr = a.backend();
+
+    std::vector<grb::index<std::uint32_t>> keys;
+    std::mt19937 gen(scale);
+    std::uniform_int_distribution<std::size_t> element(0, a.size() - 1);
+    std::uniform_int_distribution<std::uint32_t> column(0, a.shape()[1] - 1);
+    for (std::size_t k = 0; k < lookups; k++) {
+      auto&& [index, _] = *(a.begin() + element(gen));
+      auto&& [i, j] = index;
+      keys.push_back({i, k % 2 == 0 ? j : column(gen)});
+    }
+
+    std::size_t max_row = 0;
+    for (std::uint32_t i = 0; i < a.shape()[0]; i++) {
+      max_row = std::max<std::size_t>(max_row,
+                                      csr.rowptr()[i + 1] - csr.rowptr()[i]);
+    }
+
+    auto linear = nanoseconds_per_call(
+        [&] {
+          std::size_t found = 0;
+          for (auto&& [i, j] : keys) {
+            for (auto ptr = csr.rowptr()[i]; ptr < csr.rowptr()[i + 1];
+                 ptr++) {
+              if (csr.colind()[ptr] == j) {
+                found++;
+                break;
+              }
+            }
+          }
+          return found;
+        },
+        lookups);
+
+    auto find_all = [&] {
+      std::size_t found = 0;
+      for (auto&& key : keys) {
+        found += a.find(key) != a.end();
+      }
+      return found;
+    };
+
+    auto binary = nanoseconds_per_call(find_all, lookups);
+
+    a.backend().build_hash_index();
+    auto hashed = nanoseconds_per_call(find_all, lookups);
+
+    std::cout << std::fixed << std::setprecision(1) << std::setw(6) << scale
+              << std::setw(10) << max_row << std::setw(14) << linear
+              << std::setw(14) << binary << std::setw(14) << hashed << "\n";
+  }
+
+  return 0;
+}
@@ -0,0 +1,71 @@
+#include <chrono>
+#include <grb/grb.hpp>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Building a sparse matrix one element at a time.  `insert(value)` returns an
+// iterator, so it merges every element into the CSR arrays as it goes;
+// `operator[]` only appends to the pending buffer, which is merged once by
+// `wait()`.
+//
+// Usage: insert_benchmark [max elements]
+
+template <typename F>
+double seconds(F&& f) {
+  auto begin = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - begin).count();
+}
+
+int main(int argc, char** argv) {
+  std::size_t max_elements = argc > 1 ? std::stoul(argv[1]) : 1 << 22;
+
+  std::cout << std::setw(10) << "elements" << std::setw(16) << "insert (ms)"
+            << std::setw(16) << "pending (ms)" << "\n";
+
+  for (std::size_t elements = 1 << 10; elements <= max_elements;
+       elements *= 4) {
+    std::uint32_t n = elements / 4;
+
+    std::vector<grb::index<std::uint32_t>> keys;
+    std::mt19937 gen(elements);
+    std::uniform_int_distribution<std::uint32_t> index(0, n - 1);
+    for (std::size_t k = 0; k < elements; k++) {
+      keys.push_back({index(gen), index(gen)});
+    }
+
+    // Merging on every insert is quadratic; skip it for large sizes.
+    double eager = -1;
+    if (elements <= (1 << 14)) {
+      eager = seconds([&] {
+        grb::matrix<float, std::uint32_t> a({n, n});
+        for (auto&& key : keys) {
+          a.insert({key, 1.0f});
+        }
+      });
+    }
+
+    double pending = seconds([&] {
+      grb::matrix<float, std::uint32_t> a({n, n});
+      for (auto&& key : keys) {
+        a[key] += 1.0f;
+      }
+      a.wait();
+    });
+
+    std::cout << std::fixed << std::setprecision(2) << std::setw(10)
+              << elements << std::setw(16);
+    if (eager >= 0) {
+      std::cout << eager * 1000;
+    } else {
+      std::cout << "-";
+    }
+    std::cout << std::setw(16) << pending * 1000 << "\n";
+  }
+
+  return 0;
+}
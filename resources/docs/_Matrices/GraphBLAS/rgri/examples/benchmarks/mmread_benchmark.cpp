@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <grb/grb.hpp>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+// Matrix Market read throughput: a line-by-line `std::getline` and
+// `std::istringstream` parser followed by insert() (how grb::matrix used to
+// load files), against the memory-mapped parallel reader on 1 to N
+// threads.  Without an argument, writes an R-MAT graph to a temporary file
+// first.
+//
+// Usage: mmread_benchmark [matrix.mtx | rmat scale] [max threads]
+
+template <typename F>
+double seconds(F&& f) {
+  auto begin = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - begin).count();
+}
+
+std::string write_rmat(std::size_t scale) {
+  auto a = grb::generate_rmat<float, std::uint32_t>(scale, 16, 1);
+  auto path = std::filesystem::temp_directory_path() /
+              ("rmat_" + std::to_string(scale) + ".mtx");
+  std::ofstream f(path);
+  f << "%%MatrixMarket matrix coordinate real general\n";
+  f << a.shape()[0] << " " << a.shape()[1] << " " << a.size() << "\n";
+  for (auto&& [index, value] : a) {
+    auto&& [i, j] = index;
+    f << i + 1 << " " << j + 1 << " " << value << "\n";
+  }
+  return path.string();
+}
+
+grb::matrix<float, std::uint32_t> read_with_getline(const std::string& path) {
+  std::ifstream f(path);
+  std::string buf;
+  std::getline(f, buf);
+  do {
+    std::getline(f, buf);
+  } while (buf[0] == '%');
+
+  std::uint32_t m, n, nnz;
+  std::istringstream(buf) >> m >> n >> nnz;
+
+  grb::coo_matrix<float, std::uint32_t> tuples({m, n});
+  tuples.reserve(nnz);
+  while (std::getline(f, buf)) {
+    std::uint32_t i, j;
+    float v;
+    std::istringstream ss(buf);
+    ss >> i >> j >> v;
+    tuples.push_back({{i - 1, j - 1}, v});
+  }
+
+  grb::matrix<float, std::uint32_t> a({m, n});
+  a.insert(tuples.begin(), tuples.end());
+  a.wait();
+  return a;
+}
+
+int main(int argc, char** argv) {
+  std::string arg = argc > 1 ? argv[1] : "16";
+  std::size_t max_threads =
+      argc > 2 ? std::stoul(argv[2])
+               : std::max(std::thread::hardware_concurrency(), 1u);
+
+  std::string path = arg.ends_with(".mtx") ? arg : write_rmat(std::stoul(arg));
+  double megabytes = std::filesystem::file_size(path) / 1e6;
+
+  std::size_t nnz = 0;
+  auto baseline = seconds([&] { nnz = read_with_getline(path).size(); });
+
+  std::cout << path << ": " << std::fixed << std::setprecision(1) << megabytes
+            << " MB, " << nnz << " nonzeros\n";
+  std::cout << std::setw(10) << "reader" << std::setw(12) << "time (ms)"
+            << std::setw(10) << "MB/s" << "\n";
+  std::cout << std::setw(10) << "getline" << std::setw(12) << baseline * 1000
+            << std::setw(10) << megabytes / baseline << "\n";
+
+  for (std::size_t threads = 1; threads <= max_threads; threads++) {
+    grb::set_max_threads(threads);
+    auto time = seconds([&] {
+      grb::matrix<float, std::uint32_t> a(path);
+      nnz = a.size();
+    });
+    std::cout << std::setw(10) << threads << std::setw(12) << time * 1000
+              << std::setw(10) << megabytes / time << "\n";
+  }
+  grb::set_max_threads(0);
+
+  return 0;
+}
@@ -0,0 +1,101 @@
+#include <chrono>
+#include <grb/grb.hpp>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Breadth-first search on an R-MAT graph with the masked matrix-vector
+// product `next = A^T * frontier`, masked by the complement of the visited
+// set, as in examples/algorithms/breadth_first_search.cpp.  Times each level
+// with the direction picked per call by `grb::multiply`, with push and pull
+// forced, and with the element-by-element kernel used for other matrix
+// types (reached here through an identity transform view).
+//
+// Usage: push_pull_bfs [rmat scale] [edge factor]
+
+template <typename F>
+double microseconds(F&& f) {
+  auto begin = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(end - begin).count();
+}
+
+int main(int argc, char** argv) {
+  std::size_t scale = argc > 1 ? std::stoul(argv[1]) : 16;
+  std::size_t edge_factor = argc > 2 ? std::stoul(argv[2]) : 16;
+
+  auto a = grb::generate_rmat<int, std::uint32_t>(scale, edge_factor);
+  auto n = a.shape()[0];
+  std::cout << "R-MAT scale " << scale << ": " << n << " vertices, "
+            << a.size() << " edges\n";
+
+  auto at = grb::transpose(a);
+  auto identity = grb::views::transform(at, [](auto&& e) {
+    return grb::get<1>(e);
+  });
+
+  // Builds the cached column index outside the timed region.
+  auto access = grb::__detail::make_row_column_access(at);
+
+  using vector_type = grb::vector<int, std::uint32_t>;
+  vector_type frontier(n);
+  vector_type visited(n);
+  frontier[0] = 1;
+  visited[0] = 1;
+
+  std::cout << std::setw(6) << "level" << std::setw(10) << "frontier"
+            << std::setw(12) << "direction" << std::setw(12) << "auto (us)"
+            << std::setw(12) << "push (us)" << std::setw(12) << "pull (us)"
+            << std::setw(12) << "scan (us)" << "\n";
+
+  double totals[4] = {};
+  for (std::size_t level = 0; frontier.size() > 0; level++) {
+    auto mask = grb::complement_view(visited);
+    auto direction = grb::__detail::choose_spmv_direction(
+        access, frontier, mask, true);
+
+    vector_type next;
+    double times[4] = {
+        microseconds([&] {
+          next = grb::multiply(at, frontier, grb::take_left{}, grb::times{},
+                               mask);
+        }),
+        microseconds([&] {
+          grb::__detail::spmv_push<vector_type>(
+              access, frontier, grb::take_left{}, grb::times{}, mask);
+        }),
+        microseconds([&] {
+          grb::__detail::spmv_pull<vector_type>(
+              access, frontier, grb::take_left{}, grb::times{}, mask);
+        }),
+        microseconds([&] {
+          grb::multiply(identity, frontier, grb::take_left{}, grb::times{},
+                        mask);
+        })};
+
+    std::cout << std::fixed << std::setprecision(1) << std::setw(6) << level
+              << std::setw(10) << frontier.size() << std::setw(12)
+              << (direction == grb::__detail::spmv_direction::push ? "push"
+                                                                   : "pull");
+    for (std::size_t k = 0; k < 4; k++) {
+      std::cout << std::setw(12) << times[k];
+      totals[k] += times[k];
+    }
+    std::cout << "\n";
+
+    for (auto&& [j, _] : next) {
+      visited[j] = 1;
+    }
+    frontier = std::move(next);
+  }
+
+  std::cout << std::setw(28) << "total";
+  for (double total : totals) {
+    std::cout << std::setw(12) << total;
+  }
+  std::cout << "\n";
+
+  return 0;
+}
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <execution>
+#include <grb/grb.hpp>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Reductions.  Sums a dense vector of doubles with mixed signs and
+// magnitudes (profits and losses over many positions) with each summation
+// mode of grb::reduce_to_scalar, sequentially and in parallel, against a
+// plain loop over the vector's elements, and reports each sum's error
+// against a long double reference.  Then reduces the rows of an R-MAT
+// matrix with grb::reduce, against the element-by-element fold it used to
+// do, and its columns with grb::reduce_columns.
+//
+// Usage: reduce_benchmark [log2 of vector size] [R-MAT scale]
+
+template <typename F>
+double median_seconds(F&& f, std::size_t runs = 7) {
+  // Untimed warm-up run.
+  f();
+
+  std::vector<double> times;
+  for (std::size_t run = 0; run < runs; run++) {
+    auto begin = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    times.push_back(std::chrono::duration<double>(end - begin).count());
+  }
+  std::sort(times.begin(), times.end());
+  return times[times.size() / 2];
+}
+
+// Row reduction as grb::reduce did it: every element looked up in the mask
+// and folded into the output vector.
+template <typename M>
+auto reduce_by_element(M& a) {
+  grb::vector<float, int> v(a.shape()[0]);
+  grb::full_vector_mask<> mask;
+  for (auto&& [index, a_v] : a) {
+    auto&& [i, j] = index;
+    float value = a_v;
+    if (mask.find(i) != mask.end()) {
+      auto iter = v.find(i);
+      if (iter != v.end()) {
+        auto&& [_, v_v] = *iter;
+        value = value + v_v;
+      }
+      v.insert_or_assign(i, value);
+    }
+  }
+  return v;
+}
+
+template <typename Summation>
+void report(const std::string& name, grb::vector<double, std::size_t>& x,
+            long double exact) {
+  double sum = 0;
+  auto seq = median_seconds([&] {
+    sum = grb::reduce_to_scalar<Summation>(x);
+  });
+  auto par = median_seconds([&] {
+    sum = grb::reduce_to_scalar<Summation>(std::execution::par, x);
+  });
+  std::cout << std::setw(22) << name << std::setw(12) << seq * 1000
+            << std::setw(12) << par * 1000 << std::setw(14) << std::scientific
+            << std::setprecision(2)
+            << double(std::abs((long double)(sum) - exact)) << std::fixed
+            << "\n";
+}
+
+int main(int argc, char** argv) {
+  std::size_t log_n = argc > 1 ? std::stoul(argv[1]) : 25;
+  std::size_t scale = argc > 2 ? std::stoul(argv[2]) : 20;
+
+  std::size_t n = std::size_t(1) << log_n;
+  std::mt19937_64 gen(0);
+  std::lognormal_distribution<double> size(0, 2);
+  std::uniform_int_distribution<int> sign(0, 1);
+
+  grb::vector<double, std::size_t> pnl(n);
+  long double exact = 0;
+  for (std::size_t k = 0; k < n; k++) {
+    double v = (sign(gen) ? 1 : -1) * size(gen) * 1000;
+    pnl[k] = v;
+    exact += v;
+  }
+
+  std::cout << "sum of " << n << " doubles (" << grb::max_threads()
+            << " threads)\n"
+            << std::fixed << std::setprecision(2) << std::setw(22) << "method"
+            << std::setw(12) << "seq (ms)" << std::setw(12) << "par (ms)"
+            << std::setw(14) << "abs. error" << "\n";
+
+  double loop_sum = 0;
+  auto loop = median_seconds([&] {
+    loop_sum = 0;
+    for (auto&& [_, v] : pnl) {
+      loop_sum += v;
+    }
+  });
+  std::cout << std::setw(22) << "element loop" << std::setw(12)
+            << loop * 1000 << std::setw(12) << "-" << std::setw(14)
+            << std::scientific << std::setprecision(2)
+            << double(std::abs((long double)(loop_sum) - exact)) << std::fixed
+            << "\n";
+
+  report<grb::blocked_summation>("blocked_summation", pnl, exact);
+  report<grb::pairwise_summation>("pairwise_summation", pnl, exact);
+  report<grb::kahan_summation>("kahan_summation", pnl, exact);
+
+  auto a = grb::generate_rmat<float, int>(scale, 16, 1);
+  std::cout << "\nR-MAT scale " << scale << ", nnz = " << a.size() << "\n";
+
+  auto by_element = median_seconds([&] { reduce_by_element(a); }, 3);
+  auto rows = median_seconds([&] { grb::reduce(a); });
+  auto rows_par = median_seconds([&] { grb::reduce(std::execution::par, a); });
+  auto columns = median_seconds([&] { grb::reduce_columns(a); });
+  auto columns_par = median_seconds(
+      [&] { grb::reduce_columns(std::execution::par, a); });
+
+  std::cout << "  rows: element fold " << by_element * 1000
+            << " ms, grb::reduce " << rows * 1000 << " ms (par "
+            << rows_par * 1000 << " ms)\n"
+            << "  columns: grb::reduce_columns " << columns * 1000
+            << " ms (par " << columns_par * 1000 << " ms)\n";
+
+  return 0;
+}
@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <execution>
+#include <grb/grb.hpp>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+// Reordering for matrix-vector products.  A geometric graph stands in for a
+// correlation graph: points in the unit square, each linked to those within
+// a radius, labelled at random.  Also an R-MAT graph.  For each, times
+// grb::permute by a random permutation (inserting the renumbered elements,
+// in one batch, against the O(nnz) counting sort), the RCM and degree
+// orderings, and grb::multiply with a dense vector before and after.
+//
+// Usage: reorder_spmv [scale] [average degree]
+
+template <typename F>
+double median_seconds(F&& f, std::size_t runs = 5) {
+  // Untimed warm-up run.
+  f();
+
+  std::vector<double> times;
+  for (std::size_t run = 0; run < runs; run++) {
+    auto begin = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    times.push_back(std::chrono::duration<double>(end - begin).count());
+  }
+  std::sort(times.begin(), times.end());
+  return times[times.size() / 2];
+}
+
+template <typename M, typename P>
+auto permute_by_insertion(M& m, const P& p) {
+  using I = grb::matrix_index_t<M>;
+  std::vector<I> inverse(p.size());
+  for (std::size_t k = 0; k < p.size(); k++) {
+    inverse[p[k]] = I(k);
+  }
+  using T = grb::matrix_scalar_t<M>;
+  std::vector<grb::matrix_entry<T, I>> elements;
+  elements.reserve(m.size());
+  for (auto&& [index, v] : m) {
+    auto&& [i, j] = index;
+    elements.push_back({{inverse[i], inverse[j]}, v});
+  }
+  grb::matrix<T, I> o(m.shape());
+  o.insert(elements.begin(), elements.end());
+  o.wait();
+  return o;
+}
+
+template <typename M>
+std::size_t bandwidth(M& m) {
+  std::size_t b = 0;
+  for (auto&& [index, _] : m) {
+    auto&& [i, j] = index;
+    b = std::max<std::size_t>(b, i > j ? i - j : j - i);
+  }
+  return b;
+}
+
+// Points in cells of a grid, linked to the points of neighbouring cells
+// within `radius`.
+grb::matrix<float, int> geometric_graph(std::size_t n, double degree) {
+  std::mt19937 gen(n);
+  std::uniform_real_distribution<double> coordinate(0, 1);
+  std::vector<std::pair<double, double>> points(n);
+  for (auto&& point : points) {
+    point = {coordinate(gen), coordinate(gen)};
+  }
+
+  double radius = std::sqrt(degree / (3.14159 * n));
+  std::size_t cells = std::max<std::size_t>(1, std::size_t(1 / radius));
+  std::vector<std::vector<int>> grid(cells * cells);
+  auto cell = [&](double c) {
+    return std::min(cells - 1, std::size_t(c * cells));
+  };
+  for (std::size_t v = 0; v < n; v++) {
+    grid[cell(points[v].first) * cells + cell(points[v].second)].push_back(v);
+  }
+
+  std::vector<grb::matrix_entry<float, int>> elements;
+  for (std::size_t v = 0; v < n; v++) {
+    auto [x, y] = points[v];
+    std::size_t cx = cell(x);
+    std::size_t cy = cell(y);
+    for (std::size_t gx = cx ? cx - 1 : 0; gx <= std::min(cells - 1, cx + 1);
+         gx++) {
+      for (std::size_t gy = cy ? cy - 1 : 0;
+           gy <= std::min(cells - 1, cy + 1); gy++) {
+        for (int w : grid[gx * cells + gy]) {
+          double dx = points[w].first - x;
+          double dy = points[w].second - y;
+          if (dx * dx + dy * dy <= radius * radius) {
+            elements.push_back({{int(v), w}, 1});
+          }
+        }
+      }
+    }
+  }
+  grb::matrix<float, int> a({int(n), int(n)});
+  a.insert(elements.begin(), elements.end());
+  a.wait();
+  return a;
+}
+
+template <typename M>
+void benchmark(const std::string& name, M& ordered) {
+  std::size_t n = ordered.shape()[0];
+  std::vector<int> shuffle(n);
+  std::iota(shuffle.begin(), shuffle.end(), 0);
+  std::shuffle(shuffle.begin(), shuffle.end(), std::mt19937(n));
+  auto a = grb::permute(ordered, shuffle);
+
+  auto insertion = median_seconds([&] { permute_by_insertion(a, shuffle); }, 1);
+  auto counting = median_seconds([&] { grb::permute(a, shuffle); });
+
+  std::vector<int> rcm;
+  auto rcm_time = median_seconds([&] { rcm = grb::rcm_ordering(a); }, 1);
+  std::vector<int> degree;
+  auto degree_time = median_seconds([&] { degree = grb::degree_ordering(a); });
+
+  auto by_rcm = grb::permute(a, rcm);
+  auto by_degree = grb::permute(a, degree);
+
+  grb::vector<float, int> x(n);
+  for (std::size_t j = 0; j < n; j++) {
+    x[j] = float(j % 17);
+  }
+  auto spmv = [&](auto& m) {
+    return median_seconds([&] { grb::multiply(m, x); }) * 1000;
+  };
+
+  std::cout << name << ": n = " << n << ", nnz = " << a.size() << "\n"
+            << std::fixed << std::setprecision(2)
+            << "  permute: insertion " << insertion * 1000
+            << " ms, counting sort " << counting * 1000 << " ms\n"
+            << "  ordering: RCM " << rcm_time * 1000 << " ms, degree "
+            << degree_time * 1000 << " ms\n"
+            << std::setw(12) << "order" << std::setw(12) << "bandwidth"
+            << std::setw(12) << "mxv (ms)" << "\n"
+            << std::setw(12) << "random" << std::setw(12) << bandwidth(a)
+            << std::setw(12) << spmv(a) << "\n"
+            << std::setw(12) << "RCM" << std::setw(12) << bandwidth(by_rcm)
+            << std::setw(12) << spmv(by_rcm) << "\n"
+            << std::setw(12) << "degree" << std::setw(12)
+            << bandwidth(by_degree) << std::setw(12) << spmv(by_degree)
+            << "\n";
+}
+
+int main(int argc, char** argv) {
+  std::size_t scale = argc > 1 ? std::stoul(argv[1]) : 19;
+  double degree = argc > 2 ? std::stod(argv[2]) : 16;
+
+  auto geometric = geometric_graph(std::size_t(1) << scale, degree);
+  benchmark("geometric", geometric);
+
+  auto rmat = grb::generate_rmat<float, int>(scale, std::size_t(degree), 1);
+  benchmark("R-MAT", rmat);
+
+  return 0;
+}
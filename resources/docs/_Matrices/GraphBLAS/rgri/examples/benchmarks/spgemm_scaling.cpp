@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <chrono>
+#include <execution>
+#include <grb/grb.hpp>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Strong scaling of the parallel (`std::execution::par`) kernels from 1 to
+// N threads, on the chesapeake graph and on a generated R-MAT graph.
+//
+// Usage: spgemm_scaling [matrix.mtx] [rmat scale] [rmat edge factor]
+//                       [max threads]
+
+template <typename F>
+double median_seconds(F&& f, std::size_t runs = 5) {
+  // Untimed warm-up run.
+  f();
+
+  std::vector<double> times;
+  for (std::size_t run = 0; run < runs; run++) {
+    auto begin = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    times.push_back(std::chrono::duration<double>(end - begin).count());
+  }
+  std::sort(times.begin(), times.end());
+  return times[times.size() / 2];
+}
+
+// Multiply-adds needed for A * A: nnz(A(k, :)) for every nonzero A(i, k).
+template <typename M>
+std::size_t spgemm_flops(M&& a) {
+  std::vector<std::size_t> row_sizes(a.shape()[0]);
+  for (auto&& [index, _] : a) {
+    auto&& [i, k] = index;
+    row_sizes[i]++;
+  }
+
+  std::size_t flops = 0;
+  for (auto&& [index, _] : a) {
+    auto&& [i, k] = index;
+    flops += row_sizes[k];
+  }
+  return flops;
+}
+
+template <typename M>
+void benchmark(const std::string& name, M&& a, std::size_t max_threads) {
+  using T = grb::matrix_scalar_t<M>;
+  using I = grb::matrix_index_t<M>;
+
+  grb::vector<T, I> x(a.shape()[1]);
+  for (I j = 0; j < a.shape()[1]; j++) {
+    x[j] = 1;
+  }
+
+  auto flops = spgemm_flops(a);
+
+  std::cout << name << ": " << a.shape()[0] << " x " << a.shape()[1] << ", "
+            << a.size() << " nonzeros, " << flops << " SpGEMM flops\n";
+  std::cout << std::setw(8) << "threads" << std::setw(14) << "A*A (ms)"
+            << std::setw(9) << "speedup" << std::setw(14) << "A*x (ms)"
+            << std::setw(9) << "speedup" << std::setw(14) << "A+A (ms)"
+            << std::setw(9) << "speedup" << std::setw(14) << "reduce (ms)"
+            << std::setw(9) << "speedup" << "\n";
+
+  std::vector<double> baseline;
+  for (std::size_t threads = 1; threads <= max_threads; threads++) {
+    grb::set_max_threads(threads);
+
+    std::vector<double> times = {
+        median_seconds([&] { grb::multiply(std::execution::par, a, a); }),
+        median_seconds([&] { grb::multiply(std::execution::par, a, x); }),
+        median_seconds([&] {
+          grb::ewise_union(std::execution::par, a, a, grb::plus{});
+        }),
+        median_seconds([&] { grb::reduce(std::execution::par, a); })};
+
+    if (threads == 1) {
+      baseline = times;
+    }
+
+    std::cout << std::setw(8) << threads << std::fixed;
+    for (std::size_t k = 0; k < times.size(); k++) {
+      std::cout << std::setw(14) << std::setprecision(3) << times[k] * 1000
+                << std::setw(8) << std::setprecision(2)
+                << baseline[k] / times[k] << "x";
+    }
+    std::cout << "\n";
+  }
+  std::cout << std::endl;
+
+  grb::set_max_threads(0);
+}
+
+int main(int argc, char** argv) {
+  std::string path = argc > 1 ? argv[1] : "../chesapeake/chesapeake.mtx";
+  std::size_t scale = argc > 2 ? std::stoul(argv[2]) : 16;
+  std::size_t edge_factor = argc > 3 ? std::stoul(argv[3]) : 16;
+  std::size_t max_threads =
+      argc > 4 ? std::stoul(argv[4])
+               : std::max(std::thread::hardware_concurrency(), 1u);
+
+  grb::matrix<float, int> a(path);
+  benchmark(path, a, max_threads);
+
+  auto rmat = grb::generate_rmat<float, int>(scale, edge_factor);
+  benchmark("R-MAT scale " + std::to_string(scale) + ", edge factor " +
+                std::to_string(edge_factor),
+            rmat, max_threads);
+
+  return 0;
+}
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <chrono>
+#include <execution>
+#include <grb/grb.hpp>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Single-source shortest paths on R-MAT graphs with random integer weights:
+// Bellman-Ford with whole-matrix min-plus products (the approach of
+// examples/algorithms/sssp.cpp) against grb::sssp's delta-stepping,
+// sequential and parallel.  Bellman-Ford makes one pass over every edge per
+// iteration, and needs as many iterations as the longest shortest path has
+// edges.
+//
+// Usage: sssp_benchmark [max rmat scale] [edge factor] [max weight]
+
+template <typename F>
+double median_seconds(F&& f, std::size_t runs = 5) {
+  // Untimed warm-up run.
+  f();
+
+  std::vector<double> times;
+  for (std::size_t run = 0; run < runs; run++) {
+    auto begin = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    times.push_back(std::chrono::duration<double>(end - begin).count());
+  }
+  std::sort(times.begin(), times.end());
+  return times[times.size() / 2];
+}
+
+// Relax every edge until no distance changes.  Returns the distances and
+// the number of iterations.
+template <typename M>
+auto bellman_ford(M& a, std::size_t source) {
+  using T = grb::matrix_scalar_t<M>;
+  using I = grb::matrix_index_t<M>;
+
+  grb::vector<T, I> dist(a.shape()[0]);
+  dist[source] = 0;
+
+  std::size_t iterations = 0;
+  while (true) {
+    iterations++;
+    auto update = grb::multiply(grb::transpose(a), dist, grb::min{},
+                                grb::plus{});
+    auto next = grb::ewise_union(dist, update, grb::min{});
+
+    bool changed = next.size() != dist.size();
+    for (auto&& [index, d] : next) {
+      if (changed) {
+        break;
+      }
+      auto iter = dist.find(index);
+      changed = iter == dist.end() || grb::get<1>(*iter) != d;
+    }
+    if (!changed) {
+      return std::pair{dist, iterations};
+    }
+    dist = std::move(next);
+  }
+}
+
+int main(int argc, char** argv) {
+  std::size_t max_scale = argc > 1 ? std::stoul(argv[1]) : 18;
+  std::size_t edge_factor = argc > 2 ? std::stoul(argv[2]) : 16;
+  int max_weight = argc > 3 ? std::stoi(argv[3]) : 1000;
+
+  std::cout << std::setw(6) << "scale" << std::setw(12) << "nnz"
+            << std::setw(8) << "BF its" << std::setw(16) << "B-F (ms)"
+            << std::setw(16) << "delta seq (ms)" << std::setw(16)
+            << "delta par (ms)" << std::setw(8) << "match" << "\n";
+
+  for (std::size_t scale = 12; scale <= max_scale; scale += 2) {
+    auto a = grb::generate_rmat<int, int>(scale, edge_factor, scale);
+    std::mt19937 gen(scale);
+    std::uniform_int_distribution<int> weight(1, max_weight);
+    for (auto&& [_, w] : a) {
+      w = weight(gen);
+    }
+
+    // The vertex with the most out-edges, so most of the graph is reached.
+    std::size_t source = 0;
+    std::size_t best = 0;
+    auto rowptr = a.backend().rowptr();
+    for (std::size_t i = 0; i + 1 < rowptr.size(); i++) {
+      if (std::size_t(rowptr[i + 1] - rowptr[i]) > best) {
+        best = rowptr[i + 1] - rowptr[i];
+        source = i;
+      }
+    }
+
+    auto [reference, iterations] = bellman_ford(a, source);
+    auto dist = grb::sssp(a, int(source));
+    bool match = dist.size() == reference.size();
+    for (auto&& [index, d] : dist) {
+      auto iter = reference.find(index);
+      match = match && iter != reference.end() && grb::get<1>(*iter) == d;
+    }
+
+    auto bf = median_seconds([&] { bellman_ford(a, source); }, 1);
+    auto seq = median_seconds([&] { grb::sssp(a, int(source)); });
+    auto par = median_seconds(
+        [&] { grb::sssp(std::execution::par, a, int(source)); });
+
+    std::cout << std::fixed << std::setprecision(2) << std::setw(6) << scale
+              << std::setw(12) << a.size() << std::setw(8) << iterations
+              << std::setw(16) << bf * 1000 << std::setw(16) << seq * 1000
+              << std::setw(16) << par * 1000 << std::setw(8)
+              << (match ? "yes" : "NO") << "\n";
+  }
+
+  return 0;
+}
@@ -1,7 +1,10 @@
 #pragma once
 
 #include <grb/algorithms/assign.hpp>
+#include <grb/algorithms/betweenness_centrality.hpp>
 #include <grb/algorithms/ewise.hpp>
 #include <grb/algorithms/multiply.hpp>
 #include <grb/algorithms/permute.hpp>
 #include <grb/algorithms/reduce.hpp>
+#include <grb/algorithms/reorder.hpp>
+#include <grb/algorithms/sssp.hpp>
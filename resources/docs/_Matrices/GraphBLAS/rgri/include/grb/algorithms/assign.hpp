@@ -1,9 +1,15 @@
 #pragma once
 
+#include <grb/detail/row_compressed.hpp>
 #include <type_traits>
+#include <utility>
 
 namespace grb {
 
+/// Replace the contents of `a` with the elements of `b`.  A CSR-backed `a` is
+/// filled with a counting sort straight into new CSR arrays, one pass to
+/// count and one to fill, however many views `b` is built from.  `b` may be
+/// a view of `a`.
 template <grb::MatrixRange B,
           grb::MutableMatrixRange<grb::matrix_scalar_t<B>> A>
 void assign(A&& a, B&& b) {
@@ -11,8 +17,18 @@ void assign(A&& a, B&& b) {
     throw grb::invalid_argument("assign: dimensions of a and b do not match.");
   }
 
-  a.clear();
-  a.insert(std::ranges::begin(b), std::ranges::end(b));
+  if constexpr (__detail::csr_assignable<A>) {
+    using backend_type = typename std::remove_cvref_t<A>::backend_type;
+    typename backend_type::index_vector_type rowptr;
+    typename backend_type::index_vector_type colind;
+    typename backend_type::values_vector_type values;
+    __detail::gather_csr(b, rowptr, colind, values);
+    a.backend().assign_csr(std::move(rowptr), std::move(colind),
+                           std::move(values));
+  } else {
+    a.clear();
+    a.insert(std::ranges::begin(b), std::ranges::end(b));
+  }
 }
 
 template <typename T, grb::MutableMatrixRange<T> A>
@@ -41,4 +57,35 @@ void assign(A&& a, const T& value) {
   }
 }
 
+namespace __detail {
+
+// c (accumulate)= z, in place: elements of `z` are folded into `c` with
+// `accumulate` where `c` already has one.  With `merge`, other elements of
+// `c` are kept; otherwise `c` ends up with exactly the elements of `z`, and
+// `z` (a temporary) is updated and assigned to `c`.
+template <typename C, typename Z, typename Accumulate>
+void accumulate_into(C&& c, Z&& z, Accumulate&& accumulate, bool merge) {
+  if (merge) {
+    for (auto&& [index, z_value] : z) {
+      auto iter = c.find(index);
+      if (iter != c.end()) {
+        auto&& [_, c_value] = *iter;
+        c_value = accumulate(c_value, z_value);
+      } else {
+        c.insert({index, z_value});
+      }
+    }
+  } else {
+    for (auto&& [index, z_value] : z) {
+      auto iter = c.find(index);
+      if (iter != c.end()) {
+        z_value = accumulate(grb::get<1>(*iter), z_value);
+      }
+    }
+    grb::assign(c, z);
+  }
+}
+
+} // namespace __detail
+
 } // namespace grb
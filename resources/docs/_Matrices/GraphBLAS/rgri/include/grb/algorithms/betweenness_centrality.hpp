@@ -0,0 +1,356 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <grb/containers/vector.hpp>
+#include <grb/detail/concepts.hpp>
+#include <grb/detail/matrix_traits.hpp>
+#include <grb/detail/parallel.hpp>
+#include <grb/detail/row_compressed.hpp>
+#include <grb/exceptions/exception.hpp>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace grb {
+
+namespace __detail {
+
+// One BFS level of a batch of sources, as a sparse matrix with a row per
+// source: row s holds the vertices at this depth from source s (in no
+// particular order), their number of shortest paths `sigma`, and their
+// dependency `delta`, filled in on the way back.
+template <std::integral I>
+struct bc_level {
+  std::vector<std::size_t> rowptr;
+  std::vector<I> colind;
+  std::vector<double> sigma;
+  std::vector<double> delta;
+
+  std::size_t size() const noexcept {
+    return colind.size();
+  }
+};
+
+// Per-worker dense scratch space of one value per vertex, kept zeroed
+// between rows.
+struct bc_scratch {
+  std::vector<double> values;
+  std::vector<std::size_t> touched;
+};
+
+// Rows of `level` split between up to `max_workers` workers by the number
+// of edges leaving them.
+template <typename Rows, std::integral I>
+std::vector<std::size_t> bc_partition(const Rows& a, const bc_level<I>& level,
+                                      std::size_t& workers,
+                                      std::size_t max_workers) {
+  auto rowptr = a.rowptr();
+  std::size_t ns = level.rowptr.size() - 1;
+  std::vector<std::size_t> edges(ns + 1, 0);
+  for (std::size_t s = 0; s < ns; s++) {
+    edges[s + 1] = edges[s];
+    for (auto ptr = level.rowptr[s]; ptr < level.rowptr[s + 1]; ptr++) {
+      I v = level.colind[ptr];
+      edges[s + 1] += rowptr[v + 1] - rowptr[v];
+    }
+  }
+  workers = num_workers(edges[ns], max_workers);
+  return balanced_partition(std::span<const std::size_t>(edges), workers);
+}
+
+// Next level of the batched BFS: the masked SpGEMM
+//
+//   next<!visited> = frontier * A
+//
+// over the (plus, first) semiring, so each vertex's `sigma` is the sum over
+// its predecessors in the frontier.  Rows are computed by Gustavson's method
+// into a dense accumulator, then marked visited.  `visited` has
+// `words` 64-bit words per source, so workers never share a word.
+template <typename Rows, std::integral I>
+bc_level<I> bc_expand(const Rows& a, const bc_level<I>& frontier,
+                      std::vector<std::uint64_t>& visited, std::size_t words,
+                      std::vector<bc_scratch>& scratch,
+                      std::size_t max_workers) {
+  auto rowptr = a.rowptr();
+  auto colind = a.colind();
+  std::size_t ns = frontier.rowptr.size() - 1;
+
+  std::size_t workers = 0;
+  auto bounds = bc_partition(a, frontier, workers, max_workers);
+
+  // Workers own contiguous ranges of rows, so their outputs, concatenated
+  // in order, are the rows of the next level.
+  std::vector<bc_level<I>> parts(workers);
+  parallel_for_workers(workers, [&](std::size_t worker) {
+    auto&& [acc, touched] = scratch[worker];
+    auto&& out = parts[worker];
+    out.rowptr.push_back(0);
+
+    for (auto s = bounds[worker]; s < bounds[worker + 1]; s++) {
+      std::uint64_t* seen = visited.data() + s * words;
+      for (auto ptr = frontier.rowptr[s]; ptr < frontier.rowptr[s + 1];
+           ptr++) {
+        I v = frontier.colind[ptr];
+        double paths = frontier.sigma[ptr];
+        for (auto e = rowptr[v]; e < rowptr[v + 1]; e++) {
+          std::size_t w = colind[e];
+          if (seen[w / 64] >> (w % 64) & 1) {
+            continue;
+          }
+          if (acc[w] == 0) {
+            touched.push_back(w);
+          }
+          acc[w] += paths;
+        }
+      }
+
+      for (auto w : touched) {
+        seen[w / 64] |= std::uint64_t(1) << (w % 64);
+        out.colind.push_back(I(w));
+        out.sigma.push_back(acc[w]);
+        acc[w] = 0;
+      }
+      touched.clear();
+      out.rowptr.push_back(out.colind.size());
+    }
+  });
+
+  bc_level<I> next;
+  next.rowptr.assign(ns + 1, 0);
+  std::size_t s = 0;
+  for (auto&& part : parts) {
+    for (std::size_t k = 0; k + 1 < part.rowptr.size(); k++, s++) {
+      next.rowptr[s + 1] = next.rowptr[s] + part.rowptr[k + 1] -
+                           part.rowptr[k];
+    }
+    next.colind.insert(next.colind.end(), part.colind.begin(),
+                       part.colind.end());
+    next.sigma.insert(next.sigma.end(), part.sigma.begin(), part.sigma.end());
+  }
+  next.delta.assign(next.size(), 0);
+  return next;
+}
+
+// One step back: with W = (1 + delta) / sigma on `level`,
+//
+//   previous.delta<previous> += (W * A') .* previous.sigma
+//
+// computed as a masked dot product: each vertex of `previous` sums W over
+// its out-neighbors in `level`, which are its successors on shortest paths.
+template <typename Rows, std::integral I>
+void bc_accumulate(const Rows& a, bc_level<I>& previous,
+                   const bc_level<I>& level, std::vector<bc_scratch>& scratch,
+                   std::size_t max_workers) {
+  auto rowptr = a.rowptr();
+  auto colind = a.colind();
+
+  std::size_t workers = 0;
+  auto bounds = bc_partition(a, previous, workers, max_workers);
+
+  parallel_for_workers(workers, [&](std::size_t worker) {
+    auto&& w_values = scratch[worker].values;
+    for (auto s = bounds[worker]; s < bounds[worker + 1]; s++) {
+      for (auto ptr = level.rowptr[s]; ptr < level.rowptr[s + 1]; ptr++) {
+        w_values[level.colind[ptr]] =
+            (1 + level.delta[ptr]) / level.sigma[ptr];
+      }
+
+      for (auto ptr = previous.rowptr[s]; ptr < previous.rowptr[s + 1];
+           ptr++) {
+        I v = previous.colind[ptr];
+        double sum = 0;
+        for (auto e = rowptr[v]; e < rowptr[v + 1]; e++) {
+          sum += w_values[colind[e]];
+        }
+        previous.delta[ptr] += previous.sigma[ptr] * sum;
+      }
+
+      for (auto ptr = level.rowptr[s]; ptr < level.rowptr[s + 1]; ptr++) {
+        w_values[level.colind[ptr]] = 0;
+      }
+    }
+  });
+}
+
+// Add the dependencies of every vertex on the paths from `sources` to
+// `centrality` (Brandes' algorithm, batched as in LAGraph's
+// LAGr_Betweenness).  The forward sweep keeps each BFS level as a sparse
+// matrix with a row per source; the backward sweep walks the levels in
+// reverse.  Each level is one masked product, parallel across sources.
+template <std::integral I, typename Rows>
+void bc_batch(const Rows& a, std::span<const std::size_t> sources,
+              std::vector<double>& centrality, std::size_t max_workers) {
+  std::size_t n = a.shape()[0];
+  std::size_t ns = sources.size();
+  std::size_t words = (n + 63) / 64;
+
+  std::vector<bc_scratch> scratch(std::max<std::size_t>(max_workers, 1));
+  for (auto&& worker : scratch) {
+    worker.values.assign(n, 0);
+  }
+
+  std::vector<std::uint64_t> visited(ns * words, 0);
+  bc_level<I> frontier;
+  frontier.rowptr.resize(ns + 1);
+  for (std::size_t s = 0; s < ns; s++) {
+    frontier.rowptr[s + 1] = s + 1;
+    frontier.colind.push_back(I(sources[s]));
+    frontier.sigma.push_back(1);
+    visited[s * words + sources[s] / 64] |= std::uint64_t(1)
+                                            << (sources[s] % 64);
+  }
+
+  std::vector<bc_level<I>> levels;
+  while (true) {
+    auto next = bc_expand(a, levels.empty() ? frontier : levels.back(),
+                          visited, words, scratch, max_workers);
+    if (next.size() == 0) {
+      break;
+    }
+    levels.push_back(std::move(next));
+  }
+
+  for (std::size_t d = levels.size(); d-- > 1;) {
+    bc_accumulate(a, levels[d - 1], levels[d], scratch, max_workers);
+  }
+
+  for (auto&& level : levels) {
+    for (std::size_t ptr = 0; ptr < level.size(); ptr++) {
+      centrality[level.colind[ptr]] += level.delta[ptr];
+    }
+  }
+}
+
+// Sources per batch when computing exact centrality: the levels of a batch
+// take up to about 32 bytes per source and reached vertex.
+inline constexpr std::size_t bc_batch_size = 64;
+
+template <typename A, typename Sources>
+auto betweenness_centrality_impl(A&& a, Sources&& sources,
+                                 std::size_t max_workers, double scale) {
+  using I = grb::matrix_index_t<A>;
+
+  if (a.shape()[0] != a.shape()[1]) {
+    throw grb::invalid_argument(
+        "betweenness_centrality: adjacency matrix must be square.");
+  }
+
+  std::size_t n = a.shape()[0];
+  std::vector<std::size_t> batch;
+  for (auto&& source : sources) {
+    if (std::size_t(source) >= n) {
+      throw grb::out_of_range("betweenness_centrality: source vertex " +
+                              std::to_string(source) + " is out of range.");
+    }
+    batch.push_back(std::size_t(source));
+  }
+
+  auto rows = make_row_compressed(std::forward<A>(a));
+  std::vector<double> centrality(n, 0);
+  for (std::size_t first = 0; first < batch.size(); first += bc_batch_size) {
+    std::size_t count = std::min(bc_batch_size, batch.size() - first);
+    bc_batch<I>(rows, std::span<const std::size_t>(batch).subspan(first, count),
+                centrality, max_workers);
+  }
+
+  grb::vector<double, I> c(n);
+  for (std::size_t v = 0; v < n; v++) {
+    c.insert({I(v), centrality[v] * scale});
+  }
+  return c;
+}
+
+} // namespace __detail
+
+/// Betweenness centrality of every vertex, counting only the shortest paths
+/// that start at `sources`.
+///
+/// The graph has an unweighted edge i -> j for each stored element a(i, j);
+/// values are ignored.  For a symmetric matrix each path is counted in both
+/// directions.  Sources are processed in batches, each as a sparse frontier
+/// matrix with one row per source: every BFS level is one masked sparse
+/// matrix product with `a`, and so is every step back, as in LAGraph's
+/// LAGr_Betweenness.  With `std::execution::par` or `par_unseq`, each
+/// product is split across the sources of the batch.
+template <__detail::execution_policy ExecutionPolicy, MatrixRange A,
+          std::ranges::input_range Sources>
+  requires std::integral<std::ranges::range_value_t<Sources>>
+auto betweenness_centrality(ExecutionPolicy&& policy, A&& a,
+                            Sources&& sources) {
+  std::size_t max_workers =
+      __detail::is_parallel_policy_v<ExecutionPolicy> ? grb::max_threads() : 1;
+  return __detail::betweenness_centrality_impl(
+      std::forward<A>(a), std::forward<Sources>(sources), max_workers, 1.0);
+}
+
+/// Betweenness centrality from `sources` (sequentially); see above.
+template <MatrixRange A, std::ranges::input_range Sources>
+  requires std::integral<std::ranges::range_value_t<Sources>>
+auto betweenness_centrality(A&& a, Sources&& sources) {
+  return grb::betweenness_centrality(std::execution::seq, std::forward<A>(a),
+                                     std::forward<Sources>(sources));
+}
+
+/// Exact betweenness centrality: the shortest paths from every vertex.
+template <__detail::execution_policy ExecutionPolicy, MatrixRange A>
+auto betweenness_centrality(ExecutionPolicy&& policy, A&& a) {
+  std::vector<std::size_t> sources(a.shape()[0]);
+  std::iota(sources.begin(), sources.end(), std::size_t(0));
+  return grb::betweenness_centrality(std::forward<ExecutionPolicy>(policy),
+                                     std::forward<A>(a), sources);
+}
+
+/// Exact betweenness centrality (sequentially).
+template <MatrixRange A>
+auto betweenness_centrality(A&& a) {
+  return grb::betweenness_centrality(std::execution::seq, std::forward<A>(a));
+}
+
+/// Approximate betweenness centrality from the shortest paths of `samples`
+/// distinct sources drawn uniformly at random, scaled by n / `samples`
+/// (Brandes and Pich, 2007).  The estimate is unbiased, and its cost is
+/// `samples` / n of the exact computation's.
+template <__detail::execution_policy ExecutionPolicy, MatrixRange A>
+auto approximate_betweenness_centrality(ExecutionPolicy&& policy, A&& a,
+                                        std::size_t samples,
+                                        unsigned int seed = 0) {
+  std::size_t n = a.shape()[0];
+  samples = std::min(samples, n);
+  if (samples == 0) {
+    throw grb::invalid_argument(
+        "approximate_betweenness_centrality: no sources to sample.");
+  }
+
+  // A partial Fisher-Yates shuffle picks `samples` distinct vertices.
+  std::vector<std::size_t> vertices(n);
+  std::iota(vertices.begin(), vertices.end(), std::size_t(0));
+  std::mt19937_64 gen(seed);
+  for (std::size_t k = 0; k < samples; k++) {
+    std::uniform_int_distribution<std::size_t> pick(k, n - 1);
+    std::swap(vertices[k], vertices[pick(gen)]);
+  }
+  vertices.resize(samples);
+
+  std::size_t max_workers =
+      __detail::is_parallel_policy_v<ExecutionPolicy> ? grb::max_threads() : 1;
+  return __detail::betweenness_centrality_impl(
+      std::forward<A>(a), vertices, max_workers, double(n) / samples);
+}
+
+/// Approximate betweenness centrality (sequentially); see above.
+template <MatrixRange A>
+auto approximate_betweenness_centrality(A&& a, std::size_t samples,
+                                        unsigned int seed = 0) {
+  return grb::approximate_betweenness_centrality(
+      std::execution::seq, std::forward<A>(a), samples, seed);
+}
+
+} // namespace grb
@@ -1,16 +1,184 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
 #include <grb/detail/detail.hpp>
 #include <grb/detail/matrix_traits.hpp>
 #include <grb/detail/monoid_traits.hpp>
+#include <grb/detail/parallel.hpp>
+#include <grb/detail/row_compressed.hpp>
+#include <grb/detail/set_intersection.hpp>
+#include <limits>
+#include <span>
+#include <vector>
 
 namespace grb {
 
+namespace __detail {
+
+// Walk row `i` of `a` and `b` in column order and call `f(j, a_ptr, b_ptr)`
+// for each column visited; a side without an element at `j` gets `npos`.
+// `Union` visits columns in either matrix, otherwise only those in both,
+// found with intersect_sorted().  Columns where `mask` (a row_compressed
+// pointer, or `nullptr` for no mask) is not truthy are skipped.
+template <bool Union, typename AR, typename BR, typename Mask, typename F>
+void ewise_merge_row(const AR& a, const BR& b, Mask mask, std::size_t i,
+                     F&& f) {
+  constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+  auto a_colind = a.colind();
+  auto b_colind = b.colind();
+  std::size_t a_ptr = a.rowptr()[i];
+  std::size_t a_end = a.rowptr()[i + 1];
+  std::size_t b_ptr = b.rowptr()[i];
+  std::size_t b_end = b.rowptr()[i + 1];
+
+  [[maybe_unused]] std::size_t mask_ptr = 0;
+  [[maybe_unused]] std::size_t mask_end = 0;
+  if constexpr (!std::is_same_v<Mask, std::nullptr_t>) {
+    mask_ptr = mask->rowptr()[i];
+    mask_end = mask->rowptr()[i + 1];
+  }
+
+  // Columns arrive in increasing order, so the mask row is merged too.
+  auto allowed = [&](std::size_t j) {
+    if constexpr (std::is_same_v<Mask, std::nullptr_t>) {
+      return true;
+    } else {
+      auto mask_colind = mask->colind();
+      while (mask_ptr < mask_end && std::size_t(mask_colind[mask_ptr]) < j) {
+        ++mask_ptr;
+      }
+      return mask_ptr < mask_end && std::size_t(mask_colind[mask_ptr]) == j &&
+             bool(mask->values()[mask_ptr]);
+    }
+  };
+
+  if constexpr (!Union) {
+    intersect_sorted(a_colind.data() + a_ptr, a_end - a_ptr,
+                     b_colind.data() + b_ptr, b_end - b_ptr,
+                     [&](std::size_t a_k, std::size_t b_k) {
+                       std::size_t j = std::size_t(a_colind[a_ptr + a_k]);
+                       if (allowed(j)) {
+                         f(j, a_ptr + a_k, b_ptr + b_k);
+                       }
+                     });
+    return;
+  }
+
+  while (a_ptr < a_end || b_ptr < b_end) {
+    std::size_t a_j = a_ptr < a_end ? std::size_t(a_colind[a_ptr]) : npos;
+    std::size_t b_j = b_ptr < b_end ? std::size_t(b_colind[b_ptr]) : npos;
+    std::size_t j = std::min(a_j, b_j);
+    bool in_a = a_j == j;
+    bool in_b = b_j == j;
+
+    if (allowed(j)) {
+      f(j, in_a ? a_ptr : npos, in_b ? b_ptr : npos);
+    }
+
+    a_ptr += in_a;
+    b_ptr += in_b;
+  }
+}
+
+// Row-parallel element-wise merge of two equally shaped row_compressed
+// matrices.  `value(a_ptr, b_ptr)` computes the output element.  Workers get
+// row ranges of about equal combined nonzero count, count their rows, and
+// after a prefix sum write them straight into the output's CSR arrays.
+template <bool Union, typename T, std::integral I, typename AR, typename BR,
+          typename Mask, typename F>
+grb::matrix<T, I> ewise_rows(const AR& a, const BR& b, Mask mask, F&& value,
+                             std::size_t max_workers) {
+  using csr_type = typename grb::matrix<T, I>::backend_type;
+
+  std::size_t m = a.shape()[0];
+
+  std::vector<std::size_t> work(m + 1);
+  for (std::size_t i = 0; i <= m; i++) {
+    work[i] = std::size_t(a.rowptr()[i]) + std::size_t(b.rowptr()[i]);
+  }
+  std::size_t workers = num_workers(work[m], max_workers);
+  auto bounds =
+      balanced_partition(std::span<const std::size_t>(work), workers);
+
+  typename csr_type::index_vector_type rowptr(m + 1);
+  rowptr[0] = 0;
+  parallel_for_workers(workers, [&](std::size_t worker) {
+    for (auto i = bounds[worker]; i < bounds[worker + 1]; i++) {
+      I count = 0;
+      ewise_merge_row<Union>(a, b, mask, i,
+                             [&](std::size_t, std::size_t, std::size_t) {
+                               ++count;
+                             });
+      rowptr[i + 1] = count;
+    }
+  });
+  for (std::size_t i = 0; i < m; i++) {
+    rowptr[i + 1] += rowptr[i];
+  }
+
+  typename csr_type::index_vector_type colind(rowptr[m]);
+  typename csr_type::values_vector_type values(rowptr[m]);
+  parallel_for_workers(workers, [&](std::size_t worker) {
+    for (auto i = bounds[worker]; i < bounds[worker + 1]; i++) {
+      std::size_t ptr = rowptr[i];
+      ewise_merge_row<Union>(
+          a, b, mask, i,
+          [&](std::size_t j, std::size_t a_ptr, std::size_t b_ptr) {
+            colind[ptr] = I(j);
+            values[ptr] = value(a_ptr, b_ptr);
+            ++ptr;
+          });
+    }
+  });
+
+  grb::matrix<T, I> c(grb::index<I>(a.shape()[0], a.shape()[1]));
+  c.backend().assign_csr(std::move(rowptr), std::move(colind),
+                         std::move(values));
+  return c;
+}
+
+template <bool Union, typename T, std::integral I, typename A, typename B,
+          typename M, typename F>
+grb::matrix<T, I> ewise_merge(A&& a, B&& b, M&& mask, F&& value,
+                              std::size_t max_workers) {
+  auto a_rows = make_row_compressed(std::forward<A>(a));
+  auto b_rows = make_row_compressed(std::forward<B>(b));
+
+  auto compute = [&](auto mask_rows) {
+    return ewise_rows<Union, T, I>(a_rows, b_rows, mask_rows,
+                                   [&](std::size_t a_ptr, std::size_t b_ptr) {
+                                     return value(a_rows, a_ptr, b_rows, b_ptr);
+                                   },
+                                   max_workers);
+  };
+
+  if constexpr (std::is_same_v<std::remove_cvref_t<M>,
+                               grb::full_matrix_mask<>>) {
+    return compute(nullptr);
+  } else {
+    auto mask_rows = make_row_compressed(std::forward<M>(mask));
+    return compute(&mask_rows);
+  }
+}
+
+} // namespace __detail
+
+/// Element-wise intersection of two matrices
+///
+/// Each output row is the sorted intersection of the column indices of the
+/// input rows (see intersect_sorted(): galloping for very uneven rows, AVX2 or
+/// AVX-512 block comparisons when compiled for them), written straight into
+/// the output's CSR arrays.  Inputs that are not CSR-backed are gathered into
+/// CSR arrays first.  With `std::execution::par` or `par_unseq`, rows are
+/// computed in parallel.
 template <
-    MatrixRange A, MatrixRange B,
+    __detail::execution_policy ExecutionPolicy, MatrixRange A, MatrixRange B,
     BinaryOperator<grb::matrix_scalar_t<A>, grb::matrix_scalar_t<B>> Combine,
     MaskMatrixRange M = grb::full_matrix_mask<>>
-auto ewise_intersection(A&& a, B&& b, Combine&& combine, M&& mask = M{}) {
+auto ewise_intersection(ExecutionPolicy&& policy, A&& a, B&& b,
+                        Combine&& combine, M&& mask = M{}) {
   if (a.shape()[0] != b.shape()[0] || a.shape()[1] != b.shape()[1]) {
     throw grb::invalid_argument(
         "ewise_intersection: Dimensions of matrices are incompatible.");
@@ -29,43 +197,38 @@ auto ewise_intersection(A&& a, B&& b, Combine&& combine, M&& mask = M{}) {
   using index_type =
       grb::bigger_integral_t<grb::matrix_index_t<A>, grb::matrix_index_t<B>>;
 
-  grb::matrix<c_scalar_type, index_type> c(a.shape());
-
-  for (auto&& [index, a_value] : a) {
-    if constexpr (!std::is_same_v<std::remove_cvref_t<M>,
-                                  grb::full_matrix_mask<>>) {
-      auto mask_iter = mask.find(index);
-      if (mask_iter == mask.end() || !bool(grb::get<1>(*mask_iter))) {
-        continue;
-      }
-    }
-
-    auto iter = b.find(index);
-
-    if (iter != b.end()) {
-      auto&& [_, b_value] = *iter;
-      c.insert({index, std::forward<Combine>(combine)(
-                           static_cast<a_scalar_type>(a_value),
-                           static_cast<b_scalar_type>(b_value))});
-    }
-  }
-
-  return c;
+  std::size_t max_workers =
+      __detail::is_parallel_policy_v<ExecutionPolicy> ? grb::max_threads() : 1;
+
+  return __detail::ewise_merge<false, c_scalar_type, index_type>(
+      std::forward<A>(a), std::forward<B>(b), std::forward<M>(mask),
+      [&](auto&& a_rows, std::size_t a_ptr, auto&& b_rows,
+          std::size_t b_ptr) -> c_scalar_type {
+        return combine(static_cast<a_scalar_type>(a_rows.values()[a_ptr]),
+                       static_cast<b_scalar_type>(b_rows.values()[b_ptr]));
+      },
+      max_workers);
 }
 
+/// Element-wise union of two matrices
+///
+/// Each output row is a sorted merge of the input rows, written straight
+/// into the output's CSR arrays.  With `std::execution::par` or `par_unseq`,
+/// rows are computed in parallel.
 template <
-    MatrixRange A, MatrixRange B,
+    __detail::execution_policy ExecutionPolicy, MatrixRange A, MatrixRange B,
     BinaryOperator<grb::matrix_scalar_t<A>, grb::matrix_scalar_t<B>> Combine,
     MaskMatrixRange M = grb::full_matrix_mask<>>
-auto ewise_union(A&& a, B&& b, Combine&& combine, M&& mask = M{}) {
+auto ewise_union(ExecutionPolicy&& policy, A&& a, B&& b, Combine&& combine,
+                 M&& mask = M{}) {
   if (a.shape()[0] != b.shape()[0] || a.shape()[1] != b.shape()[1]) {
     throw grb::invalid_argument(
-        "ewise_intersection: Dimensions of matrices are incompatible.");
+        "ewise_union: Dimensions of matrices are incompatible.");
   }
 
   if (mask.shape()[0] < a.shape()[0] || mask.shape()[1] < a.shape()[1]) {
     throw grb::invalid_argument(
-        "ewise_intersection: Mask has smaller dimensions than matrices.");
+        "ewise_union: Mask has smaller dimensions than matrices.");
   }
 
   using a_scalar_type = grb::matrix_scalar_t<A>;
@@ -76,44 +239,45 @@ auto ewise_union(A&& a, B&& b, Combine&& combine, M&& mask = M{}) {
   using index_type =
       grb::bigger_integral_t<grb::matrix_index_t<A>, grb::matrix_index_t<B>>;
 
-  grb::matrix<c_scalar_type, index_type> c(a.shape());
-
-  size_t num_matched = 0;
-
-  for (auto&& [index, a_value] : a) {
-    if constexpr (!std::is_same_v<std::remove_cvref_t<M>,
-                                  grb::full_matrix_mask<>>) {
-      auto mask_iter = mask.find(index);
-      if (mask_iter == mask.end() || !bool(grb::get<1>(*mask_iter))) {
-        continue;
-      }
-    }
-
-    auto iter = b.find(index);
-
-    if (iter != b.end()) {
-      auto&& [_, b_value] = *iter;
-
-      c.insert({index, std::forward<Combine>(combine)(
-                           static_cast<a_scalar_type>(a_value),
-                           static_cast<b_scalar_type>(b_value))});
-      ++num_matched;
-    } else {
-      c.insert({index, static_cast<a_scalar_type>(a_value)});
-    }
-  }
+  constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+  std::size_t max_workers =
+      __detail::is_parallel_policy_v<ExecutionPolicy> ? grb::max_threads() : 1;
+
+  return __detail::ewise_merge<true, c_scalar_type, index_type>(
+      std::forward<A>(a), std::forward<B>(b), std::forward<M>(mask),
+      [&](auto&& a_rows, std::size_t a_ptr, auto&& b_rows,
+          std::size_t b_ptr) -> c_scalar_type {
+        if (a_ptr == npos) {
+          return b_rows.values()[b_ptr];
+        } else if (b_ptr == npos) {
+          return static_cast<a_scalar_type>(a_rows.values()[a_ptr]);
+        }
+        return combine(static_cast<a_scalar_type>(a_rows.values()[a_ptr]),
+                       static_cast<b_scalar_type>(b_rows.values()[b_ptr]));
+      },
+      max_workers);
+}
 
-  if (num_matched < b.size()) {
-    for (auto&& [index, b_value] : b) {
-      auto mask_iter = mask.find(index);
-      if (mask_iter == mask.end() || !bool(grb::get<1>(*mask_iter))) {
-        continue;
-      }
-      c.insert({index, b_value});
-    }
-  }
+template <
+    MatrixRange A, MatrixRange B,
+    BinaryOperator<grb::matrix_scalar_t<A>, grb::matrix_scalar_t<B>> Combine,
+    MaskMatrixRange M = grb::full_matrix_mask<>>
+auto ewise_intersection(A&& a, B&& b, Combine&& combine, M&& mask = M{}) {
+  return grb::ewise_intersection(std::execution::seq, std::forward<A>(a),
+                                 std::forward<B>(b),
+                                 std::forward<Combine>(combine),
+                                 std::forward<M>(mask));
+}
 
-  return c;
+template <
+    MatrixRange A, MatrixRange B,
+    BinaryOperator<grb::matrix_scalar_t<A>, grb::matrix_scalar_t<B>> Combine,
+    MaskMatrixRange M = grb::full_matrix_mask<>>
+auto ewise_union(A&& a, B&& b, Combine&& combine, M&& mask = M{}) {
+  return grb::ewise_union(std::execution::seq, std::forward<A>(a),
+                          std::forward<B>(b), std::forward<Combine>(combine),
+                          std::forward<M>(mask));
 }
 
 template <
@@ -1,16 +1,34 @@
 #pragma once
 
+#include <execution>
 #include <functional>
 #include <grb/algorithms/assign.hpp>
 #include <grb/containers/views/views.hpp>
 #include <grb/detail/concepts.hpp>
 #include <grb/detail/detail.hpp>
+#include <grb/detail/dia.hpp>
+#include <grb/detail/parallel.hpp>
+#include <grb/detail/row_compressed.hpp>
+#include <grb/detail/spgemm.hpp>
+#include <grb/detail/spmv.hpp>
 #include <type_traits>
 #include <utility>
 
 namespace grb {
 
 /// Multiply a matrix times a vector
+///
+/// The result uses the same storage hint as `b`.  If `a` is CSR-backed, or a
+/// `grb::transpose` view of a CSR-backed matrix, the product is
+/// direction-optimizing: it either pushes `b` down the columns of `a`, in
+/// time proportional to the columns touched, or pulls a masked dot product
+/// for each allowed row, stopping at the first match when `reduce` is
+/// `grb::take_left`.  Each call picks the cheaper direction from the size of
+/// `b`'s columns and of the mask.  Column access uses the CSR backend's
+/// cached column index, built on first use.  A DIA-backed `a` is multiplied
+/// one diagonal at a time against `b` scattered into a dense array (see
+/// `grb::diagonal`).  Other matrices are iterated in full, looking up `b` and
+/// the mask for every element.
 template <MatrixRange A, VectorRange B,
           BinaryOperator<grb::matrix_scalar_t<A>, grb::vector_scalar_t<B>>
               Combine = grb::multiplies<>,
@@ -32,7 +50,23 @@ auto multiply(A&& a, B&& b, Reduce&& reduce = Reduce{},
 
   using c_index_type = grb::bigger_integral_t<a_index_type, b_index_type>;
 
-  grb::vector<c_scalar_type, c_index_type> c(a.shape()[0]);
+  using c_type = grb::vector<c_scalar_type, c_index_type,
+                             __detail::spmv_output_hint_t<B>>;
+
+  if (a.shape()[1] != b.shape()) {
+    throw grb::invalid_argument(
+        "multiply: Matrix and vector dimensions are incompatible.");
+  }
+
+  if constexpr (__detail::row_column_accessible<A>) {
+    return __detail::direction_optimizing_spmv<c_type>(
+        __detail::make_row_column_access(a), b, reduce, combine, mask);
+  } else if constexpr (__detail::dia_backed<A>) {
+    return __detail::dia_multiply_vector<c_type>(a, b, reduce, combine, mask,
+                                                 1);
+  }
+
+  c_type c(a.shape()[0]);
 
   for (auto&& [a_index, a_v] : a) {
     auto&& [i, k] = a_index;
@@ -63,7 +97,21 @@ auto multiply(A&& a, B&& b, Reduce&& reduce = Reduce{},
 }
 
 /// Multiply two matrices
-template <MatrixRange A, MatrixRange B,
+///
+/// Row-by-row (Gustavson) SpGEMM: each row of `c` accumulates the rows of
+/// `b` selected by the corresponding row of `a`.  Inputs that are not
+/// CSR-backed matrices (views, other backends) are first gathered into CSR
+/// arrays, so the cost is O(flops + nnz) rather than a lookup per column.
+/// If `mask` is given, only elements at indices where the mask is truthy are
+/// computed.  The product of two DIA-backed matrices without a mask is
+/// computed diagonal by diagonal, and is DIA-backed itself.
+///
+/// With `std::execution::par` or `par_unseq`, rows are split into contiguous
+/// ranges of about equal flop count, and each of up to `grb::max_threads()`
+/// workers computes its range with a private accumulator directly into the
+/// output's CSR arrays.
+template <__detail::execution_policy ExecutionPolicy, MatrixRange A,
+          MatrixRange B,
           BinaryOperator<grb::matrix_scalar_t<A>, grb::matrix_scalar_t<B>>
               Combine = grb::multiplies<>,
           BinaryOperator<grb::combine_result_t<A, B, Combine>,
@@ -71,8 +119,8 @@ template <MatrixRange A, MatrixRange B,
                          grb::combine_result_t<A, B, Combine>>
               Reduce = grb::plus<>,
           MaskMatrixRange M = grb::full_matrix_mask<>>
-auto multiply(A&& a, B&& b, Reduce&& reduce = Reduce{},
-              Combine&& combine = Combine{},
+auto multiply(ExecutionPolicy&& policy, A&& a, B&& b,
+              Reduce&& reduce = Reduce{}, Combine&& combine = Combine{},
               M&& mask = grb::full_matrix_mask()) {
   using a_scalar_type = grb::matrix_scalar_t<A>;
   using b_scalar_type = grb::matrix_scalar_t<B>;
@@ -85,36 +133,160 @@ auto multiply(A&& a, B&& b, Reduce&& reduce = Reduce{},
 
   using c_index_type = grb::bigger_integral_t<a_index_type, b_index_type>;
 
-  grb::matrix<c_scalar_type, c_index_type> c(
-      grb::index<c_index_type>(a.shape()[0], b.shape()[1]));
+  if (a.shape()[1] != b.shape()[0]) {
+    throw grb::invalid_argument(
+        "multiply: Inner dimensions of matrices are incompatible.");
+  }
 
-  for (auto&& [a_index, a_v] : a) {
-    auto&& [i, k] = a_index;
+  std::size_t max_workers =
+      __detail::is_parallel_policy_v<ExecutionPolicy> ? grb::max_threads() : 1;
 
-    for (c_index_type j = 0; j < b.shape()[1]; j++) {
-      auto iter = b.find(grb::index<b_index_type>(k, j));
-
-      if (iter != b.end()) {
-        auto&& [b_index, b_v] = *iter;
-
-        if constexpr (std::is_same_v<std::decay_t<M>,
-                                     grb::full_matrix_mask<>>) {
-          c[grb::index<c_index_type>(i, j)] =
-              reduce(c[grb::index<c_index_type>(i, j)], combine(a_v, b_v));
-        } else {
-          auto iter = mask.find({i, j});
-          if (iter != mask.end()) {
-            auto&& [_, value] = *iter;
-            if (bool(value)) {
-              c[{i, j}] = reduce(c[{i, j}], combine(a_v, b_v));
-            }
-          }
-        }
+  if constexpr (__detail::dia_backed<A> && __detail::dia_backed<B> &&
+                std::is_same_v<std::decay_t<M>, grb::full_matrix_mask<>>) {
+    return __detail::dia_multiply<c_scalar_type, c_index_type>(
+        a, b, reduce, combine, max_workers);
+  } else {
+    auto a_rows = __detail::make_row_compressed(std::forward<A>(a));
+    auto b_rows = __detail::make_row_compressed(std::forward<B>(b));
+
+    if constexpr (std::is_same_v<std::decay_t<M>, grb::full_matrix_mask<>>) {
+      return __detail::gustavson_multiply<c_scalar_type, c_index_type>(
+          a_rows, b_rows, nullptr, reduce, combine, max_workers);
+    } else {
+      if (mask.shape()[0] < a_rows.shape()[0] ||
+          mask.shape()[1] < b_rows.shape()[1]) {
+        throw grb::invalid_argument(
+            "multiply: Mask has smaller dimensions than output.");
       }
+      auto mask_rows = __detail::make_row_compressed(std::forward<M>(mask));
+      return __detail::gustavson_multiply<c_scalar_type, c_index_type>(
+          a_rows, b_rows, &mask_rows, reduce, combine, max_workers);
     }
   }
+}
 
-  return c;
+/// Multiply two matrices (sequentially)
+template <MatrixRange A, MatrixRange B,
+          BinaryOperator<grb::matrix_scalar_t<A>, grb::matrix_scalar_t<B>>
+              Combine = grb::multiplies<>,
+          BinaryOperator<grb::combine_result_t<A, B, Combine>,
+                         grb::combine_result_t<A, B, Combine>,
+                         grb::combine_result_t<A, B, Combine>>
+              Reduce = grb::plus<>,
+          MaskMatrixRange M = grb::full_matrix_mask<>>
+auto multiply(A&& a, B&& b, Reduce&& reduce = Reduce{},
+              Combine&& combine = Combine{},
+              M&& mask = grb::full_matrix_mask()) {
+  return grb::multiply(std::execution::seq, std::forward<A>(a),
+                       std::forward<B>(b), std::forward<Reduce>(reduce),
+                       std::forward<Combine>(combine), std::forward<M>(mask));
+}
+
+/// Multiply a matrix times a vector, with rows of the output computed in
+/// parallel when `policy` is `std::execution::par` or `par_unseq`.
+///
+/// Rows of `a` are split into contiguous ranges of about equal nonzero
+/// count; each worker reduces its rows into its own slice of the output.
+/// Rows are read from the CSR backend's compact index if one has been built
+/// (see `csr_matrix::build_compact_index()`).  A DIA-backed `a` is split the
+/// same way, walking each diagonal over the rows of each worker.
+template <__detail::execution_policy ExecutionPolicy, MatrixRange A,
+          VectorRange B,
+          BinaryOperator<grb::matrix_scalar_t<A>, grb::vector_scalar_t<B>>
+              Combine = grb::multiplies<>,
+          BinaryOperator<grb::combine_result_t<A, B, Combine>,
+                         grb::combine_result_t<A, B, Combine>,
+                         grb::combine_result_t<A, B, Combine>>
+              Reduce = grb::plus<>,
+          MaskVectorRange M = grb::full_vector_mask<>>
+auto multiply(ExecutionPolicy&& policy, A&& a, B&& b,
+              Reduce&& reduce = Reduce{}, Combine&& combine = Combine(),
+              M&& mask = M{}) {
+  if constexpr (!__detail::is_parallel_policy_v<ExecutionPolicy>) {
+    return grb::multiply(std::forward<A>(a), std::forward<B>(b),
+                         std::forward<Reduce>(reduce),
+                         std::forward<Combine>(combine),
+                         std::forward<M>(mask));
+  } else if constexpr (__detail::dia_backed<A>) {
+    using c_type =
+        grb::vector<grb::combine_result_t<A, B, Combine>,
+                    grb::bigger_integral_t<grb::matrix_index_t<A>,
+                                           grb::vector_index_t<B>>,
+                    __detail::spmv_output_hint_t<B>>;
+
+    if (a.shape()[1] != b.shape()) {
+      throw grb::invalid_argument(
+          "multiply: Matrix and vector dimensions are incompatible.");
+    }
+    return __detail::dia_multiply_vector<c_type>(a, b, reduce, combine, mask,
+                                                 grb::max_threads());
+  } else {
+    using a_scalar_type = grb::matrix_scalar_t<A>;
+    using b_scalar_type = grb::vector_scalar_t<B>;
+
+    using a_index_type = grb::matrix_index_t<A>;
+    using b_index_type = grb::vector_index_t<B>;
+
+    using c_scalar_type = decltype(combine(std::declval<a_scalar_type>(),
+                                           std::declval<b_scalar_type>()));
+
+    using c_index_type = grb::bigger_integral_t<a_index_type, b_index_type>;
+
+    auto a_rows = __detail::make_row_compressed(std::forward<A>(a));
+    std::size_t m = a_rows.shape()[0];
+
+    shp::vector<c_scalar_type> values(m);
+    std::vector<char> present(m, false);
+
+    const __detail::compact_row_index* compact = nullptr;
+    if constexpr (requires { a.backend().compact_index(); }) {
+      compact = &a.backend().compact_index();
+    }
+
+    std::size_t workers = __detail::num_workers(a_rows.size());
+    auto bounds = __detail::balanced_partition(a_rows.rowptr(), workers);
+
+    __detail::visit_rows(
+        compact, a_rows.rowptr(), a_rows.colind(), [&](auto&& rows) {
+          __detail::parallel_for_workers(workers, [&](std::size_t worker) {
+            auto a_values = a_rows.values();
+            for (auto i = bounds[worker]; i < bounds[worker + 1]; i++) {
+              auto mask_iter = mask.find(i);
+              if (mask_iter == mask.end() ||
+                  !bool(grb::get<1>(*mask_iter))) {
+                continue;
+              }
+
+              c_scalar_type sum{};
+              bool found = false;
+              rows.for_each_in_row(i, [&](auto j, std::size_t ptr) {
+                auto iter = b.find(j);
+                if (iter != b.end()) {
+                  auto&& [_, b_v] = *iter;
+                  c_scalar_type v = combine(a_values[ptr], b_v);
+                  sum = found ? reduce(sum, v) : v;
+                  found = true;
+                }
+                return true;
+              });
+
+              if (found) {
+                values[i] = sum;
+                present[i] = true;
+              }
+            }
+          });
+        });
+
+    grb::vector<c_scalar_type, c_index_type, __detail::spmv_output_hint_t<B>>
+        c(m);
+    for (std::size_t i = 0; i < m; i++) {
+      if (present[i]) {
+        c.insert({c_index_type(i), values[i]});
+      }
+    }
+    return c;
+  }
 }
 
 template <VectorRange A, VectorRange B,
@@ -161,16 +333,47 @@ auto multiply(A&& a, B&& b, Reduce&& reduce = Reduce{},
 
 namespace {
 
+// Matrix-matrix products into a CSR-backed matrix are fused with the
+// accumulation row by row (see gustavson_multiply_accumulate()).  Otherwise
+// the product is computed and then accumulated into `c` in place.
 template <typename C, typename A, typename B, typename Combine, typename Reduce,
           typename M, typename Accumulate>
 void multiply_impl_(C&& c, A&& a, B&& b, Reduce&& reduce, Combine&& combine,
                     M&& mask, Accumulate&& acc, bool merge) {
-  auto z = multiply(a, b, reduce, combine, mask);
+  if constexpr (MatrixRange<A> && MatrixRange<B> &&
+                __detail::csr_assignable<C>) {
+    using c_scalar_type =
+        decltype(combine(std::declval<grb::matrix_scalar_t<A>>(),
+                         std::declval<grb::matrix_scalar_t<B>>()));
+
+    if (a.shape()[1] != b.shape()[0]) {
+      throw grb::invalid_argument(
+          "multiply: Inner dimensions of matrices are incompatible.");
+    }
+    if (c.shape() != grb::index<grb::matrix_index_t<C>>(a.shape()[0],
+                                                         b.shape()[1])) {
+      throw grb::invalid_argument(
+          "multiply: Output matrix has the wrong dimensions.");
+    }
+    if (mask.shape()[0] < a.shape()[0] || mask.shape()[1] < b.shape()[1]) {
+      throw grb::invalid_argument(
+          "multiply: Mask has smaller dimensions than output.");
+    }
+
+    auto a_rows = __detail::make_row_compressed(a);
+    auto b_rows = __detail::make_row_compressed(b);
 
-  if (merge) {
-    grb::assign(c, ewise_union(c, z, acc));
+    if constexpr (std::is_same_v<std::decay_t<M>, grb::full_matrix_mask<>>) {
+      __detail::gustavson_multiply_accumulate<c_scalar_type>(
+          c, a_rows, b_rows, nullptr, reduce, combine, acc, merge);
+    } else {
+      auto mask_rows = __detail::make_row_compressed(mask);
+      __detail::gustavson_multiply_accumulate<c_scalar_type>(
+          c, a_rows, b_rows, &mask_rows, reduce, combine, acc, merge);
+    }
   } else {
-    grb::assign(c, ewise_union(c, z, acc, grb::views::structure(z)));
+    auto z = multiply(a, b, reduce, combine, mask);
+    __detail::accumulate_into(c, z, acc, merge);
   }
 }
 
@@ -1,25 +1,189 @@
 #pragma once
 
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <execution>
 #include <grb/containers/matrix.hpp>
+#include <grb/detail/parallel.hpp>
+#include <grb/detail/row_compressed.hpp>
+#include <grb/experimental/sycl_tools/vector.hpp>
+#include <ranges>
+#include <span>
+#include <utility>
 #include <vector>
 
 namespace grb {
 
-template <grb::MatrixRange M, std::ranges::random_access_range P>
+namespace __detail {
+
+template <typename T, std::integral I>
+struct csr_arrays {
+  shp::vector<I> rowptr;
+  shp::vector<I> colind;
+  shp::vector<T> values;
+};
+
+// Whether `p` holds each of 0, ..., n - 1 exactly once.
+template <typename P>
+bool is_permutation_of(const P& p, std::size_t n) {
+  if (std::size_t(std::ranges::size(p)) != n) {
+    return false;
+  }
+  std::vector<char> seen(n, false);
+  for (auto&& v : p) {
+    if (std::cmp_less(v, 0) || std::cmp_greater_equal(v, n) ||
+        seen[std::size_t(v)]) {
+      return false;
+    }
+    seen[std::size_t(v)] = true;
+  }
+  return true;
+}
+
+// Counting-sort transpose.  Row k of the input is row `source[k]` of the
+// CSR arrays (row k itself if `source` is empty), and its element in column
+// j goes to output row `target[j]` (j if `target` is empty) with column
+// index k.  Input rows are scanned in order of k, so every output row comes
+// out sorted, in O(nnz + rows + buckets).
+//
+// Workers take contiguous ranges of k of about equal nonzero count and
+// count their elements into private histograms.  A prefix sum over the
+// histograms in (output row, worker) order then gives each worker its own
+// slots in every output row, in which it scatters its elements in order.
+template <typename T, std::integral I>
+csr_arrays<T, I> counting_transpose(std::span<const I> rowptr,
+                                    std::span<const I> colind,
+                                    std::span<const T> values,
+                                    std::span<const I> source,
+                                    std::span<const I> target,
+                                    std::size_t buckets,
+                                    std::size_t max_workers) {
+  std::size_t rows = rowptr.size() - 1;
+  auto source_row = [&](std::size_t k) {
+    return source.empty() ? k : std::size_t(source[k]);
+  };
+  auto target_row = [&](I j) {
+    return target.empty() ? std::size_t(j) : std::size_t(target[j]);
+  };
+
+  std::vector<std::size_t> prefix(rows + 1, 0);
+  for (std::size_t k = 0; k < rows; k++) {
+    std::size_t i = source_row(k);
+    prefix[k + 1] = prefix[k] + (rowptr[i + 1] - rowptr[i]);
+  }
+  std::size_t nnz = prefix[rows];
+
+  std::size_t workers = num_workers(nnz, max_workers);
+  auto bounds =
+      balanced_partition(std::span<const std::size_t>(prefix), workers);
+
+  // counts[w * buckets + b]: worker w's elements in output row b, then
+  // the first slot of those elements.
+  std::vector<std::size_t> counts(workers * buckets, 0);
+  parallel_for_workers(workers, [&](std::size_t worker) {
+    std::size_t* count = counts.data() + worker * buckets;
+    for (auto k = bounds[worker]; k < bounds[worker + 1]; k++) {
+      std::size_t i = source_row(k);
+      for (auto ptr = rowptr[i]; ptr < rowptr[i + 1]; ptr++) {
+        count[target_row(colind[ptr])]++;
+      }
+    }
+  });
+
+  csr_arrays<T, I> out{shp::vector<I>(buckets + 1), shp::vector<I>(nnz),
+                       shp::vector<T>(nnz)};
+  std::size_t slot = 0;
+  for (std::size_t b = 0; b < buckets; b++) {
+    out.rowptr[b] = I(slot);
+    for (std::size_t w = 0; w < workers; w++) {
+      std::size_t count = counts[w * buckets + b];
+      counts[w * buckets + b] = slot;
+      slot += count;
+    }
+  }
+  out.rowptr[buckets] = I(slot);
+
+  parallel_for_workers(workers, [&](std::size_t worker) {
+    std::size_t* next = counts.data() + worker * buckets;
+    for (auto k = bounds[worker]; k < bounds[worker + 1]; k++) {
+      std::size_t i = source_row(k);
+      for (auto ptr = rowptr[i]; ptr < rowptr[i + 1]; ptr++) {
+        std::size_t out_ptr = next[target_row(colind[ptr])]++;
+        out.colind[out_ptr] = I(k);
+        out.values[out_ptr] = values[ptr];
+      }
+    }
+  });
+
+  return out;
+}
+
+// o(k, l) = m(rows[k], columns[l]) for true permutations `rows` and
+// `columns`: two counting-sort transposes, the first gathering rows in
+// their new order and renumbering columns, the second putting the result
+// back in row-major order with sorted columns.  O(nnz + m + n).
+template <typename M, typename R, typename C>
+auto permute_csr(M&& m, const R& rows, const C& columns,
+                 std::size_t max_workers) {
+  using T = grb::matrix_scalar_t<M>;
+  using I = grb::matrix_index_t<M>;
+
+  std::size_t m_rows = m.shape()[0];
+  std::size_t m_columns = m.shape()[1];
+
+  std::vector<I> source(rows.begin(), rows.end());
+  std::vector<I> target(m_columns);
+  for (std::size_t l = 0; l < m_columns; l++) {
+    target[std::size_t(columns[l])] = I(l);
+  }
+
+  auto a = make_row_compressed(std::forward<M>(m));
+  auto transposed = counting_transpose<T, I>(
+      a.rowptr(), a.colind(), a.values(), source, target, m_columns,
+      max_workers);
+  auto csr = counting_transpose<T, I>(transposed.rowptr, transposed.colind,
+                                      transposed.values, {}, {}, m_rows,
+                                      max_workers);
+
+  grb::matrix<T, I> o({I(m_rows), I(m_columns)});
+  o.backend().assign_csr(std::move(csr.rowptr), std::move(csr.colind),
+                         std::move(csr.values));
+  return o;
+}
+
+} // namespace __detail
+
+/// Symmetrically permute `m`: element (k, l) of the result is element
+/// (permutation[k], permutation[l]) of `m`.
+///
+/// If `m` is square and `permutation` holds each of its indices exactly
+/// once, the result is built straight into CSR arrays by two counting
+/// sorts, in O(nnz + n), split across up to `grb::max_threads()` workers
+/// with `std::execution::par` or `par_unseq`.  Otherwise `permutation` may
+/// repeat or omit indices, and the result has a row and column for each of
+/// its entries.
+template <__detail::execution_policy ExecutionPolicy, grb::MatrixRange M,
+          std::ranges::random_access_range P>
   requires(std::integral<std::ranges::range_value_t<P>>)
-auto permute(M&& m, P&& permutation) {
+auto permute(ExecutionPolicy&& policy, M&& m, P&& permutation) {
   using T = grb::matrix_scalar_t<M>;
   using I = std::ranges::range_value_t<P>;
   using I2 = grb::matrix_index_t<M>;
 
+  if (m.shape()[0] == m.shape()[1] &&
+      __detail::is_permutation_of(permutation, m.shape()[0])) {
+    std::size_t max_workers =
+        __detail::is_parallel_policy_v<ExecutionPolicy> ? grb::max_threads()
+                                                        : 1;
+    return __detail::permute_csr(std::forward<M>(m), permutation,
+                                 permutation, max_workers);
+  }
+
   grb::matrix<T, I2> o({permutation.size(), permutation.size()});
 
   std::vector<std::vector<I>> proj(std::max(m.shape()[0], m.shape()[1]));
 
-  for (std::size_t i = 0; i < proj.size(); i++) {
-    proj[i].push_back({});
-  }
-
   for (std::size_t i = 0; i < permutation.size(); i++) {
     proj[permutation[i]].push_back(i);
   }
@@ -37,28 +201,42 @@ auto permute(M&& m, P&& permutation) {
   return o;
 }
 
-template <grb::MatrixRange M, std::ranges::random_access_range R,
+/// Symmetrically permute `m` (sequentially); see above.
+template <grb::MatrixRange M, std::ranges::random_access_range P>
+  requires(std::integral<std::ranges::range_value_t<P>>)
+auto permute(M&& m, P&& permutation) {
+  return grb::permute(std::execution::seq, std::forward<M>(m),
+                      std::forward<P>(permutation));
+}
+
+/// Permute the rows and columns of `m` separately: element (k, l) of the
+/// result is element (row_permutation[k], column_permutation[l]) of `m`.
+/// True permutations take the same O(nnz) path as above.
+template <__detail::execution_policy ExecutionPolicy, grb::MatrixRange M,
+          std::ranges::random_access_range R,
           std::ranges::random_access_range C>
   requires(std::integral<std::ranges::range_value_t<R>> &&
            std::integral<std::ranges::range_value_t<C>>)
-auto permute(M&& m, R&& row_permutation, C&& column_permutation) {
+auto permute(ExecutionPolicy&& policy, M&& m, R&& row_permutation,
+             C&& column_permutation) {
   using T = grb::matrix_scalar_t<M>;
   using I = std::ranges::range_value_t<R>;
   using I2 = grb::matrix_index_t<M>;
 
+  if (__detail::is_permutation_of(row_permutation, m.shape()[0]) &&
+      __detail::is_permutation_of(column_permutation, m.shape()[1])) {
+    std::size_t max_workers =
+        __detail::is_parallel_policy_v<ExecutionPolicy> ? grb::max_threads()
+                                                        : 1;
+    return __detail::permute_csr(std::forward<M>(m), row_permutation,
+                                 column_permutation, max_workers);
+  }
+
   grb::matrix<T, I2> o({row_permutation.size(), column_permutation.size()});
 
   std::vector<std::vector<I>> row_proj(m.shape()[0]);
   std::vector<std::vector<I>> col_proj(m.shape()[1]);
 
-  for (std::size_t i = 0; i < row_proj.size(); i++) {
-    row_proj[i].push_back({});
-  }
-
-  for (std::size_t i = 0; i < col_proj.size(); i++) {
-    col_proj[i].push_back({});
-  }
-
   for (std::size_t i = 0; i < row_permutation.size(); i++) {
     row_proj[row_permutation[i]].push_back(i);
   }
@@ -80,4 +258,15 @@ auto permute(M&& m, R&& row_permutation, C&& column_permutation) {
   return o;
 }
 
+/// Permute the rows and columns of `m` (sequentially); see above.
+template <grb::MatrixRange M, std::ranges::random_access_range R,
+          std::ranges::random_access_range C>
+  requires(std::integral<std::ranges::range_value_t<R>> &&
+           std::integral<std::ranges::range_value_t<C>>)
+auto permute(M&& m, R&& row_permutation, C&& column_permutation) {
+  return grb::permute(std::execution::seq, std::forward<M>(m),
+                      std::forward<R>(row_permutation),
+                      std::forward<C>(column_permutation));
+}
+
 } // namespace grb
@@ -1,39 +1,304 @@
 #pragma once
 
+#include <algorithm>
+#include <execution>
+#include <grb/algorithms/permute.hpp>
 #include <grb/containers/views/views.hpp>
 #include <grb/detail/concepts.hpp>
 #include <grb/detail/detail.hpp>
+#include <grb/detail/parallel.hpp>
+#include <grb/detail/reduce.hpp>
+#include <grb/detail/row_compressed.hpp>
+#include <grb/experimental/sycl_tools/vector.hpp>
+#include <span>
+#include <vector>
 
 namespace grb {
 
-template <MatrixRange A,
+namespace __detail {
+
+// Reduce each row of CSR arrays to a single value, rows split into
+// contiguous ranges of about equal nonzero count between up to
+// `max_workers` workers.  Built-in monoids fold each row with
+// `reduce_values`; other operators fold the values of row i as
+// reduce(x[k], ... reduce(x[1], x[0])).
+template <typename Summation, typename T, std::integral I, typename Reduce,
+          typename M>
+grb::vector<T, I> reduce_rows(std::span<const I> rowptr,
+                              std::span<const T> values, Reduce&& reduce,
+                              M&& mask, std::size_t max_workers) {
+  std::size_t m = rowptr.size() - 1;
+
+  shp::vector<T> results(m);
+  std::vector<char> present(m, false);
+
+  std::size_t workers = num_workers(values.size(), max_workers);
+  auto bounds = balanced_partition(rowptr, workers);
+
+  parallel_for_workers(workers, [&](std::size_t worker) {
+    for (auto i = bounds[worker]; i < bounds[worker + 1]; i++) {
+      std::size_t first = rowptr[i];
+      std::size_t last = rowptr[i + 1];
+      if (first == last || mask.find(I(i)) == mask.end()) {
+        continue;
+      }
+
+      if constexpr (is_lane_reducible_v<Reduce, T>) {
+        results[i] = reduce_values<Summation>(
+            values.subspan(first, last - first), reduce, 1);
+      } else {
+        T value = values[first];
+        for (auto ptr = first + 1; ptr < last; ptr++) {
+          value = reduce(T(values[ptr]), value);
+        }
+        results[i] = value;
+      }
+      present[i] = true;
+    }
+  });
+
+  grb::vector<T, I> v(m);
+  for (std::size_t i = 0; i < m; i++) {
+    if (present[i]) {
+      v.insert({I(i), results[i]});
+    }
+  }
+  return v;
+}
+
+// Reduce each column of CSR arrays with sorted rows to a single value,
+// folding each column's values in row order into a dense accumulator.  Up
+// to `max_workers` workers each own a contiguous range of columns, finding
+// it in every row by binary search, so each column is folded the same way
+// whatever the number of workers.  Compensated sums keep an error term per
+// column; other operators fold as reduce(x[k], ... reduce(x[1], x[0])).
+template <typename Summation, typename T, std::integral I, typename Reduce,
+          typename M>
+grb::vector<T, I> reduce_columns_dense(std::span<const I> rowptr,
+                                       std::span<const I> colind,
+                                       std::span<const T> values,
+                                       std::size_t n, Reduce&& reduce,
+                                       M&& mask, std::size_t max_workers) {
+  constexpr bool kahan = uses_kahan_v<Summation, Reduce, T>;
+  std::size_t m = rowptr.size() - 1;
+
+  shp::vector<T> results(n, T{});
+  std::vector<compensated_sum<T>> sums(kahan ? n : 0);
+  std::vector<char> present(n, false);
+
+  std::size_t workers = num_workers(values.size(), max_workers);
+  parallel_for_workers(workers, [&](std::size_t worker) {
+    I first_column = I(n * worker / workers);
+    I last_column = I(n * (worker + 1) / workers);
+
+    for (std::size_t i = 0; i < m; i++) {
+      auto row_begin = colind.begin() + rowptr[i];
+      auto row_end = colind.begin() + rowptr[i + 1];
+      auto iter = workers == 1
+                      ? row_begin
+                      : std::lower_bound(row_begin, row_end, first_column);
+
+      for (; iter != row_end && *iter < last_column; ++iter) {
+        std::size_t j = *iter;
+        T v = values[iter - colind.begin()];
+        if constexpr (kahan) {
+          sums[j].add(v);
+        } else {
+          results[j] = present[j] ? T(reduce(v, results[j])) : v;
+        }
+        present[j] = true;
+      }
+    }
+  });
+
+  grb::vector<T, I> c(n);
+  for (std::size_t j = 0; j < n; j++) {
+    if (present[j] && mask.find(I(j)) != mask.end()) {
+      if constexpr (kahan) {
+        c.insert({I(j), sums[j].value()});
+      } else {
+        c.insert({I(j), results[j]});
+      }
+    }
+  }
+  return c;
+}
+
+// The stored values of the matrix or vector `r` in storage order, as a
+// contiguous array: the backend's own when it has one, otherwise gathered
+// into `buffer`.
+template <typename T, typename R>
+std::span<const T> stored_values(R&& r, shp::vector<T>& buffer) {
+  if constexpr (requires { r.backend().values(); }) {
+    return r.backend().values();
+  } else if constexpr (requires { r.backend().data(); }) {
+    // Dense storage can be used as is once every element is present.
+    if (std::size_t(r.size()) == std::size_t(r.shape())) {
+      return r.backend().data();
+    }
+  }
+
+  buffer = shp::vector<T>(r.size());
+  std::size_t k = 0;
+  for (auto&& [_, v] : r) {
+    buffer[k++] = v;
+  }
+  return std::span<const T>(buffer.data(), k);
+}
+
+} // namespace __detail
+
+/// Reduce each row of `a` to a single value, giving a vector with an
+/// element for each nonempty row allowed by `mask`.  Rows are computed in
+/// parallel when `policy` is `std::execution::par` or `par_unseq`, split
+/// into contiguous ranges of about equal nonzero count.
+///
+/// `grb::plus`, `grb::min`, `grb::max` and `grb::logical_or` on arithmetic
+/// values are folded with the blocked kernel of `grb::reduce_to_scalar`,
+/// with sums in the `Summation` mode (see `grb::blocked_summation`); other
+/// operators are folded in storage order.  Either way, each result depends
+/// only on its row, not on the policy or number of threads.
+template <typename Summation = grb::blocked_summation,
+          __detail::execution_policy ExecutionPolicy, MatrixRange A,
+          BinaryOperator<grb::matrix_scalar_t<A>, grb::matrix_scalar_t<A>,
+                         grb::matrix_scalar_t<A>>
+              Reduce = grb::plus<>,
+          MaskVectorRange M = grb::full_vector_mask<>>
+  requires(__detail::is_summation_v<Summation>)
+auto reduce(ExecutionPolicy&& policy, A&& a, Reduce&& reduce = Reduce{},
+            M&& mask = M{}) {
+  using T = grb::matrix_scalar_t<A>;
+  using I = grb::matrix_index_t<A>;
+
+  std::size_t max_workers =
+      __detail::is_parallel_policy_v<ExecutionPolicy> ? grb::max_threads() : 1;
+
+  auto a_rows = __detail::make_row_compressed(std::forward<A>(a));
+  return __detail::reduce_rows<Summation, T, I>(
+      a_rows.rowptr(), a_rows.values(), reduce, mask, max_workers);
+}
+
+/// Reduce each row of `a` (sequentially); see above.
+template <typename Summation = grb::blocked_summation, MatrixRange A,
           BinaryOperator<grb::matrix_scalar_t<A>, grb::matrix_scalar_t<A>,
                          grb::matrix_scalar_t<A>>
               Reduce = grb::plus<>,
           MaskVectorRange M = grb::full_vector_mask<>>
+  requires(__detail::is_summation_v<Summation>)
 auto reduce(A&& a, Reduce&& reduce = Reduce{}, M&& mask = M{}) {
+  return grb::reduce<Summation>(std::execution::seq, std::forward<A>(a),
+                                std::forward<Reduce>(reduce),
+                                std::forward<M>(mask));
+}
+
+/// Reduce each column of `a` to a single value, giving a vector with an
+/// element for each nonempty column allowed by `mask`.  Each column's values
+/// are folded in row order into a dense accumulator, with up to
+/// `grb::max_threads()` workers each owning a range of columns under
+/// `std::execution::par` or `par_unseq`, so the results do not depend on
+/// the policy or number of threads.  Compensated sums keep an error term
+/// per column.  Pairwise sums need each column's values together, so they
+/// are gathered by column with a counting sort first, and the columns then
+/// reduced as rows are by `grb::reduce`.
+template <typename Summation = grb::blocked_summation,
+          __detail::execution_policy ExecutionPolicy, MatrixRange A,
+          BinaryOperator<grb::matrix_scalar_t<A>, grb::matrix_scalar_t<A>,
+                         grb::matrix_scalar_t<A>>
+              Reduce = grb::plus<>,
+          MaskVectorRange M = grb::full_vector_mask<>>
+  requires(__detail::is_summation_v<Summation>)
+auto reduce_columns(ExecutionPolicy&& policy, A&& a,
+                    Reduce&& reduce = Reduce{}, M&& mask = M{}) {
   using T = grb::matrix_scalar_t<A>;
   using I = grb::matrix_index_t<A>;
 
-  grb::vector<T, I> v(grb::shape(a)[0]);
+  std::size_t max_workers =
+      __detail::is_parallel_policy_v<ExecutionPolicy> ? grb::max_threads() : 1;
 
-  for (auto&& [idx, a_v] : a) {
-    T value = a_v;
-    auto&& [row, col] = idx;
+  auto a_rows = __detail::make_row_compressed(std::forward<A>(a));
+  std::size_t n = a_rows.shape()[1];
 
-    if (mask.find(row) != mask.end()) {
-      auto iter = v.find(row);
+  if constexpr (__detail::uses_pairwise_v<Summation, Reduce, T>) {
+    auto columns = __detail::counting_transpose<T, I>(
+        a_rows.rowptr(), a_rows.colind(), a_rows.values(), {}, {}, n,
+        max_workers);
+    return __detail::reduce_rows<Summation, T, I>(
+        std::span<const I>(columns.rowptr.data(), columns.rowptr.size()),
+        std::span<const T>(columns.values.data(), columns.values.size()),
+        reduce, mask, max_workers);
+  } else {
+    return __detail::reduce_columns_dense<Summation, T, I>(
+        a_rows.rowptr(), a_rows.colind(), a_rows.values(), n, reduce, mask,
+        max_workers);
+  }
+}
 
-      if (iter != v.end()) {
-        auto&& [_, v_v] = *iter;
-        value = reduce(value, v_v);
-      }
+/// Reduce each column of `a` (sequentially); see above.
+template <typename Summation = grb::blocked_summation, MatrixRange A,
+          BinaryOperator<grb::matrix_scalar_t<A>, grb::matrix_scalar_t<A>,
+                         grb::matrix_scalar_t<A>>
+              Reduce = grb::plus<>,
+          MaskVectorRange M = grb::full_vector_mask<>>
+  requires(__detail::is_summation_v<Summation>)
+auto reduce_columns(A&& a, Reduce&& reduce = Reduce{}, M&& mask = M{}) {
+  return grb::reduce_columns<Summation>(
+      std::execution::seq, std::forward<A>(a), std::forward<Reduce>(reduce),
+      std::forward<M>(mask));
+}
+
+/// Reduce the stored values of the matrix or vector `r` to a single value
+/// with the monoid `reduce`, which gives its identity if there are none.
+///
+/// Values are taken in storage order (row by row for a matrix) and reduced
+/// in blocks of 8192, which workers take in contiguous runs: up to
+/// `grb::max_threads()` of them with `std::execution::par` or `par_unseq`.
+/// Block results are then combined in order, so the result does not depend
+/// on the policy or number of threads.  `grb::plus`, `grb::min`, `grb::max`
+/// and `grb::logical_or` on arithmetic values fold each block into 16
+/// independent lanes, which the compiler vectorizes; floating-point sums use
+/// the `Summation` mode (see `grb::blocked_summation`).  Other monoids are
+/// folded in order.  A logical or stops at the first block holding true.
+template <typename Summation = grb::blocked_summation,
+          __detail::execution_policy ExecutionPolicy, typename R,
+          typename Reduce = grb::plus<>>
+  requires((MatrixRange<R> || VectorRange<R>) &&
+           grb::Monoid<std::remove_cvref_t<Reduce>,
+                       grb::container_scalar_t<std::remove_cvref_t<R>>> &&
+           __detail::is_summation_v<Summation>)
+auto reduce_to_scalar(ExecutionPolicy&& policy, R&& r,
+                      Reduce&& reduce = Reduce{}) {
+  using T = grb::container_scalar_t<std::remove_cvref_t<R>>;
+
+  std::size_t max_workers =
+      __detail::is_parallel_policy_v<ExecutionPolicy> ? grb::max_threads() : 1;
 
-      v.insert_or_assign(row, value);
+  auto reduce_span = [&](std::span<const T> values) {
+    if (values.empty()) {
+      return grb::monoid_traits<std::remove_cvref_t<Reduce>, T>::identity();
     }
+    return __detail::reduce_values<Summation>(values, reduce, max_workers);
+  };
+
+  if constexpr (MatrixRange<R>) {
+    auto a_rows = __detail::make_row_compressed(std::forward<R>(r));
+    return reduce_span(a_rows.values());
+  } else {
+    shp::vector<T> buffer;
+    return reduce_span(__detail::stored_values(r, buffer));
   }
+}
 
-  return v;
+/// Reduce the stored values of `r` to a single value (sequentially); see
+/// above.
+template <typename Summation = grb::blocked_summation, typename R,
+          typename Reduce = grb::plus<>>
+  requires((MatrixRange<R> || VectorRange<R>) &&
+           grb::Monoid<std::remove_cvref_t<Reduce>,
+                       grb::container_scalar_t<std::remove_cvref_t<R>>> &&
+           __detail::is_summation_v<Summation>)
+auto reduce_to_scalar(R&& r, Reduce&& reduce = Reduce{}) {
+  return grb::reduce_to_scalar<Summation>(
+      std::execution::seq, std::forward<R>(r), std::forward<Reduce>(reduce));
 }
 
 } // namespace grb
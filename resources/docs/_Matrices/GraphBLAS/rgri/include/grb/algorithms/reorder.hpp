@@ -0,0 +1,226 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <grb/algorithms/permute.hpp>
+#include <grb/detail/concepts.hpp>
+#include <grb/detail/matrix_traits.hpp>
+#include <grb/detail/row_compressed.hpp>
+#include <grb/exceptions/exception.hpp>
+#include <utility>
+#include <vector>
+
+namespace grb {
+
+namespace __detail {
+
+// Neighbors of each vertex in the undirected graph of a square matrix: the
+// union of the patterns of the matrix and its transpose, without
+// self-loops.  Vertex v's neighbors are adj[ptr[v], ptr[v + 1]), sorted.
+template <std::integral I>
+struct undirected_graph {
+  std::vector<std::size_t> ptr;
+  std::vector<I> adj;
+
+  std::size_t degree(I v) const noexcept {
+    return ptr[v + 1] - ptr[v];
+  }
+};
+
+// Each row of the matrix is merged with the same row of its transpose,
+// which a counting sort gives with sorted columns, so this is O(nnz + n).
+template <typename Rows>
+auto make_undirected_graph(const Rows& a) {
+  using T = typename Rows::scalar_type;
+  using I = typename Rows::index_type;
+
+  std::size_t n = a.shape()[0];
+  auto rowptr = a.rowptr();
+  auto colind = a.colind();
+  auto t = counting_transpose<T, I>(rowptr, colind, a.values(), {}, {}, n, 1);
+
+  undirected_graph<I> g;
+  g.ptr.assign(n + 1, 0);
+  g.adj.reserve(2 * colind.size());
+  for (std::size_t v = 0; v < n; v++) {
+    auto x = colind.begin() + rowptr[v];
+    auto x_end = colind.begin() + rowptr[v + 1];
+    auto y = t.colind.begin() + t.rowptr[v];
+    auto y_end = t.colind.begin() + t.rowptr[v + 1];
+
+    while (x != x_end || y != y_end) {
+      I w;
+      if (y == y_end || (x != x_end && *x < *y)) {
+        w = *x++;
+      } else if (x == x_end || *y < *x) {
+        w = *y++;
+      } else {
+        w = *x++;
+        ++y;
+      }
+      if (std::size_t(w) != v) {
+        g.adj.push_back(w);
+      }
+    }
+    g.ptr[v + 1] = g.adj.size();
+  }
+  return g;
+}
+
+// Vertices in increasing (or decreasing) order of `degree`, ties in index
+// order: a counting sort, O(n + max degree).
+template <std::integral I, typename Degree>
+std::vector<I> order_by_degree(std::size_t n, Degree&& degree,
+                               bool descending) {
+  std::size_t max_degree = 0;
+  for (std::size_t v = 0; v < n; v++) {
+    max_degree = std::max(max_degree, degree(v));
+  }
+
+  std::vector<std::size_t> start(max_degree + 2, 0);
+  for (std::size_t v = 0; v < n; v++) {
+    std::size_t d = degree(v);
+    start[(descending ? max_degree - d : d) + 1]++;
+  }
+  for (std::size_t d = 0; d <= max_degree; d++) {
+    start[d + 1] += start[d];
+  }
+
+  std::vector<I> order(n);
+  for (std::size_t v = 0; v < n; v++) {
+    std::size_t d = degree(v);
+    order[start[descending ? max_degree - d : d]++] = I(v);
+  }
+  return order;
+}
+
+// Reverse Cuthill-McKee.  Each connected component is numbered in
+// breadth-first order from a pseudo-peripheral vertex, visiting the
+// unnumbered neighbors of each vertex in increasing order of degree, and
+// the whole order is then reversed.  Components are started from their
+// lowest-degree vertex, which George and Liu's search then moves to the
+// lowest-degree vertex of the last BFS level for as long as that makes the
+// BFS deeper.
+template <std::integral I>
+std::vector<I> reverse_cuthill_mckee(const undirected_graph<I>& g) {
+  std::size_t n = g.ptr.size() - 1;
+
+  // BFS depths of the current pseudo-peripheral search; `stamp` tells which
+  // search set them, so they never need clearing.
+  std::vector<std::size_t> depth(n, 0);
+  std::vector<std::size_t> stamp(n, 0);
+  std::size_t search = 0;
+  std::vector<I> queue;
+
+  // BFS over the component of `root`; returns its depth.
+  auto bfs = [&](I root) {
+    search++;
+    queue.assign(1, root);
+    stamp[root] = search;
+    depth[root] = 0;
+    for (std::size_t head = 0; head < queue.size(); head++) {
+      I v = queue[head];
+      for (auto ptr = g.ptr[v]; ptr < g.ptr[v + 1]; ptr++) {
+        I w = g.adj[ptr];
+        if (stamp[w] != search) {
+          stamp[w] = search;
+          depth[w] = depth[v] + 1;
+          queue.push_back(w);
+        }
+      }
+    }
+    return depth[queue.back()];
+  };
+
+  auto by_degree = [&](I v, I w) {
+    return std::pair{g.degree(v), v} < std::pair{g.degree(w), w};
+  };
+
+  std::vector<I> order;
+  order.reserve(n);
+  std::vector<char> numbered(n, false);
+  std::vector<I> neighbors;
+
+  auto starts = order_by_degree<I>(
+      n, [&](std::size_t v) { return g.degree(I(v)); }, false);
+  for (I start : starts) {
+    if (numbered[start]) {
+      continue;
+    }
+
+    I root = start;
+    std::size_t eccentricity = bfs(root);
+    while (true) {
+      I candidate = queue.back();
+      for (auto v : queue) {
+        if (depth[v] == eccentricity && by_degree(v, candidate)) {
+          candidate = v;
+        }
+      }
+      std::size_t candidate_eccentricity = bfs(candidate);
+      if (candidate_eccentricity <= eccentricity) {
+        break;
+      }
+      root = candidate;
+      eccentricity = candidate_eccentricity;
+    }
+
+    numbered[root] = true;
+    order.push_back(root);
+    for (std::size_t head = order.size() - 1; head < order.size(); head++) {
+      I v = order[head];
+      neighbors.clear();
+      for (auto ptr = g.ptr[v]; ptr < g.ptr[v + 1]; ptr++) {
+        I w = g.adj[ptr];
+        if (!numbered[w]) {
+          numbered[w] = true;
+          neighbors.push_back(w);
+        }
+      }
+      std::sort(neighbors.begin(), neighbors.end(), by_degree);
+      order.insert(order.end(), neighbors.begin(), neighbors.end());
+    }
+  }
+
+  std::reverse(order.begin(), order.end());
+  return order;
+}
+
+} // namespace __detail
+
+/// Reverse Cuthill-McKee ordering of the square matrix `a`, as a
+/// permutation for `grb::permute(a, p)`: row and column k of the permuted
+/// matrix are row and column p[k] of `a`.
+///
+/// Numbers the vertices of the undirected graph of `a` (its pattern made
+/// symmetric) breadth-first from a pseudo-peripheral vertex, then reverses
+/// the order.  This gathers each vertex's neighbors near it, keeping the
+/// elements of the permuted matrix close to the diagonal, so matrix-vector
+/// products touch `x` with good locality.  Values are ignored.  O(nnz + n)
+/// plus the sorting of each neighbor list by degree.
+template <MatrixRange A>
+auto rcm_ordering(A&& a) {
+  if (a.shape()[0] != a.shape()[1]) {
+    throw grb::invalid_argument("rcm_ordering: matrix must be square.");
+  }
+
+  auto rows = __detail::make_row_compressed(std::forward<A>(a));
+  return __detail::reverse_cuthill_mckee(__detail::make_undirected_graph(rows));
+}
+
+/// Ordering of the rows of `a` by number of stored elements, largest first
+/// unless `descending` is false, ties in index order; a permutation for
+/// `grb::permute(a, p)`.  Putting the high-degree rows of a power-law graph
+/// first keeps their entries of `x` together in cache during matrix-vector
+/// products.  O(nnz + n) for non-CSR inputs, O(n) otherwise.
+template <MatrixRange A>
+auto degree_ordering(A&& a, bool descending = true) {
+  using I = grb::matrix_index_t<A>;
+
+  auto rows = __detail::make_row_compressed(std::forward<A>(a));
+  auto degree = [&](std::size_t v) { return std::size_t(rows.row_size(I(v))); };
+  return __detail::order_by_degree<I>(rows.shape()[0], degree, descending);
+}
+
+} // namespace grb
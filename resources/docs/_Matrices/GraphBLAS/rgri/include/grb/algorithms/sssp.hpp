@@ -0,0 +1,279 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <execution>
+#include <grb/containers/vector.hpp>
+#include <grb/detail/concepts.hpp>
+#include <grb/detail/matrix_traits.hpp>
+#include <grb/detail/parallel.hpp>
+#include <grb/detail/row_compressed.hpp>
+#include <grb/exceptions/exception.hpp>
+#include <limits>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace grb {
+
+namespace __detail {
+
+// The out-edges of each vertex reordered so its light edges (weight at most
+// `delta`) come first: vertex v's light edges are [rowptr[v], split[v]) and
+// its heavy edges [split[v], rowptr[v + 1]).
+template <typename T, std::integral I>
+struct split_graph {
+  std::vector<std::size_t> rowptr;
+  std::vector<std::size_t> split;
+  std::vector<I> target;
+  std::vector<T> weight;
+  T max_weight = 0;
+};
+
+template <typename T, std::integral I, typename Rows>
+split_graph<T, I> make_split_graph(const Rows& rows, T delta) {
+  std::size_t n = rows.shape()[0];
+  auto rowptr = rows.rowptr();
+  auto colind = rows.colind();
+  auto values = rows.values();
+
+  split_graph<T, I> g;
+  g.rowptr.assign(rowptr.begin(), rowptr.end());
+  g.split.resize(n);
+  g.target.resize(colind.size());
+  g.weight.resize(colind.size());
+
+  for (std::size_t v = 0; v < n; v++) {
+    std::size_t light = rowptr[v];
+    std::size_t heavy = rowptr[v + 1];
+    for (std::size_t ptr = rowptr[v]; ptr < std::size_t(rowptr[v + 1]);
+         ptr++) {
+      T w = values[ptr];
+      if (w < T(0)) {
+        throw grb::invalid_argument("sssp: edge weights must be nonnegative.");
+      }
+      g.max_weight = std::max(g.max_weight, w);
+      std::size_t out = w <= delta ? light++ : --heavy;
+      g.target[out] = colind[ptr];
+      g.weight[out] = w;
+    }
+    g.split[v] = light;
+  }
+  return g;
+}
+
+// Distance of the vertices not reached (yet).
+template <typename T>
+inline constexpr T unreached_distance = std::numeric_limits<T>::has_infinity
+                                            ? std::numeric_limits<T>::infinity()
+                                            : std::numeric_limits<T>::max();
+
+// Bucket width for delta-stepping: the largest weight over the average
+// degree, which Meyer and Sanders show keeps both the passes per bucket and
+// the re-relaxed edges few for random weights.
+template <typename T>
+T default_delta(T max_weight, std::size_t n, std::size_t nnz) {
+  T delta = max_weight;
+  if (nnz > n && n > 0) {
+    delta = T(max_weight / T(nnz / n));
+  }
+  if (!(delta > T(0))) {
+    delta = T(1);
+  }
+  return delta;
+}
+
+// Delta-stepping single-source shortest paths (Meyer and Sanders, 2003).
+//
+// Tentative distances d are kept in buckets of width `delta`.  The lowest
+// non-empty bucket is emptied by repeatedly relaxing the light edges of the
+// vertices just added to it, which can only add vertices to the same or
+// later buckets; once it stays empty, the heavy edges of every vertex it
+// held are relaxed once.  Only vertices whose distance changed are ever
+// relaxed.  A vertex moved to a lower bucket leaves a stale entry behind,
+// which is skipped when its bucket comes up.  Light edges never lead to an
+// earlier bucket and heavy ones always lead to a later one; targets are
+// clamped to that so floating-point rounding cannot break it.
+//
+// Live entries are at most `max_weight / delta + 1` buckets ahead of the
+// current one, so the buckets are a ring of slightly more slots than that.
+//
+// Each relaxation pass splits the frontier's edges between up to
+// `max_workers` workers, which collect improved distances in private
+// buffers; these are then applied, and their vertices bucketed, serially.
+// Results do not depend on the number of workers.
+template <typename T, std::integral I, typename Rows>
+std::vector<T> delta_stepping(const Rows& rows, std::size_t source, T delta,
+                              std::size_t max_workers) {
+  constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+  std::size_t n = rows.shape()[0];
+  if (delta <= T(0)) {
+    T max_weight = 0;
+    for (auto w : rows.values()) {
+      max_weight = std::max(max_weight, w);
+    }
+    delta = default_delta(max_weight, n, rows.size());
+  }
+  auto g = make_split_graph<T, I>(rows, delta);
+
+  auto bucket_of = [&](T d) { return std::size_t(d / delta); };
+  std::size_t slots = bucket_of(g.max_weight) + 3;
+  std::vector<std::vector<I>> buckets(slots);
+
+  std::vector<T> dist(n, unreached_distance<T>);
+  std::vector<std::size_t> level(n, npos);
+  std::vector<std::size_t> frontier_pass(n, npos);
+  std::vector<std::size_t> settled_bucket(n, npos);
+
+  std::vector<std::vector<std::pair<I, T>>> requests(
+      std::max<std::size_t>(max_workers, 1));
+  std::vector<std::size_t> edges;
+
+  std::size_t queued = 0;
+  // Lower v's distance to `d` if shorter, queueing it in bucket
+  // `min_bucket` or later.
+  auto update = [&](I v, T d, std::size_t min_bucket) {
+    if (d < dist[v]) {
+      dist[v] = d;
+      level[v] = std::max(bucket_of(d), min_bucket);
+      buckets[level[v] % slots].push_back(v);
+      queued++;
+    }
+  };
+
+  // Relax the light or heavy edges of `vertices`.  Distances are only read
+  // while the workers run, and only written afterwards.
+  auto relax = [&](std::span<const I> vertices, bool light, std::size_t b) {
+    auto first = [&](I v) { return light ? g.rowptr[v] : g.split[v]; };
+    auto last = [&](I v) { return light ? g.split[v] : g.rowptr[v + 1]; };
+
+    edges.assign(vertices.size() + 1, 0);
+    for (std::size_t k = 0; k < vertices.size(); k++) {
+      edges[k + 1] = edges[k] + last(vertices[k]) - first(vertices[k]);
+    }
+    if (edges.back() == 0) {
+      return;
+    }
+
+    std::size_t workers = num_workers(edges.back(), max_workers);
+    auto bounds = balanced_partition(std::span<const std::size_t>(edges),
+                                     workers);
+
+    parallel_for_workers(workers, [&](std::size_t worker) {
+      auto&& out = requests[worker];
+      out.clear();
+      for (auto k = bounds[worker]; k < bounds[worker + 1]; k++) {
+        I v = vertices[k];
+        T d = dist[v];
+        for (std::size_t e = first(v); e < last(v); e++) {
+          T candidate = d + g.weight[e];
+          if (candidate < dist[g.target[e]]) {
+            out.push_back({g.target[e], candidate});
+          }
+        }
+      }
+    });
+
+    for (std::size_t worker = 0; worker < workers; worker++) {
+      for (auto&& [v, d] : requests[worker]) {
+        update(v, d, light ? b : b + 1);
+      }
+    }
+  };
+
+  update(I(source), T(0), 0);
+
+  std::vector<I> frontier;
+  std::vector<I> settled;
+  std::vector<I> entries;
+  std::size_t pass = 0;
+  for (std::size_t b = 0; queued > 0; b++) {
+    auto&& bucket = buckets[b % slots];
+    settled.clear();
+
+    while (!bucket.empty()) {
+      std::swap(entries, bucket);
+      queued -= entries.size();
+
+      frontier.clear();
+      for (auto v : entries) {
+        if (level[v] == b && frontier_pass[v] != pass) {
+          frontier_pass[v] = pass;
+          frontier.push_back(v);
+          if (settled_bucket[v] != b) {
+            settled_bucket[v] = b;
+            settled.push_back(v);
+          }
+        }
+      }
+      entries.clear();
+      pass++;
+
+      relax(frontier, true, b);
+    }
+
+    relax(settled, false, b);
+  }
+
+  return dist;
+}
+
+} // namespace __detail
+
+/// Single-source shortest paths from `source` in the graph with an edge
+/// i -> j of weight a(i, j) for each stored element.
+///
+/// Returns a vector holding the length of the shortest path to each vertex
+/// reachable from `source`; unreachable vertices have no element.  Uses
+/// delta-stepping: vertices are settled in buckets of tentative distance
+/// `delta` wide, relaxing light edges (weight at most `delta`) within a
+/// bucket and heavy ones once per bucket, and only the vertices whose
+/// distance changed are relaxed, so the work is close to O(nnz).  A
+/// `delta` of 0 picks the largest weight over the average degree.  Weights
+/// must be nonnegative.
+///
+/// With `std::execution::par` or `par_unseq`, each relaxation pass is split
+/// across up to `grb::max_threads()` workers.
+template <__detail::execution_policy ExecutionPolicy, MatrixRange A>
+auto sssp(ExecutionPolicy&& policy, A&& a, grb::matrix_index_t<A> source,
+          grb::matrix_scalar_t<A> delta = grb::matrix_scalar_t<A>{}) {
+  using T = grb::matrix_scalar_t<A>;
+  using I = grb::matrix_index_t<A>;
+
+  if (a.shape()[0] != a.shape()[1]) {
+    throw grb::invalid_argument("sssp: adjacency matrix must be square.");
+  }
+
+  if (std::size_t(source) >= std::size_t(a.shape()[0])) {
+    throw grb::out_of_range("sssp: source vertex " + std::to_string(source) +
+                            " is out of range.");
+  }
+
+  std::size_t max_workers =
+      __detail::is_parallel_policy_v<ExecutionPolicy> ? grb::max_threads() : 1;
+
+  auto rows = __detail::make_row_compressed(std::forward<A>(a));
+  auto dist =
+      __detail::delta_stepping<T, I>(rows, std::size_t(source), delta,
+                                     max_workers);
+
+  grb::vector<T, I> distances(a.shape()[0]);
+  for (std::size_t v = 0; v < dist.size(); v++) {
+    if (dist[v] != __detail::unreached_distance<T>) {
+      distances.insert({I(v), dist[v]});
+    }
+  }
+  return distances;
+}
+
+/// Single-source shortest paths (sequentially); see above.
+template <MatrixRange A>
+auto sssp(A&& a, grb::matrix_index_t<A> source,
+          grb::matrix_scalar_t<A> delta = grb::matrix_scalar_t<A>{}) {
+  return grb::sssp(std::execution::seq, std::forward<A>(a), source, delta);
+}
+
+} // namespace grb
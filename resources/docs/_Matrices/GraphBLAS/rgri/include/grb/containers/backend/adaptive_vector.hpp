@@ -0,0 +1,215 @@
+#pragma once
+
+#include <grb/containers/backend/adaptive_vector_iterator.hpp>
+#include <grb/containers/backend/bitmap_vector.hpp>
+#include <grb/containers/backend/sparse_vector.hpp>
+
+namespace grb {
+
+/// Vector backend that stores its elements as a `sparse_vector` while few
+/// indices are present and as a `bitmap_vector` once they fill more than
+/// 1 / `bitmap_switch` of the shape, so iterating costs about
+/// O(min(nnz log nnz, nnz + shape / 64)).  It switches back to sparse in
+/// `conform()` when the fill drops below 1 / `sparse_switch`.  Switching
+/// invalidates iterators, as any insert into a sparse vector does.
+template <typename T, typename I, typename Allocator>
+class adaptive_vector {
+public:
+  using index_type = I;
+  using value_type = grb::vector_entry<T, I>;
+
+  using key_type = I;
+  using map_type = T;
+
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  using allocator_type = Allocator;
+
+  using sparse_type = grb::sparse_vector<T, I, Allocator>;
+  using bitmap_type = grb::bitmap_vector<T, I, Allocator>;
+
+  using iterator = adaptive_vector_iterator<typename sparse_type::iterator,
+                                            typename bitmap_type::iterator>;
+  using const_iterator =
+      adaptive_vector_iterator<typename sparse_type::const_iterator,
+                               typename bitmap_type::const_iterator>;
+
+  using reference = typename sparse_type::reference;
+  using const_reference = typename sparse_type::const_reference;
+
+  using pointer = iterator;
+  using const_pointer = const_iterator;
+
+  using scalar_reference = typename sparse_type::scalar_reference;
+
+  static constexpr size_type bitmap_switch = 16;
+  static constexpr size_type sparse_switch = 64;
+
+  adaptive_vector(I shape) : sparse_(shape) {}
+
+  adaptive_vector(I shape, const Allocator& allocator)
+      : sparse_(shape, allocator), bitmap_(allocator) {}
+
+  size_type shape() const noexcept {
+    return sparse_.shape();
+  }
+
+  size_type size() const noexcept {
+    return is_bitmap_ ? bitmap_.size() : sparse_.size();
+  }
+
+  /// Whether the elements are currently stored as a bitmap.
+  bool is_bitmap() const noexcept {
+    return is_bitmap_;
+  }
+
+  scalar_reference operator[](I index) {
+    if (is_bitmap_) {
+      return bitmap_[index];
+    }
+    if (sparse_.find(index) == sparse_.end() && grow_to_bitmap()) {
+      return bitmap_[index];
+    }
+    return sparse_[index];
+  }
+
+  iterator begin() noexcept {
+    return is_bitmap_ ? iterator(bitmap_.begin()) : iterator(sparse_.begin());
+  }
+
+  const_iterator begin() const noexcept {
+    return is_bitmap_ ? const_iterator(bitmap_.begin())
+                      : const_iterator(sparse_.begin());
+  }
+
+  iterator end() noexcept {
+    return is_bitmap_ ? iterator(bitmap_.end()) : iterator(sparse_.end());
+  }
+
+  const_iterator end() const noexcept {
+    return is_bitmap_ ? const_iterator(bitmap_.end())
+                      : const_iterator(sparse_.end());
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    auto&& [idx, v] = value;
+    if (!is_bitmap_ && sparse_.find(idx) == sparse_.end()) {
+      grow_to_bitmap();
+    }
+    if (is_bitmap_) {
+      auto [iter, inserted] = bitmap_.insert(value);
+      return {iterator(iter), inserted};
+    }
+    auto [iter, inserted] = sparse_.insert(value);
+    return {iterator(iter), inserted};
+  }
+
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(key_type k, M&& obj) {
+    if (!is_bitmap_ && sparse_.find(k) == sparse_.end()) {
+      grow_to_bitmap();
+    }
+    if (is_bitmap_) {
+      auto [iter, inserted] = bitmap_.insert_or_assign(k, std::forward<M>(obj));
+      return {iterator(iter), inserted};
+    }
+    auto [iter, inserted] = sparse_.insert_or_assign(k, std::forward<M>(obj));
+    return {iterator(iter), inserted};
+  }
+
+  iterator find(key_type key) noexcept {
+    return is_bitmap_ ? iterator(bitmap_.find(key))
+                      : iterator(sparse_.find(key));
+  }
+
+  const_iterator find(key_type key) const noexcept {
+    return is_bitmap_ ? const_iterator(bitmap_.find(key))
+                      : const_iterator(sparse_.find(key));
+  }
+
+  void reshape(I shape) {
+    if (is_bitmap_) {
+      bitmap_.reshape(shape);
+    }
+    sparse_.reshape(shape);
+    conform();
+  }
+
+  /// Pick the representation that suits the current fill ratio.
+  void conform() {
+    if (is_bitmap_ && bitmap_.size() * sparse_switch < shape()) {
+      to_sparse();
+    } else if (!is_bitmap_ && sparse_.size() * bitmap_switch > shape()) {
+      to_bitmap();
+    }
+  }
+
+  /// The active representations; only one holds elements at a time.
+  const sparse_type& sparse() const noexcept {
+    return sparse_;
+  }
+
+  const bitmap_type& bitmap() const noexcept {
+    return bitmap_;
+  }
+
+  adaptive_vector() = default;
+
+  adaptive_vector(const Allocator& allocator)
+      : sparse_(allocator), bitmap_(allocator) {}
+
+  ~adaptive_vector() = default;
+  adaptive_vector(const adaptive_vector&) = default;
+  adaptive_vector& operator=(const adaptive_vector&) = default;
+
+  adaptive_vector(adaptive_vector&& other)
+      : sparse_(std::move(other.sparse_)), bitmap_(std::move(other.bitmap_)),
+        is_bitmap_(other.is_bitmap_) {
+    other.is_bitmap_ = false;
+  }
+
+  adaptive_vector& operator=(adaptive_vector&& other) {
+    sparse_ = std::move(other.sparse_);
+    bitmap_ = std::move(other.bitmap_);
+    is_bitmap_ = other.is_bitmap_;
+    other.is_bitmap_ = false;
+    return *this;
+  }
+
+private:
+  // Switch to a bitmap if one more element would cross the threshold.
+  bool grow_to_bitmap() {
+    if ((sparse_.size() + 1) * bitmap_switch > shape()) {
+      to_bitmap();
+    }
+    return is_bitmap_;
+  }
+
+  void to_bitmap() {
+    bitmap_type bitmap(I(shape()), sparse_.get_allocator());
+    for (auto&& [index, value] : sparse_) {
+      bitmap.insert({index, value});
+    }
+    bitmap_ = std::move(bitmap);
+    sparse_.clear();
+    is_bitmap_ = true;
+  }
+
+  void to_sparse() {
+    sparse_.clear();
+    sparse_.reserve(bitmap_.size());
+    for (auto&& [index, value] : bitmap_) {
+      sparse_.insert({index, value});
+    }
+    bitmap_ = bitmap_type(sparse_.get_allocator());
+    is_bitmap_ = false;
+  }
+
+  // `sparse_` always carries the shape, even while empty.
+  sparse_type sparse_;
+  bitmap_type bitmap_;
+  bool is_bitmap_ = false;
+};
+
+} // namespace grb
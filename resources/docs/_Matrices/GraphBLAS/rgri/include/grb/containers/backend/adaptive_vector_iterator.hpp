@@ -0,0 +1,93 @@
+#pragma once
+
+#include <grb/containers/vector_entry.hpp>
+#include <iterator>
+
+namespace grb {
+
+// Iterator over an `adaptive_vector`, wrapping the iterator of whichever
+// representation the vector currently uses.
+template <typename SparseIter, typename BitmapIter>
+class adaptive_vector_iterator {
+public:
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  using scalar_type = typename SparseIter::scalar_type;
+  using index_type = typename SparseIter::index_type;
+
+  using key_type = index_type;
+  using map_type = scalar_type;
+
+  using value_type = typename SparseIter::value_type;
+  using iterator = adaptive_vector_iterator;
+  using const_iterator =
+      adaptive_vector_iterator<typename SparseIter::const_iterator,
+                               typename BitmapIter::const_iterator>;
+
+  using reference = typename SparseIter::reference;
+  using const_reference = typename SparseIter::const_reference;
+
+  static_assert(std::is_same_v<reference, typename BitmapIter::reference>);
+
+  using pointer = iterator;
+  using const_pointer = const_iterator;
+
+  using iterator_category = std::forward_iterator_tag;
+
+  adaptive_vector_iterator(SparseIter sparse)
+      : sparse_(sparse), bitmap_(false) {}
+
+  adaptive_vector_iterator(BitmapIter bitmap)
+      : bitmap_iter_(bitmap), bitmap_(true) {}
+
+  operator const_iterator() const noexcept
+    requires(!std::is_same_v<iterator, const_iterator>)
+  {
+    if (bitmap_) {
+      return const_iterator(
+          static_cast<typename BitmapIter::const_iterator>(bitmap_iter_));
+    }
+    return const_iterator(
+        static_cast<typename SparseIter::const_iterator>(sparse_));
+  }
+
+  decltype(auto) operator*() const noexcept {
+    return bitmap_ ? *bitmap_iter_ : *sparse_;
+  }
+
+  adaptive_vector_iterator& operator++() noexcept {
+    if (bitmap_) {
+      ++bitmap_iter_;
+    } else {
+      ++sparse_;
+    }
+    return *this;
+  }
+
+  adaptive_vector_iterator operator++(int) noexcept {
+    adaptive_vector_iterator other = *this;
+    ++(*this);
+    return other;
+  }
+
+  bool operator==(const adaptive_vector_iterator& other) const noexcept {
+    return bitmap_ ? bitmap_iter_ == other.bitmap_iter_
+                   : sparse_ == other.sparse_;
+  }
+
+  adaptive_vector_iterator() = default;
+  ~adaptive_vector_iterator() = default;
+  adaptive_vector_iterator(const adaptive_vector_iterator&) = default;
+  adaptive_vector_iterator(adaptive_vector_iterator&&) = default;
+  adaptive_vector_iterator&
+  operator=(const adaptive_vector_iterator&) = default;
+  adaptive_vector_iterator& operator=(adaptive_vector_iterator&&) = default;
+
+private:
+  SparseIter sparse_;
+  BitmapIter bitmap_iter_;
+  bool bitmap_ = false;
+};
+
+} // namespace grb
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <grb/containers/backend/bitmap_vector_iterator.hpp>
+#include <grb/containers/vector_entry.hpp>
+#include <span>
+#include <vector>
+
+namespace grb {
+
+/// Vector backend storing a value slot for every index plus a packed bitset
+/// of which slots hold an element.  Lookups are O(1), and iteration skips
+/// 64 empty slots per word, so it suits vectors with a sizeable fraction of
+/// their elements present.
+template <typename T, typename I, typename Allocator>
+class bitmap_vector {
+public:
+  using index_type = I;
+  using value_type = grb::vector_entry<T, I>;
+
+  using key_type = I;
+  using map_type = T;
+
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  using allocator_type = Allocator;
+
+  using word_allocator_type = typename std::allocator_traits<
+      allocator_type>::template rebind_alloc<std::uint64_t>;
+
+  using iterator = bitmap_vector_iterator<
+      T, index_type, typename std::vector<T, allocator_type>::iterator,
+      typename std::vector<T, allocator_type>::const_iterator>;
+
+  using const_iterator = bitmap_vector_iterator<
+      std::add_const_t<T>, index_type,
+      typename std::vector<T, allocator_type>::iterator,
+      typename std::vector<T, allocator_type>::const_iterator>;
+
+  using reference = grb::vector_ref<T, index_type>;
+  using const_reference = grb::vector_ref<std::add_const_t<T>, index_type>;
+
+  using pointer = iterator;
+  using const_pointer = const_iterator;
+
+  using scalar_reference = typename std::vector<T, allocator_type>::reference;
+
+  bitmap_vector(I shape) {
+    data_.resize(shape);
+    words_.resize(words_for(shape), 0);
+  }
+
+  bitmap_vector(I shape, const Allocator& allocator)
+      : data_(allocator), words_(allocator) {
+    data_.resize(shape);
+    words_.resize(words_for(shape), 0);
+  }
+
+  size_type shape() const noexcept {
+    return data_.size();
+  }
+
+  size_type size() const noexcept {
+    return nnz_;
+  }
+
+  bool contains(I index) const noexcept {
+    return (words_[index / 64] >> (index % 64)) & 1;
+  }
+
+  scalar_reference operator[](I index) noexcept {
+    if (!contains(index)) {
+      set(index);
+      data_[index] = T();
+    }
+    return data_[index];
+  }
+
+  iterator begin() noexcept {
+    return iterator(data_, words_.data(), 0);
+  }
+
+  const_iterator begin() const noexcept {
+    return const_iterator(data_, words_.data(), 0);
+  }
+
+  iterator end() noexcept {
+    return iterator(data_, words_.data(), shape());
+  }
+
+  const_iterator end() const noexcept {
+    return const_iterator(data_, words_.data(), shape());
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    auto&& [idx, v] = value;
+    if (contains(idx)) {
+      return {iterator(data_, words_.data(), idx), false};
+    }
+    set(idx);
+    data_[idx] = v;
+    return {iterator(data_, words_.data(), idx), true};
+  }
+
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(key_type k, M&& obj) {
+    bool inserted = !contains(k);
+    if (inserted) {
+      set(k);
+    }
+    data_[k] = std::forward<M>(obj);
+    return {iterator(data_, words_.data(), k), inserted};
+  }
+
+  iterator find(key_type key) noexcept {
+    if (contains(key)) {
+      return iterator(data_, words_.data(), key);
+    }
+    return end();
+  }
+
+  const_iterator find(key_type key) const noexcept {
+    if (contains(key)) {
+      return const_iterator(data_, words_.data(), key);
+    }
+    return end();
+  }
+
+  void reshape(I shape) {
+    if (shape < this->shape()) {
+      // Clear the bits past the new end of the last word.
+      if (shape % 64 != 0) {
+        words_[shape / 64] &= (std::uint64_t(1) << (shape % 64)) - 1;
+      }
+      words_.resize(words_for(shape));
+      nnz_ = 0;
+      for (auto&& word : words_) {
+        nnz_ += std::popcount(word);
+      }
+    } else {
+      words_.resize(words_for(shape), 0);
+    }
+    data_.resize(shape);
+  }
+
+  /// The bitset, 64 indices per word with index `i` at bit `i % 64` of word
+  /// `i / 64`.
+  std::span<const std::uint64_t> words() const noexcept {
+    return {words_.data(), words_.size()};
+  }
+
+  bitmap_vector() = default;
+
+  bitmap_vector(const Allocator& allocator)
+      : data_(allocator), words_(allocator) {}
+
+  ~bitmap_vector() = default;
+  bitmap_vector(const bitmap_vector&) = default;
+  bitmap_vector& operator=(const bitmap_vector&) = default;
+
+  bitmap_vector(bitmap_vector&& other)
+      : data_(std::move(other.data_)), words_(std::move(other.words_)),
+        nnz_(other.nnz_) {
+    other.data_.clear();
+    other.words_.clear();
+    other.nnz_ = 0;
+  }
+
+  bitmap_vector& operator=(bitmap_vector&& other) {
+    data_ = std::move(other.data_);
+    words_ = std::move(other.words_);
+    nnz_ = other.nnz_;
+    other.data_.clear();
+    other.words_.clear();
+    other.nnz_ = 0;
+    return *this;
+  }
+
+private:
+  static size_type words_for(size_type shape) noexcept {
+    return (shape + 63) / 64;
+  }
+
+  void set(I index) noexcept {
+    words_[index / 64] |= std::uint64_t(1) << (index % 64);
+    nnz_++;
+  }
+
+  std::vector<T, allocator_type> data_;
+  std::vector<std::uint64_t, word_allocator_type> words_;
+  size_type nnz_ = 0;
+};
+
+} // namespace grb
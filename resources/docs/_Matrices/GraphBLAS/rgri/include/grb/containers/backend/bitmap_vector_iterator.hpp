@@ -0,0 +1,127 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <grb/containers/vector_entry.hpp>
+#include <grb/detail/spanner.hpp>
+#include <iterator>
+#include <ranges>
+
+namespace grb {
+
+template <typename T, typename I, typename TIter, typename TConstIter>
+class bitmap_vector_iterator {
+public:
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  using scalar_type = T;
+  using index_type = I;
+
+  using key_type = I;
+  using map_type = T;
+
+  using backend_iterator =
+      std::conditional_t<!std::is_const_v<T>, TIter, TConstIter>;
+
+  using value_type = grb::vector_entry<T, index_type>;
+  using iterator = bitmap_vector_iterator;
+  using const_iterator = bitmap_vector_iterator<std::add_const_t<T>,
+                                                index_type, TIter, TConstIter>;
+
+  using scalar_reference = decltype(*std::declval<TIter>());
+  using const_scalar_reference = decltype(*std::declval<TConstIter>());
+
+  using reference = grb::vector_ref<T, I, scalar_reference>;
+  using const_reference =
+      grb::vector_ref<std::add_const_t<T>, I, const_scalar_reference>;
+
+  using pointer = iterator;
+  using const_pointer = const_iterator;
+
+  using iterator_category = std::forward_iterator_tag;
+
+  template <std::ranges::random_access_range R>
+  bitmap_vector_iterator(R&& data, const std::uint64_t* words,
+                         size_type index)
+      : data_(data), words_(words), index_(index) {
+    fast_forward();
+  }
+
+  bitmap_vector_iterator(grb::detail::spanner<backend_iterator> data,
+                         const std::uint64_t* words, size_type index)
+      : data_(data), words_(words), index_(index) {
+    fast_forward();
+  }
+
+  operator const_iterator() const noexcept
+    requires(!std::is_const_v<T>)
+  {
+    return const_iterator(
+        grb::detail::spanner<TConstIter>(data_.begin(), data_.end()), words_,
+        index_);
+  }
+
+  reference operator*() const noexcept
+    requires(!std::is_const_v<T>)
+  {
+    return reference(index_type(index_), data_[index_]);
+  }
+
+  const_reference operator*() const noexcept
+    requires(std::is_const_v<T>)
+  {
+    return const_reference(index_type(index_), data_[index_]);
+  }
+
+  // Move to the next set bit at or after `index_`, a word at a time.
+  void fast_forward() noexcept {
+    size_type shape = data_.size();
+    if (index_ >= shape) {
+      index_ = shape;
+      return;
+    }
+
+    size_type word = index_ / 64;
+    std::uint64_t bits = words_[word] & (~std::uint64_t(0) << (index_ % 64));
+    size_type words = (shape + 63) / 64;
+    while (bits == 0) {
+      if (++word == words) {
+        index_ = shape;
+        return;
+      }
+      bits = words_[word];
+    }
+    index_ = word * 64 + std::countr_zero(bits);
+  }
+
+  bitmap_vector_iterator& operator++() noexcept {
+    index_++;
+    fast_forward();
+    return *this;
+  }
+
+  bitmap_vector_iterator operator++(int) noexcept {
+    bitmap_vector_iterator other = *this;
+    ++(*this);
+    return other;
+  }
+
+  bool operator==(const bitmap_vector_iterator& other) const noexcept {
+    return index_ == other.index_;
+  }
+
+  bitmap_vector_iterator() = default;
+  ~bitmap_vector_iterator() = default;
+  bitmap_vector_iterator(const bitmap_vector_iterator&) = default;
+  bitmap_vector_iterator(bitmap_vector_iterator&&) = default;
+  bitmap_vector_iterator& operator=(const bitmap_vector_iterator&) = default;
+  bitmap_vector_iterator& operator=(bitmap_vector_iterator&&) = default;
+
+private:
+  grb::detail::spanner<backend_iterator> data_;
+  const std::uint64_t* words_ = nullptr;
+  size_type index_ = 0;
+};
+
+} // namespace grb
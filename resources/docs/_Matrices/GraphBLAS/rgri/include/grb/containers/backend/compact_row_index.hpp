@@ -0,0 +1,232 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace grb {
+
+/// Encodings of the column indices in a CSR matrix's compact row index (see
+/// `csr_matrix::build_compact_index()`).
+enum class index_compression {
+  /// 32-bit column indices.
+  narrow,
+  /// 16-bit gaps between consecutive column indices of a row, with an
+  /// escape for larger gaps.  About half the size of `narrow` when most
+  /// gaps are small, e.g. for clustered or bandwidth-reduced matrices.
+  delta
+};
+
+namespace __detail {
+
+// Row structures scanned by bandwidth-bound kernels.  Each has `rowptr`,
+// with row i's elements at positions [rowptr[i], rowptr[i + 1]) of the
+// matrix's values, and
+//
+//   for_each_in_row(i, f)
+//
+// which calls `f(j, ptr)` for every element of row i in column order, with
+// its column `j` and position `ptr`, until `f` returns false.
+
+// The matrix's own CSR arrays.
+template <std::integral I>
+struct csr_rows {
+  std::span<const I> rowptr;
+  std::span<const I> colind;
+
+  template <typename F>
+  void for_each_in_row(std::size_t i, F&& f) const {
+    for (std::size_t ptr = rowptr[i]; ptr < std::size_t(rowptr[i + 1]);
+         ptr++) {
+      if (!f(colind[ptr], ptr)) {
+        return;
+      }
+    }
+  }
+};
+
+// 32-bit column indices.  `P` is the offset type: 32-bit unless there are
+// 2^32 or more elements.
+template <std::unsigned_integral P>
+struct narrow_rows {
+  std::vector<P> rowptr;
+  std::vector<std::uint32_t> colind;
+
+  template <typename F>
+  void for_each_in_row(std::size_t i, F&& f) const {
+    for (std::size_t ptr = rowptr[i]; ptr < std::size_t(rowptr[i + 1]);
+         ptr++) {
+      if (!f(colind[ptr], ptr)) {
+        return;
+      }
+    }
+  }
+
+  std::size_t nbytes() const noexcept {
+    return rowptr.size() * sizeof(P) + colind.size() * sizeof(std::uint32_t);
+  }
+};
+
+// Delta-encoded column indices.  Row i's code starts at gaps[gapptr[i]],
+// and holds each column's gap from the previous one in the row (the first
+// column's gap is from -1, so no gap is zero).  Gaps that do not fit in 16
+// bits are written as an escape word of 0 followed by the column's high and
+// low 16 bits.
+template <std::unsigned_integral P>
+struct delta_rows {
+  std::vector<P> rowptr;
+  std::vector<P> gapptr;
+  std::vector<std::uint16_t> gaps;
+
+  template <typename F>
+  void for_each_in_row(std::size_t i, F&& f) const {
+    const std::uint16_t* code = gaps.data() + gapptr[i];
+    std::uint32_t j = std::numeric_limits<std::uint32_t>::max();
+    for (std::size_t ptr = rowptr[i]; ptr < std::size_t(rowptr[i + 1]);
+         ptr++) {
+      std::uint32_t gap = *code++;
+      if (gap != 0) [[likely]] {
+        j += gap;
+      } else {
+        j = std::uint32_t(code[0]) << 16 | code[1];
+        code += 2;
+      }
+      if (!f(j, ptr)) {
+        return;
+      }
+    }
+  }
+
+  std::size_t nbytes() const noexcept {
+    return (rowptr.size() + gapptr.size()) * sizeof(P) +
+           gaps.size() * sizeof(std::uint16_t);
+  }
+};
+
+// `std::monostate` when no index has been built.
+using compact_row_index =
+    std::variant<std::monostate, narrow_rows<std::uint32_t>,
+                 narrow_rows<std::uint64_t>, delta_rows<std::uint32_t>,
+                 delta_rows<std::uint64_t>>;
+
+inline constexpr std::size_t max_compact_columns =
+    std::size_t(std::numeric_limits<std::uint32_t>::max()) + 1;
+
+template <std::unsigned_integral P, std::integral I>
+narrow_rows<P> make_narrow_rows(std::span<const I> rowptr,
+                                std::span<const I> colind) {
+  narrow_rows<P> rows;
+  rows.rowptr.assign(rowptr.begin(), rowptr.end());
+  rows.colind.assign(colind.begin(), colind.end());
+  return rows;
+}
+
+// Encodes in two passes: the first sizes each row's code, the second
+// writes it.
+template <std::unsigned_integral P, std::integral I>
+delta_rows<P> make_delta_rows(std::span<const I> rowptr,
+                              std::span<const I> colind,
+                              std::span<const std::size_t> gapptr) {
+  constexpr std::uint32_t max_gap = std::numeric_limits<std::uint16_t>::max();
+
+  delta_rows<P> rows;
+  rows.rowptr.assign(rowptr.begin(), rowptr.end());
+  rows.gapptr.assign(gapptr.begin(), gapptr.end());
+  rows.gaps.resize(gapptr.back());
+
+  std::uint16_t* code = rows.gaps.data();
+  for (std::size_t i = 0; i + 1 < rowptr.size(); i++) {
+    std::uint32_t previous = std::numeric_limits<std::uint32_t>::max();
+    for (std::size_t ptr = rowptr[i]; ptr < std::size_t(rowptr[i + 1]);
+         ptr++) {
+      std::uint32_t j = std::uint32_t(colind[ptr]);
+      std::uint32_t gap = j - previous;
+      if (gap != 0 && gap <= max_gap) {
+        *code++ = std::uint16_t(gap);
+      } else {
+        *code++ = 0;
+        *code++ = std::uint16_t(j >> 16);
+        *code++ = std::uint16_t(j);
+      }
+      previous = j;
+    }
+  }
+  return rows;
+}
+
+// Compact copy of the row structure of an `n`-column CSR matrix, or an
+// empty index if it would not be smaller: more than 2^32 columns, or
+// `narrow` requested for indices that already have 32 bits or fewer.
+template <std::integral I>
+compact_row_index make_compact_row_index(std::span<const I> rowptr,
+                                         std::span<const I> colind,
+                                         std::size_t n,
+                                         index_compression compression) {
+  constexpr std::size_t max_offset = std::numeric_limits<std::uint32_t>::max();
+
+  if (n > max_compact_columns) {
+    return {};
+  }
+
+  if (compression == index_compression::narrow) {
+    if constexpr (sizeof(I) <= sizeof(std::uint32_t)) {
+      return {};
+    } else if (colind.size() <= max_offset) {
+      return make_narrow_rows<std::uint32_t>(rowptr, colind);
+    } else {
+      return make_narrow_rows<std::uint64_t>(rowptr, colind);
+    }
+  }
+
+  constexpr std::uint32_t max_gap = std::numeric_limits<std::uint16_t>::max();
+  std::size_t m = rowptr.size() - 1;
+  std::vector<std::size_t> gapptr(m + 1, 0);
+  for (std::size_t i = 0; i < m; i++) {
+    std::size_t words = 0;
+    std::uint32_t previous = std::numeric_limits<std::uint32_t>::max();
+    for (std::size_t ptr = rowptr[i]; ptr < std::size_t(rowptr[i + 1]);
+         ptr++) {
+      std::uint32_t j = std::uint32_t(colind[ptr]);
+      std::uint32_t gap = j - previous;
+      words += gap != 0 && gap <= max_gap ? 1 : 3;
+      previous = j;
+    }
+    gapptr[i + 1] = gapptr[i] + words;
+  }
+
+  if (gapptr[m] <= max_offset) {
+    return make_delta_rows<std::uint32_t>(rowptr, colind, gapptr);
+  } else {
+    return make_delta_rows<std::uint64_t>(rowptr, colind, gapptr);
+  }
+}
+
+// Call `f(rows)` with `compact`'s row structure if it holds one, and
+// otherwise with the CSR arrays `rowptr` and `colind`.
+template <std::integral I, typename F>
+decltype(auto) visit_rows(const compact_row_index* compact,
+                          std::span<const I> rowptr, std::span<const I> colind,
+                          F&& f) {
+  if (compact == nullptr) {
+    return f(csr_rows<I>{rowptr, colind});
+  }
+  return std::visit(
+      [&](auto&& rows) -> decltype(auto) {
+        if constexpr (std::is_same_v<std::remove_cvref_t<decltype(rows)>,
+                                     std::monostate>) {
+          return f(csr_rows<I>{rowptr, colind});
+        } else {
+          return f(rows);
+        }
+      },
+      *compact);
+}
+
+} // namespace __detail
+
+} // namespace grb
@@ -1,7 +1,12 @@
 
 #pragma once
 
+#include <algorithm>
+#include <bit>
 #include <climits>
+#include <cstdint>
+#include <deque>
+#include <grb/containers/backend/compact_row_index.hpp>
 #include <grb/containers/backend/coo_matrix.hpp>
 #include <grb/containers/backend/csr_matrix_iterator.hpp>
 #include <grb/containers/matrix_entry.hpp>
@@ -9,6 +14,9 @@
 #include <grb/util/index.hpp>
 #include <grb/util/matrix_io.hpp>
 #include <limits>
+#include <numeric>
+#include <span>
+#include <unordered_map>
 #include <vector>
 
 namespace grb {
@@ -54,19 +62,26 @@ public:
   using pointer = iterator;
   using const_pointer = const_iterator;
 
-  iterator begin() noexcept {
+  using index_vector_type = vector_type<index_type, index_allocator_type>;
+  using values_vector_type = vector_type<T, allocator_type>;
+
+  iterator begin() {
+    wait();
     return iterator(0, 0, values_, rowptr_, colind_);
   }
 
-  const_iterator begin() const noexcept {
+  const_iterator begin() const {
+    wait();
     return const_iterator(0, 0, values_, rowptr_, colind_);
   }
 
-  iterator end() noexcept {
+  iterator end() {
+    wait();
     return iterator(shape()[0], size(), values_, rowptr_, colind_);
   }
 
-  const_iterator end() const noexcept {
+  const_iterator end() const {
+    wait();
     return const_iterator(shape()[0], size(), values_, rowptr_, colind_);
   }
 
@@ -74,22 +89,156 @@ public:
     return {m_, n_};
   }
 
+  /// Number of stored elements, including pending ones.
   size_type size() const noexcept {
-    return nnz_;
+    return nnz_ + pending_keys_.size();
   }
 
+  /// Insert the elements in [first, last) whose index is not stored yet.
+  /// They are appended to the pending buffer and merged on the next read.
   template <typename InputIt>
   void insert(InputIt first, InputIt last);
 
+  /// Insert `value` if its index is not stored yet.  Returning an iterator
+  /// requires merging pending elements, so building a matrix through
+  /// repeated calls costs O(nnz) each; prefer operator[] or the range
+  /// insert().
   std::pair<iterator, bool> insert(const value_type& value);
 
   template <class M>
   std::pair<iterator, bool> insert_or_assign(key_type k, M&& obj);
 
-  iterator find(key_type key) noexcept;
-  const_iterator find(key_type key) const noexcept;
+  /// Reference to the element at `key`, inserting a value-initialized
+  /// element first if there is none.  New elements are only appended to the
+  /// pending buffer, so this is O(log n) and does not invalidate iterators.
+  scalar_reference operator[](key_type key);
+
+  /// Merge pending elements into the CSR arrays with one sort of the
+  /// pending elements and a linear merge, O(nnz + p log p).  Every read
+  /// (iteration, find(), the CSR accessors) calls this first, so a matrix
+  /// with pending elements must not be read from several threads at once.
+  /// Parallel kernels gather their input on the calling thread.
+  void wait() const;
+
+  /// Number of inserted elements not yet merged into the CSR arrays.
+  size_type pending_size() const noexcept {
+    return pending_keys_.size();
+  }
+
+  /// Find the element at `key`.  Rows are searched with a branchless
+  /// binary search over their sorted column indices, or through the hash
+  /// index if one has been built for the row.
+  iterator find(key_type key);
+  const_iterator find(key_type key) const;
+
+  /// Build an open-addressing hash index for every row with at least
+  /// `min_row_size` elements, making find() O(1) in those rows.  Worth it for
+  /// matrices with a few very long rows (power-law graphs) that are searched
+  /// many times, e.g. as masks.  The index is dropped whenever the sparsity
+  /// pattern changes.
+  void build_hash_index(size_type min_row_size = default_hash_row_size);
+
+  void clear_hash_index() noexcept {
+    hash_offsets_.clear();
+    hash_slots_.clear();
+  }
+
+  bool has_hash_index() const noexcept {
+    return !hash_offsets_.empty();
+  }
+
+  static constexpr size_type default_hash_row_size = 256;
+
+  /// Column-major index of the sparsity pattern: the elements of column j
+  /// are at positions [colptr[j], colptr[j + 1]) of `rowind` (their row
+  /// indices, sorted) and `position` (their offsets into `values()`).
+  struct column_index_type {
+    std::span<const index_type> colptr;
+    std::span<const index_type> rowind;
+    std::span<const size_type> position;
+  };
+
+  /// The column index, built on first use with a counting sort, O(nnz + n).
+  /// It stores positions rather than values, so it stays valid when values
+  /// are written and is only dropped when the sparsity pattern changes.
+  /// Like wait(), this mutates a const matrix and must not race with other
+  /// reads.
+  column_index_type column_index() const;
+
+  void clear_column_index() noexcept {
+    colptr_.clear();
+    rowind_.clear();
+    colpos_.clear();
+  }
+
+  bool has_column_index() const noexcept {
+    return !colptr_.empty();
+  }
+
+  using compact_index_type = __detail::compact_row_index;
+
+  /// Build a compact copy of the row structure, which matrix-vector
+  /// multiplication reads in place of `rowptr()` and `colind()`.  Column
+  /// indices are stored in 32 bits (`narrow`) or as 16-bit gaps (`delta`),
+  /// and row offsets in 32 bits unless there are 2^32 or more elements, so
+  /// a bandwidth-bound SpMV moves fewer bytes per element than with 64-bit
+  /// `index_type`.  No index is built if it would not be smaller: with more
+  /// than 2^32 columns, or `narrow` for 32-bit `index_type`.  The index is
+  /// dropped whenever the sparsity pattern changes.
+  void build_compact_index(
+      grb::index_compression compression = grb::index_compression::narrow);
+
+  void clear_compact_index() noexcept {
+    compact_ = std::monostate{};
+  }
+
+  bool has_compact_index() const noexcept {
+    return compact_.index() != 0;
+  }
+
+  /// The compact index, holding `std::monostate` if none has been built.
+  const compact_index_type& compact_index() const {
+    wait();
+    return compact_;
+  }
+
+  /// Row offsets (`shape()[0] + 1` of them) into `colind()` and `values()`.
+  /// Column indices are sorted within each row.
+  std::span<const index_type> rowptr() const {
+    wait();
+    return {rowptr_.data(), rowptr_.size()};
+  }
+
+  std::span<const index_type> colind() const {
+    wait();
+    return {colind_.data(), nnz_};
+  }
+
+  std::span<const T> values() const {
+    wait();
+    return {values_.data(), nnz_};
+  }
+
+  /// Replace the contents of the matrix with already-assembled CSR arrays.
+  /// `rowptr` must hold `shape()[0] + 1` offsets and each row's column
+  /// indices must be sorted and unique.
+  void assign_csr(index_vector_type rowptr, index_vector_type colind,
+                  values_vector_type values) {
+    clear_hash_index();
+    clear_column_index();
+    clear_compact_index();
+    clear_pending();
+    nnz_ = colind.size();
+    rowptr_ = std::move(rowptr);
+    colind_ = std::move(colind);
+    values_ = std::move(values);
+  }
 
   void reshape(grb::index<I> shape) {
+    wait();
+    clear_hash_index();
+    clear_column_index();
+    clear_compact_index();
     bool all_inside = true;
     for (auto&& [index, v] : *this) {
       auto&& [i, j] = index;
@@ -129,7 +278,8 @@ public:
   csr_matrix(const csr_matrix&) = default;
   csr_matrix& operator=(const csr_matrix&) = default;
 
-  std::size_t nbytes() const noexcept {
+  std::size_t nbytes() const {
+    wait();
     std::size_t size_bytes = 0;
     size_bytes += rowptr_.size() * sizeof(index_type);
     size_bytes += colind_.size() * sizeof(index_type);
@@ -144,7 +294,14 @@ public:
   csr_matrix(csr_matrix&& other)
       : rowptr_(std::move(other.rowptr_)), colind_(std::move(other.colind_)),
         values_(std::move(other.values_)), m_(other.m_), n_(other.n_),
-        nnz_(other.nnz_) {
+        nnz_(other.nnz_), hash_offsets_(std::move(other.hash_offsets_)),
+        hash_slots_(std::move(other.hash_slots_)),
+        colptr_(std::move(other.colptr_)), rowind_(std::move(other.rowind_)),
+        colpos_(std::move(other.colpos_)), compact_(std::move(other.compact_)),
+        pending_keys_(std::move(other.pending_keys_)),
+        pending_values_(std::move(other.pending_values_)),
+        pending_index_(std::move(other.pending_index_)) {
+    other.clear_pending();
     other.m_ = 0;
     other.n_ = 0;
     other.nnz_ = 0;
@@ -162,6 +319,16 @@ public:
     other.n_ = 0;
     nnz_ = other.nnz_;
     other.nnz_ = 0;
+    hash_offsets_ = std::move(other.hash_offsets_);
+    hash_slots_ = std::move(other.hash_slots_);
+    colptr_ = std::move(other.colptr_);
+    rowind_ = std::move(other.rowind_);
+    colpos_ = std::move(other.colpos_);
+    compact_ = std::move(other.compact_);
+    pending_keys_ = std::move(other.pending_keys_);
+    pending_values_ = std::move(other.pending_values_);
+    pending_index_ = std::move(other.pending_index_);
+    other.clear_pending();
     return *this;
   }
 
@@ -169,18 +336,77 @@ private:
   template <typename InputIt>
   void assign_tuples(InputIt first, InputIt last);
 
+  static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+  // Position of `key` in `colind_` / `values_`, or `npos`.  Only searches
+  // the CSR arrays, not the pending buffer.
+  size_type find_position(key_type key) const noexcept;
+
+  // The value stored or pending at `key`, or nullptr.
+  T* locate(key_type key) noexcept;
+
+  // Append a pending element at `key`, which must not be stored or pending.
+  template <typename U>
+  scalar_reference stage(key_type key, U&& value);
+
+  void clear_pending() noexcept {
+    pending_keys_.clear();
+    pending_values_.clear();
+    pending_index_.clear();
+  }
+
+  struct key_hash {
+    std::size_t operator()(key_type key) const noexcept {
+      return std::hash<std::uint64_t>{}(std::uint64_t(key[0]) *
+                                            0x9E3779B97F4A7C15ull ^
+                                        std::uint64_t(key[1]));
+    }
+  };
+
+  // Slot of column `j` in a row table of `capacity` (a power of two, at
+  // least 2) slots.  Fibonacci hashing: the top bits of the product are well
+  // mixed.
+  static size_type hash_slot(index_type j, size_type capacity) noexcept {
+    std::uint64_t h = std::uint64_t(j) * 0x9E3779B97F4A7C15ull;
+    return size_type(h >> (64 - std::countr_zero(capacity)));
+  }
+
+  // The CSR arrays and the indices are `mutable` because const reads merge
+  // pending elements into them first (see wait()).
   index_type m_ = 0;
   index_type n_ = 0;
-  size_type nnz_ = 0;
+  mutable size_type nnz_ = 0;
 
   Allocator allocator_;
 
-  vector_type<index_type, index_allocator_type> rowptr_ =
+  mutable vector_type<index_type, index_allocator_type> rowptr_ =
       vector_type<index_type, index_allocator_type>({0}, allocator_);
-  vector_type<index_type, index_allocator_type> colind_ =
+  mutable vector_type<index_type, index_allocator_type> colind_ =
       vector_type<index_type, index_allocator_type>(allocator_);
-  vector_type<T, allocator_type> values_ =
+  mutable vector_type<T, allocator_type> values_ =
       vector_type<T, allocator_type>(allocator_);
+
+  // Optional hash index (see build_hash_index()).  Row i owns the
+  // power-of-two slot range [hash_offsets_[i], hash_offsets_[i + 1]), empty
+  // for rows without an index; slots hold positions into `colind_`, or
+  // `npos`.  Both are empty when there is no index.
+  mutable std::vector<size_type> hash_offsets_;
+  mutable std::vector<size_type> hash_slots_;
+
+  // Optional column index (see column_index()).  All empty when not built.
+  mutable std::vector<index_type> colptr_;
+  mutable std::vector<index_type> rowind_;
+  mutable std::vector<size_type> colpos_;
+
+  // Optional compact row index (see build_compact_index()).
+  mutable compact_index_type compact_;
+
+  // Pending elements, in insertion order, whose indices are neither stored
+  // in the CSR arrays nor repeated.  Values live in a deque so references
+  // returned by operator[] stay valid as more elements are appended.
+  mutable std::vector<key_type> pending_keys_;
+  mutable std::deque<T> pending_values_;
+  mutable std::unordered_map<key_type, size_type, key_hash> pending_index_;
 };
 
 template <typename T, std::integral I, typename Allocator>
@@ -216,6 +442,9 @@ csr_matrix<T, I, Allocator>::csr_matrix(index<I> shape)
 template <typename T, std::integral I, typename Allocator>
 template <typename InputIt>
 void csr_matrix<T, I, Allocator>::assign_tuples(InputIt first, InputIt last) {
+  clear_hash_index();
+  clear_column_index();
+  clear_compact_index();
   nnz_ = last - first;
   rowptr_.resize(shape()[0] + 1);
   colind_.resize(nnz_);
@@ -253,73 +482,248 @@ void csr_matrix<T, I, Allocator>::assign_tuples(InputIt first, InputIt last) {
   }
 }
 
-// Currently assumes NO DUPLICATES in range first -> last
+// Elements whose index is already stored or pending are skipped, so the
+// first of several duplicates in [first, last) wins.
 template <typename T, std::integral I, typename Allocator>
 template <typename InputIt>
 void csr_matrix<T, I, Allocator>::insert(InputIt first, InputIt last) {
-  // a < b
-  auto sort_fn = [](const auto& a, const auto& b) {
-    auto&& [a_index, a_value] = a;
-    auto&& [b_index, b_value] = b;
-    auto&& [a_i, a_j] = a_index;
-    auto&& [b_i, b_j] = b_index;
-    if (a_i < b_i) {
-      return true;
-    } else if (a_i == b_i) {
-      if (a_j < b_j) {
-        return true;
-      }
+  for (auto iter = first; iter != last; ++iter) {
+    auto&& [index, value] = *iter;
+    auto&& [i, j] = index;
+    key_type key(i, j);
+    if (locate(key) == nullptr) {
+      stage(key, value);
     }
-    return false;
-  };
-
-  using tuple_type = value_type;
-  vector_type<tuple_type> my_sorted_indices(begin(), end());
+  }
+}
 
-  vector_type<tuple_type> sorted_indices_toadd(first, last);
-  std::ranges::sort(my_sorted_indices, sort_fn);
-  std::ranges::sort(sorted_indices_toadd, sort_fn);
+template <typename T, std::integral I, typename Allocator>
+T* csr_matrix<T, I, Allocator>::locate(key_type key) noexcept {
+  size_type ptr = find_position(key);
+  if (ptr != npos) {
+    return &values_[ptr];
+  }
 
-  vector_type<tuple_type> output_indices(my_sorted_indices.size() +
-                                         sorted_indices_toadd.size());
+  if (!pending_index_.empty()) {
+    auto iter = pending_index_.find(key);
+    if (iter != pending_index_.end()) {
+      return &pending_values_[iter->second];
+    }
+  }
+  return nullptr;
+}
 
-  auto new_last =
-      std::set_union(my_sorted_indices.begin(), my_sorted_indices.end(),
-                     sorted_indices_toadd.begin(), sorted_indices_toadd.end(),
-                     output_indices.begin(), sort_fn);
-  /*
-    vector_type<std::tuple<index_type, index_type, value_type>>
-    merged_tuples(nnz() + (last - first)); std::set_union(begin(), end(), first,
-    last, merged_tuples.begin(), sort_fn);
-    */
+template <typename T, std::integral I, typename Allocator>
+template <typename U>
+typename csr_matrix<T, I, Allocator>::scalar_reference
+csr_matrix<T, I, Allocator>::stage(key_type key, U&& value) {
+  pending_index_.emplace(key, pending_keys_.size());
+  pending_keys_.push_back(key);
+  return pending_values_.emplace_back(std::forward<U>(value));
+}
 
-  assign_tuples(output_indices.begin(), new_last);
+template <typename T, std::integral I, typename Allocator>
+typename csr_matrix<T, I, Allocator>::scalar_reference
+csr_matrix<T, I, Allocator>::operator[](key_type key) {
+  T* value = locate(key);
+  if (value != nullptr) {
+    return *value;
+  }
+  return stage(key, T());
 }
 
-// NOTE: if sorted, you could exit this for loop early
 template <typename T, std::integral I, typename Allocator>
+void csr_matrix<T, I, Allocator>::wait() const {
+  size_type p = pending_keys_.size();
+  if (p == 0) {
+    return;
+  }
 
-typename csr_matrix<T, I, Allocator>::iterator
-csr_matrix<T, I, Allocator>::find(key_type key) noexcept {
+  std::vector<size_type> order(p);
+  std::iota(order.begin(), order.end(), size_type(0));
+  std::sort(order.begin(), order.end(), [&](size_type a, size_type b) {
+    auto&& x = pending_keys_[a];
+    auto&& y = pending_keys_[b];
+    return x[0] < y[0] || (x[0] == y[0] && x[1] < y[1]);
+  });
+
+  size_type nnz = nnz_ + p;
+  vector_type<index_type, index_allocator_type> rowptr(m_ + 1, allocator_);
+  vector_type<index_type, index_allocator_type> colind(nnz, allocator_);
+  vector_type<T, allocator_type> values(nnz, allocator_);
+
+  // Pending indices never collide with stored ones, so each row is a plain
+  // two-way merge.
+  size_type out = 0;
+  size_type k = 0;
+  rowptr[0] = 0;
+  for (size_type i = 0; i < size_type(m_); i++) {
+    size_type ptr = rowptr_[i];
+    size_type row_end = rowptr_[i + 1];
+    for (;;) {
+      bool pending_in_row = k < p && size_type(pending_keys_[order[k]][0]) == i;
+      if (pending_in_row &&
+          (ptr == row_end || pending_keys_[order[k]][1] < colind_[ptr])) {
+        colind[out] = pending_keys_[order[k]][1];
+        values[out] = std::move(pending_values_[order[k]]);
+        k++;
+      } else if (ptr < row_end) {
+        colind[out] = colind_[ptr];
+        values[out] = std::move(values_[ptr]);
+        ptr++;
+      } else {
+        break;
+      }
+      out++;
+    }
+    rowptr[i + 1] = out;
+  }
+
+  rowptr_ = std::move(rowptr);
+  colind_ = std::move(colind);
+  values_ = std::move(values);
+  nnz_ = nnz;
+
+  hash_offsets_.clear();
+  hash_slots_.clear();
+  colptr_.clear();
+  rowind_.clear();
+  colpos_.clear();
+  compact_ = std::monostate{};
+  pending_keys_.clear();
+  pending_values_.clear();
+  pending_index_.clear();
+}
+
+template <typename T, std::integral I, typename Allocator>
+typename csr_matrix<T, I, Allocator>::size_type
+csr_matrix<T, I, Allocator>::find_position(key_type key) const noexcept {
   index_type i = key[0];
-  for (index_type j_ptr = rowptr_[i]; j_ptr < rowptr_[i + 1]; j_ptr++) {
-    if (colind_[j_ptr] == key[1]) {
-      return iterator(i, j_ptr, values_, rowptr_, colind_);
+  index_type j = key[1];
+  size_type first = rowptr_[i];
+  size_type n = rowptr_[i + 1] - first;
+
+  if (n == 0) {
+    return npos;
+  }
+
+  if (!hash_offsets_.empty()) {
+    size_type slots = hash_offsets_[i];
+    size_type capacity = hash_offsets_[i + 1] - slots;
+    if (capacity > 0) {
+      for (size_type slot = hash_slot(j, capacity);;
+           slot = (slot + 1) & (capacity - 1)) {
+        size_type ptr = hash_slots_[slots + slot];
+        if (ptr == npos || colind_[ptr] == j) {
+          return ptr;
+        }
+      }
     }
   }
-  return end();
+
+  // Branchless lower bound: the loop runs exactly log2(n) times and the
+  // comparison compiles to a conditional move, so there are no
+  // mispredictions on random lookups.
+  const index_type* base = colind_.data() + first;
+  while (n > 1) {
+    size_type half = n / 2;
+    base = (base[half] <= j) ? base + half : base;
+    n -= half;
+  }
+
+  if (*base == j) {
+    return base - colind_.data();
+  }
+  return npos;
+}
+
+template <typename T, std::integral I, typename Allocator>
+typename csr_matrix<T, I, Allocator>::iterator
+csr_matrix<T, I, Allocator>::find(key_type key) {
+  wait();
+  size_type ptr = find_position(key);
+  if (ptr == npos) {
+    return end();
+  }
+  return iterator(key[0], ptr, values_, rowptr_, colind_);
 }
 
 template <typename T, std::integral I, typename Allocator>
 typename csr_matrix<T, I, Allocator>::const_iterator
-csr_matrix<T, I, Allocator>::find(key_type key) const noexcept {
-  index_type i = key[0];
-  for (index_type j_ptr = rowptr_[i]; j_ptr < rowptr_[i + 1]; j_ptr++) {
-    if (colind_[j_ptr] == key[1]) {
-      return const_iterator(i, j_ptr, values_, rowptr_, colind_);
+csr_matrix<T, I, Allocator>::find(key_type key) const {
+  wait();
+  size_type ptr = find_position(key);
+  if (ptr == npos) {
+    return end();
+  }
+  return const_iterator(key[0], ptr, values_, rowptr_, colind_);
+}
+
+template <typename T, std::integral I, typename Allocator>
+void csr_matrix<T, I, Allocator>::build_hash_index(size_type min_row_size) {
+  wait();
+  min_row_size = std::max<size_type>(min_row_size, 1);
+
+  hash_offsets_.assign(m_ + 1, 0);
+  for (size_type i = 0; i < m_; i++) {
+    size_type row_size = rowptr_[i + 1] - rowptr_[i];
+    size_type capacity = row_size >= min_row_size ? std::bit_ceil(2 * row_size)
+                                                  : 0;
+    hash_offsets_[i + 1] = hash_offsets_[i] + capacity;
+  }
+
+  hash_slots_.assign(hash_offsets_[m_], npos);
+  for (size_type i = 0; i < m_; i++) {
+    size_type slots = hash_offsets_[i];
+    size_type capacity = hash_offsets_[i + 1] - slots;
+    if (capacity == 0) {
+      continue;
+    }
+    for (size_type ptr = rowptr_[i]; ptr < size_type(rowptr_[i + 1]); ptr++) {
+      size_type slot = hash_slot(colind_[ptr], capacity);
+      while (hash_slots_[slots + slot] != npos) {
+        slot = (slot + 1) & (capacity - 1);
+      }
+      hash_slots_[slots + slot] = ptr;
+    }
+  }
+}
+
+template <typename T, std::integral I, typename Allocator>
+typename csr_matrix<T, I, Allocator>::column_index_type
+csr_matrix<T, I, Allocator>::column_index() const {
+  wait();
+  if (colptr_.empty()) {
+    colptr_.assign(size_type(n_) + 1, 0);
+    for (size_type ptr = 0; ptr < nnz_; ptr++) {
+      ++colptr_[colind_[ptr] + 1];
+    }
+    for (size_type j = 0; j < size_type(n_); j++) {
+      colptr_[j + 1] += colptr_[j];
+    }
+
+    // Rows are visited in order, so each column comes out sorted by row.
+    rowind_.resize(nnz_);
+    colpos_.resize(nnz_);
+    std::vector<index_type> fill(colptr_.begin(), colptr_.end() - 1);
+    for (size_type i = 0; i < size_type(m_); i++) {
+      for (size_type ptr = rowptr_[i]; ptr < size_type(rowptr_[i + 1]);
+           ptr++) {
+        index_type out = fill[colind_[ptr]]++;
+        rowind_[out] = i;
+        colpos_[out] = ptr;
+      }
     }
   }
-  return end();
+  return {colptr_, rowind_, colpos_};
+}
+
+template <typename T, std::integral I, typename Allocator>
+void csr_matrix<T, I, Allocator>::build_compact_index(
+    grb::index_compression compression) {
+  wait();
+  compact_ = __detail::make_compact_row_index(rowptr(), colind(), n_,
+                                              compression);
 }
 
 template <typename T, std::integral I, typename Allocator>
@@ -327,14 +731,11 @@ std::pair<typename csr_matrix<T, I, Allocator>::iterator, bool>
 csr_matrix<T, I, Allocator>::insert(
     const typename csr_matrix<T, I, Allocator>::value_type& value) {
   auto&& [idx, v] = value;
-  auto iter = find(idx);
-  if (iter != end()) {
-    return {iter, false};
-  } else {
-    insert(&value, &value + 1);
-    auto iter = find(idx);
-    return {iter, true};
+  bool inserted = locate(idx) == nullptr;
+  if (inserted) {
+    stage(idx, v);
   }
+  return {find(idx), inserted};
 }
 
 template <typename T, std::integral I, typename Allocator>
@@ -342,16 +743,14 @@ template <class M>
 std::pair<typename csr_matrix<T, I, Allocator>::iterator, bool>
 csr_matrix<T, I, Allocator>::insert_or_assign(
     csr_matrix<T, I, Allocator>::key_type k, M&& obj) {
-  auto iter = find(k);
-
-  if (iter != end()) {
-    auto&& [index, value] = *iter;
-    value = std::forward<M>(obj);
-    return {iter, false};
+  T* value = locate(k);
+  bool inserted = value == nullptr;
+  if (inserted) {
+    stage(k, std::forward<M>(obj));
   } else {
-    auto&& [iter, flag] = insert({k, std::forward<M>(obj)});
-    return {iter, true};
+    *value = std::forward<M>(obj);
   }
+  return {find(k), inserted};
 }
 
 } // namespace grb
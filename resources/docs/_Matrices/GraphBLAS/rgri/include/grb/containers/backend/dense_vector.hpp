@@ -3,6 +3,8 @@
 #include <grb/containers/backend/dense_vector_iterator.hpp>
 #include <grb/containers/vector_entry.hpp>
 #include <numeric>
+#include <span>
+#include <type_traits>
 #include <vector>
 
 namespace grb {
@@ -137,6 +139,13 @@ public:
     }
   }
 
+  /// All `shape()` slots, including those of absent elements.
+  std::span<const T> data() const noexcept
+    requires(!std::is_same_v<T, bool>)
+  {
+    return {data_.data(), data_.size()};
+  }
+
   dense_vector() = default;
 
   dense_vector(const Allocator& allocator)
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <algorithm>
 #include <climits>
+#include <cstddef>
 #include <grb/containers/backend/dia_matrix_iterator.hpp>
 #include <grb/containers/matrix_entry.hpp>
 #include <grb/util/index.hpp>
@@ -11,6 +13,25 @@
 
 namespace grb {
 
+/// One stored diagonal of a `dia_matrix`.  `values[k]` and `present[k]` hold
+/// its k-th element from the top-left end; absent elements hold `T{}`.
+/// `size` is the number of present elements, so a full diagonal is a plain
+/// contiguous array.
+template <typename T, typename Allocator = std::allocator<T>>
+struct dia_diagonal {
+  std::vector<T, Allocator> values;
+  std::vector<bool> present;
+  std::size_t size = 0;
+
+  bool full() const noexcept {
+    return size == values.size();
+  }
+};
+
+/// Matrix backend storing each diagonal that holds an element as a
+/// contiguous array, for banded matrices.  Diagonal number `j - i + m - 1`
+/// holds the elements (i, j); diagonals are kept in increasing order, so the
+/// elements of a row come in increasing column order across diagonals.
 template <typename T, std::integral I = std::size_t,
           typename Allocator = std::allocator<T>>
 class dia_matrix {
@@ -29,18 +50,30 @@ public:
   using index_allocator_type = typename std::allocator_traits<
       allocator_type>::template rebind_alloc<index_type>;
 
-  using iterator = dia_matrix_iterator<T, index_type>;
+  using diagonal_type = dia_diagonal<T, Allocator>;
+  using diagonal_map_type = std::map<index_type, diagonal_type>;
 
-  using const_iterator = dia_matrix_iterator<std::add_const_t<T>, index_type>;
+  using iterator =
+      dia_matrix_iterator<T, index_type, typename diagonal_map_type::iterator,
+                          typename diagonal_map_type::const_iterator>;
+
+  using const_iterator = dia_matrix_iterator<
+      std::add_const_t<T>, index_type, typename diagonal_map_type::iterator,
+      typename diagonal_map_type::const_iterator>;
 
   using reference = grb::matrix_ref<T, index_type>;
   using const_reference = grb::matrix_ref<std::add_const_t<T>, index_type>;
 
+  using scalar_reference = T&;
+
   using pointer = iterator;
   using const_pointer = const_iterator;
 
   dia_matrix(grb::index<I> shape) : m_(shape[0]), n_(shape[1]) {}
 
+  dia_matrix(grb::index<I> shape, const Allocator& allocator)
+      : m_(shape[0]), n_(shape[1]), allocator_(allocator) {}
+
   grb::index<I> shape() const noexcept {
     return {m_, n_};
   }
@@ -50,6 +83,7 @@ public:
   }
 
   dia_matrix() = default;
+  dia_matrix(const Allocator& allocator) : allocator_(allocator) {}
   ~dia_matrix() = default;
   dia_matrix(const dia_matrix&) = default;
   dia_matrix(dia_matrix&&) = default;
@@ -66,99 +100,156 @@ public:
   std::pair<iterator, bool> insert(const value_type& value) {
     auto&& [index, v] = value;
     auto&& [i, j] = index;
-    index_type diagonal =
-        (difference_type(j) - difference_type(i)) + shape()[0] - 1;
+    auto iter = get_diagonal(i, j);
     index_type idx = std::min(i, j);
-    // index_type count = std::min(m_, n_) - std::abs(difference_type(i) -
-    // difference_type(j));
-    index_type count = std::min(m_ - i, n_ - j) + idx;
-
-    auto iter = diagonals_.find(diagonal);
-    if (iter == diagonals_.end()) {
-      auto [it, _] = diagonals_.insert(
-          {diagonal, {std::vector<T>(count), std::vector<bool>(count, false)}});
-      iter = it;
-    }
-
-    auto&& [vec, bvec] = iter->second;
 
-    if (!bvec[idx]) {
-      vec[idx] = v;
-      bvec[idx] = true;
+    auto&& diagonal = iter->second;
+    if (!diagonal.present[idx]) {
+      diagonal.values[idx] = v;
+      diagonal.present[idx] = true;
+      diagonal.size++;
       nnz_++;
-      return {iterator(idx, m_, n_, iter, diagonals_.end()), true};
+      return {iterator(idx, m_, iter, diagonals_.end()), true};
     } else {
-      return {iterator(idx, m_, n_, iter, diagonals_.end()), false};
+      return {iterator(idx, m_, iter, diagonals_.end()), false};
     }
   }
 
   template <typename M>
   std::pair<iterator, bool> insert_or_assign(key_type k, M&& obj) {
     auto&& [i, j] = k;
-    index_type diagonal =
-        (difference_type(j) - difference_type(i)) + shape()[0] - 1;
+    auto iter = get_diagonal(i, j);
     index_type idx = std::min(i, j);
-    // index_type count = std::min(m_, n_) - std::abs(difference_type(i) -
-    // difference_type(j));
-    index_type count = std::min(m_ - i, n_ - j) + idx;
 
-    auto iter = diagonals_.find(diagonal);
-    if (iter == diagonals_.end()) {
-      auto [it, b] = diagonals_.insert(
-          {diagonal,
-           {std::vector<T>(count, false), std::vector<bool>(count, false)}});
-      iter = it;
-    }
+    auto&& diagonal = iter->second;
+    diagonal.values[idx] = std::forward<M>(obj);
 
-    auto&& [vec, bvec] = iter->second;
-    vec[idx] = std::forward<M>(obj);
-
-    if (!bvec[idx]) {
-      bvec[idx] = true;
+    if (!diagonal.present[idx]) {
+      diagonal.present[idx] = true;
+      diagonal.size++;
       nnz_++;
-      return {iterator(idx, m_, n_, iter, diagonals_.end()), true};
+      return {iterator(idx, m_, iter, diagonals_.end()), true};
     } else {
-      return {iterator(idx, m_, n_, iter, diagonals_.end()), false};
+      return {iterator(idx, m_, iter, diagonals_.end()), false};
+    }
+  }
+
+  iterator find(key_type key) noexcept {
+    auto&& [i, j] = key;
+    auto iter = diagonals_.find(diagonal_number(i, j));
+    index_type idx = std::min(i, j);
+    if (iter == diagonals_.end() || !iter->second.present[idx]) {
+      return end();
+    }
+    return iterator(idx, m_, iter, diagonals_.end());
+  }
+
+  const_iterator find(key_type key) const noexcept {
+    auto&& [i, j] = key;
+    auto iter = diagonals_.find(diagonal_number(i, j));
+    index_type idx = std::min(i, j);
+    if (iter == diagonals_.end() || !iter->second.present[idx]) {
+      return end();
+    }
+    return const_iterator(idx, m_, iter, diagonals_.end());
+  }
+
+  /// Reshape to `shape[0]` x `shape[1]`, deleting any elements outside it.
+  /// Diagonals are numbered from the bottom-left corner, so all are rebuilt.
+  void reshape(grb::index<I> shape) {
+    dia_matrix other(shape, allocator_);
+    for (auto&& [index, value] : *this) {
+      auto&& [i, j] = index;
+      if (i < shape[0] && j < shape[1]) {
+        other.insert({index, value});
+      }
     }
+    *this = std::move(other);
   }
 
   iterator begin() noexcept {
-    return iterator(0, m_, n_, diagonals_.begin(), diagonals_.end());
+    return iterator(0, m_, diagonals_.begin(), diagonals_.end());
   }
 
   const_iterator begin() const noexcept {
-    return const_iterator(0, m_, n_, diagonals_.begin(), diagonals_.end());
+    return const_iterator(0, m_, diagonals_.begin(), diagonals_.end());
   }
 
   iterator end() noexcept {
-    return iterator(0, m_, n_, diagonals_.end(), diagonals_.end());
+    return iterator(0, m_, diagonals_.end(), diagonals_.end());
   }
 
   const_iterator end() const noexcept {
-    return const_iterator(0, m_, n_, diagonals_.end(), diagonals_.end());
+    return const_iterator(0, m_, diagonals_.end(), diagonals_.end());
+  }
+
+  /// The stored diagonals, by diagonal number.
+  const diagonal_map_type& diagonals() const noexcept {
+    return diagonals_;
+  }
+
+  /// Offset `j - i` of the elements on diagonal number `diagonal`.
+  difference_type diagonal_offset(index_type diagonal) const noexcept {
+    return difference_type(diagonal) - (difference_type(m_) - 1);
+  }
+
+  /// Replace the diagonal with offset `j - i` by `diagonal`, whose arrays
+  /// must be as long as the diagonal.
+  void assign_diagonal(difference_type offset, diagonal_type diagonal) {
+    index_type number = index_type(offset + difference_type(m_) - 1);
+    auto iter = diagonals_.find(number);
+    if (iter != diagonals_.end()) {
+      nnz_ -= iter->second.size;
+      diagonals_.erase(iter);
+    }
+    if (diagonal.size > 0) {
+      nnz_ += diagonal.size;
+      diagonals_.insert({number, std::move(diagonal)});
+    }
+  }
+
+  allocator_type get_allocator() const noexcept {
+    return allocator_;
   }
 
   std::size_t nbytes() const noexcept {
     size_t size_bytes = 0;
-    for (auto&& diagonal : diagonals_) {
-      auto&& [_, arrays] = diagonal;
-      auto&& [values, bvec] = arrays;
+    for (auto&& [_, diagonal] : diagonals_) {
       if constexpr (!std::is_same_v<scalar_type, bool>) {
-        size_bytes += values.size() * sizeof(scalar_type);
+        size_bytes += diagonal.values.size() * sizeof(scalar_type);
       } else {
-        size_bytes += (values.size() + CHAR_BIT - 1) / CHAR_BIT;
+        size_bytes += (diagonal.values.size() + CHAR_BIT - 1) / CHAR_BIT;
       }
-      size_bytes += (bvec.size() + CHAR_BIT - 1) / CHAR_BIT;
+      size_bytes += (diagonal.present.size() + CHAR_BIT - 1) / CHAR_BIT;
     }
     return size_bytes;
   }
 
 private:
+  index_type diagonal_number(index_type i, index_type j) const noexcept {
+    return (difference_type(j) - difference_type(i)) + shape()[0] - 1;
+  }
+
+  // The diagonal holding (i, j), created empty if it is not stored yet.
+  typename diagonal_map_type::iterator get_diagonal(index_type i,
+                                                    index_type j) {
+    index_type diagonal = diagonal_number(i, j);
+    auto iter = diagonals_.find(diagonal);
+    if (iter == diagonals_.end()) {
+      index_type count = std::min(m_ - i, n_ - j) + std::min(i, j);
+      diagonal_type d{std::vector<T, Allocator>(count, T{}, allocator_),
+                      std::vector<bool>(count, false), 0};
+      iter = diagonals_.insert({diagonal, std::move(d)}).first;
+    }
+    return iter;
+  }
+
   index_type m_ = 0;
   index_type n_ = 0;
   size_type nnz_ = 0;
+  allocator_type allocator_;
 
-  std::map<index_type, std::pair<std::vector<T>, std::vector<bool>>> diagonals_;
+  diagonal_map_type diagonals_;
 };
 
 } // namespace grb
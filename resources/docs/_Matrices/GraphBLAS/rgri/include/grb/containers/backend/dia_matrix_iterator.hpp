@@ -1,9 +1,18 @@
 #pragma once
 
-#include <map>
-#include <vector>
-
-template <typename T, typename I>
+#include <cstddef>
+#include <grb/containers/matrix_entry.hpp>
+#include <iterator>
+#include <type_traits>
+
+namespace grb {
+
+// Iterates over the present elements of a `dia_matrix`, diagonal by
+// diagonal from the bottom-left corner, and along each diagonal from its
+// top-left end.  `DiagonalIter` and `DiagonalConstIter` are iterators into
+// the backend's map from diagonal number to `dia_diagonal`.
+template <typename T, typename I, typename DiagonalIter,
+          typename DiagonalConstIter>
 class dia_matrix_iterator {
 public:
   using size_type = std::size_t;
@@ -13,9 +22,14 @@ public:
   using index_type = I;
   using map_type = T;
 
+  using diagonal_iterator =
+      std::conditional_t<!std::is_const_v<T>, DiagonalIter, DiagonalConstIter>;
+
   using value_type = grb::matrix_entry<T, index_type>;
   using iterator = dia_matrix_iterator;
-  using const_iterator = dia_matrix_iterator<std::add_const_t<T>, index_type>;
+  using const_iterator =
+      dia_matrix_iterator<std::add_const_t<T>, index_type, DiagonalIter,
+                          DiagonalConstIter>;
 
   using reference = grb::matrix_ref<T, I>;
   using const_reference = grb::matrix_ref<std::add_const_t<T>, I>;
@@ -25,32 +39,25 @@ public:
 
   using iterator_category = std::forward_iterator_tag;
 
-  dia_matrix_iterator(
-      index_type idx, index_type m, index_type n,
-      typename std::map<index_type,
-                        std::pair<std::vector<T>, std::vector<bool>>>::iterator
-          diagonal,
-      typename std::map<index_type,
-                        std::pair<std::vector<T>, std::vector<bool>>>::iterator
-          end)
-      : idx_(idx), m_(m), n_(n), diagonal_(diagonal), end_(end) {
+  dia_matrix_iterator(index_type idx, index_type m, diagonal_iterator diagonal,
+                      diagonal_iterator end)
+      : idx_(idx), m_(m), diagonal_(diagonal), end_(end) {
     fast_forward();
   }
 
+  // Skip absent elements and finished diagonals.
   void fast_forward() {
-    index_type diagonal_count = diagonal_->second.second.size();
-    if (idx_ >= diagonal_count) {
+    while (diagonal_ != end_) {
+      auto&& present = diagonal_->second.present;
+      while (idx_ < present.size() && !bool(present[idx_])) {
+        idx_++;
+      }
+      if (idx_ < present.size()) {
+        return;
+      }
       ++diagonal_;
       idx_ = 0;
     }
-    while (diagonal_ != end_ && !bool(diagonal_->second.second[idx_])) {
-      idx_++;
-      index_type diagonal_count = diagonal_->second.second.size();
-      if (idx_ >= diagonal_count) {
-        ++diagonal_;
-        idx_ = 0;
-      }
-    }
   }
 
   dia_matrix_iterator& operator++() noexcept {
@@ -61,12 +68,11 @@ public:
 
   dia_matrix_iterator operator++(int) noexcept {
     dia_matrix_iterator other = *this;
-    idx_++;
-    fast_forward();
+    ++(*this);
     return other;
   }
 
-  reference operator*() noexcept {
+  reference operator*() const noexcept {
     difference_type i, j;
 
     difference_type v =
@@ -76,14 +82,20 @@ public:
       j = 0;
     } else {
       i = 0;
-      j = std::abs(v);
+      j = -v;
     }
 
     i += idx_;
     j += idx_;
 
     return reference({index_type(i), index_type(j)},
-                     diagonal_->second.first[idx_]);
+                     diagonal_->second.values[idx_]);
+  }
+
+  operator const_iterator() const noexcept
+    requires(!std::is_const_v<T>)
+  {
+    return const_iterator(idx_, m_, diagonal_, end_);
   }
 
   dia_matrix_iterator() = default;
@@ -93,15 +105,17 @@ public:
   dia_matrix_iterator& operator=(const dia_matrix_iterator&) = default;
   dia_matrix_iterator& operator=(dia_matrix_iterator&&) = default;
 
-  bool operator==(const dia_matrix_iterator&) const = default;
+  bool operator==(const dia_matrix_iterator& other) const noexcept {
+    return diagonal_ == other.diagonal_ && idx_ == other.idx_;
+  }
+
   bool operator!=(const dia_matrix_iterator&) const = default;
 
 private:
-  index_type idx_;
-  index_type m_, n_;
-  typename std::map<index_type,
-                    std::pair<std::vector<T>, std::vector<bool>>>::iterator
-      diagonal_;
-  typename std::map<
-      index_type, std::pair<std::vector<T>, std::vector<bool>>>::iterator end_;
+  std::size_t idx_ = 0;
+  index_type m_ = 0;
+  diagonal_iterator diagonal_;
+  diagonal_iterator end_;
 };
+
+} // namespace grb
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <algorithm>
+#include <grb/containers/backend/sparse_vector_iterator.hpp>
+#include <grb/containers/vector_entry.hpp>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace grb {
+
+/// Sparse vector backend storing the indices of its elements in sorted
+/// order, next to their values.  Iteration and memory are O(nnz), so it suits
+/// vectors with few elements, such as BFS frontiers.  `find()` is a binary
+/// search; inserting an index past the last one appends in O(1), anywhere
+/// else shifts the elements after it.
+template <typename T, typename I, typename Allocator>
+class sparse_vector {
+public:
+  using index_type = I;
+  using value_type = grb::vector_entry<T, I>;
+
+  using key_type = I;
+  using map_type = T;
+
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  using allocator_type = Allocator;
+
+  using index_allocator_type = typename std::allocator_traits<
+      allocator_type>::template rebind_alloc<index_type>;
+
+  using iterator = sparse_vector_iterator<
+      T, index_type, typename std::vector<T, allocator_type>::iterator,
+      typename std::vector<T, allocator_type>::const_iterator,
+      typename std::vector<I, index_allocator_type>::const_iterator>;
+
+  using const_iterator = sparse_vector_iterator<
+      std::add_const_t<T>, index_type,
+      typename std::vector<T, allocator_type>::iterator,
+      typename std::vector<T, allocator_type>::const_iterator,
+      typename std::vector<I, index_allocator_type>::const_iterator>;
+
+  using reference = grb::vector_ref<T, index_type>;
+  using const_reference = grb::vector_ref<std::add_const_t<T>, index_type>;
+
+  using pointer = iterator;
+  using const_pointer = const_iterator;
+
+  using scalar_reference = typename std::vector<T, allocator_type>::reference;
+
+  sparse_vector(I shape) : shape_(shape) {}
+
+  sparse_vector(I shape, const Allocator& allocator)
+      : shape_(shape), indices_(allocator), values_(allocator) {}
+
+  size_type shape() const noexcept {
+    return shape_;
+  }
+
+  size_type size() const noexcept {
+    return indices_.size();
+  }
+
+  scalar_reference operator[](I index) {
+    size_type position = lower_bound(index);
+    if (position == size() || indices_[position] != index) {
+      indices_.insert(indices_.begin() + position, index);
+      values_.insert(values_.begin() + position, T());
+    }
+    return values_[position];
+  }
+
+  iterator begin() noexcept {
+    return iterator(values_, indices_, 0);
+  }
+
+  const_iterator begin() const noexcept {
+    return const_iterator(values_, indices_, 0);
+  }
+
+  iterator end() noexcept {
+    return iterator(values_, indices_, size());
+  }
+
+  const_iterator end() const noexcept {
+    return const_iterator(values_, indices_, size());
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    auto&& [idx, v] = value;
+    size_type position = lower_bound(idx);
+    if (position < size() && indices_[position] == idx) {
+      return {iterator(values_, indices_, position), false};
+    }
+    indices_.insert(indices_.begin() + position, idx);
+    values_.insert(values_.begin() + position, v);
+    return {iterator(values_, indices_, position), true};
+  }
+
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(key_type k, M&& obj) {
+    size_type position = lower_bound(k);
+    if (position < size() && indices_[position] == k) {
+      values_[position] = std::forward<M>(obj);
+      return {iterator(values_, indices_, position), false};
+    }
+    indices_.insert(indices_.begin() + position, k);
+    values_.insert(values_.begin() + position, std::forward<M>(obj));
+    return {iterator(values_, indices_, position), true};
+  }
+
+  iterator find(key_type key) noexcept {
+    size_type position = lower_bound(key);
+    if (position < size() && indices_[position] == key) {
+      return iterator(values_, indices_, position);
+    }
+    return end();
+  }
+
+  const_iterator find(key_type key) const noexcept {
+    size_type position = lower_bound(key);
+    if (position < size() && indices_[position] == key) {
+      return const_iterator(values_, indices_, position);
+    }
+    return end();
+  }
+
+  void reshape(I shape) {
+    size_type position = lower_bound(shape);
+    indices_.resize(position);
+    values_.resize(position);
+    shape_ = shape;
+  }
+
+  void reserve(size_type capacity) {
+    indices_.reserve(capacity);
+    values_.reserve(capacity);
+  }
+
+  /// Remove all elements, keeping the shape.
+  void clear() noexcept {
+    indices_.clear();
+    values_.clear();
+  }
+
+  allocator_type get_allocator() const noexcept {
+    return values_.get_allocator();
+  }
+
+  /// Sorted indices of the stored elements.
+  std::span<const index_type> indices() const noexcept {
+    return {indices_.data(), indices_.size()};
+  }
+
+  /// Values of the stored elements, in the order of `indices()`.
+  std::span<const T> values() const noexcept
+    requires(!std::is_same_v<T, bool>)
+  {
+    return {values_.data(), values_.size()};
+  }
+
+  sparse_vector() = default;
+
+  sparse_vector(const Allocator& allocator)
+      : indices_(allocator), values_(allocator) {}
+
+  ~sparse_vector() = default;
+  sparse_vector(const sparse_vector&) = default;
+  sparse_vector& operator=(const sparse_vector&) = default;
+
+  sparse_vector(sparse_vector&& other)
+      : shape_(other.shape_), indices_(std::move(other.indices_)),
+        values_(std::move(other.values_)) {
+    other.shape_ = 0;
+    other.indices_.clear();
+    other.values_.clear();
+  }
+
+  sparse_vector& operator=(sparse_vector&& other) {
+    shape_ = other.shape_;
+    indices_ = std::move(other.indices_);
+    values_ = std::move(other.values_);
+    other.shape_ = 0;
+    other.indices_.clear();
+    other.values_.clear();
+    return *this;
+  }
+
+private:
+  // Position of the first stored index not less than `index`.
+  size_type lower_bound(I index) const noexcept {
+    // Appending in order is the common case.
+    if (indices_.empty() || indices_.back() < index) {
+      return indices_.size();
+    }
+    return std::lower_bound(indices_.begin(), indices_.end(), index) -
+           indices_.begin();
+  }
+
+  I shape_ = 0;
+  std::vector<I, index_allocator_type> indices_;
+  std::vector<T, allocator_type> values_;
+};
+
+} // namespace grb
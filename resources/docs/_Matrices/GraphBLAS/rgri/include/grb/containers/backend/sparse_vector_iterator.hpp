@@ -0,0 +1,151 @@
+#pragma once
+
+#include <grb/containers/vector_entry.hpp>
+#include <grb/detail/spanner.hpp>
+#include <iterator>
+#include <ranges>
+
+namespace grb {
+
+template <typename T, typename I, typename TIter, typename TConstIter,
+          typename IIter>
+class sparse_vector_iterator {
+public:
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  using scalar_type = T;
+  using index_type = I;
+
+  using key_type = I;
+  using map_type = T;
+
+  using backend_iterator =
+      std::conditional_t<!std::is_const_v<T>, TIter, TConstIter>;
+
+  using value_type = grb::vector_entry<T, index_type>;
+  using iterator = sparse_vector_iterator;
+  using const_iterator = sparse_vector_iterator<std::add_const_t<T>, index_type,
+                                                TIter, TConstIter, IIter>;
+
+  using scalar_reference = decltype(*std::declval<TIter>());
+  using const_scalar_reference = decltype(*std::declval<TConstIter>());
+
+  using reference = grb::vector_ref<T, I, scalar_reference>;
+  using const_reference =
+      grb::vector_ref<std::add_const_t<T>, I, const_scalar_reference>;
+
+  using pointer = iterator;
+  using const_pointer = const_iterator;
+
+  using iterator_category = std::random_access_iterator_tag;
+
+  template <std::ranges::random_access_range R1,
+            std::ranges::random_access_range R2>
+  sparse_vector_iterator(R1&& values, R2&& indices, size_type position)
+      : values_(values), indices_(indices), position_(position) {}
+
+  sparse_vector_iterator(grb::detail::spanner<backend_iterator> values,
+                         grb::detail::spanner<IIter> indices,
+                         size_type position)
+      : values_(values), indices_(indices), position_(position) {}
+
+  operator const_iterator() const noexcept
+    requires(!std::is_const_v<T>)
+  {
+    return const_iterator(
+        grb::detail::spanner<TConstIter>(values_.begin(), values_.end()),
+        indices_, position_);
+  }
+
+  reference operator*() const noexcept
+    requires(!std::is_const_v<T>)
+  {
+    return reference(indices_[position_], values_[position_]);
+  }
+
+  const_reference operator*() const noexcept
+    requires(std::is_const_v<T>)
+  {
+    return const_reference(indices_[position_], values_[position_]);
+  }
+
+  auto operator[](difference_type n) const noexcept {
+    return *(*this + n);
+  }
+
+  sparse_vector_iterator& operator+=(difference_type n) noexcept {
+    position_ += n;
+    return *this;
+  }
+
+  sparse_vector_iterator& operator-=(difference_type n) noexcept {
+    position_ -= n;
+    return *this;
+  }
+
+  sparse_vector_iterator operator+(difference_type n) const noexcept {
+    sparse_vector_iterator other = *this;
+    other += n;
+    return other;
+  }
+
+  friend sparse_vector_iterator operator+(difference_type n,
+                                          sparse_vector_iterator iter) {
+    return iter + n;
+  }
+
+  sparse_vector_iterator operator-(difference_type n) const noexcept {
+    sparse_vector_iterator other = *this;
+    other -= n;
+    return other;
+  }
+
+  difference_type operator-(sparse_vector_iterator other) const noexcept {
+    return difference_type(position_) - difference_type(other.position_);
+  }
+
+  sparse_vector_iterator& operator++() noexcept {
+    ++position_;
+    return *this;
+  }
+
+  sparse_vector_iterator operator++(int) noexcept {
+    sparse_vector_iterator other = *this;
+    ++position_;
+    return other;
+  }
+
+  sparse_vector_iterator& operator--() noexcept {
+    --position_;
+    return *this;
+  }
+
+  sparse_vector_iterator operator--(int) noexcept {
+    sparse_vector_iterator other = *this;
+    --position_;
+    return other;
+  }
+
+  auto operator<=>(const sparse_vector_iterator& other) const noexcept {
+    return position_ <=> other.position_;
+  }
+
+  bool operator==(const sparse_vector_iterator& other) const noexcept {
+    return position_ == other.position_;
+  }
+
+  sparse_vector_iterator() = default;
+  ~sparse_vector_iterator() = default;
+  sparse_vector_iterator(const sparse_vector_iterator&) = default;
+  sparse_vector_iterator(sparse_vector_iterator&&) = default;
+  sparse_vector_iterator& operator=(const sparse_vector_iterator&) = default;
+  sparse_vector_iterator& operator=(sparse_vector_iterator&&) = default;
+
+private:
+  grb::detail::spanner<backend_iterator> values_;
+  grb::detail::spanner<IIter> indices_;
+  size_type position_ = 0;
+};
+
+} // namespace grb
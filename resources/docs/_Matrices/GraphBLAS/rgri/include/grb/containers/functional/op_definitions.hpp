@@ -149,7 +149,7 @@ struct max_impl_ {
 
   template <typename T>
   static constexpr T identity()
-    requires(std::numeric_limits<T>::is_specialized())
+    requires(std::numeric_limits<T>::is_specialized)
   {
     return std::min(std::numeric_limits<T>::lowest(),
                     -std::numeric_limits<T>::infinity());
@@ -185,7 +185,7 @@ struct min_impl_ {
 
   template <typename T>
   static constexpr T identity()
-    requires(std::numeric_limits<T>::is_specialized())
+    requires(std::numeric_limits<T>::is_specialized)
   {
     return std::max(std::numeric_limits<T>::max(),
                     std::numeric_limits<T>::infinity());
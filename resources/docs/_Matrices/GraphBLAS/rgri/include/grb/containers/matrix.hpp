@@ -72,18 +72,14 @@ public:
       : backend_({*shape.begin(), *(shape.begin() + 1)}, allocator) {}
 
   /// Construct a matrix from the Matrix Market file stored at location
-  /// `file_path`.
+  /// `file_path`.  Sparse matrices are read in parallel straight into CSR.
   matrix(std::string file_path) {
-    auto tuples = grb::mmread<T, I>(file_path);
-    reshape(tuples.shape());
-    insert(tuples.begin(), tuples.end());
+    read_file(file_path);
   }
 
   matrix(std::string file_path, const Allocator& allocator)
       : backend_(allocator) {
-    auto tuples = grb::mmread<T, I>(file_path);
-    reshape(tuples.shape());
-    insert(tuples.begin(), tuples.end());
+    read_file(file_path);
   }
 
   /// Dimensions of the matrix
@@ -102,22 +98,22 @@ public:
   }
 
   /// Iterator to the beginning
-  iterator begin() noexcept {
+  iterator begin() {
     return backend_.begin();
   }
 
   /// Const iterator to the beginning
-  const_iterator begin() const noexcept {
+  const_iterator begin() const {
     return backend_.begin();
   }
 
   /// Iterator to the end
-  iterator end() noexcept {
+  iterator end() {
     return backend_.end();
   }
 
   /// Const iterator to the end
-  const_iterator end() const noexcept {
+  const_iterator end() const {
     return backend_.end();
   }
 
@@ -148,11 +144,11 @@ public:
     return backend_.insert_or_assign(k, std::forward<M>(obj));
   }
 
-  iterator find(key_type key) noexcept {
+  iterator find(key_type key) {
     return backend_.find(key);
   }
 
-  const_iterator find(key_type key) const noexcept {
+  const_iterator find(key_type key) const {
     return backend_.find(key);
   }
 
@@ -162,10 +158,34 @@ public:
     return backend_.reshape(shape);
   }
 
+  /// Reference to the element at `index`, inserting a value-initialized
+  /// element first if there is none.
   scalar_reference operator[](grb::index<I> index) {
-    auto [iterator, inserted] = insert({index, T()});
-    auto&& [i_, value] = *iterator;
-    return value;
+    if constexpr (requires { backend_[index]; }) {
+      return backend_[index];
+    } else {
+      auto [iterator, inserted] = insert({index, T()});
+      auto&& [i_, value] = *iterator;
+      return value;
+    }
+  }
+
+  /// Finish any deferred work, such as merging elements inserted into a
+  /// sparse matrix.  Reads do this implicitly.
+  void wait() const {
+    if constexpr (requires { backend_.wait(); }) {
+      backend_.wait();
+    }
+  }
+
+  /// The backend data structure storing the elements, for algorithms that
+  /// work directly on its layout (e.g. the CSR arrays of a sparse matrix).
+  backend_type& backend() noexcept {
+    return backend_;
+  }
+
+  const backend_type& backend() const noexcept {
+    return backend_;
   }
 
   matrix() = default;
@@ -177,6 +197,23 @@ public:
   matrix& operator=(matrix&&) = default;
 
 private:
+  void read_file(const std::string& file_path) {
+    if constexpr (requires(__detail::mm_csr<T, I> csr) {
+                    backend_.assign_csr(std::move(csr.rowptr),
+                                        std::move(csr.colind),
+                                        std::move(csr.values));
+                  }) {
+      auto csr = __detail::mmread_csr<T, I>(file_path);
+      reshape(csr.shape);
+      backend_.assign_csr(std::move(csr.rowptr), std::move(csr.colind),
+                          std::move(csr.values));
+    } else {
+      auto tuples = grb::mmread<T, I>(file_path);
+      reshape(tuples.shape());
+      insert(tuples.begin(), tuples.end());
+    }
+  }
+
   backend_type backend_;
 };
 
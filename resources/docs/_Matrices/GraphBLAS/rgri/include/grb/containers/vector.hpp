@@ -3,6 +3,7 @@
 
 #include <grb/containers/backend/dense_vector.hpp>
 #include <grb/grb.hpp>
+#include <grb/util/matrix_hints.hpp>
 #include <numeric>
 
 namespace grb {
@@ -27,8 +28,10 @@ public:
   /// Allocator type
   using allocator_type = Allocator;
 
-  // TODO: implement sparse, allow selecting sparse.
-  using backend_type = grb::dense_vector<T, I, Allocator>;
+  using hint_type = Hint;
+
+  using backend_type =
+      typename pick_vector_backend_type<Hint>::template type<T, I, Allocator>;
 
   using iterator = typename backend_type::iterator;
   using const_iterator = typename backend_type::const_iterator;
@@ -116,6 +119,16 @@ public:
     backend_.reshape(shape);
   }
 
+  /// The backend data structure storing the elements, for algorithms that
+  /// work directly on its layout.
+  backend_type& backend() noexcept {
+    return backend_;
+  }
+
+  const backend_type& backend() const noexcept {
+    return backend_;
+  }
+
   vector() = default;
   vector(const Allocator& allocator) : backend_(allocator) {}
 
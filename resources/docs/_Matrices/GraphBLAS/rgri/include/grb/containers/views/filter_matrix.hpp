@@ -92,9 +92,7 @@ public:
   using key_type = container_key_t<container_type>;
 
   using iterator = filter_iterator<
-      decltype(std::declval<std::ranges::views::all_t<ContainerType>>()
-                   .base()
-                   .begin()),
+      __detail::adapted_iterator_t<ContainerType>,
       Fn>;
   using const_iterator = iterator;
 
@@ -128,7 +126,7 @@ public:
   }
 
   decltype(auto) base() const noexcept {
-    return matrix_.base();
+    return __detail::adapted_range<ContainerType>(matrix_);
   }
 
 private:
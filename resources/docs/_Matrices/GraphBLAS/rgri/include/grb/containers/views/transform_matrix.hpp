@@ -94,9 +94,7 @@ public:
   using key_type = container_key_t<matrix_type>;
 
   using iterator = transform_matrix_iterator<
-      decltype(std::declval<std::ranges::views::all_t<MatrixType>>()
-                   .base()
-                   .begin()),
+      __detail::adapted_iterator_t<MatrixType>,
       Fn>;
   using const_iterator = iterator;
 
@@ -126,7 +124,7 @@ public:
   }
 
   decltype(auto) base() const noexcept {
-    return matrix_.base();
+    return __detail::adapted_range<MatrixType>(matrix_);
   }
 
 private:
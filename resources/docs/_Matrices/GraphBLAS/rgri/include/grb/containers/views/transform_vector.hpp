@@ -94,9 +94,7 @@ public:
   using key_type = container_key_t<vector_type>;
 
   using iterator = transform_vector_iterator<
-      decltype(std::declval<std::ranges::views::all_t<VectorType>>()
-                   .base()
-                   .begin()),
+      __detail::adapted_iterator_t<VectorType>,
       Fn>;
   using const_iterator = iterator;
 
@@ -126,7 +124,7 @@ public:
   }
 
   decltype(auto) base() const noexcept {
-    return vector_.base();
+    return __detail::adapted_range<VectorType>(vector_);
   }
 
 private:
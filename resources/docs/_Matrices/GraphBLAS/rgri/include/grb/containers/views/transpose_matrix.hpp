@@ -113,6 +113,11 @@ public:
     return iterator(matrix_.find({key[1], key[0]}));
   }
 
+  /// The matrix being transposed.
+  const MatrixType& base() const noexcept {
+    return matrix_;
+  }
+
 private:
   const MatrixType& matrix_;
 };
@@ -0,0 +1,265 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <grb/containers/backend/dia_matrix.hpp>
+#include <grb/containers/functional/op_definitions.hpp>
+#include <grb/containers/matrix.hpp>
+#include <grb/detail/matrix_traits.hpp>
+#include <grb/detail/op_traits.hpp>
+#include <grb/detail/parallel.hpp>
+#include <grb/detail/spmv.hpp>
+#include <grb/experimental/sycl_tools/vector.hpp>
+#include <map>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace grb {
+
+namespace __detail {
+
+// A `grb::matrix` stored as diagonals (see `grb::dia_matrix`).
+template <typename M>
+concept dia_backed = requires(const std::remove_cvref_t<M>& m) {
+  m.backend().diagonals();
+  m.backend().diagonal_offset(0);
+};
+
+// (plus, times) on arithmetic values.  A missing product then adds nothing,
+// so a full diagonal needs no presence checks and its products can be
+// accumulated with a plain axpy.
+template <typename Reduce, typename Combine, typename... Scalars>
+inline constexpr bool is_arithmetic_plus_times_v =
+    is_plus<std::remove_cvref_t<Reduce>>::value &&
+    is_multiplies<std::remove_cvref_t<Combine>>::value &&
+    (std::is_arithmetic_v<Scalars> && ...);
+
+// y[t] += d[t] * x[t] over contiguous arrays, which the compiler vectorizes
+// (to the full vector width with ENABLE_NATIVE_ARCH).
+template <typename V, typename T, typename U>
+void dia_axpy(V* __restrict y, const T* __restrict d, const U* __restrict x,
+              std::size_t length) {
+  for (std::size_t t = 0; t < length; t++) {
+    y[t] += d[t] * x[t];
+  }
+}
+
+// First row of the diagonal with offset `j - i`: element t of the diagonal
+// is (first_row + t, first_row + offset + t).
+inline std::size_t dia_first_row(std::ptrdiff_t offset) {
+  return offset < 0 ? std::size_t(-offset) : 0;
+}
+
+// Number of elements on the diagonal with offset `j - i` of an m x n
+// matrix.
+inline std::size_t dia_length(std::ptrdiff_t offset, std::size_t m,
+                              std::size_t n) {
+  if (offset >= 0) {
+    return std::size_t(offset) < n ? std::min(m, n - offset) : 0;
+  }
+  return std::size_t(-offset) < m ? std::min(m + offset, n) : 0;
+}
+
+// Matrix-vector product of a DIA-backed matrix, one diagonal at a time.
+//
+// `b` is first scattered into a dense array, so every diagonal is a
+// contiguous run of both the matrix values and `b`: when `b` holds every
+// index and the semiring is arithmetic (plus, times), a full diagonal is a
+// single axpy into the output.  Otherwise elements are combined one by one,
+// skipping absent ones.  Within a row, products are reduced in increasing
+// column order, as for CSR.  Rows are split evenly between up to
+// `max_workers` workers, each of which walks every diagonal over its rows.
+template <typename C, typename A, typename B, typename Reduce,
+          typename Combine, typename M>
+C dia_multiply_vector(const A& a, B&& b, Reduce&& reduce, Combine&& combine,
+                      M&& mask, std::size_t max_workers) {
+  using a_scalar_type = grb::matrix_scalar_t<A>;
+  using b_scalar_type = grb::vector_scalar_t<B>;
+  using c_scalar_type = grb::vector_scalar_t<C>;
+  using c_index_type = grb::vector_index_t<C>;
+
+  constexpr bool plus_times =
+      is_arithmetic_plus_times_v<Reduce, Combine, a_scalar_type,
+                                 b_scalar_type, c_scalar_type>;
+
+  auto&& backend = a.backend();
+  std::size_t m = a.shape()[0];
+  std::size_t n = a.shape()[1];
+
+  shp::vector<b_scalar_type> x(n);
+  std::vector<char> x_present(n, false);
+  for (auto&& [j, v] : b) {
+    x[j] = v;
+    x_present[j] = true;
+  }
+  bool dense = std::size_t(b.size()) == n;
+
+  shp::vector<c_scalar_type> y(m, c_scalar_type{});
+  std::vector<char> found(m, false);
+
+  std::size_t workers = num_workers(backend.size(), max_workers);
+  parallel_for_workers(workers, [&](std::size_t worker) {
+    std::size_t row_begin = m * worker / workers;
+    std::size_t row_end = m * (worker + 1) / workers;
+
+    for (auto&& [number, diagonal] : backend.diagonals()) {
+      auto offset = backend.diagonal_offset(number);
+      std::size_t i0 = dia_first_row(offset);
+      std::size_t j0 = i0 + offset;
+
+      // This worker's part of the diagonal.
+      std::size_t first = std::max(row_begin, i0) - i0;
+      std::size_t last = std::min(row_end, i0 + diagonal.values.size());
+      if (last <= i0 + first) {
+        continue;
+      }
+      last -= i0;
+
+      if constexpr (plus_times) {
+        if (dense && diagonal.full()) {
+          dia_axpy(y.data() + i0 + first, diagonal.values.data() + first,
+                   x.data() + j0 + first, last - first);
+          std::fill(found.begin() + i0 + first, found.begin() + i0 + last,
+                    true);
+          continue;
+        }
+      }
+
+      for (std::size_t t = first; t < last; t++) {
+        if (diagonal.present[t] && x_present[j0 + t]) {
+          c_scalar_type v = combine(diagonal.values[t], x[j0 + t]);
+          std::size_t i = i0 + t;
+          y[i] = found[i] ? c_scalar_type(reduce(y[i], v)) : v;
+          found[i] = true;
+        }
+      }
+    }
+  });
+
+  C c(m);
+  for (std::size_t i = 0; i < m; i++) {
+    if (found[i] && mask_allows(mask, i)) {
+      c.insert({c_index_type(i), y[i]});
+    }
+  }
+  return c;
+}
+
+// Product of two DIA-backed matrices, as a DIA-backed matrix.
+//
+// Diagonal p of `a` times diagonal q of `b` contributes to diagonal p + q of
+// the product: element (i, i + p + q) gets a(i, i + p) * b(i + p, i + p + q),
+// so each pair of diagonals is an elementwise product of two contiguous runs
+// accumulated into a third, over the rows where both runs exist.  Pairs of
+// full diagonals under arithmetic (plus, times) are a single axpy.  Products
+// for an element are reduced in increasing order of p, as Gustavson's
+// method would.  Rows are split evenly between up to `max_workers` workers.
+template <typename T, std::integral I, typename A, typename B,
+          typename Reduce, typename Combine>
+auto dia_multiply(const A& a, const B& b, Reduce&& reduce, Combine&& combine,
+                  std::size_t max_workers) {
+  constexpr bool plus_times =
+      is_arithmetic_plus_times_v<Reduce, Combine, grb::matrix_scalar_t<A>,
+                                 grb::matrix_scalar_t<B>, T>;
+
+  auto&& a_backend = a.backend();
+  auto&& b_backend = b.backend();
+  std::size_t m = a.shape()[0];
+  std::size_t n = b.shape()[1];
+
+  // Output diagonals, written by several workers at once, hence `char`
+  // rather than `bool` flags.
+  struct accumulator {
+    shp::vector<T> values;
+    std::vector<char> present;
+  };
+  std::map<std::ptrdiff_t, accumulator> diagonals;
+  for (auto&& [p_number, a_diagonal] : a_backend.diagonals()) {
+    for (auto&& [q_number, b_diagonal] : b_backend.diagonals()) {
+      auto offset = a_backend.diagonal_offset(p_number) +
+                    b_backend.diagonal_offset(q_number);
+      std::size_t length = dia_length(offset, m, n);
+      if (length > 0 && !diagonals.contains(offset)) {
+        diagonals[offset] = {shp::vector<T>(length, T{}),
+                             std::vector<char>(length, false)};
+      }
+    }
+  }
+
+  std::size_t work = a_backend.size() + b_backend.size();
+  std::size_t workers = num_workers(work, max_workers);
+  parallel_for_workers(workers, [&](std::size_t worker) {
+    std::size_t row_begin = m * worker / workers;
+    std::size_t row_end = m * (worker + 1) / workers;
+
+    for (auto&& [p_number, a_diagonal] : a_backend.diagonals()) {
+      auto p = a_backend.diagonal_offset(p_number);
+      std::size_t a0 = dia_first_row(p);
+
+      for (auto&& [q_number, b_diagonal] : b_backend.diagonals()) {
+        auto q = b_backend.diagonal_offset(q_number);
+        auto iter = diagonals.find(p + q);
+        if (iter == diagonals.end()) {
+          continue;
+        }
+        auto&& [values, present] = iter->second;
+        std::size_t c0 = dia_first_row(p + q);
+
+        // Rows i of `a`'s run for which row i + p is in `b`'s run.
+        std::ptrdiff_t b0 = std::ptrdiff_t(dia_first_row(q)) - p;
+        std::ptrdiff_t lo = std::max({std::ptrdiff_t(row_begin),
+                                      std::ptrdiff_t(a0), b0});
+        std::ptrdiff_t hi = std::min(
+            {std::ptrdiff_t(row_end),
+             std::ptrdiff_t(a0 + a_diagonal.values.size()),
+             b0 + std::ptrdiff_t(b_diagonal.values.size())});
+        if (lo >= hi) {
+          continue;
+        }
+
+        std::size_t a_first = lo - a0;
+        std::size_t b_first = lo - b0;
+        std::size_t c_first = lo - c0;
+        std::size_t length = hi - lo;
+
+        if constexpr (plus_times) {
+          if (a_diagonal.full() && b_diagonal.full()) {
+            dia_axpy(values.data() + c_first,
+                     a_diagonal.values.data() + a_first,
+                     b_diagonal.values.data() + b_first, length);
+            std::fill(present.begin() + c_first,
+                      present.begin() + c_first + length, true);
+            continue;
+          }
+        }
+
+        for (std::size_t t = 0; t < length; t++) {
+          if (a_diagonal.present[a_first + t] &&
+              b_diagonal.present[b_first + t]) {
+            T v = combine(a_diagonal.values[a_first + t],
+                          b_diagonal.values[b_first + t]);
+            auto&& c_v = values[c_first + t];
+            c_v = present[c_first + t] ? T(reduce(c_v, v)) : v;
+            present[c_first + t] = true;
+          }
+        }
+      }
+    }
+  });
+
+  grb::matrix<T, I, grb::diagonal> c({I(m), I(n)});
+  for (auto&& [offset, diagonal] : diagonals) {
+    grb::dia_diagonal<T> result;
+    result.values.assign(diagonal.values.begin(), diagonal.values.end());
+    result.present.assign(diagonal.present.begin(), diagonal.present.end());
+    result.size = std::count(diagonal.present.begin(),
+                             diagonal.present.end(), true);
+    c.backend().assign_diagonal(offset, std::move(result));
+  }
+  return c;
+}
+
+} // namespace __detail
+
+} // namespace grb
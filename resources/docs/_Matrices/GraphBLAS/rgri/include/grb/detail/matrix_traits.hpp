@@ -28,6 +28,23 @@ struct get_index_type<Tuple> {
   using type = typename get_index_type<std::tuple_element_t<0, Tuple>>::type;
 };
 
+// The range adapted by a view that stores `R` as
+// `std::ranges::views::all_t<R>`: the container inside a `ref_view` or
+// `owning_view`, or the stored view itself when `R` is already a view, so
+// that views of views compose.
+template <typename R, typename Stored>
+decltype(auto) adapted_range(Stored& stored) noexcept {
+  if constexpr (std::ranges::view<std::remove_cvref_t<R>>) {
+    return stored;
+  } else {
+    return stored.base();
+  }
+}
+
+template <typename R>
+using adapted_iterator_t = decltype(adapted_range<R>(
+    std::declval<const std::ranges::views::all_t<R>&>()).begin());
+
 } // namespace __detail
 
 using any = std::any;
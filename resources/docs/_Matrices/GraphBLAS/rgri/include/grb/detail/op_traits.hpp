@@ -0,0 +1,47 @@
+#pragma once
+
+#include <grb/containers/functional/op_definitions.hpp>
+#include <type_traits>
+
+namespace grb {
+
+namespace __detail {
+
+// Recognize the built-in operators, for kernels that specialize on them.
+
+template <typename Op>
+struct is_plus : std::false_type {};
+
+template <typename T, typename U, typename V>
+struct is_plus<grb::plus<T, U, V>> : std::true_type {};
+
+template <typename Op>
+struct is_multiplies : std::false_type {};
+
+template <typename T, typename U, typename V>
+struct is_multiplies<grb::multiplies<T, U, V>> : std::true_type {};
+
+template <typename T, typename U, typename V>
+struct is_multiplies<grb::times<T, U, V>> : std::true_type {};
+
+template <typename Op>
+struct is_min : std::false_type {};
+
+template <typename T, typename U, typename V>
+struct is_min<grb::min<T, U, V>> : std::true_type {};
+
+template <typename Op>
+struct is_max : std::false_type {};
+
+template <typename T, typename U, typename V>
+struct is_max<grb::max<T, U, V>> : std::true_type {};
+
+template <typename Op>
+struct is_logical_or : std::false_type {};
+
+template <typename T, typename U, typename V>
+struct is_logical_or<grb::logical_or<T, U, V>> : std::true_type {};
+
+} // namespace __detail
+
+} // namespace grb
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <execution>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace grb {
+
+namespace __detail {
+
+inline std::atomic<std::size_t>& max_threads_setting() {
+  static std::atomic<std::size_t> setting(0);
+  return setting;
+}
+
+} // namespace __detail
+
+/// Maximum number of threads used by the algorithms' parallel
+/// (`std::execution::par`) overloads.  Defaults to
+/// `std::thread::hardware_concurrency()`.
+inline std::size_t max_threads() {
+  std::size_t n = __detail::max_threads_setting().load();
+  if (n == 0) {
+    n = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+  }
+  return n;
+}
+
+/// Limit the parallel overloads to `n` threads.  `0` restores the default.
+inline void set_max_threads(std::size_t n) {
+  __detail::max_threads_setting().store(n);
+}
+
+namespace __detail {
+
+template <typename ExecutionPolicy>
+concept execution_policy =
+    std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>;
+
+// `seq` and `unseq` run the serial algorithm; `par` and `par_unseq` split the
+// work across threads.
+template <typename ExecutionPolicy>
+inline constexpr bool is_parallel_policy_v =
+    !std::is_same_v<std::remove_cvref_t<ExecutionPolicy>,
+                    std::execution::sequenced_policy>
+#if defined(__cpp_lib_execution) && __cpp_lib_execution >= 201902L
+    && !std::is_same_v<std::remove_cvref_t<ExecutionPolicy>,
+                       std::execution::unsequenced_policy>
+#endif
+    ;
+
+// Below this much work per thread, starting threads costs more than it saves.
+inline constexpr std::size_t min_work_per_thread = 1 << 14;
+
+// Number of workers to use for `work` units (nonzeros, flops).
+inline std::size_t num_workers(std::size_t work,
+                               std::size_t max_workers = grb::max_threads()) {
+  return std::clamp<std::size_t>(work / min_work_per_thread, 1,
+                                 std::max<std::size_t>(max_workers, 1));
+}
+
+// Split rows into `parts` contiguous ranges of about equal weight.
+// `prefix` holds the running total of the per-row weights, starting with 0
+// (e.g. a CSR row pointer, or a prefix sum of per-row flops).  Part `p` is
+// rows [bounds[p], bounds[p + 1]).
+template <typename W>
+std::vector<std::size_t> balanced_partition(std::span<const W> prefix,
+                                            std::size_t parts) {
+  std::size_t rows = prefix.size() - 1;
+  std::vector<std::size_t> bounds(parts + 1, rows);
+  bounds[0] = 0;
+
+  // Weigh each row at least 1 so long runs of empty rows still get split.
+  auto weight = [&](std::size_t row) {
+    return std::size_t(prefix[row] - prefix[0]) + row;
+  };
+  std::size_t total = weight(rows);
+
+  for (std::size_t p = 1; p < parts; p++) {
+    std::size_t target = total * p / parts;
+    std::size_t lo = bounds[p - 1];
+    std::size_t hi = rows;
+    while (lo < hi) {
+      std::size_t mid = lo + (hi - lo) / 2;
+      if (weight(mid) < target) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    bounds[p] = lo;
+  }
+  return bounds;
+}
+
+// Run `f(worker)` for worker = 0, ..., workers - 1, each on its own thread
+// (worker 0 on the calling thread).  The first exception thrown by any worker
+// is rethrown once all of them have finished.
+template <typename F>
+void parallel_for_workers(std::size_t workers, F&& f) {
+  if (workers <= 1) {
+    f(std::size_t(0));
+    return;
+  }
+
+  std::vector<std::exception_ptr> errors(workers);
+  auto run = [&](std::size_t worker) {
+    try {
+      f(worker);
+    } catch (...) {
+      errors[worker] = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(workers - 1);
+  for (std::size_t worker = 1; worker < workers; worker++) {
+    threads.emplace_back(run, worker);
+  }
+  run(0);
+
+  for (auto&& thread : threads) {
+    thread.join();
+  }
+
+  for (auto&& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+} // namespace __detail
+
+} // namespace grb
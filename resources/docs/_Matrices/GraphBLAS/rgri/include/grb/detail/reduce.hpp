@@ -0,0 +1,277 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <grb/detail/monoid_traits.hpp>
+#include <grb/detail/op_traits.hpp>
+#include <grb/detail/parallel.hpp>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace grb {
+
+/// Summation modes for `grb::reduce`, `grb::reduce_columns` and
+/// `grb::reduce_to_scalar`, given as their first template argument.  They
+/// only affect `grb::plus` on floating-point values.  In every mode the
+/// result depends only on the values and their order, not on the execution
+/// policy or the number of threads.
+///
+/// The default: values are summed in independent lanes, which the compiler
+/// vectorizes.  The rounding error grows linearly with the number of values.
+struct blocked_summation {};
+
+/// Pairwise summation: the rounding error grows with the logarithm of the
+/// number of values.  Up to about twice as slow as `blocked_summation`.
+struct pairwise_summation {};
+
+/// Compensated summation (Neumaier's variant of Kahan's), lane by lane: the
+/// rounding error does not grow with the number of values.  A few times
+/// slower than `blocked_summation` when the values are in cache.  Fast-math
+/// compiler options break the compensation.
+struct kahan_summation {};
+
+namespace __detail {
+
+template <typename S>
+inline constexpr bool is_summation_v =
+    std::is_same_v<S, blocked_summation> ||
+    std::is_same_v<S, pairwise_summation> ||
+    std::is_same_v<S, kahan_summation>;
+
+// Values are folded into this many independent accumulators.
+inline constexpr std::size_t reduce_lanes = 16;
+
+// Values are reduced in blocks of this many, the unit of work for parallel
+// reductions.  Block boundaries do not depend on the number of workers.
+inline constexpr std::size_t reduce_block_size = 1 << 13;
+
+// Leaves of the pairwise summation tree.
+inline constexpr std::size_t pairwise_leaf_size = 128;
+
+// Built-in monoids on arithmetic values.  These are commutative as well as
+// associative, so values can be spread over lanes.
+template <typename Reduce, typename T>
+inline constexpr bool is_lane_reducible_v =
+    std::is_arithmetic_v<T> && grb::Monoid<std::remove_cvref_t<Reduce>, T> &&
+    (is_plus<std::remove_cvref_t<Reduce>>::value ||
+     is_min<std::remove_cvref_t<Reduce>>::value ||
+     is_max<std::remove_cvref_t<Reduce>>::value ||
+     is_logical_or<std::remove_cvref_t<Reduce>>::value);
+
+// The summation mode applies only to floating-point sums.
+template <typename Reduce, typename T>
+inline constexpr bool is_floating_sum_v =
+    std::is_floating_point_v<T> && is_plus<std::remove_cvref_t<Reduce>>::value;
+
+template <typename Summation, typename Reduce, typename T>
+inline constexpr bool uses_kahan_v =
+    is_floating_sum_v<Reduce, T> &&
+    std::is_same_v<Summation, kahan_summation>;
+
+template <typename Summation, typename Reduce, typename T>
+inline constexpr bool uses_pairwise_v =
+    is_floating_sum_v<Reduce, T> &&
+    std::is_same_v<Summation, pairwise_summation>;
+
+// A sum together with the rounding error it has lost.
+template <typename T>
+struct compensated_sum {
+  T sum = 0;
+  T error = 0;
+
+  // Neumaier's variant of Kahan's step recovers the error of the addition
+  // exactly whichever operand is larger.
+  void add(T x) {
+    T s = sum + x;
+    error += std::abs(sum) >= std::abs(x) ? (sum - s) + x : (x - s) + sum;
+    sum = s;
+  }
+
+  void add(const compensated_sum& other) {
+    add(other.sum);
+    error += other.error;
+  }
+
+  T value() const {
+    return sum + error;
+  }
+};
+
+// Fold of the nonempty `x` into `reduce_lanes` accumulators, value t going
+// to lane t % reduce_lanes, which are then combined as a binary tree.  The
+// lanes do not depend on each other, so the compiler vectorizes the main
+// loop without reassociating anything.
+template <typename T, typename Reduce>
+T fold_lanes(std::span<const T> x, Reduce&& reduce) {
+  std::array<T, reduce_lanes> acc;
+  acc.fill(grb::monoid_traits<std::remove_cvref_t<Reduce>, T>::identity());
+
+  std::size_t t = 0;
+  for (; t + reduce_lanes <= x.size(); t += reduce_lanes) {
+    for (std::size_t l = 0; l < reduce_lanes; l++) {
+      acc[l] = T(reduce(acc[l], x[t + l]));
+    }
+  }
+  for (std::size_t l = 0; t + l < x.size(); l++) {
+    acc[l] = T(reduce(acc[l], x[t + l]));
+  }
+
+  for (std::size_t width = reduce_lanes / 2; width > 0; width /= 2) {
+    for (std::size_t l = 0; l < width; l++) {
+      acc[l] = T(reduce(acc[l], acc[l + width]));
+    }
+  }
+  return acc[0];
+}
+
+// Pairwise fold of the nonempty `x`: halves are folded recursively, down to
+// leaves folded by `fold_lanes`.
+template <typename T, typename Reduce>
+T fold_pairwise(std::span<const T> x, Reduce&& reduce) {
+  if (x.size() <= pairwise_leaf_size) {
+    return fold_lanes(x, reduce);
+  }
+  std::size_t half = x.size() / 2;
+  return T(reduce(fold_pairwise(x.first(half), reduce),
+                  fold_pairwise(x.subspan(half), reduce)));
+}
+
+// Compensated sum of `x`, each lane keeping its own error, as separate
+// arrays so that the lanes vectorize.
+template <typename T>
+compensated_sum<T> fold_kahan(std::span<const T> x) {
+  std::array<T, reduce_lanes> sum{};
+  std::array<T, reduce_lanes> error{};
+
+  auto add = [&](std::size_t l, T v) {
+    T s = sum[l] + v;
+    error[l] += std::abs(sum[l]) >= std::abs(v) ? (sum[l] - s) + v
+                                                : (v - s) + sum[l];
+    sum[l] = s;
+  };
+
+  std::size_t t = 0;
+  for (; t + reduce_lanes <= x.size(); t += reduce_lanes) {
+    for (std::size_t l = 0; l < reduce_lanes; l++) {
+      add(l, x[t + l]);
+    }
+  }
+  for (std::size_t l = 0; t + l < x.size(); l++) {
+    add(l, x[t + l]);
+  }
+
+  compensated_sum<T> total;
+  for (std::size_t l = 0; l < reduce_lanes; l++) {
+    total.add(compensated_sum<T>{sum[l], error[l]});
+  }
+  return total;
+}
+
+template <typename Summation, typename Reduce, typename T>
+using reduce_partial_t =
+    std::conditional_t<uses_kahan_v<Summation, Reduce, T>, compensated_sum<T>,
+                       T>;
+
+// Partial result for the nonempty block `x`.  Operators other than the
+// built-in monoids are folded in order, from the first value.
+template <typename Summation, typename T, typename Reduce>
+reduce_partial_t<Summation, Reduce, T> reduce_block(std::span<const T> x,
+                                                    Reduce&& reduce) {
+  if constexpr (uses_kahan_v<Summation, Reduce, T>) {
+    return fold_kahan(x);
+  } else if constexpr (uses_pairwise_v<Summation, Reduce, T>) {
+    return fold_pairwise(x, reduce);
+  } else if constexpr (is_lane_reducible_v<Reduce, T>) {
+    return fold_lanes(x, reduce);
+  } else {
+    T value = x[0];
+    for (std::size_t t = 1; t < x.size(); t++) {
+      value = T(reduce(value, x[t]));
+    }
+    return value;
+  }
+}
+
+// Combination of the nonempty `partials`, in block order.
+template <typename Summation, typename T, typename Reduce, typename P>
+T combine_partials(std::span<const P> partials, Reduce&& reduce) {
+  if constexpr (uses_kahan_v<Summation, Reduce, T>) {
+    compensated_sum<T> total;
+    for (auto&& partial : partials) {
+      total.add(partial);
+    }
+    return total.value();
+  } else if constexpr (uses_pairwise_v<Summation, Reduce, T>) {
+    return fold_pairwise(partials, reduce);
+  } else {
+    T value = partials[0];
+    for (std::size_t b = 1; b < partials.size(); b++) {
+      value = T(reduce(value, partials[b]));
+    }
+    return value;
+  }
+}
+
+// Reduction of the nonempty `x` with the associative `reduce`.  Blocks of
+// `reduce_block_size` values are reduced independently, by up to
+// `max_workers` workers taking contiguous runs of blocks, and their partial
+// results are then combined in order, so the result is the same for any
+// number of workers.  A logical or stops at the first block holding true.
+template <typename Summation, typename T, typename Reduce>
+T reduce_values(std::span<const T> x, Reduce&& reduce,
+                std::size_t max_workers) {
+  using P = reduce_partial_t<Summation, Reduce, T>;
+
+  std::size_t blocks = (x.size() + reduce_block_size - 1) / reduce_block_size;
+  if (blocks == 1) {
+    P partial = reduce_block<Summation>(x, reduce);
+    return combine_partials<Summation, T>(std::span<const P>(&partial, 1),
+                                          reduce);
+  }
+
+  constexpr bool stops_early =
+      is_lane_reducible_v<Reduce, T> &&
+      is_logical_or<std::remove_cvref_t<Reduce>>::value;
+  std::atomic<bool> found = false;
+
+  std::vector<P> partials(blocks);
+  std::size_t workers = num_workers(x.size(), max_workers);
+  parallel_for_workers(workers, [&](std::size_t worker) {
+    std::size_t first = blocks * worker / workers;
+    std::size_t last = blocks * (worker + 1) / workers;
+    for (std::size_t b = first; b < last; b++) {
+      if constexpr (stops_early) {
+        if (found.load(std::memory_order_relaxed)) {
+          return;
+        }
+      }
+
+      std::size_t offset = b * reduce_block_size;
+      auto block =
+          x.subspan(offset, std::min(reduce_block_size, x.size() - offset));
+      partials[b] = reduce_block<Summation>(block, reduce);
+
+      if constexpr (stops_early) {
+        if (bool(partials[b])) {
+          found.store(true, std::memory_order_relaxed);
+          return;
+        }
+      }
+    }
+  });
+
+  if constexpr (stops_early) {
+    if (found) {
+      return T(true);
+    }
+  }
+  return combine_partials<Summation, T>(std::span<const P>(partials), reduce);
+}
+
+} // namespace __detail
+
+} // namespace grb
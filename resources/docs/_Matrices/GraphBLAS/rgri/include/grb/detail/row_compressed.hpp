@@ -0,0 +1,168 @@
+#pragma once
+
+#include <algorithm>
+#include <grb/detail/concepts.hpp>
+#include <grb/detail/matrix_traits.hpp>
+#include <grb/experimental/sycl_tools/vector.hpp>
+#include <grb/util/index.hpp>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace grb {
+
+namespace __detail {
+
+// Gather the elements of any matrix range into CSR arrays with a counting
+// sort by row, in one pass over the range to count and one to fill.  Column
+// indices are sorted within each row afterwards if the range was not
+// row-major.
+template <MatrixRange M, typename IndexVector, typename ValueVector>
+void gather_csr(M&& matrix, IndexVector& rowptr, IndexVector& colind,
+                ValueVector& values) {
+  using I = std::remove_cvref_t<decltype(rowptr[0])>;
+  using T = std::remove_cvref_t<decltype(values[0])>;
+  I m = matrix.shape()[0];
+
+  rowptr.resize(m + 1);
+  std::fill(rowptr.begin(), rowptr.end(), I(0));
+
+  for (auto&& [index, _] : matrix) {
+    auto&& [i, j] = index;
+    ++rowptr[i + 1];
+  }
+
+  for (I i = 0; i < m; i++) {
+    rowptr[i + 1] += rowptr[i];
+  }
+
+  I nnz = rowptr[m];
+  colind.resize(nnz);
+  values.resize(nnz);
+
+  shp::vector<I> fill(rowptr.begin(), rowptr.end() - 1);
+  for (auto&& [index, value] : matrix) {
+    auto&& [i, j] = index;
+    I ptr = fill[i]++;
+    colind[ptr] = j;
+    values[ptr] = static_cast<T>(value);
+  }
+
+  // Row-major ranges come out sorted already; others (e.g. a transposed
+  // view of a non-CSR matrix) need each row sorted.
+  std::vector<std::pair<I, T>> row;
+  for (I i = 0; i < m; i++) {
+    auto first = colind.begin() + rowptr[i];
+    auto last = colind.begin() + rowptr[i + 1];
+    if (std::is_sorted(first, last)) {
+      continue;
+    }
+
+    row.clear();
+    for (I ptr = rowptr[i]; ptr < rowptr[i + 1]; ptr++) {
+      row.push_back({colind[ptr], values[ptr]});
+    }
+    std::sort(row.begin(), row.end(),
+              [](auto&& x, auto&& y) { return x.first < y.first; });
+    for (std::size_t k = 0; k < row.size(); k++) {
+      colind[rowptr[i] + k] = row[k].first;
+      values[rowptr[i] + k] = row[k].second;
+    }
+  }
+}
+
+// A `grb::matrix` whose backend can take CSR arrays wholesale.
+template <typename M>
+concept csr_assignable = requires(std::remove_cvref_t<M>& m) {
+  typename std::remove_cvref_t<M>::backend_type::index_vector_type;
+  m.backend().assign_csr(
+      std::declval<typename std::remove_cvref_t<
+          M>::backend_type::index_vector_type>(),
+      std::declval<typename std::remove_cvref_t<
+          M>::backend_type::index_vector_type>(),
+      std::declval<typename std::remove_cvref_t<
+          M>::backend_type::values_vector_type>());
+};
+
+// Read-only CSR arrays of an arbitrary matrix range, with column indices
+// sorted within each row.  A CSR-backed `grb::matrix` is borrowed as-is; any
+// other range (views, dense or COO backends) is gathered once into owned
+// arrays with a counting sort by row.
+template <typename T, std::integral I>
+class row_compressed {
+public:
+  using scalar_type = T;
+  using index_type = I;
+
+  row_compressed(grb::index<I> shape, std::span<const I> rowptr,
+                 std::span<const I> colind, std::span<const T> values)
+      : shape_(shape), rowptr_(rowptr), colind_(colind), values_(values) {}
+
+  template <MatrixRange M>
+  explicit row_compressed(M&& matrix) : shape_(matrix.shape()) {
+    gather_csr(std::forward<M>(matrix), rowptr_storage_, colind_storage_,
+               values_storage_);
+
+    rowptr_ = {rowptr_storage_.data(), rowptr_storage_.size()};
+    colind_ = {colind_storage_.data(), colind_storage_.size()};
+    values_ = {values_storage_.data(), values_storage_.size()};
+  }
+
+  // Moving keeps the spans valid: shp::vector moves its buffer.
+  row_compressed(row_compressed&&) = default;
+  row_compressed(const row_compressed&) = delete;
+  row_compressed& operator=(const row_compressed&) = delete;
+
+  grb::index<I> shape() const noexcept {
+    return shape_;
+  }
+
+  std::size_t size() const noexcept {
+    return colind_.size();
+  }
+
+  std::span<const I> rowptr() const noexcept {
+    return rowptr_;
+  }
+
+  std::span<const I> colind() const noexcept {
+    return colind_;
+  }
+
+  std::span<const T> values() const noexcept {
+    return values_;
+  }
+
+  I row_size(I i) const noexcept {
+    return rowptr_[i + 1] - rowptr_[i];
+  }
+
+private:
+  grb::index<I> shape_;
+  std::span<const I> rowptr_;
+  std::span<const I> colind_;
+  std::span<const T> values_;
+
+  shp::vector<I> rowptr_storage_;
+  shp::vector<I> colind_storage_;
+  shp::vector<T> values_storage_;
+};
+
+template <MatrixRange M>
+auto make_row_compressed(M&& matrix) {
+  using scalar_type = grb::matrix_scalar_t<M>;
+  using index_type = grb::matrix_index_t<M>;
+
+  if constexpr (requires { matrix.backend().rowptr(); }) {
+    auto&& backend = matrix.backend();
+    return row_compressed<scalar_type, index_type>(
+        matrix.shape(), backend.rowptr(), backend.colind(), backend.values());
+  } else {
+    return row_compressed<scalar_type, index_type>(std::forward<M>(matrix));
+  }
+}
+
+} // namespace __detail
+
+} // namespace grb
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace grb {
+
+namespace __detail {
+
+// Intersection of two sorted, duplicate-free index lists.  Each function
+// calls `f(i, j)` with the positions of every value with `a[i] == b[j]`, in
+// increasing order.
+//
+// intersect_sorted() picks a kernel: galloping when one list is much
+// shorter, otherwise a SIMD block intersection for 32- and 64-bit indices
+// when the translation unit is compiled with AVX2 or AVX-512 (e.g. with
+// `-march=native`), and a scalar merge for the rest.
+
+// Lists this many times longer than the other are searched, not merged.
+inline constexpr std::size_t gallop_ratio = 32;
+
+template <std::integral I, typename F>
+void intersect_sorted_scalar(const I* a, std::size_t a_size, const I* b,
+                             std::size_t b_size, F&& f) {
+  std::size_t i = 0;
+  std::size_t j = 0;
+  while (i < a_size && j < b_size) {
+    I x = a[i];
+    I y = b[j];
+    if (x == y) {
+      f(i, j);
+    }
+    // Branch-free advance: the comparisons are unpredictable.
+    i += x <= y;
+    j += y <= x;
+  }
+}
+
+// For each element of the short list `a`, an exponential then binary search
+// in the rest of `b`: O(|a| log(|b| / |a|)).
+template <std::integral I, typename F>
+void intersect_sorted_gallop(const I* a, std::size_t a_size, const I* b,
+                             std::size_t b_size, F&& f) {
+  std::size_t j = 0;
+  for (std::size_t i = 0; i < a_size && j < b_size; i++) {
+    I x = a[i];
+    std::size_t step = 1;
+    std::size_t hi = j;
+    while (hi < b_size && b[hi] < x) {
+      j = hi + 1;
+      hi += step;
+      step *= 2;
+    }
+    hi = hi < b_size ? hi : b_size;
+    while (j < hi) {
+      std::size_t mid = j + (hi - j) / 2;
+      if (b[mid] < x) {
+        j = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    if (j < b_size && b[j] == x) {
+      f(i, j);
+      j++;
+    }
+  }
+}
+
+// Block intersection: compare a block of `a` against every rotation of a
+// block of `b`, then drop whichever block ends first (both if they end on
+// the same value).  Only equality is tested in SIMD, so signed and unsigned
+// indices share a kernel.  `Simd` supplies the block width, `matches(a, b)`
+// (a bitmask of the lanes of block `a` found in block `b`) and
+// `lane_of(x, b)` (the lane of block `b` holding `x`).
+template <typename Simd, std::integral I, typename F>
+void intersect_sorted_blocks(const I* a, std::size_t a_size, const I* b,
+                             std::size_t b_size, F&& f) {
+  constexpr std::size_t width = Simd::width;
+  std::size_t i = 0;
+  std::size_t j = 0;
+  while (i + width <= a_size && j + width <= b_size) {
+    auto a_block = Simd::load(a + i);
+    auto b_block = Simd::load(b + j);
+    for (auto mask = Simd::matches(a_block, b_block); mask != 0;
+         mask &= mask - 1) {
+      std::size_t lane = std::countr_zero(mask);
+      f(i + lane, j + Simd::lane_of(a[i + lane], b_block));
+    }
+
+    I a_last = a[i + width - 1];
+    I b_last = b[j + width - 1];
+    i += a_last <= b_last ? width : 0;
+    j += b_last <= a_last ? width : 0;
+  }
+
+  intersect_sorted_scalar(a + i, a_size - i, b + j, b_size - j,
+                          [&](std::size_t x, std::size_t y) {
+                            f(i + x, j + y);
+                          });
+}
+
+#if defined(__AVX512F__)
+
+struct simd_epi32 {
+  static constexpr std::size_t width = 16;
+
+  static __m512i load(const void* p) noexcept {
+    return _mm512_loadu_si512(p);
+  }
+
+  static unsigned matches(__m512i a, __m512i b) noexcept {
+    __mmask16 mask = _mm512_cmpeq_epi32_mask(a, b);
+    for (int r = 1; r < 16; r++) {
+      b = _mm512_alignr_epi32(b, b, 1);
+      mask |= _mm512_cmpeq_epi32_mask(a, b);
+    }
+    return mask;
+  }
+
+  static std::size_t lane_of(std::uint32_t x, __m512i b) noexcept {
+    return std::countr_zero(unsigned(
+        _mm512_cmpeq_epi32_mask(_mm512_set1_epi32(int(x)), b)));
+  }
+};
+
+struct simd_epi64 {
+  static constexpr std::size_t width = 8;
+
+  static __m512i load(const void* p) noexcept {
+    return _mm512_loadu_si512(p);
+  }
+
+  static unsigned matches(__m512i a, __m512i b) noexcept {
+    __mmask8 mask = _mm512_cmpeq_epi64_mask(a, b);
+    for (int r = 1; r < 8; r++) {
+      b = _mm512_alignr_epi64(b, b, 1);
+      mask |= _mm512_cmpeq_epi64_mask(a, b);
+    }
+    return mask;
+  }
+
+  static std::size_t lane_of(std::uint64_t x, __m512i b) noexcept {
+    return std::countr_zero(unsigned(
+        _mm512_cmpeq_epi64_mask(_mm512_set1_epi64((long long)(x)), b)));
+  }
+};
+
+#elif defined(__AVX2__)
+
+struct simd_epi32 {
+  static constexpr std::size_t width = 8;
+
+  static __m256i load(const void* p) noexcept {
+    return _mm256_loadu_si256(static_cast<const __m256i*>(p));
+  }
+
+  static unsigned matches(__m256i a, __m256i b) noexcept {
+    const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+    __m256i found = _mm256_cmpeq_epi32(a, b);
+    for (int r = 1; r < 8; r++) {
+      b = _mm256_permutevar8x32_epi32(b, rotate);
+      found = _mm256_or_si256(found, _mm256_cmpeq_epi32(a, b));
+    }
+    return unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(found)));
+  }
+
+  static std::size_t lane_of(std::uint32_t x, __m256i b) noexcept {
+    __m256i found = _mm256_cmpeq_epi32(_mm256_set1_epi32(int(x)), b);
+    return std::countr_zero(
+        unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(found))));
+  }
+};
+
+struct simd_epi64 {
+  static constexpr std::size_t width = 4;
+
+  static __m256i load(const void* p) noexcept {
+    return _mm256_loadu_si256(static_cast<const __m256i*>(p));
+  }
+
+  static unsigned matches(__m256i a, __m256i b) noexcept {
+    __m256i found = _mm256_cmpeq_epi64(a, b);
+    for (int r = 1; r < 4; r++) {
+      b = _mm256_permute4x64_epi64(b, 0x39);
+      found = _mm256_or_si256(found, _mm256_cmpeq_epi64(a, b));
+    }
+    return unsigned(_mm256_movemask_pd(_mm256_castsi256_pd(found)));
+  }
+
+  static std::size_t lane_of(std::uint64_t x, __m256i b) noexcept {
+    __m256i x_block = _mm256_set1_epi64x((long long)(x));
+    __m256i found = _mm256_cmpeq_epi64(x_block, b);
+    return std::countr_zero(
+        unsigned(_mm256_movemask_pd(_mm256_castsi256_pd(found))));
+  }
+};
+
+#endif
+
+template <std::integral I, typename F>
+void intersect_sorted(const I* a, std::size_t a_size, const I* b,
+                      std::size_t b_size, F&& f) {
+  if (a_size == 0 || b_size == 0) {
+    return;
+  }
+
+  if (a_size * gallop_ratio < b_size) {
+    intersect_sorted_gallop(a, a_size, b, b_size, f);
+    return;
+  }
+  if (b_size * gallop_ratio < a_size) {
+    intersect_sorted_gallop(b, b_size, a, a_size,
+                            [&](std::size_t j, std::size_t i) { f(i, j); });
+    return;
+  }
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+  if constexpr (sizeof(I) == 4) {
+    intersect_sorted_blocks<simd_epi32>(a, a_size, b, b_size, f);
+    return;
+  } else if constexpr (sizeof(I) == 8) {
+    intersect_sorted_blocks<simd_epi64>(a, a_size, b, b_size, f);
+    return;
+  }
+#endif
+
+  intersect_sorted_scalar(a, a_size, b, b_size, f);
+}
+
+} // namespace __detail
+
+} // namespace grb
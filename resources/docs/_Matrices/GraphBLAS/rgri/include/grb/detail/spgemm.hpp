@@ -0,0 +1,449 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <grb/containers/matrix.hpp>
+#include <grb/detail/parallel.hpp>
+#include <grb/detail/row_compressed.hpp>
+#include <grb/experimental/sycl_tools/vector.hpp>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace grb {
+
+namespace __detail {
+
+// Sparse accumulator for one row of a Gustavson SpGEMM.
+//
+// Rows whose product count is a sizable fraction of the output width use a
+// dense array indexed by column, with a per-row stamp instead of clearing it.
+// Rows with few products relative to the width use a small open-addressing
+// hash table sized to the row, so very wide, very sparse outputs never touch
+// O(ncols) memory per row.
+template <typename T, std::integral I>
+class spgemm_accumulator {
+public:
+  // Rows with `flops * dense_ratio >= ncols` use the dense accumulator.
+  static constexpr std::size_t dense_ratio = 16;
+  static constexpr std::size_t min_hash_capacity = 16;
+
+  explicit spgemm_accumulator(I ncols) : ncols_(ncols) {}
+
+  // Start a new output row that receives at most `flops` products.
+  void start_row(std::size_t flops) {
+    touched_.clear();
+    dense_ = flops * dense_ratio >= std::size_t(ncols_);
+
+    if (dense_) {
+      if (stamps_.empty()) {
+        stamps_.assign(ncols_, 0);
+        dense_values_.resize(ncols_);
+      }
+      ++stamp_;
+    } else {
+      std::size_t capacity =
+          std::bit_ceil(std::max(2 * flops, min_hash_capacity));
+      hash_mask_ = capacity - 1;
+      hash_keys_.assign(capacity, empty_key);
+      hash_values_.resize(capacity);
+    }
+  }
+
+  // Restrict the current row to the columns `colind` whose mask value is
+  // truthy.  Must be called after `start_row`.  Mask columns past the output
+  // width are ignored.
+  template <typename MaskT>
+  void set_mask(std::span<const I> colind, std::span<const MaskT> values) {
+    if (mask_stamps_.empty()) {
+      mask_stamps_.assign(ncols_, 0);
+    }
+    ++mask_stamp_;
+    for (std::size_t k = 0; k < colind.size(); k++) {
+      if (colind[k] < ncols_ && bool(values[k])) {
+        mask_stamps_[colind[k]] = mask_stamp_;
+      }
+    }
+  }
+
+  bool allowed(I j) const noexcept {
+    return mask_stamps_[j] == mask_stamp_;
+  }
+
+  // Symbolic phase: record column `j` without a value.
+  void mark(I j) {
+    if (dense_) {
+      if (stamps_[j] != stamp_) {
+        stamps_[j] = stamp_;
+        touched_.push_back(j);
+      }
+    } else {
+      std::size_t slot = probe(j);
+      if (hash_keys_[slot] == empty_key) {
+        hash_keys_[slot] = j;
+        touched_.push_back(j);
+      }
+    }
+  }
+
+  // Numeric phase: the first product at `j` is stored as-is, later ones are
+  // folded in with `reduce`.
+  template <typename Reduce>
+  void accumulate(I j, const T& value, Reduce&& reduce) {
+    if (dense_) {
+      if (stamps_[j] != stamp_) {
+        stamps_[j] = stamp_;
+        dense_values_[j] = value;
+        touched_.push_back(j);
+      } else {
+        dense_values_[j] = reduce(dense_values_[j], value);
+      }
+    } else {
+      std::size_t slot = probe(j);
+      if (hash_keys_[slot] == empty_key) {
+        hash_keys_[slot] = j;
+        hash_values_[slot] = value;
+        touched_.push_back(j);
+      } else {
+        hash_values_[slot] = reduce(hash_values_[slot], value);
+      }
+    }
+  }
+
+  // Whether column `j` has been marked or accumulated in the current row.
+  bool contains(I j) const noexcept {
+    if (dense_) {
+      return stamps_[j] == stamp_;
+    } else {
+      return hash_keys_[probe(j)] == j;
+    }
+  }
+
+  // Number of distinct columns in the current row.
+  std::size_t size() const noexcept {
+    return touched_.size();
+  }
+
+  // Write the current row, sorted by column, to `colind` and `values`.
+  void flush(I* colind, T* values) {
+    std::sort(touched_.begin(), touched_.end());
+    for (std::size_t k = 0; k < touched_.size(); k++) {
+      I j = touched_[k];
+      colind[k] = j;
+      values[k] = dense_ ? dense_values_[j] : hash_values_[probe(j)];
+    }
+  }
+
+private:
+  static constexpr I empty_key = std::numeric_limits<I>::max();
+
+  std::size_t probe(I j) const noexcept {
+    std::size_t slot =
+        ((static_cast<std::size_t>(j) * 0x9E3779B97F4A7C15ull) >> 17) &
+        hash_mask_;
+    while (hash_keys_[slot] != empty_key && hash_keys_[slot] != j) {
+      slot = (slot + 1) & hash_mask_;
+    }
+    return slot;
+  }
+
+  I ncols_;
+  bool dense_ = true;
+  std::vector<I> touched_;
+
+  std::size_t stamp_ = 0;
+  std::vector<std::size_t> stamps_;
+  shp::vector<T> dense_values_;
+
+  std::size_t hash_mask_ = 0;
+  std::vector<I> hash_keys_;
+  shp::vector<T> hash_values_;
+
+  std::size_t mask_stamp_ = 0;
+  std::vector<std::size_t> mask_stamps_;
+};
+
+// Upper bound on the entries of row `i` of A * B: the number of products.
+template <typename AR, typename BR>
+std::size_t spgemm_row_flops(const AR& a, const BR& b,
+                             typename AR::index_type i) {
+  std::size_t flops = 0;
+  auto colind = a.colind();
+  for (auto ptr = a.rowptr()[i]; ptr < a.rowptr()[i + 1]; ptr++) {
+    flops += b.row_size(colind[ptr]);
+  }
+  return flops;
+}
+
+// Start row `i` in `acc`, applying row `i` of `*mask` unless `mask` is
+// `nullptr`.  Returns false if the row cannot have any entries.
+template <typename Acc, typename AR, typename BR, typename Mask>
+bool spgemm_start_row(Acc& acc, const AR& a, const BR& b, Mask mask,
+                      typename AR::index_type i) {
+  if constexpr (!std::is_same_v<Mask, std::nullptr_t>) {
+    if (mask->row_size(i) == 0) {
+      return false;
+    }
+  }
+
+  std::size_t flops = spgemm_row_flops(a, b, i);
+  if (flops == 0) {
+    return false;
+  }
+
+  acc.start_row(flops);
+
+  if constexpr (!std::is_same_v<Mask, std::nullptr_t>) {
+    auto begin = mask->rowptr()[i];
+    auto count = mask->row_size(i);
+    acc.set_mask(mask->colind().subspan(begin, count),
+                 mask->values().subspan(begin, count));
+  }
+  return true;
+}
+
+// Symbolic phase for row `i`: the exact number of entries in C(i, :).
+template <typename Acc, typename AR, typename BR, typename Mask>
+std::size_t spgemm_row_symbolic(Acc& acc, const AR& a, const BR& b,
+                                Mask mask, typename AR::index_type i) {
+  if (!spgemm_start_row(acc, a, b, mask, i)) {
+    return 0;
+  }
+
+  auto a_colind = a.colind();
+  auto b_colind = b.colind();
+  for (auto a_ptr = a.rowptr()[i]; a_ptr < a.rowptr()[i + 1]; a_ptr++) {
+    auto k = a_colind[a_ptr];
+    for (auto b_ptr = b.rowptr()[k]; b_ptr < b.rowptr()[k + 1]; b_ptr++) {
+      auto j = b_colind[b_ptr];
+      if constexpr (!std::is_same_v<Mask, std::nullptr_t>) {
+        if (!acc.allowed(j)) {
+          continue;
+        }
+      }
+      acc.mark(j);
+    }
+  }
+  return acc.size();
+}
+
+// Numeric phase for row `i`: write C(i, :), sorted by column, to `colind` and
+// `values`, which have room for the count the symbolic phase returned.
+template <typename Acc, typename AR, typename BR, typename Mask,
+          typename Reduce, typename Combine, typename I, typename T>
+void spgemm_row_numeric(Acc& acc, const AR& a, const BR& b, Mask mask,
+                        typename AR::index_type i, Reduce&& reduce,
+                        Combine&& combine, I* colind, T* values) {
+  if (!spgemm_start_row(acc, a, b, mask, i)) {
+    return;
+  }
+
+  auto a_colind = a.colind();
+  auto a_values = a.values();
+  auto b_colind = b.colind();
+  auto b_values = b.values();
+  for (auto a_ptr = a.rowptr()[i]; a_ptr < a.rowptr()[i + 1]; a_ptr++) {
+    auto k = a_colind[a_ptr];
+    auto&& a_v = a_values[a_ptr];
+    for (auto b_ptr = b.rowptr()[k]; b_ptr < b.rowptr()[k + 1]; b_ptr++) {
+      auto j = b_colind[b_ptr];
+      if constexpr (!std::is_same_v<Mask, std::nullptr_t>) {
+        if (!acc.allowed(j)) {
+          continue;
+        }
+      }
+      acc.accumulate(j, static_cast<T>(combine(a_v, b_values[b_ptr])),
+                     reduce);
+    }
+  }
+  acc.flush(colind, values);
+}
+
+// Split the rows of A * B into contiguous ranges of about equal flop count
+// (not row count: a few rows of a power-law graph can hold most of the work),
+// one per worker.  Returns the `workers + 1` range bounds.
+template <typename AR, typename BR>
+std::vector<std::size_t> spgemm_partition(const AR& a, const BR& b,
+                                          std::size_t max_workers) {
+  using I = typename AR::index_type;
+  I m = a.shape()[0];
+
+  if (max_workers <= 1 || m == 0) {
+    return {0, std::size_t(m)};
+  }
+
+  std::vector<std::size_t> flops(m + 1, 0);
+  std::size_t flop_workers = num_workers(a.size(), max_workers);
+  auto a_bounds = balanced_partition(a.rowptr(), flop_workers);
+  parallel_for_workers(flop_workers, [&](std::size_t worker) {
+    for (auto i = a_bounds[worker]; i < a_bounds[worker + 1]; i++) {
+      flops[i + 1] = spgemm_row_flops(a, b, I(i));
+    }
+  });
+  for (I i = 0; i < m; i++) {
+    flops[i + 1] += flops[i];
+  }
+
+  std::size_t workers = num_workers(flops[m], max_workers);
+  return balanced_partition(std::span<const std::size_t>(flops), workers);
+}
+
+// Row-wise (Gustavson) sparse matrix times sparse matrix, C<M> = A * B.
+// A symbolic pass sizes every row of C exactly, so the numeric pass writes
+// straight into C's final CSR arrays.  `mask` points to a row_compressed
+// mask, or is `nullptr` for no mask.
+//
+// With `max_workers > 1`, rows are split with spgemm_partition().  Each
+// worker owns its accumulator and writes only its own rows of C, so no
+// locking is needed.
+template <typename T, std::integral I, typename AR, typename BR,
+          typename Mask, typename Reduce, typename Combine>
+grb::matrix<T, I> gustavson_multiply(const AR& a, const BR& b,
+                                     Mask mask, Reduce&& reduce,
+                                     Combine&& combine,
+                                     std::size_t max_workers = 1) {
+  using csr_type = typename grb::matrix<T, I>::backend_type;
+
+  I m = a.shape()[0];
+  I n = b.shape()[1];
+
+  auto bounds = spgemm_partition(a, b, max_workers);
+  std::size_t workers = bounds.size() - 1;
+
+  typename csr_type::index_vector_type rowptr(m + 1);
+  rowptr[0] = 0;
+  parallel_for_workers(workers, [&](std::size_t worker) {
+    spgemm_accumulator<T, I> acc(n);
+    for (auto i = bounds[worker]; i < bounds[worker + 1]; i++) {
+      rowptr[i + 1] = I(spgemm_row_symbolic(acc, a, b, mask, I(i)));
+    }
+  });
+  for (I i = 0; i < m; i++) {
+    rowptr[i + 1] += rowptr[i];
+  }
+
+  typename csr_type::index_vector_type colind(rowptr[m]);
+  typename csr_type::values_vector_type values(rowptr[m]);
+  parallel_for_workers(workers, [&](std::size_t worker) {
+    spgemm_accumulator<T, I> acc(n);
+    for (auto i = bounds[worker]; i < bounds[worker + 1]; i++) {
+      spgemm_row_numeric(acc, a, b, mask, I(i), reduce, combine,
+                         colind.data() + rowptr[i], values.data() + rowptr[i]);
+    }
+  });
+
+  grb::matrix<T, I> c(grb::index<I>(m, n));
+  c.backend().assign_csr(std::move(rowptr), std::move(colind),
+                         std::move(values));
+  return c;
+}
+
+// Fused C<M> (accumulate)= A * B for a CSR-backed matrix `c`: each row of the
+// product is merged with the same row of `c` as soon as it is computed,
+// applying `accumulate` where both have an element, so no product matrix is
+// ever built.  With `merge`, elements of `c` without a product are kept;
+// otherwise the result has exactly the product's sparsity pattern (GraphBLAS
+// "replace").  Products are computed in type `T`.  New CSR arrays are built
+// and then swapped into `c`, so `c` may also be `a` or `b`.
+template <typename T, typename CMatrix, typename AR, typename BR,
+          typename Mask, typename Reduce, typename Combine,
+          typename Accumulate>
+void gustavson_multiply_accumulate(CMatrix& c, const AR& a, const BR& b,
+                                   Mask mask, Reduce&& reduce,
+                                   Combine&& combine, Accumulate&& accumulate,
+                                   bool merge, std::size_t max_workers = 1) {
+  using csr_type = typename std::remove_cvref_t<CMatrix>::backend_type;
+  using S = typename csr_type::scalar_type;
+  using I = typename csr_type::index_type;
+  using AI = typename AR::index_type;
+
+  auto&& c_backend = c.backend();
+  auto c_rowptr = c_backend.rowptr();
+  auto c_colind = c_backend.colind();
+  auto c_values = c_backend.values();
+
+  I m = a.shape()[0];
+  I n = b.shape()[1];
+
+  auto bounds = spgemm_partition(a, b, max_workers);
+  std::size_t workers = bounds.size() - 1;
+
+  // Symbolic: the product's row sizes, and the merged row sizes.
+  std::vector<std::size_t> product_sizes(m);
+  typename csr_type::index_vector_type rowptr(m + 1);
+  rowptr[0] = 0;
+  parallel_for_workers(workers, [&](std::size_t worker) {
+    spgemm_accumulator<T, AI> acc(n);
+    for (auto i = bounds[worker]; i < bounds[worker + 1]; i++) {
+      std::size_t t = spgemm_row_symbolic(acc, a, b, mask, AI(i));
+      std::size_t size = t;
+      if (merge) {
+        for (auto ptr = c_rowptr[i]; ptr < c_rowptr[i + 1]; ptr++) {
+          if (t == 0 || !acc.contains(AI(c_colind[ptr]))) {
+            size++;
+          }
+        }
+      }
+      product_sizes[i] = t;
+      rowptr[i + 1] = I(size);
+    }
+  });
+  for (I i = 0; i < m; i++) {
+    rowptr[i + 1] += rowptr[i];
+  }
+
+  // Numeric: compute each product row into a buffer, then merge it with
+  // the row of `c` straight into the new arrays.
+  typename csr_type::index_vector_type colind(rowptr[m]);
+  typename csr_type::values_vector_type values(rowptr[m]);
+  parallel_for_workers(workers, [&](std::size_t worker) {
+    spgemm_accumulator<T, AI> acc(n);
+    std::vector<AI> t_colind;
+    shp::vector<T> t_values;
+    for (auto i = bounds[worker]; i < bounds[worker + 1]; i++) {
+      std::size_t t = product_sizes[i];
+      t_colind.resize(t);
+      t_values.resize(t);
+      if (t > 0) {
+        spgemm_row_numeric(acc, a, b, mask, AI(i), reduce, combine,
+                           t_colind.data(), t_values.data());
+      }
+
+      std::size_t out = rowptr[i];
+      std::size_t k = 0;
+      auto ptr = c_rowptr[i];
+      auto row_end = c_rowptr[i + 1];
+      while (k < t || (merge && ptr < row_end)) {
+        // Skip elements of `c` left behind by the product.
+        while (!merge && ptr < row_end && AI(c_colind[ptr]) < t_colind[k]) {
+          ptr++;
+        }
+
+        if (k < t && (ptr == row_end || t_colind[k] < AI(c_colind[ptr]))) {
+          colind[out] = I(t_colind[k]);
+          values[out] = static_cast<S>(t_values[k]);
+          k++;
+        } else if (k < t && t_colind[k] == AI(c_colind[ptr])) {
+          colind[out] = I(t_colind[k]);
+          values[out] =
+              static_cast<S>(accumulate(S(c_values[ptr]), t_values[k]));
+          k++;
+          ptr++;
+        } else {
+          colind[out] = c_colind[ptr];
+          values[out] = c_values[ptr];
+          ptr++;
+        }
+        out++;
+      }
+    }
+  });
+
+  c_backend.assign_csr(std::move(rowptr), std::move(colind),
+                       std::move(values));
+}
+
+} // namespace __detail
+
+} // namespace grb
@@ -0,0 +1,277 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <grb/containers/backend/compact_row_index.hpp>
+#include <grb/containers/functional/op_definitions.hpp>
+#include <grb/containers/vector.hpp>
+#include <grb/containers/views/full_vector_view.hpp>
+#include <grb/containers/views/transpose_matrix.hpp>
+#include <grb/util/index.hpp>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace grb {
+
+namespace __detail {
+
+// One compressed dimension of a matrix.  The elements of row (or column) i
+// are at positions [ptr[i], ptr[i + 1]) of `ind`, which holds their column
+// (or row) indices.  Their values are `values[position[k]]`, or `values[k]`
+// when `position` is empty.
+template <typename T, std::integral I>
+struct compressed_axis {
+  std::span<const I> ptr;
+  std::span<const I> ind;
+  std::span<const T> values;
+  std::span<const std::size_t> position;
+
+  const T& value(std::size_t k) const noexcept {
+    return position.empty() ? values[k] : values[position[k]];
+  }
+};
+
+// Row and column access to a matrix, without copying its elements.
+// `compact`, if not null, is a compact copy of the structure of `rows`.
+template <typename T, std::integral I>
+struct row_column_access {
+  grb::index<I> shape;
+  std::size_t nnz;
+  compressed_axis<T, I> rows;
+  compressed_axis<T, I> columns;
+  const compact_row_index* compact = nullptr;
+};
+
+template <typename M>
+concept column_indexed_matrix = requires(const M& m) {
+  m.backend().rowptr();
+  m.backend().column_index();
+};
+
+template <typename M>
+struct is_transpose_view : std::false_type {};
+
+template <typename M>
+struct is_transpose_view<grb::transpose_matrix_view<M>> : std::true_type {};
+
+// CSR-backed matrices, and transposed views of them, can be traversed by row
+// and by column: the columns come from the backend's cached column index.
+template <typename M>
+concept row_column_accessible =
+    column_indexed_matrix<std::remove_cvref_t<M>> ||
+    (is_transpose_view<std::remove_cvref_t<M>>::value &&
+     column_indexed_matrix<typename std::remove_cvref_t<M>::matrix_type>);
+
+template <row_column_accessible M>
+auto make_row_column_access(const M& matrix) {
+  using scalar_type = grb::matrix_scalar_t<M>;
+  using index_type = grb::matrix_index_t<M>;
+  using access_type = row_column_access<scalar_type, index_type>;
+
+  if constexpr (column_indexed_matrix<std::remove_cvref_t<M>>) {
+    auto&& backend = matrix.backend();
+    auto columns = backend.column_index();
+    return access_type{matrix.shape(),
+                       backend.colind().size(),
+                       {backend.rowptr(), backend.colind(), backend.values()},
+                       {columns.colptr, columns.rowind, backend.values(),
+                        columns.position},
+                       &backend.compact_index()};
+  } else {
+    // The rows of a transpose are the columns of its base, and vice versa.
+    auto base = make_row_column_access(matrix.base());
+    return access_type{matrix.shape(), base.nnz, base.columns, base.rows};
+  }
+}
+
+template <typename M>
+struct is_full_vector_mask : std::false_type {};
+
+template <typename I>
+struct is_full_vector_mask<grb::full_vector_mask<I>> : std::true_type {};
+
+template <typename M>
+inline constexpr bool is_full_vector_mask_v =
+    is_full_vector_mask<std::remove_cvref_t<M>>::value;
+
+template <typename M, typename I>
+bool mask_allows(const M& mask, I i) {
+  if constexpr (is_full_vector_mask_v<M>) {
+    return true;
+  } else {
+    auto iter = mask.find(i);
+    return iter != mask.end() && bool(grb::get<1>(*iter));
+  }
+}
+
+template <typename Reduce>
+struct is_take_left : std::false_type {};
+
+template <typename T>
+struct is_take_left<grb::take_left<T>> : std::true_type {};
+
+// With `take_left` as the reduction, a row's result is its first product, so
+// the pull kernel can stop at the first match.
+template <typename Reduce>
+inline constexpr bool has_early_exit_v =
+    is_take_left<std::remove_cvref_t<Reduce>>::value;
+
+// Storage hint of the output of a matrix-vector product: the same as the
+// input vector's, so a sparse frontier gives a sparse result.
+template <typename V>
+struct spmv_output_hint {
+  using type = grb::dense;
+};
+
+template <typename V>
+  requires requires { typename std::remove_cvref_t<V>::hint_type; }
+struct spmv_output_hint<V> {
+  using type = typename std::remove_cvref_t<V>::hint_type;
+};
+
+template <typename V>
+using spmv_output_hint_t = typename spmv_output_hint<V>::type;
+
+enum class spmv_direction { push, pull };
+
+// Pull when the push kernel would touch more than 1 / `pull_ratio` of the
+// elements the pull kernel scans (Beamer et al., direction-optimizing BFS).
+// Pushed products are scattered and sorted, so a plain pull already wins at
+// twice the push work; with an early exit the pull kernel usually scans only
+// a small part of each row, as in a BFS step.
+inline constexpr std::size_t pull_ratio = 2;
+inline constexpr std::size_t early_exit_pull_ratio = 14;
+
+template <typename T, typename I, typename B, typename M>
+spmv_direction choose_spmv_direction(const row_column_access<T, I>& a,
+                                     const B& b, const M& mask,
+                                     bool early_exit) {
+  std::size_t m = a.shape[0];
+  std::size_t n = a.shape[1];
+
+  std::size_t push_work = 0;
+  for (auto&& [k, _] : b) {
+    push_work += 1 + a.columns.ptr[k + 1] - a.columns.ptr[k];
+  }
+
+  // The pull kernel visits every row and gathers `b`, then scans the rows
+  // the mask allows; the mask's size stands in for the number allowed.
+  std::size_t rows = m;
+  if constexpr (!is_full_vector_mask_v<M>) {
+    rows = std::min<std::size_t>(mask.size(), m);
+  }
+  std::size_t pull_work = m + n + (m > 0 ? a.nnz * rows / m : 0);
+
+  std::size_t ratio = early_exit ? early_exit_pull_ratio : pull_ratio;
+  return push_work * ratio > pull_work ? spmv_direction::pull
+                                       : spmv_direction::push;
+}
+
+// Push: every stored b(k) is multiplied down column k of `a`.  Costs time in
+// proportion to the columns touched, plus a sort of their products; no
+// O(rows) work is done.
+template <typename C, typename T, typename I, typename B, typename Reduce,
+          typename Combine, typename M>
+C spmv_push(const row_column_access<T, I>& a, const B& b, Reduce&& reduce,
+            Combine&& combine, const M& mask) {
+  using c_scalar_type = grb::vector_scalar_t<C>;
+  using c_index_type = grb::vector_index_t<C>;
+
+  std::vector<std::pair<c_index_type, c_scalar_type>> products;
+  for (auto&& [k, b_v] : b) {
+    for (auto ptr = a.columns.ptr[k]; ptr < a.columns.ptr[k + 1]; ptr++) {
+      products.push_back(
+          {a.columns.ind[ptr], combine(a.columns.value(ptr), b_v)});
+    }
+  }
+
+  // Stable, so each row's products stay in column order, the order in which
+  // the pull kernel reduces them.
+  std::stable_sort(products.begin(), products.end(),
+                   [](auto&& x, auto&& y) { return x.first < y.first; });
+
+  C c(a.shape[0]);
+  for (std::size_t first = 0; first < products.size();) {
+    c_index_type i = products[first].first;
+    std::size_t last = first + 1;
+    while (last < products.size() && products[last].first == i) {
+      last++;
+    }
+
+    if (mask_allows(mask, i)) {
+      c_scalar_type sum = products[first].second;
+      for (std::size_t k = first + 1; k < last; k++) {
+        sum = reduce(sum, products[k].second);
+      }
+      c.insert({i, sum});
+    }
+    first = last;
+  }
+  return c;
+}
+
+// Pull: a dot product of `b` with every row of `a` the mask allows.  `b` is
+// gathered into a dense array first so each probe is O(1).  Rows are read
+// from the compact index when `a` has one.
+template <typename C, typename T, typename I, typename B, typename Reduce,
+          typename Combine, typename M>
+C spmv_pull(const row_column_access<T, I>& a, const B& b, Reduce&& reduce,
+            Combine&& combine, const M& mask) {
+  using b_scalar_type = grb::vector_scalar_t<B>;
+  using c_scalar_type = grb::vector_scalar_t<C>;
+  using c_index_type = grb::vector_index_t<C>;
+
+  std::vector<b_scalar_type> b_values(a.shape[1]);
+  std::vector<char> present(a.shape[1], false);
+  for (auto&& [k, b_v] : b) {
+    b_values[k] = b_v;
+    present[k] = true;
+  }
+
+  C c(a.shape[0]);
+  visit_rows(a.compact, a.rows.ptr, a.rows.ind, [&](auto&& rows) {
+    for (I i = 0; i < a.shape[0]; i++) {
+      if (!mask_allows(mask, i)) {
+        continue;
+      }
+
+      c_scalar_type sum{};
+      bool found = false;
+      rows.for_each_in_row(i, [&](auto k, std::size_t ptr) {
+        if (present[k]) {
+          c_scalar_type v = combine(a.rows.value(ptr), b_values[k]);
+          sum = found ? reduce(sum, v) : v;
+          found = true;
+          return !has_early_exit_v<Reduce>;
+        }
+        return true;
+      });
+
+      if (found) {
+        c.insert({c_index_type(i), sum});
+      }
+    }
+  });
+  return c;
+}
+
+template <typename C, typename T, typename I, typename B, typename Reduce,
+          typename Combine, typename M>
+C direction_optimizing_spmv(const row_column_access<T, I>& a, const B& b,
+                            Reduce&& reduce, Combine&& combine,
+                            const M& mask) {
+  auto direction =
+      choose_spmv_direction(a, b, mask, has_early_exit_v<Reduce>);
+  if (direction == spmv_direction::push) {
+    return spmv_push<C>(a, b, reduce, combine, mask);
+  } else {
+    return spmv_pull<C>(a, b, reduce, combine, mask);
+  }
+}
+
+} // namespace __detail
+
+} // namespace grb
@@ -103,6 +103,12 @@ public:
   vector& operator=(vector&& other) noexcept
     requires(std::is_trivially_move_constructible_v<T>)
   {
+    if (this == &other) {
+      return *this;
+    }
+    if (data_ != nullptr) {
+      allocator_.deallocate(data_, capacity());
+    }
     data_ = other.data_;
     other.data_ = nullptr;
     size_ = other.size_;
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <concepts>
 #include <grb/containers/matrix.hpp>
 #include <grb/containers/vector.hpp>
@@ -5,6 +6,8 @@
 #include <grb/util/matrix_hints.hpp>
 #include <random>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace grb {
 
@@ -90,4 +93,62 @@ grb::vector<T, I, Hint> generate_random(I shape, double density = 0.01) {
   return vector;
 }
 
+/// Generate the adjacency matrix of a directed R-MAT graph with
+/// `2^scale` vertices and about `edge_factor * 2^scale` edges (duplicate
+/// edges and self loops are dropped).  Each edge picks one quadrant of the
+/// matrix with probabilities `a`, `b`, `c` and `1 - a - b - c`, `scale`
+/// times over, which yields the skewed degree distribution of real-world
+/// graphs.  The defaults are the Graph500 parameters.  Every stored value is
+/// `1`.
+template <typename T = float, std::integral I = std::size_t,
+          typename Hint = grb::sparse>
+grb::matrix<T, I, Hint> generate_rmat(std::size_t scale,
+                                      std::size_t edge_factor = 16,
+                                      unsigned int seed = 0, double a = 0.57,
+                                      double b = 0.19, double c = 0.19) {
+  if (a < 0 || b < 0 || c < 0 || a + b + c > 1.0) {
+    throw grb::invalid_argument("generate_rmat: invalid probabilities.");
+  }
+
+  std::size_t n = std::size_t(1) << scale;
+  std::size_t edges = edge_factor * n;
+
+  std::mt19937_64 gen(seed);
+  std::uniform_real_distribution<double> quadrant(0, 1);
+
+  std::vector<std::pair<I, I>> indices;
+  indices.reserve(edges);
+  for (std::size_t e = 0; e < edges; e++) {
+    std::size_t i = 0;
+    std::size_t j = 0;
+    for (std::size_t bit = n >> 1; bit > 0; bit >>= 1) {
+      double r = quadrant(gen);
+      if (r >= a + b + c) {
+        i |= bit;
+        j |= bit;
+      } else if (r >= a + b) {
+        i |= bit;
+      } else if (r >= a) {
+        j |= bit;
+      }
+    }
+    if (i != j) {
+      indices.push_back({I(i), I(j)});
+    }
+  }
+
+  std::sort(indices.begin(), indices.end());
+  indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+  std::vector<grb::matrix_entry<T, I>> tuples;
+  tuples.reserve(indices.size());
+  for (auto&& [i, j] : indices) {
+    tuples.push_back({{i, j}, T(1)});
+  }
+
+  grb::matrix<T, I, Hint> matrix({I(n), I(n)});
+  matrix.insert(tuples.begin(), tuples.end());
+  return matrix;
+}
+
 } // namespace grb
@@ -1,10 +1,19 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <grb/containers/backend/adaptive_vector.hpp>
+#include <grb/containers/backend/bitmap_vector.hpp>
 #include <grb/containers/backend/coo_matrix.hpp>
 #include <grb/containers/backend/csr_matrix.hpp>
+#include <grb/containers/backend/dense_vector.hpp>
 #include <grb/containers/backend/dia_matrix.hpp>
+#include <grb/containers/backend/sparse_vector.hpp>
 #include <grb/containers/matrix_entry.hpp>
+#include <grb/detail/matrix_traits.hpp>
 #include <grb/detail/pack_includes.hpp>
+#include <type_traits>
+#include <vector>
 
 namespace grb {
 
@@ -13,6 +22,8 @@ struct dense {};
 struct row {};
 struct column {};
 struct coordinate {};
+struct bitmap {};
+struct diagonal {};
 
 template <typename... Hints>
 struct compose {
@@ -37,6 +48,14 @@ struct pick_backend_type<coordinate> {
   using type = grb::coo_matrix<Args...>;
 };
 
+// Banded matrices: each diagonal holding an element is a contiguous array
+// (see `prefers_diagonal_storage()` below).
+template <>
+struct pick_backend_type<diagonal> {
+  template <typename... Args>
+  using type = grb::dia_matrix<Args...>;
+};
+
 template <>
 struct pick_backend_type<dense> {
   template <typename... Args>
@@ -70,6 +89,88 @@ struct pick_backend_type<compose<Hints...>,
   using type = grb::coo_matrix<Args...>;
 };
 
+/// Whether `a` would take fewer bytes as a `grb::diagonal` (DIA) matrix than
+/// as a `grb::sparse` (CSR) one.  A DIA matrix stores every slot of each
+/// diagonal holding an element, but no column indices or row pointers, so
+/// it wins when the elements fill most of few diagonals, as in banded and
+/// Toeplitz-like matrices.  Matrix-vector products stream the whole
+/// structure, so they are faster in whichever format is smaller.
+///
+/// The backend is fixed by the hint when a matrix is declared, so this
+/// is meant for picking the hint of a matrix to be built from `a`, e.g.
+/// before copying a matrix read from a file into a `grb::diagonal` one.
+template <typename A>
+bool prefers_diagonal_storage(const A& a) {
+  using T = grb::matrix_scalar_t<A>;
+  using I = grb::matrix_index_t<A>;
+
+  // Bookkeeping per stored diagonal (map node and array headers).
+  constexpr std::size_t diagonal_overhead = 128;
+
+  std::size_t m = a.shape()[0];
+  std::size_t n = a.shape()[1];
+  if (m == 0 || n == 0) {
+    return false;
+  }
+
+  // Diagonal j - i is at position j - i + m - 1.
+  std::vector<char> used(m + n - 1, false);
+  std::size_t nnz = 0;
+  for (auto&& [index, _] : a) {
+    auto&& [i, j] = index;
+    used[std::size_t(j) + m - 1 - std::size_t(i)] = true;
+    nnz++;
+  }
+
+  std::size_t dia_bytes = 0;
+  for (std::size_t d = 0; d < used.size(); d++) {
+    if (used[d]) {
+      std::size_t first_row = d < m - 1 ? m - 1 - d : 0;
+      std::size_t first_column = d > m - 1 ? d - (m - 1) : 0;
+      std::size_t length = std::min(m - first_row, n - first_column);
+      dia_bytes += length * sizeof(T) + (length + 7) / 8 +
+                   diagonal_overhead;
+    }
+  }
+  std::size_t csr_bytes = nnz * (sizeof(T) + sizeof(I)) + (m + 1) * sizeof(I);
+  return dia_bytes < csr_bytes;
+}
+
+// Vector backends: `dense` is a value array with a flag per index, `sparse`
+// sorted indices, and `bitmap` a value array with a packed bitset.  A
+// composition of `sparse` and `bitmap` switches between the two by fill
+// ratio.
+template <typename T, typename Enabler = void>
+struct pick_vector_backend_type;
+
+template <>
+struct pick_vector_backend_type<dense> {
+  template <typename... Args>
+  using type = grb::dense_vector<Args...>;
+};
+
+template <>
+struct pick_vector_backend_type<sparse> {
+  template <typename... Args>
+  using type = grb::sparse_vector<Args...>;
+};
+
+template <>
+struct pick_vector_backend_type<bitmap> {
+  template <typename... Args>
+  using type = grb::bitmap_vector<Args...>;
+};
+
+template <typename... Hints>
+struct pick_vector_backend_type<
+    compose<Hints...>,
+    std::enable_if_t<
+        compose<Hints...>::template includes<grb::sparse>::value &&
+        compose<Hints...>::template includes<grb::bitmap>::value>> {
+  template <typename... Args>
+  using type = grb::adaptive_vector<Args...>;
+};
+
 // Current logic: if one of the matrices is dense,
 // pick dense. Otherwise, sparse.
 template <typename T, typename U, typename Enabler = void>
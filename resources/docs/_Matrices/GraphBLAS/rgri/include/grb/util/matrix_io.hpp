@@ -3,13 +3,30 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cctype>
+#include <charconv>
+#include <climits>
+#include <cstring>
 #include <fstream>
+#include <iterator>
+#include <limits>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <tuple>
+#include <type_traits>
 #include <vector>
 
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include <grb/containers/backend/coo_matrix.hpp>
+#include <grb/detail/parallel.hpp>
+#include <grb/experimental/sycl_tools/vector.hpp>
 
 namespace grb {
 
@@ -204,129 +221,471 @@ private:
   bool is_symmetric_ = false;
 };
 
-/// Read in the Matrix Market file at location `file_path` and a return
-/// a coo_matrix data structure with its contents.
-template <typename T, typename I = std::size_t>
-inline coo_matrix<T, I> mmread(std::string file_path, bool one_indexed = true) {
-  using index_type = I;
-  using size_type = std::size_t;
+namespace __detail {
+
+// Read-only view of a whole file, memory-mapped where the platform has
+// mmap() and read into memory otherwise.
+class mapped_file {
+public:
+  explicit mapped_file(const std::string& path) {
+#if __has_include(<sys/mman.h>)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error("mmread: cannot open " + path);
+    }
+    struct stat status;
+    if (::fstat(fd, &status) != 0) {
+      ::close(fd);
+      throw std::runtime_error("mmread: cannot stat " + path);
+    }
+    size_ = status.st_size;
+    if (size_ > 0) {
+      void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      ::close(fd);
+      if (data == MAP_FAILED) {
+        throw std::runtime_error("mmread: cannot map " + path);
+      }
+      // Each thread reads its chunk front to back.
+      ::madvise(data, size_, MADV_SEQUENTIAL);
+      data_ = static_cast<const char*>(data);
+    } else {
+      ::close(fd);
+    }
+#else
+    std::ifstream f(path, std::ios::binary);
+    if (!f.is_open()) {
+      throw std::runtime_error("mmread: cannot open " + path);
+    }
+    buffer_.assign(std::istreambuf_iterator<char>(f),
+                   std::istreambuf_iterator<char>());
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#endif
+  }
 
-  std::ifstream f;
+  ~mapped_file() {
+#if __has_include(<sys/mman.h>)
+    if (data_ != nullptr) {
+      ::munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+  }
 
-  f.open(file_path.c_str());
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
 
-  if (!f.is_open()) {
-    // TODO better choice of exception.
-    throw std::runtime_error("mmread: cannot open " + file_path);
+  std::string_view view() const noexcept {
+    return {data_, size_};
   }
 
-  std::string buf;
-
-  // Make sure the file is matrix market matrix, coordinate, and check whether
-  // it is symmetric. If the matrix is symmetric, non-diagonal elements will
-  // be inserted in both (i, j) and (j, i).  Error out if skew-symmetric or
-  // Hermitian.
-  std::getline(f, buf);
-  std::istringstream ss(buf);
-  std::string item;
-  ss >> item;
-  if (item != "%%MatrixMarket") {
-    throw std::runtime_error(file_path +
-                             " could not be parsed as a Matrix Market file.");
+private:
+  const char* data_ = nullptr;
+  std::size_t size_ = 0;
+#if !__has_include(<sys/mman.h>)
+  std::string buffer_;
+#endif
+};
+
+struct mm_header {
+  std::size_t m = 0;
+  std::size_t n = 0;
+  std::size_t nnz = 0;
+  bool pattern = false;
+  bool symmetric = false;
+  // Offset of the first line after the size line.
+  std::size_t body = 0;
+};
+
+inline const char* mm_skip_blanks(const char* p, const char* end) noexcept {
+  while (p != end && (*p == ' ' || *p == '\t')) {
+    ++p;
   }
-  ss >> item;
-  if (item != "matrix") {
-    throw std::runtime_error(file_path +
-                             " could not be parsed as a Matrix Market file.");
+  return p;
+}
+
+// Parse a number starting at `p` (after blanks), returning the position
+// after it, or nullptr if there is none.
+template <typename U>
+const char* mm_parse_number(const char* p, const char* end, U& value) {
+  p = mm_skip_blanks(p, end);
+  if (p != end && *p == '+') {
+    ++p;
   }
-  ss >> item;
-  if (item != "coordinate") {
-    throw std::runtime_error(file_path +
+
+  if constexpr (std::is_floating_point_v<U>) {
+    auto [ptr, ec] = std::from_chars(p, end, value);
+    return ec == std::errc() ? ptr : nullptr;
+  } else if constexpr (std::is_arithmetic_v<U>) {
+    // Integer (or pattern-like bool) matrices are sometimes stored as
+    // "real"; fall back to parsing a double.
+    long long integer;
+    auto [ptr, ec] = std::from_chars(p, end, integer);
+    if (ec == std::errc() &&
+        (ptr == end || (*ptr != '.' && *ptr != 'e' && *ptr != 'E'))) {
+      value = static_cast<U>(integer);
+      return ptr;
+    }
+    double real;
+    auto [real_ptr, real_ec] = std::from_chars(p, end, real);
+    if (real_ec != std::errc()) {
+      return nullptr;
+    }
+    value = static_cast<U>(real);
+    return real_ptr;
+  } else {
+    const char* token_end = p;
+    while (token_end != end &&
+           !std::isspace(static_cast<unsigned char>(*token_end))) {
+      ++token_end;
+    }
+    std::istringstream ss(std::string(p, token_end));
+    if (!(ss >> value)) {
+      return nullptr;
+    }
+    return token_end;
+  }
+}
+
+inline std::string_view mm_line(std::string_view file, std::size_t& offset) {
+  std::size_t end = file.find('\n', offset);
+  if (end == std::string_view::npos) {
+    end = file.size();
+  }
+  std::string_view line = file.substr(offset, end - offset);
+  offset = std::min(end + 1, file.size());
+  return line;
+}
+
+// Parse the banner and size line.  Only coordinate matrices with a
+// "general" or "symmetric" layout are supported; for symmetric matrices,
+// off-diagonal elements are inserted at both (i, j) and (j, i).
+inline mm_header mm_read_header(std::string_view file,
+                                const std::string& path) {
+  mm_header header;
+  std::size_t offset = 0;
+
+  std::istringstream ss{std::string(mm_line(file, offset))};
+  std::vector<std::string> items;
+  for (std::string item; ss >> item;) {
+    std::transform(item.begin(), item.end(), item.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    items.push_back(item);
+  }
+
+  if (items.size() < 5 || items[0] != "%%matrixmarket" ||
+      items[1] != "matrix" || items[2] != "coordinate") {
+    throw std::runtime_error(path +
                              " could not be parsed as a Matrix Market file.");
   }
-  bool pattern;
-  ss >> item;
-  if (item == "pattern") {
-    pattern = true;
-  } else {
-    pattern = false;
+  header.pattern = items[3] == "pattern";
+  if (items[3] == "complex") {
+    throw std::runtime_error(path + " has an unsupported matrix type");
   }
-  // TODO: do something with real vs. integer vs. pattern?
-  ss >> item;
-  bool symmetric;
-  if (item == "general") {
-    symmetric = false;
-  } else if (item == "symmetric") {
-    symmetric = true;
+  if (items[4] == "general") {
+    header.symmetric = false;
+  } else if (items[4] == "symmetric") {
+    header.symmetric = true;
   } else {
-    throw std::runtime_error(file_path + " has an unsupported matrix type");
+    throw std::runtime_error(path + " has an unsupported matrix type");
   }
 
-  bool outOfComments = false;
-  while (!outOfComments) {
-    std::getline(f, buf);
-
-    if (buf[0] != '%') {
-      outOfComments = true;
+  std::string_view line;
+  do {
+    if (offset == file.size()) {
+      throw std::runtime_error(path + " has no size line.");
     }
+    line = mm_line(file, offset);
+  } while (line.empty() || line[0] == '%' ||
+           line.find_first_not_of(" \t\r") == std::string_view::npos);
+
+  const char* p = line.data();
+  const char* end = line.data() + line.size();
+  p = mm_parse_number(p, end, header.m);
+  p = p ? mm_parse_number(p, end, header.n) : nullptr;
+  p = p ? mm_parse_number(p, end, header.nnz) : nullptr;
+  if (p == nullptr) {
+    throw std::runtime_error(path + " has an invalid size line.");
   }
 
-  I m, n, nnz;
-  // std::istringstream ss(buf);
-  ss.clear();
-  ss.str(buf);
-  ss >> m >> n >> nnz;
+  header.body = offset;
+  return header;
+}
 
-  // NOTE for symmetric matrices: `nnz` holds the number of stored values in
-  // the matrix market file, while `matrix.nnz_` will hold the total number of
-  // stored values (including "mirrored" symmetric values).
-  coo_matrix<T, I> matrix({m, n});
-  if (symmetric) {
-    matrix.reserve(2 * nnz);
-  } else {
-    matrix.reserve(nnz);
+template <typename T, typename I>
+struct mm_entry {
+  I i;
+  I j;
+  T v;
+};
+
+// Parse the entries of a Matrix Market file on `workers` threads.  The body
+// is split into chunks at line boundaries, one per worker.  Worker `w`
+// appends each entry to `buckets[w][i / rows_per_block]`, so every bucket
+// holds its entries in file order.
+template <typename T, typename I>
+std::vector<std::vector<std::vector<mm_entry<T, I>>>>
+mm_parse_entries(std::string_view file, const mm_header& header,
+                 bool one_indexed, std::size_t rows_per_block,
+                 std::size_t blocks, std::size_t workers,
+                 const std::string& path) {
+  std::vector<std::vector<std::vector<mm_entry<T, I>>>> buckets(
+      workers, std::vector<std::vector<mm_entry<T, I>>>(blocks));
+
+  std::string_view body = file.substr(header.body);
+  std::vector<std::size_t> bounds(workers + 1, body.size());
+  bounds[0] = 0;
+  for (std::size_t w = 1; w < workers; w++) {
+    // Start after the first newline at or past the even split point.
+    std::size_t start = body.size() * w / workers;
+    std::size_t newline = body.find('\n', std::max<std::size_t>(start, 1) - 1);
+    bounds[w] = newline == std::string_view::npos ? body.size() : newline + 1;
+    bounds[w] = std::max(bounds[w], bounds[w - 1]);
   }
-  /*
-    TODO: reserve? (for general and for symmetric)
-  */
-
-  size_type c = 0;
-  while (std::getline(f, buf)) {
-    I i, j;
-    T v;
-    std::istringstream ss(buf);
-    if (!pattern) {
-      ss >> i >> j >> v;
-    } else {
-      ss >> i >> j;
-      v = T(1);
-    }
-    if (one_indexed) {
-      i--;
-      j--;
+
+  std::vector<std::size_t> lines(workers, 0);
+
+  __detail::parallel_for_workers(workers, [&](std::size_t w) {
+    auto&& my_buckets = buckets[w];
+    std::size_t reserve = (bounds[w + 1] - bounds[w]) / 16 / blocks;
+    for (auto&& bucket : my_buckets) {
+      bucket.reserve(reserve);
     }
 
-    if (i >= m || j >= n) {
-      throw std::runtime_error(
-          "read_MatrixMarket: file has nonzero out of bounds.");
+    auto emit = [&](I i, I j, const T& v) {
+      my_buckets[i / rows_per_block].push_back({i, j, v});
+    };
+
+    const char* p = body.data() + bounds[w];
+    const char* chunk_end = body.data() + bounds[w + 1];
+    while (p < chunk_end) {
+      const char* line_end = static_cast<const char*>(
+          std::memchr(p, '\n', chunk_end - p));
+      if (line_end == nullptr) {
+        line_end = chunk_end;
+      }
+
+      const char* q = mm_skip_blanks(p, line_end);
+      if (q == line_end || *q == '%' || *q == '\r') {
+        p = line_end + 1;
+        continue;
+      }
+
+      std::size_t i, j;
+      T v = T(1);
+      q = mm_parse_number(q, line_end, i);
+      q = q ? mm_parse_number(q, line_end, j) : nullptr;
+      if (q && !header.pattern) {
+        q = mm_parse_number(q, line_end, v);
+      }
+      if (q == nullptr) {
+        throw std::runtime_error("read_MatrixMarket: cannot parse line \"" +
+                                 std::string(p, line_end) + "\" in " + path);
+      }
+
+      if (one_indexed) {
+        i--;
+        j--;
+      }
+      if (i >= header.m || j >= header.n) {
+        throw std::runtime_error(
+            "read_MatrixMarket: file has nonzero out of bounds.");
+      }
+
+      emit(I(i), I(j), v);
+      if (header.symmetric && i != j) {
+        emit(I(j), I(i), v);
+      }
+      lines[w]++;
+      p = line_end + 1;
     }
+  });
+
+  std::size_t total = 0;
+  for (auto&& count : lines) {
+    total += count;
+  }
+  if (total > header.nnz) {
+    throw std::runtime_error("read_MatrixMarket: error reading Matrix Market "
+                             "file, file has more nonzeros than reported.");
+  }
+
+  return buckets;
+}
+
+// CSR arrays read from a Matrix Market file (see mmread_csr()).
+template <typename T, typename I>
+struct mm_csr {
+  grb::index<I> shape;
+  shp::vector<I> rowptr;
+  shp::vector<I> colind;
+  shp::vector<T> values;
+};
 
-    matrix.push_back({{i, j}, v});
+/// Read the Matrix Market file at `file_path` straight into CSR arrays.
+/// The file is memory-mapped and parsed with `std::from_chars` on up to
+/// `grb::max_threads()` threads, then the entries are placed with a counting
+/// sort on row index, one block of rows per task.  Column indices are sorted
+/// within each row; of duplicate entries, the first in the file is kept.
+template <typename T, typename I>
+mm_csr<T, I> mmread_csr(std::string file_path, bool one_indexed = true) {
+  mapped_file file(file_path);
+  auto header = mm_read_header(file.view(), file_path);
+
+  if (header.m + 1 > std::size_t(std::numeric_limits<I>::max()) ||
+      header.n + 1 > std::size_t(std::numeric_limits<I>::max()) ||
+      header.nnz * (header.symmetric ? 2 : 1) >
+          std::size_t(std::numeric_limits<I>::max())) {
+    throw std::runtime_error(file_path + ": dimensions too big for " +
+                             std::to_string(sizeof(I) * CHAR_BIT) +
+                             "-bit integer");
+  }
 
-    if (symmetric && i != j) {
-      matrix.push_back({{j, i}, v});
+  std::size_t body_size = file.view().size() - header.body;
+  std::size_t workers = num_workers(body_size);
+  std::size_t blocks = std::clamp<std::size_t>(
+      8 * workers, 1, std::max<std::size_t>(header.m, 1));
+  std::size_t rows_per_block =
+      std::max<std::size_t>((header.m + blocks - 1) / blocks, 1);
+
+  auto buckets = mm_parse_entries<T, I>(file.view(), header, one_indexed,
+                                        rows_per_block, blocks, workers,
+                                        file_path);
+
+  std::vector<std::size_t> block_offsets(blocks + 1, 0);
+  for (std::size_t b = 0; b < blocks; b++) {
+    block_offsets[b + 1] = block_offsets[b];
+    for (std::size_t w = 0; w < workers; w++) {
+      block_offsets[b + 1] += buckets[w][b].size();
     }
+  }
+  std::size_t nnz = block_offsets[blocks];
+
+  mm_csr<T, I> csr{{I(header.m), I(header.n)},
+                   shp::vector<I>(header.m + 1),
+                   shp::vector<I>(nnz),
+                   shp::vector<T>(nnz)};
+  csr.rowptr[0] = 0;
+
+  // Blocks own disjoint rows, so each one counts, places, and sorts its
+  // rows without synchronization.  Visiting workers in order keeps entries
+  // within a row in file order before the (stable) sort.
+  std::vector<std::size_t> duplicates(workers, 0);
+  __detail::parallel_for_workers(workers, [&](std::size_t w) {
+    std::vector<std::size_t> cursor;
+    std::vector<std::pair<I, T>> row;
+
+    for (std::size_t b = w; b < blocks; b += workers) {
+      std::size_t first_row = std::min(b * rows_per_block, header.m);
+      std::size_t last_row = std::min(first_row + rows_per_block, header.m);
+
+      cursor.assign(last_row - first_row, 0);
+      for (std::size_t k = 0; k < workers; k++) {
+        for (auto&& entry : buckets[k][b]) {
+          cursor[entry.i - first_row]++;
+        }
+      }
 
-    c++;
-    if (c > nnz) {
-      throw std::runtime_error("read_MatrixMarket: error reading Matrix Market "
-                               "file, file has more nonzeros than reported.");
+      std::size_t offset = block_offsets[b];
+      for (std::size_t r = first_row; r < last_row; r++) {
+        std::size_t count = cursor[r - first_row];
+        cursor[r - first_row] = offset;
+        offset += count;
+        csr.rowptr[r + 1] = I(offset);
+      }
+
+      for (std::size_t k = 0; k < workers; k++) {
+        for (auto&& entry : buckets[k][b]) {
+          std::size_t ptr = cursor[entry.i - first_row]++;
+          csr.colind[ptr] = entry.j;
+          csr.values[ptr] = entry.v;
+        }
+        std::vector<mm_entry<T, I>>().swap(buckets[k][b]);
+      }
+
+      // rowptr[first_row] belongs to the previous block, which another
+      // worker may not have written yet.
+      std::size_t row_begin = block_offsets[b];
+      for (std::size_t r = first_row; r < last_row; r++) {
+        std::size_t row_end = csr.rowptr[r + 1];
+        auto first = csr.colind.begin() + row_begin;
+        auto last = csr.colind.begin() + row_end;
+        if (!std::is_sorted(first, last)) {
+          row.clear();
+          for (std::size_t ptr = row_begin; ptr < row_end; ptr++) {
+            row.push_back({csr.colind[ptr], csr.values[ptr]});
+          }
+          std::stable_sort(row.begin(), row.end(), [](auto&& x, auto&& y) {
+            return x.first < y.first;
+          });
+          for (std::size_t k = 0; k < row.size(); k++) {
+            csr.colind[row_begin + k] = row[k].first;
+            csr.values[row_begin + k] = row[k].second;
+          }
+        }
+        duplicates[w] += (std::adjacent_find(first, last) != last);
+        row_begin = row_end;
+      }
+    }
+  });
+
+  // Duplicate entries are rare (and not valid Matrix Market), so squeeze
+  // them out with a serial pass only when there are some.
+  if (std::any_of(duplicates.begin(), duplicates.end(),
+                  [](std::size_t d) { return d > 0; })) {
+    std::size_t out = 0;
+    std::size_t row_begin = 0;
+    for (std::size_t r = 0; r < header.m; r++) {
+      std::size_t row_end = csr.rowptr[r + 1];
+      std::size_t row_out = out;
+      for (std::size_t ptr = row_begin; ptr < row_end; ptr++) {
+        if (out > row_out && csr.colind[out - 1] == csr.colind[ptr]) {
+          continue;
+        }
+        csr.colind[out] = csr.colind[ptr];
+        csr.values[out] = csr.values[ptr];
+        out++;
+      }
+      row_begin = row_end;
+      csr.rowptr[r + 1] = I(out);
     }
+    csr.colind.resize(out);
+    csr.values.resize(out);
   }
 
-  // std::sort(matrix.matrix_.begin(), matrix.matrix_.end(), sort_fn);
+  return csr;
+}
+
+} // namespace __detail
 
-  f.close();
+/// Read in the Matrix Market file at location `file_path` and a return
+/// a coo_matrix data structure with its contents, in file order.  The file
+/// is memory-mapped and parsed on up to `grb::max_threads()` threads.
+template <typename T, typename I = std::size_t>
+inline coo_matrix<T, I> mmread(std::string file_path, bool one_indexed = true) {
+  __detail::mapped_file file(file_path);
+  auto header = __detail::mm_read_header(file.view(), file_path);
+
+  std::size_t body_size = file.view().size() - header.body;
+  std::size_t workers = __detail::num_workers(body_size);
+  auto buckets = __detail::mm_parse_entries<T, I>(
+      file.view(), header, one_indexed, std::max<std::size_t>(header.m, 1), 1,
+      workers, file_path);
+
+  // NOTE for symmetric matrices: `nnz` holds the number of stored values in
+  // the matrix market file, while `matrix.nnz_` will hold the total number of
+  // stored values (including "mirrored" symmetric values).
+  coo_matrix<T, I> matrix({I(header.m), I(header.n)});
+  std::size_t size = 0;
+  for (auto&& worker_buckets : buckets) {
+    size += worker_buckets[0].size();
+  }
+  matrix.reserve(size);
+
+  for (auto&& worker_buckets : buckets) {
+    for (auto&& entry : worker_buckets[0]) {
+      matrix.push_back({{entry.i, entry.j}, entry.v});
+    }
+  }
 
   return matrix;
 }
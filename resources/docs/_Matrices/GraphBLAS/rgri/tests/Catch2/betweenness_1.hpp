@@ -0,0 +1,159 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <execution>
+#include <grb/grb.hpp>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Brandes' algorithm, one BFS per source, on adjacency lists built from the
+// matrix.
+template <typename M>
+auto reference_betweenness(const M& a,
+                           const std::vector<std::size_t>& sources) {
+  std::size_t n = a.shape()[0];
+  std::vector<std::vector<std::size_t>> edges(n);
+  for (auto&& [index, _] : a) {
+    auto&& [i, j] = index;
+    edges[i].push_back(j);
+  }
+
+  std::vector<double> centrality(n, 0);
+  for (auto source : sources) {
+    std::vector<long> depth(n, -1);
+    std::vector<double> sigma(n, 0);
+    std::vector<double> delta(n, 0);
+    std::vector<std::size_t> order;
+
+    std::queue<std::size_t> queue;
+    depth[source] = 0;
+    sigma[source] = 1;
+    queue.push(source);
+    while (!queue.empty()) {
+      auto v = queue.front();
+      queue.pop();
+      order.push_back(v);
+      for (auto w : edges[v]) {
+        if (depth[w] < 0) {
+          depth[w] = depth[v] + 1;
+          queue.push(w);
+        }
+        if (depth[w] == depth[v] + 1) {
+          sigma[w] += sigma[v];
+        }
+      }
+    }
+
+    for (auto iter = order.rbegin(); iter != order.rend(); ++iter) {
+      auto v = *iter;
+      for (auto w : edges[v]) {
+        if (depth[w] == depth[v] + 1) {
+          delta[v] += sigma[v] / sigma[w] * (1 + delta[w]);
+        }
+      }
+      if (v != source) {
+        centrality[v] += delta[v];
+      }
+    }
+  }
+  return centrality;
+}
+
+template <typename V>
+bool centrality_matches(V&& c, const std::vector<double>& expected) {
+  if (std::size_t(c.size()) != expected.size()) {
+    return false;
+  }
+  for (auto&& [index, value] : c) {
+    double tolerance = 1e-9 * std::max(1.0, std::abs(expected[index]));
+    if (std::abs(value - expected[index]) > tolerance) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+TEST_CASE("batched betweenness centrality matches Brandes",
+          "[betweenness]") {
+  // Directed, with self-loops and vertices that reach nothing.
+  auto a = grb::generate_rmat<int, std::size_t>(8, 8, 6);
+  std::size_t n = a.shape()[0];
+
+  std::vector<std::size_t> all(n);
+  for (std::size_t v = 0; v < n; v++) {
+    all[v] = v;
+  }
+  auto exact = reference_betweenness(a, all);
+
+  // More vertices than fit in one batch.
+  REQUIRE(centrality_matches(grb::betweenness_centrality(a), exact));
+
+  std::vector<std::size_t> sources = {0, 3, 3, 17, 200, 255};
+  auto expected = reference_betweenness(a, sources);
+  REQUIRE(centrality_matches(grb::betweenness_centrality(a, sources),
+                             expected));
+
+  for (std::size_t threads : {1, 3}) {
+    grb::set_max_threads(threads);
+    REQUIRE(centrality_matches(
+        grb::betweenness_centrality(std::execution::par, a, sources),
+        expected));
+    REQUIRE(centrality_matches(
+        grb::betweenness_centrality(std::execution::par, a), exact));
+  }
+  grb::set_max_threads(0);
+
+  // Sampling every vertex is exact.
+  REQUIRE(centrality_matches(grb::approximate_betweenness_centrality(a, n),
+                             exact));
+
+  // A sample is scaled up by n / samples.
+  auto estimate = grb::approximate_betweenness_centrality(a, 32, 7);
+  double total = 0;
+  for (auto&& [_, value] : estimate) {
+    total += value;
+  }
+  REQUIRE(total > 0);
+  REQUIRE(std::size_t(estimate.size()) == n);
+
+  // Undirected: both directions of each path count.
+  auto symmetric = grb::ewise_union(a, grb::transpose(a), grb::plus{});
+  std::vector<std::size_t> some = {1, 2, 4, 8};
+  REQUIRE(centrality_matches(grb::betweenness_centrality(symmetric, some),
+                             reference_betweenness(symmetric, some)));
+}
+
+TEST_CASE("betweenness centrality on small graphs", "[betweenness]") {
+  // 0 - 1 - 2, and 3 joined to 1 and 2 by two paths 3 -> {4, 5} -> 1.
+  grb::matrix<int, int> a({6, 6});
+  std::vector<std::pair<int, int>> edges = {{0, 1}, {1, 2}, {3, 4},
+                                            {3, 5}, {4, 1}, {5, 1}};
+  for (auto [i, j] : edges) {
+    a[{i, j}] = 1;
+    a[{j, i}] = 1;
+  }
+
+  auto c = grb::betweenness_centrality(a);
+  REQUIRE(centrality_matches(c, reference_betweenness(
+                                    a, {0, 1, 2, 3, 4, 5})));
+  // 1 is on every path from 0 or 2 to another vertex, and on half of those
+  // between 4 and 5; half of the paths from 3 to {0, 1, 2} go through 4.
+  REQUIRE(c[1] == 2 * (1 + 3 + 3 + 0.5));
+  REQUIRE(c[4] == 2 * 1.5);
+
+  REQUIRE_THROWS_AS(grb::betweenness_centrality(a, std::vector<int>{6}),
+                    grb::out_of_range);
+  REQUIRE_THROWS_AS(grb::approximate_betweenness_centrality(a, 0),
+                    grb::invalid_argument);
+
+  grb::matrix<int, int> rectangular({3, 4});
+  REQUIRE_THROWS_AS(grb::betweenness_centrality(rectangular),
+                    grb::invalid_argument);
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <execution>
+#include <grb/grb.hpp>
+#include <variant>
+#include <vector>
+
+namespace {
+
+// The compact index lists the same columns, at the same positions, as the
+// CSR arrays.
+template <typename M>
+bool compact_rows_match(const M& matrix) {
+  auto&& backend = matrix.backend();
+  auto rowptr = backend.rowptr();
+  auto colind = backend.colind();
+
+  bool match = true;
+  grb::__detail::visit_rows(
+      &backend.compact_index(), rowptr, colind, [&](auto&& rows) {
+        for (std::size_t i = 0; i + 1 < rowptr.size(); i++) {
+          std::size_t next = rowptr[i];
+          rows.for_each_in_row(i, [&](auto j, std::size_t ptr) {
+            match = match && ptr == next && std::size_t(colind[ptr]) == j;
+            ++next;
+            return true;
+          });
+          match = match && next == std::size_t(rowptr[i + 1]);
+        }
+      });
+  return match;
+}
+
+} // namespace
+
+TEMPLATE_TEST_CASE("csr_matrix compact row index",
+                   "[matrix][compact][template]", int, std::size_t) {
+  using I = TestType;
+
+  auto a = grb::generate_rmat<float, I>(12, 16, 3);
+  grb::vector<float, I> x(a.shape()[1]);
+  for (I j = 0; j < a.shape()[1]; j++) {
+    x[j] = float(j % 7) + 1;
+  }
+  auto sparse_x = grb::generate_random<float, I>(a.shape()[1], 0.05);
+  auto mask = grb::generate_random<int, I>(a.shape()[0], 0.3);
+
+  auto y = grb::multiply(a, x);
+  auto y_par = grb::multiply(std::execution::par, a, x);
+  auto y_sparse = grb::multiply(a, sparse_x);
+  auto y_masked = grb::multiply(a, x, grb::plus{}, grb::times{}, mask);
+
+  for (auto compression :
+       {grb::index_compression::narrow, grb::index_compression::delta}) {
+    a.backend().build_compact_index(compression);
+
+    // 32-bit indices are already narrow.
+    bool expect_index = sizeof(I) > sizeof(std::uint32_t) ||
+                        compression == grb::index_compression::delta;
+    REQUIRE(a.backend().has_compact_index() == expect_index);
+    REQUIRE(compact_rows_match(a));
+
+    REQUIRE(same_elements(grb::multiply(a, x), y));
+    REQUIRE(same_elements(grb::multiply(std::execution::par, a, x), y_par));
+    REQUIRE(same_elements(grb::multiply(a, sparse_x), y_sparse));
+    REQUIRE(same_elements(
+        grb::multiply(a, x, grb::plus{}, grb::times{}, mask), y_masked));
+
+    // Copies keep the index.
+    auto b = a;
+    REQUIRE(b.backend().has_compact_index() == expect_index);
+    REQUIRE(compact_rows_match(b));
+  }
+
+  // Writing values keeps the index; changing the sparsity pattern drops it
+  // once the new element is merged.
+  a.backend().build_compact_index(grb::index_compression::delta);
+  auto&& [index, _] = *a.begin();
+  a[index] = 2;
+  REQUIRE(a.backend().has_compact_index());
+  a[{a.shape()[0] - 1, 0}] = 1;
+  a.wait();
+  REQUIRE(!a.backend().has_compact_index());
+}
+
+TEMPLATE_TEST_CASE("delta-encoded rows with wide gaps",
+                   "[matrix][compact][template]", int, std::size_t) {
+  using I = TestType;
+
+  // Gaps of one, gaps too wide for 16 bits, and the first and last columns.
+  I n = 300000;
+  grb::matrix<int, I> a({4, n});
+  std::vector<I> columns = {0, 1, 2, 65535, 65536, 65537, 200000, n - 1};
+  for (auto j : columns) {
+    a[{0, j}] = int(j % 100) + 1;
+    a[{2, n - 1 - j}] = 1;
+  }
+  a[{3, 65536}] = 5;
+  a.wait();
+
+  a.backend().build_compact_index(grb::index_compression::delta);
+  REQUIRE(a.backend().has_compact_index());
+  REQUIRE(compact_rows_match(a));
+
+  // Rows 0 and 2 each have six one-word gaps and two three-word escapes;
+  // row 3's only column is 65537 past -1.
+  auto&& rows = std::get<grb::__detail::delta_rows<std::uint32_t>>(
+      a.backend().compact_index());
+  REQUIRE(rows.gaps.size() == 2 * (6 + 2 * 3) + 3);
+
+  grb::vector<int, I> x(n);
+  for (I j = 0; j < n; j += 3) {
+    x[j] = 1;
+  }
+  a.backend().clear_compact_index();
+  auto y = grb::multiply(a, x);
+  a.backend().build_compact_index(grb::index_compression::delta);
+  REQUIRE(same_elements(grb::multiply(a, x), y));
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <execution>
+#include <grb/grb.hpp>
+#include <map>
+#include <random>
+#include <utility>
+
+namespace {
+
+template <typename V>
+auto vector_values(V&& v) {
+  std::map<std::size_t, grb::vector_scalar_t<V>> elements;
+  for (auto&& [index, value] : v) {
+    elements[index] = value;
+  }
+  return elements;
+}
+
+// The same banded matrix as DIA and as CSR: `bandwidth` full diagonals on
+// each side of the main one, plus one diagonal with gaps.  Whole-number
+// values keep float sums exact in any order.
+template <typename T>
+auto banded_pair(std::size_t m, std::size_t n, std::ptrdiff_t bandwidth,
+                 unsigned seed) {
+  grb::matrix<T, int, grb::diagonal> dia({int(m), int(n)});
+  grb::matrix<T, int> csr({int(m), int(n)});
+
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> value(1, 9);
+  for (std::size_t i = 0; i < m; i++) {
+    for (std::ptrdiff_t k = -bandwidth; k <= bandwidth + 3; k++) {
+      std::ptrdiff_t j = std::ptrdiff_t(i) + k;
+      bool gap = k == bandwidth + 3 && i % 3 != 0;
+      if (j >= 0 && std::size_t(j) < n && (k <= bandwidth || !gap)) {
+        T v = T(value(gen));
+        dia[{int(i), int(j)}] = v;
+        csr[{int(i), int(j)}] = v;
+      }
+    }
+  }
+  return std::pair{std::move(dia), std::move(csr)};
+}
+
+} // namespace
+
+TEST_CASE("dia_matrix backend", "[matrix][dia]") {
+  grb::matrix<int, int, grb::diagonal> a({4, 5});
+  a[{0, 0}] = 1;
+  a[{1, 2}] = 2;
+  a[{3, 0}] = 3;
+  a[{2, 4}] = 4;
+  a[{1, 2}] = 5;
+
+  REQUIRE(a.size() == 4);
+  using elements = std::map<std::pair<std::size_t, std::size_t>, int>;
+  REQUIRE(matrix_elements(a) ==
+          elements{{{0, 0}, 1}, {{1, 2}, 5}, {{3, 0}, 3}, {{2, 4}, 4}});
+
+  const auto& c = a;
+  REQUIRE(c.find({2, 4}) != c.end());
+  REQUIRE(grb::get<1>(*c.find({2, 4})) == 4);
+  REQUIRE(c.find({2, 3}) == c.end());
+  REQUIRE(c.find({0, 1}) == c.end());
+
+  REQUIRE(std::distance(c.begin(), c.end()) == 4);
+
+  auto [inserted, success] = a.insert({{0, 0}, 9});
+  REQUIRE(!success);
+  REQUIRE(grb::get<1>(*inserted) == 1);
+
+  a.reshape({3, 5});
+  REQUIRE(matrix_elements(a) ==
+          elements{{{0, 0}, 1}, {{1, 2}, 5}, {{2, 4}, 4}});
+
+  grb::matrix<int, int, grb::diagonal> empty({3, 3});
+  REQUIRE(empty.begin() == empty.end());
+}
+
+TEMPLATE_TEST_CASE("dia matrix-vector multiply matches CSR",
+                   "[multiply][dia][template]", int, float) {
+  using T = TestType;
+
+  for (auto [m, n] : {std::pair{300, 300}, {200, 350}, {350, 200}}) {
+    auto [dia, csr] = banded_pair<T>(m, n, 2, m + n);
+
+    grb::vector<T, int> dense(n);
+    grb::vector<T, int> sparse(n);
+    for (std::size_t j = 0; j < std::size_t(n); j++) {
+      dense[j] = T(j % 7 + 1);
+      if (j % 5 == 0) {
+        sparse[j] = T(j % 3 + 1);
+      }
+    }
+
+    grb::vector<bool, int> mask(m);
+    for (std::size_t i = 0; i < std::size_t(m); i += 2) {
+      mask[i] = true;
+    }
+
+    for (auto* x : {&dense, &sparse}) {
+      auto expected = vector_values(grb::multiply(csr, *x));
+      REQUIRE(vector_values(grb::multiply(dia, *x)) == expected);
+
+      REQUIRE(vector_values(grb::multiply(dia, *x, grb::min{}, grb::plus{})) ==
+              vector_values(grb::multiply(csr, *x, grb::min{}, grb::plus{})));
+
+      REQUIRE(vector_values(grb::multiply(dia, *x, grb::plus{},
+                                          grb::multiplies{}, mask)) ==
+              vector_values(grb::multiply(csr, *x, grb::plus{},
+                                          grb::multiplies{}, mask)));
+
+      for (std::size_t threads : {1, 3}) {
+        grb::set_max_threads(threads);
+        REQUIRE(vector_values(grb::multiply(std::execution::par, dia, *x)) ==
+                expected);
+      }
+      grb::set_max_threads(0);
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("dia times dia matches CSR", "[multiply][dia][template]",
+                   int, float) {
+  using T = TestType;
+
+  auto [a_dia, a_csr] = banded_pair<T>(120, 90, 2, 1);
+  auto [b_dia, b_csr] = banded_pair<T>(90, 150, 1, 2);
+
+  auto c = grb::multiply(a_dia, b_dia);
+  static_assert(
+      std::is_same_v<typename decltype(c)::hint_type, grb::diagonal>);
+  REQUIRE(c.shape() == grb::index<int>{120, 150});
+  REQUIRE(matrix_elements(c) == matrix_elements(grb::multiply(a_csr, b_csr)));
+
+  auto min_plus = grb::multiply(a_dia, b_dia, grb::min{}, grb::plus{});
+  auto csr_min_plus = grb::multiply(a_csr, b_csr, grb::min{}, grb::plus{});
+  REQUIRE(matrix_elements(min_plus) == matrix_elements(csr_min_plus));
+
+  for (std::size_t threads : {1, 3}) {
+    grb::set_max_threads(threads);
+    REQUIRE(matrix_elements(grb::multiply(std::execution::par, a_dia, b_dia)) ==
+            matrix_elements(c));
+  }
+  grb::set_max_threads(0);
+
+  // Mixed backends go through CSR.
+  REQUIRE(matrix_elements(grb::multiply(a_dia, b_csr)) == matrix_elements(c));
+}
+
+TEST_CASE("prefers_diagonal_storage", "[dia]") {
+  auto [dia, csr] = banded_pair<float>(1000, 1000, 3, 0);
+  REQUIRE(grb::prefers_diagonal_storage(csr));
+  REQUIRE(grb::prefers_diagonal_storage(dia));
+
+  auto rmat = grb::generate_rmat<float, int>(10, 8, 0);
+  REQUIRE(!grb::prefers_diagonal_storage(rmat));
+
+  grb::matrix<float, int> empty({0, 0});
+  REQUIRE(!grb::prefers_diagonal_storage(empty));
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <grb/grb.hpp>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// `size` distinct sorted values drawn from [0, range).
+template <typename I>
+std::vector<I> sorted_sample(std::size_t size, std::size_t range,
+                             std::mt19937& gen) {
+  std::vector<I> all(range);
+  for (std::size_t k = 0; k < range; k++) {
+    all[k] = I(k);
+  }
+  std::shuffle(all.begin(), all.end(), gen);
+  all.resize(std::min(size, range));
+  std::sort(all.begin(), all.end());
+  return all;
+}
+
+template <typename I>
+auto intersection_positions(const std::vector<I>& a, const std::vector<I>& b,
+                            bool dispatched) {
+  std::vector<std::pair<std::size_t, std::size_t>> positions;
+  auto record = [&](std::size_t i, std::size_t j) {
+    positions.push_back({i, j});
+  };
+  if (dispatched) {
+    grb::__detail::intersect_sorted(a.data(), a.size(), b.data(), b.size(),
+                                    record);
+  } else {
+    grb::__detail::intersect_sorted_scalar(a.data(), a.size(), b.data(),
+                                           b.size(), record);
+  }
+  return positions;
+}
+
+} // namespace
+
+TEMPLATE_TEST_CASE("sorted-set intersection kernels",
+                   "[ewise][intersection][template]", std::int16_t, int,
+                   std::uint32_t, std::int64_t, std::size_t) {
+  using I = TestType;
+
+  std::mt19937 gen(0);
+
+  // Sizes around the SIMD block widths, and ratios on both sides of the
+  // galloping threshold.
+  for (std::size_t a_size : {0, 1, 3, 4, 7, 8, 9, 16, 17, 33, 100, 1000}) {
+    for (std::size_t b_size : {0, 1, 5, 8, 15, 16, 31, 64, 200, 5000}) {
+      std::size_t dense = std::max(a_size, b_size);
+      for (std::size_t range : {dense, 2 * (a_size + b_size), dense + 10000}) {
+        auto a = sorted_sample<I>(a_size, range, gen);
+        auto b = sorted_sample<I>(b_size, range, gen);
+
+        auto expected = intersection_positions(a, b, false);
+        for (auto&& [i, j] : expected) {
+          REQUIRE(a[i] == b[j]);
+        }
+        REQUIRE(expected.size() ==
+                std::size_t(std::count_if(a.begin(), a.end(), [&](I x) {
+                  return std::binary_search(b.begin(), b.end(), x);
+                })));
+
+        REQUIRE(intersection_positions(a, b, true) == expected);
+
+        std::vector<std::pair<std::size_t, std::size_t>> gallop;
+        grb::__detail::intersect_sorted_gallop(
+            a.data(), a.size(), b.data(), b.size(),
+            [&](std::size_t i, std::size_t j) { gallop.push_back({i, j}); });
+        REQUIRE(gallop == expected);
+      }
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("ewise merges at several densities",
+                   "[ewise][template]", int, std::size_t) {
+  using I = TestType;
+
+  for (double density : {0.001, 0.01, 0.1, 0.5}) {
+    auto a = grb::generate_random<int, I>({400, 300}, density, 1);
+    auto b = grb::generate_random<int, I>({400, 300}, density / 2, 2);
+    auto mask = grb::generate_random<int, I>({400, 300}, 0.3, 3);
+
+    auto a_elements = matrix_elements(a);
+    auto b_elements = matrix_elements(b);
+    auto mask_elements = matrix_elements(mask);
+    decltype(a_elements) all;
+    for (auto&& [index, _] : a_elements) {
+      all[index] = 1;
+    }
+    for (auto&& [index, _] : b_elements) {
+      all[index] = 1;
+    }
+
+    REQUIRE(matrix_elements(grb::ewise_intersection(a, b, grb::plus{})) ==
+            reference_ewise(a_elements, b_elements, all, false));
+    REQUIRE(matrix_elements(grb::ewise_intersection(b, a, grb::plus{})) ==
+            reference_ewise(b_elements, a_elements, all, false));
+    REQUIRE(matrix_elements(grb::ewise_intersection(a, b, grb::plus{},
+                                                    mask)) ==
+            reference_ewise(a_elements, b_elements, mask_elements, false));
+    REQUIRE(matrix_elements(grb::ewise_union(a, b, grb::plus{})) ==
+            reference_ewise(a_elements, b_elements, all, true));
+    REQUIRE(matrix_elements(grb::ewise_union(a, b, grb::plus{}, mask)) ==
+            reference_ewise(a_elements, b_elements, mask_elements, true));
+
+    // A matrix with itself: every element matches.
+    auto twice = grb::ewise_intersection(a, a, grb::plus{});
+    REQUIRE(twice.size() == a.size());
+    REQUIRE(matrix_elements(twice) ==
+            reference_ewise(a_elements, a_elements, all, false));
+
+    // Views are gathered into CSR arrays first.
+    auto l = grb::views::filter(a, grb::lower_triangle());
+    auto l_elements = matrix_elements(l);
+    REQUIRE(matrix_elements(grb::ewise_intersection(l, b, grb::plus{})) ==
+            reference_ewise(l_elements, b_elements, all, false));
+  }
+}
+
+TEMPLATE_TEST_CASE("ewise_intersection on skewed rows",
+                   "[ewise][intersection][template]", int, std::size_t) {
+  using I = TestType;
+
+  // R-MAT rows range from empty to thousands of elements, so pairs of rows
+  // take both the galloping and the block kernels.
+  auto a = grb::generate_rmat<int, I>(12, 16, 1);
+  auto b = grb::generate_rmat<int, I>(12, 4, 2);
+
+  auto a_elements = matrix_elements(a);
+  auto b_elements = matrix_elements(b);
+  decltype(a_elements) all;
+  for (auto&& [index, _] : a_elements) {
+    all[index] = 1;
+  }
+
+  auto expected = reference_ewise(a_elements, b_elements, all, false);
+  REQUIRE(matrix_elements(grb::ewise_intersection(a, b, grb::plus{})) ==
+          expected);
+  REQUIRE(matrix_elements(grb::ewise_intersection(std::execution::par, a, b,
+                                                  grb::plus{})) == expected);
+}
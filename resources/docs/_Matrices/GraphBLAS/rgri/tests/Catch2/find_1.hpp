@@ -0,0 +1,83 @@
+#pragma once
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <grb/grb.hpp>
+#include <map>
+#include <random>
+#include <utility>
+
+namespace {
+
+// Every stored element is found with its value, and random other indices
+// are not.
+template <typename M>
+void check_find(M& matrix) {
+  using I = grb::matrix_index_t<M>;
+  using T = grb::matrix_scalar_t<M>;
+
+  std::map<std::pair<I, I>, T> elements;
+  for (auto&& [index, value] : matrix) {
+    auto&& [i, j] = index;
+    elements[{i, j}] = value;
+  }
+
+  for (auto&& [index, value] : elements) {
+    auto iter = matrix.find({index.first, index.second});
+    REQUIRE(iter != matrix.end());
+    auto&& [found_index, found_value] = *iter;
+    REQUIRE(found_index == grb::index<I>(index.first, index.second));
+    REQUIRE(found_value == value);
+  }
+
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<I> row(0, matrix.shape()[0] - 1);
+  std::uniform_int_distribution<I> column(0, matrix.shape()[1] - 1);
+  for (std::size_t k = 0; k < 10000; k++) {
+    I i = row(gen);
+    I j = column(gen);
+    bool stored = elements.find({i, j}) != elements.end();
+    REQUIRE((matrix.find({i, j}) != matrix.end()) == stored);
+    REQUIRE((std::as_const(matrix).find({i, j}) != matrix.end()) == stored);
+  }
+}
+
+} // namespace
+
+TEMPLATE_TEST_CASE("csr_matrix find", "[matrix][find][template]", int,
+                   std::size_t) {
+  using I = TestType;
+
+  GIVEN("Matrix read from \"chesapeake/chesapeake.mtx\"") {
+    grb::matrix<float, I> a("chesapeake/chesapeake.mtx");
+    check_find(a);
+
+    a.backend().build_hash_index(8);
+    REQUIRE(a.backend().has_hash_index());
+    check_find(a);
+  }
+
+  GIVEN("An R-MAT graph with a skewed degree distribution") {
+    auto a = grb::generate_rmat<int, I>(10, 16, 7);
+    check_find(a);
+
+    // Index only the long rows, then every row.
+    a.backend().build_hash_index(64);
+    check_find(a);
+    a.backend().build_hash_index(1);
+    check_find(a);
+
+    // Changing the sparsity pattern drops the index once the new element
+    // is merged.
+    a[{0, 0}] = 12;
+    a.wait();
+    REQUIRE(!a.backend().has_hash_index());
+    check_find(a);
+
+    // Copies keep the index; it still points at valid positions.
+    a.backend().build_hash_index(16);
+    auto b = a;
+    REQUIRE(b.backend().has_hash_index());
+    check_find(b);
+  }
+}
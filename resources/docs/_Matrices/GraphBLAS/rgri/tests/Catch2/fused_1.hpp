@@ -0,0 +1,154 @@
+#pragma once
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <grb/grb.hpp>
+#include <map>
+#include <utility>
+
+TEMPLATE_TEST_CASE("multiply accumulates into the output in place",
+                   "[multiply][accumulate][template]", int, std::size_t) {
+  using I = TestType;
+
+  auto a = grb::generate_random<int, I>({200, 150}, 0.05, 1);
+  auto b = grb::generate_random<int, I>({150, 180}, 0.05, 2);
+  auto mask = grb::generate_random<int, I>({200, 180}, 0.2, 3);
+  auto c = grb::generate_random<int, I>({200, 180}, 0.1, 4);
+
+  auto c_elements = matrix_elements(c);
+  auto z_elements = matrix_elements(grb::multiply(a, b));
+  auto masked_elements = matrix_elements(
+      grb::multiply(a, b, grb::plus{}, grb::times{}, mask));
+
+  auto keys = [](auto&&... maps) {
+    std::map<std::pair<std::size_t, std::size_t>, int> keys;
+    (
+        [&](auto&& map) {
+          for (auto&& [index, _] : map) {
+            keys[index] = 1;
+          }
+        }(maps),
+        ...);
+    return keys;
+  };
+
+  GIVEN("Merging into the output") {
+    grb::multiply(c, a, b, grb::plus{}, grb::times{}, grb::full_matrix_mask(),
+                  grb::plus{}, true);
+    REQUIRE(matrix_elements(c) ==
+            reference_ewise(c_elements, z_elements,
+                            keys(c_elements, z_elements), true));
+  }
+
+  GIVEN("Replacing the output") {
+    grb::multiply(c, a, b, grb::plus{}, grb::times{}, grb::full_matrix_mask(),
+                  grb::plus{}, false);
+    REQUIRE(matrix_elements(c) ==
+            reference_ewise(c_elements, z_elements, keys(z_elements), true));
+  }
+
+  GIVEN("A masked product") {
+    grb::multiply(c, a, b, grb::plus{}, grb::times{}, mask, grb::plus{},
+                  true);
+    REQUIRE(matrix_elements(c) ==
+            reference_ewise(c_elements, masked_elements,
+                            keys(c_elements, masked_elements), true));
+  }
+
+  GIVEN("A masked product replacing the output") {
+    grb::multiply(c, a, b, grb::plus{}, grb::times{}, mask, grb::plus{},
+                  false);
+    REQUIRE(matrix_elements(c) ==
+            reference_ewise(c_elements, masked_elements,
+                            keys(masked_elements), true));
+  }
+
+  GIVEN("The output as an input") {
+    auto s = grb::generate_random<int, I>({150, 150}, 0.05, 5);
+    auto s_elements = matrix_elements(s);
+    auto ss_elements = matrix_elements(grb::multiply(s, s));
+    grb::multiply(s, s, s, grb::plus{}, grb::times{}, grb::full_matrix_mask(),
+                  grb::plus{}, true);
+    REQUIRE(matrix_elements(s) ==
+            reference_ewise(s_elements, ss_elements,
+                            keys(s_elements, ss_elements), true));
+  }
+
+  GIVEN("An output of the wrong shape") {
+    grb::matrix<int, I> d({200, 200});
+    REQUIRE_THROWS_AS(grb::multiply(d, a, b), grb::invalid_argument);
+  }
+
+  GIVEN("A vector product") {
+    auto x = grb::generate_random<int, I>(150, 0.3);
+    grb::vector<int, I> y(200);
+    for (I i = 0; i < 200; i += 3) {
+      y[i] = 1;
+    }
+    std::map<std::pair<std::size_t, std::size_t>, int> y_elements, ax;
+    for (auto&& [i, v] : y) {
+      y_elements[{i, 0}] = v;
+    }
+    for (auto&& [i, v] : grb::multiply(a, x)) {
+      ax[{i, 0}] = v;
+    }
+
+    auto y_merged = y;
+    grb::multiply(y_merged, a, x, grb::plus{}, grb::times{},
+                  grb::full_vector_mask(), grb::plus{}, true);
+    std::map<std::pair<std::size_t, std::size_t>, int> merged;
+    for (auto&& [i, v] : y_merged) {
+      merged[{i, 0}] = v;
+    }
+    REQUIRE(merged ==
+            reference_ewise(y_elements, ax, keys(y_elements, ax), true));
+
+    grb::multiply(y, a, x, grb::plus{}, grb::times{}, grb::full_vector_mask(),
+                  grb::plus{}, false);
+    std::map<std::pair<std::size_t, std::size_t>, int> replaced;
+    for (auto&& [i, v] : y) {
+      replaced[{i, 0}] = v;
+    }
+    REQUIRE(replaced == reference_ewise(y_elements, ax, keys(ax), true));
+  }
+}
+
+TEMPLATE_TEST_CASE("assign gathers view chains into CSR arrays",
+                   "[assign][views][template]", int, std::size_t) {
+  using I = TestType;
+
+  auto a = grb::generate_random<int, I>({100, 120}, 0.1, 6);
+  auto elements = matrix_elements(a);
+
+  auto view = grb::views::transform(
+      grb::views::filter(a, [](auto&& e) { return grb::get<1>(e) % 2 == 0; }),
+      [](auto&& e) { return grb::get<1>(e) * 3; });
+
+  decltype(elements) expected;
+  for (auto&& [index, value] : elements) {
+    if (value % 2 == 0) {
+      expected[index] = value * 3;
+    }
+  }
+
+  grb::matrix<int, I> c({100, 120});
+  c[{5, 5}] = 1;
+  grb::assign(c, view);
+  REQUIRE(matrix_elements(c) == expected);
+  REQUIRE(c.size() == expected.size());
+  check_find(c);
+
+  // A transposed view is row-sorted while it is gathered.
+  grb::matrix<int, I> t({120, 100});
+  grb::assign(t, grb::transpose(c));
+  decltype(elements) transposed;
+  for (auto&& [index, value] : expected) {
+    transposed[{index.second, index.first}] = value;
+  }
+  REQUIRE(matrix_elements(t) == transposed);
+  check_find(t);
+
+  // Assigning a view of the matrix itself.
+  grb::assign(a, view);
+  REQUIRE(matrix_elements(a) == expected);
+}
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+#include <grb/grb.hpp>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+
+namespace {
+
+std::string write_temp_file(const std::string& name,
+                            const std::string& contents) {
+  auto path = std::filesystem::temp_directory_path() / name;
+  std::ofstream f(path, std::ios::binary);
+  f << contents;
+  return path.string();
+}
+
+template <typename M>
+auto element_map(M&& m) {
+  using T = grb::matrix_scalar_t<M>;
+  std::map<std::pair<std::size_t, std::size_t>, T> elements;
+  for (auto&& [index, value] : m) {
+    auto&& [i, j] = index;
+    elements.insert({{i, j}, value});
+  }
+  return elements;
+}
+
+// CSR iteration is row-major with sorted columns.
+template <typename M>
+bool row_major(M&& m) {
+  bool first = true;
+  std::pair<std::size_t, std::size_t> previous;
+  for (auto&& [index, value] : m) {
+    auto&& [i, j] = index;
+    std::pair<std::size_t, std::size_t> current(i, j);
+    if (!first && !(previous < current)) {
+      return false;
+    }
+    previous = current;
+    first = false;
+  }
+  return true;
+}
+
+} // namespace
+
+TEMPLATE_TEST_CASE("Matrix Market reader", "[io][template]", int,
+                   std::size_t) {
+  using I = TestType;
+  using elements = std::map<std::pair<std::size_t, std::size_t>, float>;
+
+  GIVEN("A general matrix with comments, blank lines, CRLF line endings "
+        "and unsorted entries") {
+    auto path = write_temp_file(
+        "rgri_io_general.mtx",
+        "%%MatrixMarket matrix coordinate real general\r\n"
+        "% comment\r\n"
+        "%\r\n"
+        "3 4 5\r\n"
+        "3 4 1.5\r\n"
+        "1 2 -2e1\r\n"
+        "\r\n"
+        "  1 1\t+3\r\n"
+        "2 3 .25\r\n"
+        "1 4 7\r\n");
+    elements expected = {{{0, 0}, 3.f},
+                         {{0, 1}, -20.f},
+                         {{0, 3}, 7.f},
+                         {{1, 2}, .25f},
+                         {{2, 3}, 1.5f}};
+
+    grb::matrix<float, I> a(path);
+    REQUIRE(a.shape() == grb::index<I>(3, 4));
+    REQUIRE(a.size() == 5);
+    REQUIRE(row_major(a));
+    REQUIRE(element_map(a) == expected);
+
+    auto tuples = grb::mmread<float, I>(path);
+    REQUIRE(tuples.shape() == grb::index<I>(3, 4));
+    REQUIRE(element_map(tuples) == expected);
+
+    grb::matrix<float, I, grb::dense> d(path);
+    REQUIRE(element_map(d) == expected);
+  }
+
+  GIVEN("A symmetric pattern matrix") {
+    auto path = write_temp_file(
+        "rgri_io_symmetric.mtx",
+        "%%MatrixMarket matrix coordinate pattern symmetric\n"
+        "3 3 3\n"
+        "2 1\n"
+        "3 3\n"
+        "3 1\n");
+
+    grb::matrix<int, I> a(path);
+    REQUIRE(a.size() == 5);
+    REQUIRE(row_major(a));
+    REQUIRE(element_map(a) ==
+            std::map<std::pair<std::size_t, std::size_t>, int>{{{0, 1}, 1},
+                                                                {{0, 2}, 1},
+                                                                {{1, 0}, 1},
+                                                                {{2, 0}, 1},
+                                                                {{2, 2}, 1}});
+  }
+
+  GIVEN("Duplicate entries") {
+    auto path = write_temp_file(
+        "rgri_io_duplicates.mtx",
+        "%%MatrixMarket matrix coordinate integer general\n"
+        "2 2 4\n"
+        "1 2 5\n"
+        "1 1 6\n"
+        "1 2 7\n"
+        "2 2 8\n");
+
+    // The first entry in the file wins.
+    grb::matrix<int, I> a(path);
+    REQUIRE(a.size() == 3);
+    REQUIRE(element_map(a) ==
+            std::map<std::pair<std::size_t, std::size_t>, int>{
+                {{0, 0}, 6}, {{0, 1}, 5}, {{1, 1}, 8}});
+  }
+
+  GIVEN("Malformed files") {
+    auto banner = write_temp_file("rgri_io_banner.mtx",
+                                  "%%MatrixMarket matrix array real general\n"
+                                  "2 2\n");
+    REQUIRE_THROWS(grb::matrix<float, I>(banner));
+
+    auto bounds = write_temp_file(
+        "rgri_io_bounds.mtx",
+        "%%MatrixMarket matrix coordinate real general\n"
+        "2 2 1\n"
+        "3 1 1.0\n");
+    REQUIRE_THROWS(grb::matrix<float, I>(bounds));
+
+    auto extra = write_temp_file(
+        "rgri_io_extra.mtx",
+        "%%MatrixMarket matrix coordinate real general\n"
+        "2 2 1\n"
+        "1 1 1.0\n"
+        "2 2 1.0\n");
+    REQUIRE_THROWS(grb::matrix<float, I>(extra));
+
+    auto garbage = write_temp_file(
+        "rgri_io_garbage.mtx",
+        "%%MatrixMarket matrix coordinate real general\n"
+        "2 2 1\n"
+        "1 x 1.0\n");
+    REQUIRE_THROWS(grb::matrix<float, I>(garbage));
+
+    REQUIRE_THROWS(grb::matrix<float, I>("rgri_io_does_not_exist.mtx"));
+  }
+
+  GIVEN("A large random matrix read on several threads") {
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<std::size_t> index(1, 500);
+    std::uniform_int_distribution<int> value(-1000, 1000);
+
+    std::string contents = "%%MatrixMarket matrix coordinate integer general\n"
+                           "500 500 40000\n";
+    std::map<std::pair<std::size_t, std::size_t>, int> expected;
+    for (std::size_t k = 0; k < 40000; k++) {
+      std::size_t i = index(gen);
+      std::size_t j = index(gen);
+      int v = value(gen);
+      contents += std::to_string(i) + " " + std::to_string(j) + " " +
+                  std::to_string(v) + "\n";
+      expected.insert({{i - 1, j - 1}, v});
+    }
+    auto path = write_temp_file("rgri_io_large.mtx", contents);
+
+    for (std::size_t threads : {1, 3, 8}) {
+      grb::set_max_threads(threads);
+      grb::matrix<int, I> a(path);
+      REQUIRE(a.size() == expected.size());
+      REQUIRE(row_major(a));
+      REQUIRE(element_map(a) == expected);
+
+      auto tuples = grb::mmread<int, I>(path);
+      REQUIRE(tuples.size() == 40000);
+      REQUIRE(element_map(tuples) == expected);
+    }
+    grb::set_max_threads(0);
+  }
+}
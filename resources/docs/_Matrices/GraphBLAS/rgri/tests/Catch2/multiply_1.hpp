@@ -0,0 +1,186 @@
+#pragma once
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <grb/grb.hpp>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Reference C = A * B (optionally masked) using ordered maps.
+template <typename T, typename A, typename B, typename Reduce,
+          typename Combine, typename Mask = std::nullptr_t>
+std::map<std::pair<std::size_t, std::size_t>, T>
+reference_multiply(A&& a, B&& b, Reduce&& reduce, Combine&& combine,
+                   const Mask& mask = nullptr) {
+  std::map<std::size_t, std::vector<std::pair<std::size_t, T>>> b_rows;
+  for (auto&& [index, value] : b) {
+    auto&& [k, j] = index;
+    b_rows[k].push_back({j, T(value)});
+  }
+
+  std::map<std::pair<std::size_t, std::size_t>, T> c;
+  for (auto&& [index, a_value] : a) {
+    auto&& [i, k] = index;
+    for (auto&& [j, b_value] : b_rows[k]) {
+      if constexpr (!std::is_same_v<Mask, std::nullptr_t>) {
+        using mask_index = grb::matrix_index_t<Mask>;
+        auto iter = mask.find({mask_index(i), mask_index(j)});
+        if (iter == mask.end() || !bool(grb::get<1>(*iter))) {
+          continue;
+        }
+      }
+      T product = combine(T(a_value), b_value);
+      auto [iter, inserted] = c.insert({{i, j}, product});
+      if (!inserted) {
+        iter->second = reduce(iter->second, product);
+      }
+    }
+  }
+  return c;
+}
+
+template <typename M, typename T>
+void check_product(
+    const M& c, const std::map<std::pair<std::size_t, std::size_t>, T>& ref) {
+  REQUIRE(c.size() == ref.size());
+
+  std::size_t previous_i = 0;
+  std::size_t previous_j = 0;
+  bool first = true;
+  for (auto&& [index, value] : c) {
+    auto&& [i, j] = index;
+    // Elements must come out in row-major order.
+    if (!first) {
+      REQUIRE((i > previous_i || (i == previous_i && j > previous_j)));
+    }
+    first = false;
+    previous_i = i;
+    previous_j = j;
+
+    auto iter = ref.find({i, j});
+    REQUIRE(iter != ref.end());
+    REQUIRE(value == iter->second);
+  }
+}
+
+template <typename T, typename I>
+grb::matrix<T, I> random_matrix(I m, I n, std::size_t nnz, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<I> row(0, m - 1);
+  std::uniform_int_distribution<I> column(0, n - 1);
+  std::uniform_int_distribution<int> value(1, 9);
+
+  std::map<std::pair<I, I>, T> entries;
+  while (entries.size() < nnz) {
+    entries[{row(gen), column(gen)}] = T(value(gen));
+  }
+
+  std::vector<grb::matrix_entry<T, I>> tuples;
+  for (auto&& [index, v] : entries) {
+    tuples.push_back({{index.first, index.second}, v});
+  }
+
+  grb::matrix<T, I> a({m, n});
+  a.insert(tuples.begin(), tuples.end());
+  return a;
+}
+
+} // namespace
+
+TEMPLATE_TEST_CASE("multiply matrix times matrix", "[multiply][template]",
+                   int, std::size_t) {
+  using I = TestType;
+
+  GIVEN("Matrix read from \"chesapeake/chesapeake.mtx\"") {
+    grb::matrix<float, I> a("chesapeake/chesapeake.mtx");
+
+    auto c = grb::multiply(a, a);
+    check_product(c, reference_multiply<float>(a, a, grb::plus{},
+                                               grb::times{}));
+
+    auto c_min = grb::multiply(a, a, grb::min{}, grb::plus{});
+    check_product(c_min,
+                  reference_multiply<float>(a, a, grb::min{}, grb::plus{}));
+
+    // Views are gathered into CSR before multiplying.
+    auto a_t = grb::transpose(a);
+    auto c_t = grb::multiply(a_t, a);
+    check_product(c_t, reference_multiply<float>(a_t, a, grb::plus{},
+                                                 grb::times{}));
+  }
+
+  GIVEN("Random rectangular matrices") {
+    // Wide output: short rows use the hash accumulator, the full last row
+    // of `a` the dense one.
+    auto a = random_matrix<int, I>(60, 40, 300, 1);
+    auto b = random_matrix<int, I>(40, 5000, 800, 2);
+
+    std::vector<grb::matrix_entry<int, I>> full_row;
+    for (I k = 0; k < 40; k++) {
+      full_row.push_back({{59, k}, 2});
+    }
+    a.insert(full_row.begin(), full_row.end());
+
+    auto c = grb::multiply(a, b);
+    check_product(c,
+                  reference_multiply<int>(a, b, grb::plus{}, grb::times{}));
+
+    auto empty = grb::matrix<int, I>({40, 70});
+    auto c_empty = grb::multiply(a, empty);
+    REQUIRE(c_empty.size() == 0);
+    REQUIRE(c_empty.shape() == grb::index<I>(60, 70));
+
+    REQUIRE_THROWS_AS(grb::multiply(a, a), grb::invalid_argument);
+  }
+}
+
+TEMPLATE_TEST_CASE("masked multiply matrix times matrix",
+                   "[multiply][template]", int, std::size_t) {
+  using I = TestType;
+
+  GIVEN("Matrix read from \"chesapeake/chesapeake.mtx\"") {
+    grb::matrix<int, I> a("chesapeake/chesapeake.mtx");
+
+    auto l = grb::views::filter(a, grb::lower_triangle());
+
+    // Triangle counting: sum(L .* (L * L)).
+    auto c = grb::multiply(l, l, grb::plus{}, grb::times{}, l);
+    check_product(c,
+                  reference_multiply<int>(l, l, grb::plus{}, grb::times{}, l));
+
+    std::size_t triangles = 0;
+    for (auto&& [index, value] : c) {
+      triangles += value;
+    }
+
+    std::size_t reference_triangles = 0;
+    for (auto&& [index, value] : reference_multiply<int>(
+             a, a, grb::plus{}, grb::times{}, a)) {
+      reference_triangles += value;
+    }
+    // Every triangle appears six times in A .* (A * A).
+    REQUIRE(triangles * 6 == reference_triangles);
+  }
+
+  GIVEN("A mask with explicit false values") {
+    auto a = random_matrix<int, I>(50, 50, 400, 3);
+    auto mask = random_matrix<int, I>(50, 50, 1200, 4);
+
+    // Stored zeros must mask out their element just like missing ones.
+    std::size_t count = 0;
+    for (auto&& [index, value] : mask) {
+      if (count++ % 3 == 0) {
+        value = 0;
+      }
+    }
+
+    auto c = grb::multiply(a, a, grb::plus{}, grb::times{}, mask);
+    check_product(c, reference_multiply<int>(a, a, grb::plus{}, grb::times{},
+                                             mask));
+  }
+}
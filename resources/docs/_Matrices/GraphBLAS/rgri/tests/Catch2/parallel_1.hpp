@@ -0,0 +1,125 @@
+#pragma once
+
+#include <algorithm>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <execution>
+#include <grb/grb.hpp>
+#include <map>
+#include <utility>
+
+namespace {
+
+// Both ranges hold the same elements in the same order.
+template <typename X, typename Y>
+bool same_elements(X&& x, Y&& y) {
+  if (x.size() != y.size()) {
+    return false;
+  }
+  return std::equal(x.begin(), x.end(), y.begin(), [](auto&& e, auto&& f) {
+    auto&& [e_index, e_value] = e;
+    auto&& [f_index, f_value] = f;
+    return e_index == f_index && e_value == f_value;
+  });
+}
+
+template <typename M>
+auto matrix_elements(M&& m) {
+  using scalar_type = grb::matrix_scalar_t<M>;
+  std::map<std::pair<std::size_t, std::size_t>, scalar_type> elements;
+  for (auto&& [index, value] : m) {
+    auto&& [i, j] = index;
+    elements[{i, j}] = value;
+  }
+  return elements;
+}
+
+// Reference element-wise merge on ordered maps (the sequential ewise
+// inserts one element at a time, which is too slow at this size).
+template <typename E, typename Mask>
+E reference_ewise(const E& a, const E& b, const Mask& mask, bool is_union) {
+  E c;
+  for (auto&& [index, a_value] : a) {
+    auto iter = b.find(index);
+    if (iter != b.end()) {
+      c[index] = a_value + iter->second;
+    } else if (is_union) {
+      c[index] = a_value;
+    }
+  }
+  if (is_union) {
+    for (auto&& [index, b_value] : b) {
+      c.insert({index, b_value});
+    }
+  }
+  std::erase_if(c, [&](auto&& element) {
+    auto iter = mask.find(element.first);
+    return iter == mask.end() || !bool(iter->second);
+  });
+  return c;
+}
+
+} // namespace
+
+TEMPLATE_TEST_CASE("parallel algorithms match sequential ones",
+                   "[parallel][template]", int, std::size_t) {
+  using I = TestType;
+
+  // Large enough to be split across several workers.
+  auto a = grb::generate_random<int, I>({1000, 1000}, 0.05, 1);
+  auto b = grb::generate_random<int, I>({1000, 1000}, 0.05, 2);
+  auto mask = grb::generate_random<int, I>({1000, 1000}, 0.1, 3);
+  auto x = grb::generate_random<int, I>(1000, 0.5);
+
+  for (std::size_t threads : {1, 3, 4}) {
+    grb::set_max_threads(threads);
+
+    GIVEN(std::to_string(threads) + " threads") {
+      REQUIRE(same_elements(grb::multiply(std::execution::par, a, b),
+                            grb::multiply(a, b)));
+
+      REQUIRE(same_elements(grb::multiply(std::execution::par, a, b,
+                                          grb::plus{}, grb::times{}, mask),
+                            grb::multiply(a, b, grb::plus{}, grb::times{},
+                                          mask)));
+
+      REQUIRE(same_elements(grb::multiply(std::execution::par, a, x),
+                            grb::multiply(a, x)));
+
+      auto a_elements = matrix_elements(a);
+      auto b_elements = matrix_elements(b);
+      auto mask_elements = matrix_elements(mask);
+      decltype(a_elements) all;
+      for (auto&& [index, _] : a_elements) {
+        all[index] = 1;
+      }
+      for (auto&& [index, _] : b_elements) {
+        all[index] = 1;
+      }
+
+      REQUIRE(matrix_elements(grb::ewise_intersection(
+                  std::execution::par, a, b, grb::plus{}, mask)) ==
+              reference_ewise(a_elements, b_elements, mask_elements, false));
+
+      REQUIRE(matrix_elements(grb::ewise_union(std::execution::par, a, b,
+                                               grb::plus{})) ==
+              reference_ewise(a_elements, b_elements, all, true));
+
+      REQUIRE(matrix_elements(grb::ewise_union(std::execution::par, a, b,
+                                               grb::plus{}, mask)) ==
+              reference_ewise(a_elements, b_elements, mask_elements, true));
+
+      REQUIRE(same_elements(grb::reduce(std::execution::par, a),
+                            grb::reduce(a)));
+
+      // Views are gathered into CSR arrays first.
+      auto l = grb::views::filter(a, grb::lower_triangle());
+      REQUIRE(same_elements(grb::multiply(std::execution::par, l, l,
+                                          grb::plus{}, grb::times{}, l),
+                            grb::multiply(l, l, grb::plus{}, grb::times{},
+                                          l)));
+    }
+  }
+
+  grb::set_max_threads(0);
+}
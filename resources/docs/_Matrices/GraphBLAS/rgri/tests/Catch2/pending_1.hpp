@@ -0,0 +1,176 @@
+#pragma once
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <grb/grb.hpp>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// The matrix iterates over exactly the elements of `reference`, in row-major
+// order, and finds each of them.
+template <typename M, typename T, typename I>
+bool matches(M&& matrix, const std::map<std::pair<I, I>, T>& reference) {
+  if (matrix.size() != reference.size()) {
+    return false;
+  }
+
+  auto ref = reference.begin();
+  for (auto&& [index, value] : matrix) {
+    auto&& [i, j] = index;
+    if (ref == reference.end() || ref->first != std::pair<I, I>(i, j) ||
+        ref->second != value) {
+      return false;
+    }
+    ++ref;
+  }
+
+  for (auto&& [index, value] : reference) {
+    auto iter = matrix.find({index.first, index.second});
+    if (iter == matrix.end() || grb::get<1>(*iter) != value) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+TEMPLATE_TEST_CASE("csr_matrix pending inserts", "[matrix][pending][template]",
+                   int, std::size_t) {
+  using I = TestType;
+  using T = int;
+
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<I> row(0, 99);
+  std::uniform_int_distribution<I> column(0, 199);
+  std::uniform_int_distribution<T> value(-100, 100);
+
+  GIVEN("A matrix built one element at a time with operator[]") {
+    grb::matrix<T, I> a({100, 200});
+    std::map<std::pair<I, I>, T> reference;
+
+    for (std::size_t k = 0; k < 5000; k++) {
+      I i = row(gen);
+      I j = column(gen);
+      T v = value(gen);
+      a[{i, j}] += v;
+      reference[{i, j}] += v;
+    }
+
+    // Repeated indices accumulate into the same pending element.
+    REQUIRE(a.backend().pending_size() == reference.size());
+    REQUIRE(a.size() == reference.size());
+    REQUIRE(matches(a, reference));
+    REQUIRE(a.backend().pending_size() == 0);
+
+    THEN("Later inserts merge with the stored elements") {
+      for (std::size_t k = 0; k < 2000; k++) {
+        I i = row(gen);
+        I j = column(gen);
+        T v = value(gen);
+        a[{i, j}] = v;
+        reference[{i, j}] = v;
+      }
+      REQUIRE(a.backend().pending_size() > 0);
+      a.wait();
+      REQUIRE(a.backend().pending_size() == 0);
+      REQUIRE(matches(a, reference));
+    }
+
+    THEN("References to pending elements stay valid") {
+      T& first = a[{0, 0}];
+      for (I j = 1; j < 200; j++) {
+        a[{0, j}] = T(j);
+        reference[{0, j}] = T(j);
+      }
+      first = 42;
+      reference[{0, 0}] = 42;
+      REQUIRE(matches(a, reference));
+    }
+
+    THEN("Copies and moves carry the pending elements") {
+      a[{99, 199}] = 7;
+      reference[{99, 199}] = 7;
+
+      auto b = a;
+      REQUIRE(matches(b, reference));
+
+      auto c = std::move(a);
+      REQUIRE(matches(c, reference));
+      REQUIRE(a.size() == 0);
+    }
+  }
+
+  GIVEN("Range inserts with duplicates") {
+    grb::matrix<T, I> a({100, 200});
+    std::map<std::pair<I, I>, T> reference;
+
+    for (std::size_t batch = 0; batch < 4; batch++) {
+      std::vector<grb::matrix_entry<T, I>> tuples;
+      for (std::size_t k = 0; k < 1000; k++) {
+        I i = row(gen);
+        I j = column(gen);
+        T v = value(gen);
+        tuples.push_back({{i, j}, v});
+        // The first element at an index wins, as with insert(value).
+        reference.insert({{i, j}, v});
+      }
+      a.insert(tuples.begin(), tuples.end());
+      if (batch % 2 == 1) {
+        REQUIRE(matches(a, reference));
+      }
+    }
+    REQUIRE(matches(std::as_const(a), reference));
+  }
+
+  GIVEN("Single-element inserts") {
+    grb::matrix<T, I> a({100, 200});
+    a[{5, 5}] = 1;
+
+    auto [iter, inserted] = a.insert({{5, 5}, 2});
+    REQUIRE(!inserted);
+    REQUIRE(grb::get<1>(*iter) == 1);
+
+    a[{5, 6}] = 3;
+    auto [iter2, inserted2] = a.insert_or_assign({5, 6}, 4);
+    REQUIRE(!inserted2);
+    REQUIRE(grb::get<1>(*iter2) == 4);
+
+    auto [iter3, inserted3] = a.insert_or_assign({5, 4}, 5);
+    REQUIRE(inserted3);
+    REQUIRE(grb::get<1>(*iter3) == 5);
+
+    REQUIRE(matches(a, std::map<std::pair<I, I>, T>{
+                           {{5, 4}, 5}, {{5, 5}, 1}, {{5, 6}, 4}}));
+
+    // Reshaping keeps pending elements inside the new shape.
+    a[{50, 150}] = 6;
+    a.reshape({10, 10});
+    REQUIRE(matches(a, std::map<std::pair<I, I>, T>{
+                           {{5, 4}, 5}, {{5, 5}, 1}, {{5, 6}, 4}}));
+  }
+
+  GIVEN("Kernels reading a matrix with pending elements") {
+    auto a = grb::generate_random<T, I>({100, 200}, 0.05, 1);
+    auto b = a;
+    for (I i = 0; i < 100; i++) {
+      a[{i, I(2 * i)}] += 1;
+      b.wait();
+      b[{i, I(2 * i)}] += 1;
+      b.wait();
+    }
+    REQUIRE(a.backend().pending_size() > 0);
+    REQUIRE(same_elements(grb::reduce(a), grb::reduce(b)));
+
+    a[{0, 199}] = 3;
+    b[{0, 199}] = 3;
+    b.wait();
+    auto c = grb::multiply(a, grb::transpose(a));
+    auto d = grb::multiply(b, grb::transpose(b));
+    REQUIRE(same_elements(c, d));
+  }
+}
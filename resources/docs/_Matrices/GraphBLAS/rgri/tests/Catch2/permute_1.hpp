@@ -0,0 +1,170 @@
+#pragma once
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdlib>
+#include <execution>
+#include <grb/grb.hpp>
+#include <map>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Largest |i - j| over the stored elements.
+template <typename M>
+std::size_t bandwidth(M&& m) {
+  std::size_t b = 0;
+  for (auto&& [index, _] : m) {
+    auto&& [i, j] = index;
+    b = std::max<std::size_t>(b, i > j ? i - j : j - i);
+  }
+  return b;
+}
+
+template <typename P>
+bool is_permutation(const P& p, std::size_t n) {
+  std::vector<std::size_t> sorted(p.begin(), p.end());
+  std::sort(sorted.begin(), sorted.end());
+  std::vector<std::size_t> identity(n);
+  std::iota(identity.begin(), identity.end(), std::size_t(0));
+  return sorted == identity;
+}
+
+// Element (k, l) of the result is element (rows[k], columns[l]) of `m`.
+template <typename M, typename P>
+auto reference_permute(M&& m, const P& rows, const P& columns) {
+  std::vector<std::size_t> new_row(rows.size());
+  std::vector<std::size_t> new_column(columns.size());
+  for (std::size_t k = 0; k < rows.size(); k++) {
+    new_row[rows[k]] = k;
+  }
+  for (std::size_t l = 0; l < columns.size(); l++) {
+    new_column[columns[l]] = l;
+  }
+
+  std::map<std::pair<std::size_t, std::size_t>, grb::matrix_scalar_t<M>>
+      elements;
+  for (auto&& [index, value] : m) {
+    auto&& [i, j] = index;
+    elements[{new_row[i], new_column[j]}] = value;
+  }
+  return elements;
+}
+
+} // namespace
+
+TEST_CASE("permute by true permutations", "[permute]") {
+  auto a = grb::generate_rmat<int, int>(9, 8, 3);
+  std::size_t n = a.shape()[0];
+  for (auto&& [index, v] : a) {
+    auto&& [i, j] = index;
+    v = i * 1000 + j;
+  }
+
+  std::vector<int> p(n);
+  std::iota(p.begin(), p.end(), 0);
+  std::shuffle(p.begin(), p.end(), std::mt19937(1));
+
+  auto expected = reference_permute(a, p, p);
+  auto b = grb::permute(a, p);
+  REQUIRE(matrix_elements(b) == expected);
+
+  // Built straight into CSR, with sorted columns.
+  auto rowptr = b.backend().rowptr();
+  auto colind = b.backend().colind();
+  for (std::size_t i = 0; i < n; i++) {
+    REQUIRE(std::is_sorted(colind.begin() + rowptr[i],
+                           colind.begin() + rowptr[i + 1]));
+  }
+
+  for (std::size_t threads : {1, 3}) {
+    grb::set_max_threads(threads);
+    REQUIRE(matrix_elements(grb::permute(std::execution::par, a, p)) ==
+            expected);
+  }
+  grb::set_max_threads(0);
+
+  // Views are gathered first.
+  REQUIRE(matrix_elements(grb::permute(grb::transpose(a), p)) ==
+          reference_permute(grb::transpose(a), p, p));
+
+  // Separate row and column permutations of a rectangular matrix.
+  grb::matrix<float, int> r({40, 70});
+  for (int i = 0; i < 40; i++) {
+    for (int j = (i * 7) % 5; j < 70; j += 3 + i % 4) {
+      r[{i, j}] = float(i - j);
+    }
+  }
+  std::vector<int> rows(40);
+  std::vector<int> columns(70);
+  std::iota(rows.begin(), rows.end(), 0);
+  std::iota(columns.begin(), columns.end(), 0);
+  std::shuffle(rows.begin(), rows.end(), std::mt19937(2));
+  std::shuffle(columns.begin(), columns.end(), std::mt19937(3));
+  REQUIRE(matrix_elements(grb::permute(r, rows, columns)) ==
+          reference_permute(r, rows, columns));
+  REQUIRE(matrix_elements(grb::permute(std::execution::par, r, rows,
+                                       columns)) ==
+          reference_permute(r, rows, columns));
+}
+
+TEST_CASE("permute by general index maps", "[permute]") {
+  grb::matrix<int, int> a({3, 3});
+  a[{0, 1}] = 1;
+  a[{1, 2}] = 2;
+  a[{2, 2}] = 3;
+
+  // Index 1 twice, index 0 never: only the elements they select.
+  std::vector<int> p = {1, 1, 2};
+  auto b = grb::permute(a, p);
+  REQUIRE(matrix_elements(b) ==
+          std::map<std::pair<std::size_t, std::size_t>, int>{
+              {{0, 2}, 2}, {{1, 2}, 2}, {{2, 2}, 3}});
+}
+
+TEST_CASE("RCM and degree orderings", "[permute][reorder]") {
+  // A banded matrix with its labels shuffled.
+  std::size_t n = 500;
+  grb::matrix<float, int> banded({int(n), int(n)});
+  for (std::size_t i = 0; i < n; i++) {
+    for (std::size_t j = i; j < std::min(n, i + 4); j++) {
+      banded[{int(i), int(j)}] = 1;
+      banded[{int(j), int(i)}] = 1;
+    }
+  }
+  std::vector<int> shuffle(n);
+  std::iota(shuffle.begin(), shuffle.end(), 0);
+  std::shuffle(shuffle.begin(), shuffle.end(), std::mt19937(4));
+  auto scrambled = grb::permute(banded, shuffle);
+  REQUIRE(bandwidth(scrambled) > 100);
+
+  auto p = grb::rcm_ordering(scrambled);
+  REQUIRE(is_permutation(p, n));
+  REQUIRE(bandwidth(grb::permute(scrambled, p)) <= 6);
+
+  // Several components, isolated vertices, self-loops and one-way edges.
+  auto g = grb::generate_rmat<int, int>(8, 2, 5);
+  auto q = grb::rcm_ordering(g);
+  REQUIRE(is_permutation(q, g.shape()[0]));
+
+  auto d = grb::degree_ordering(g);
+  REQUIRE(is_permutation(d, g.shape()[0]));
+  auto rowptr = g.backend().rowptr();
+  auto degree = [&](int v) { return rowptr[v + 1] - rowptr[v]; };
+  for (std::size_t k = 0; k + 1 < d.size(); k++) {
+    REQUIRE(degree(d[k]) >= degree(d[k + 1]));
+    if (degree(d[k]) == degree(d[k + 1])) {
+      REQUIRE(d[k] < d[k + 1]);
+    }
+  }
+  auto ascending = grb::degree_ordering(g, false);
+  for (std::size_t k = 0; k + 1 < ascending.size(); k++) {
+    REQUIRE(degree(ascending[k]) <= degree(ascending[k + 1]));
+  }
+
+  grb::matrix<int, int> rectangular({3, 4});
+  REQUIRE_THROWS_AS(grb::rcm_ordering(rectangular), grb::invalid_argument);
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <grb/grb.hpp>
+#include <map>
+#include <random>
+
+namespace {
+
+// Reference masked matrix-vector product on ordered maps.  Each row's
+// products are reduced in column order.
+template <typename E, typename X, typename Mask, typename Reduce>
+std::map<std::size_t, int> reference_mxv(const E& a, const X& x,
+                                         const Mask& allowed, Reduce reduce) {
+  std::map<std::size_t, int> c;
+  for (auto&& [index, a_value] : a) {
+    auto&& [i, k] = index;
+    auto iter = x.find(k);
+    if (iter == x.end() || !allowed(i)) {
+      continue;
+    }
+    int v = a_value * iter->second;
+    auto c_iter = c.find(i);
+    if (c_iter == c.end()) {
+      c[i] = v;
+    } else {
+      c_iter->second = reduce(c_iter->second, v);
+    }
+  }
+  return c;
+}
+
+template <typename V>
+std::map<std::size_t, int> vector_elements(V&& v) {
+  std::map<std::size_t, int> elements;
+  for (auto&& [index, value] : v) {
+    elements[index] = value;
+  }
+  return elements;
+}
+
+} // namespace
+
+TEMPLATE_TEST_CASE("direction-optimizing mxv", "[multiply][mxv][template]",
+                   grb::dense, grb::sparse) {
+  using Hint = TestType;
+
+  auto a = grb::generate_random<int, int>({300, 200}, 0.05, 5);
+  auto elements = matrix_elements(a);
+  std::map<std::pair<std::size_t, std::size_t>, int> transposed;
+  for (auto&& [index, value] : elements) {
+    transposed[{index.second, index.first}] = value;
+  }
+
+  grb::vector<int, int, Hint> visited(300);
+  std::mt19937 gen(3);
+  for (int i = 0; i < 300; i++) {
+    if (gen() % 3 == 0) {
+      visited[i] = 1;
+    }
+  }
+  auto unvisited = [&](std::size_t i) {
+    return visited.find(i) == visited.end();
+  };
+  auto everything = [](std::size_t) { return true; };
+
+  // A single element pushes; a full vector pulls.
+  for (std::size_t fill : {1, 200}) {
+    GIVEN(std::to_string(fill) + " elements in x") {
+      grb::vector<int, int, Hint> x(200);
+      std::map<std::size_t, int> x_elements;
+      for (std::size_t k = 0; k < fill; k++) {
+        int j = fill == 200 ? k : 7;
+        x[j] = int(k % 5) + 1;
+        x_elements[j] = int(k % 5) + 1;
+      }
+
+      REQUIRE(vector_elements(grb::multiply(a, x)) ==
+              reference_mxv(elements, x_elements, everything, grb::plus{}));
+      REQUIRE(a.backend().has_column_index());
+
+      REQUIRE(vector_elements(grb::multiply(a, x, grb::plus{},
+                                            grb::times{},
+                                            grb::complement_view(visited))) ==
+              reference_mxv(elements, x_elements, unvisited, grb::plus{}));
+
+      REQUIRE(vector_elements(grb::multiply(a, x, grb::take_left{},
+                                            grb::times{},
+                                            grb::complement_view(visited))) ==
+              reference_mxv(elements, x_elements, unvisited,
+                            grb::take_left{}));
+
+      // Writing values keeps the column index valid.
+      for (auto&& [_, value] : a) {
+        value += 1;
+      }
+      for (auto&& [_, value] : elements) {
+        value += 1;
+      }
+      REQUIRE(a.backend().has_column_index());
+      REQUIRE(vector_elements(grb::multiply(a, x)) ==
+              reference_mxv(elements, x_elements, everything, grb::plus{}));
+
+      // A new element changes the pattern and drops it.
+      a[{0, 7}] = 2;
+      elements[{0, 7}] = 2;
+      a.wait();
+      REQUIRE(!a.backend().has_column_index());
+      REQUIRE(vector_elements(grb::multiply(a, x)) ==
+              reference_mxv(elements, x_elements, everything, grb::plus{}));
+    }
+  }
+
+  GIVEN("A transposed view") {
+    grb::vector<int, int, Hint> frontier(300);
+    std::map<std::size_t, int> frontier_elements;
+    for (int i : {4, 150, 299}) {
+      frontier[i] = 1;
+      frontier_elements[i] = 1;
+    }
+
+    auto not_in_frontier = [&](std::size_t j) {
+      return frontier_elements.find(j) == frontier_elements.end();
+    };
+
+    auto b = grb::multiply(grb::transpose(a), frontier, grb::plus{},
+                           grb::times{}, grb::complement_view(frontier));
+    REQUIRE(vector_elements(b) == reference_mxv(transposed, frontier_elements,
+                                                not_in_frontier, grb::plus{}));
+    static_assert(std::is_same_v<typename decltype(b)::hint_type, Hint>);
+
+    // Every vertex in the frontier.
+    for (int i = 0; i < 300; i++) {
+      frontier[i] = 1;
+      frontier_elements[i] = 1;
+    }
+    REQUIRE(vector_elements(grb::multiply(grb::transpose(a), frontier)) ==
+            reference_mxv(transposed, frontier_elements, everything,
+                          grb::plus{}));
+  }
+
+  GIVEN("Mismatched dimensions") {
+    grb::vector<int, int, Hint> x(300);
+    REQUIRE_THROWS_AS(grb::multiply(a, x), grb::invalid_argument);
+  }
+}
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <execution>
+#include <grb/grb.hpp>
+#include <limits>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Reference row (or, with `by_column`, column) reduction on ordered maps.
+template <typename M, typename Reduce>
+auto reference_reduce(M&& a, Reduce reduce, bool by_column) {
+  std::map<std::size_t, grb::matrix_scalar_t<M>> elements;
+  for (auto&& [index, value] : a) {
+    auto&& [i, j] = index;
+    std::size_t k = by_column ? j : i;
+    auto iter = elements.find(k);
+    if (iter == elements.end()) {
+      elements[k] = value;
+    } else {
+      iter->second = reduce(iter->second, value);
+    }
+  }
+  return elements;
+}
+
+// Reduce to a scalar with every execution policy and a few thread counts,
+// checking that all agree exactly.
+template <typename Summation, typename R, typename Reduce = grb::plus<>>
+auto reproducible_reduce(R&& r, Reduce reduce = Reduce{}) {
+  auto value = grb::reduce_to_scalar<Summation>(r, reduce);
+  for (std::size_t threads : {1, 2, 3}) {
+    grb::set_max_threads(threads);
+    REQUIRE(grb::reduce_to_scalar<Summation>(std::execution::par, r,
+                                             reduce) == value);
+  }
+  grb::set_max_threads(0);
+  return value;
+}
+
+} // namespace
+
+TEST_CASE("reduce rows and columns") {
+  // Integer values keep sums exact in any order; long rows and columns span
+  // several blocks.
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<int> value(-50, 50);
+  std::uniform_int_distribution<int> column(0, 19999);
+  std::vector<grb::matrix_entry<int, int>> elements;
+  for (int i = 0; i < 300; i++) {
+    elements.push_back({{i, 12345}, value(gen)});
+    int count = i % 10 == 0 ? 15000 : i % 7;
+    for (int k = 0; k < count; k++) {
+      elements.push_back({{i, column(gen)}, value(gen)});
+    }
+  }
+  grb::matrix<int, int> a({300, 20000});
+  a.insert(elements.begin(), elements.end());
+  a.wait();
+
+  REQUIRE(vector_values(grb::reduce(a)) ==
+          reference_reduce(a, grb::plus{}, false));
+  REQUIRE(vector_values(grb::reduce(a, grb::max{})) ==
+          reference_reduce(a, grb::max{}, false));
+  REQUIRE(vector_values(grb::reduce_columns(a)) ==
+          reference_reduce(a, grb::plus{}, true));
+  REQUIRE(vector_values(grb::reduce_columns(a, grb::min{})) ==
+          reference_reduce(a, grb::min{}, true));
+
+  // Masks pick rows or columns.
+  grb::vector<bool, int> rows(300);
+  rows[0] = true;
+  rows[17] = true;
+  auto masked = vector_values(grb::reduce(a, grb::plus{}, rows));
+  REQUIRE(masked.size() == 2);
+  REQUIRE(masked[0] == reference_reduce(a, grb::plus{}, false)[0]);
+  grb::vector<bool, int> columns(20000);
+  columns[12345] = true;
+  auto column_sums =
+      vector_values(grb::reduce_columns(a, grb::plus{}, columns));
+  REQUIRE(column_sums.size() == 1);
+  REQUIRE(column_sums[12345] ==
+          reference_reduce(a, grb::plus{}, true)[12345]);
+
+  // Other operators fold in storage order, each element on the left: with
+  // `take_left`, a row reduces to its last element.
+  std::map<std::size_t, int> last;
+  for (auto&& [index, v] : a) {
+    last[grb::get<0>(index)] = v;
+  }
+  REQUIRE(vector_values(grb::reduce(a, grb::take_left{})) == last);
+
+  // Floating-point sums do not depend on the policy or thread count.
+  // Pairwise column sums gather columns first, then reduce them as the rows
+  // of the transpose are.
+  std::vector<grb::matrix_entry<float, int>> fractions;
+  for (auto&& [index, v] : a) {
+    fractions.push_back({index, float(v) / 7});
+  }
+  grb::matrix<float, int> f({300, 20000});
+  f.insert(fractions.begin(), fractions.end());
+  f.wait();
+
+  auto rows_f = vector_values(grb::reduce<grb::kahan_summation>(f));
+  auto columns_f = vector_values(grb::reduce_columns(f));
+  auto kahan_f = vector_values(grb::reduce_columns<grb::kahan_summation>(f));
+  for (std::size_t threads : {1, 3}) {
+    grb::set_max_threads(threads);
+    REQUIRE(vector_values(grb::reduce<grb::kahan_summation>(
+                std::execution::par, f)) == rows_f);
+    REQUIRE(vector_values(grb::reduce_columns(std::execution::par, f)) ==
+            columns_f);
+    REQUIRE(vector_values(grb::reduce_columns<grb::kahan_summation>(
+                std::execution::par, f)) == kahan_f);
+  }
+  grb::set_max_threads(0);
+  REQUIRE(vector_values(grb::reduce_columns<grb::pairwise_summation>(f)) ==
+          vector_values(
+              grb::reduce<grb::pairwise_summation>(grb::transpose(f))));
+
+  auto reference_f = reference_reduce(f, grb::plus{}, true);
+  REQUIRE(kahan_f.size() == reference_f.size());
+  for (auto&& [j, sum] : reference_f) {
+    REQUIRE(std::abs(kahan_f[j] - sum) <= 1e-3f * (1 + std::abs(sum)));
+  }
+}
+
+TEST_CASE("reduce to scalar") {
+  std::size_t n = 1 << 20;
+  std::mt19937 gen(11);
+  std::uniform_real_distribution<float> uniform(0, 1);
+
+  grb::vector<float, int> x(n);
+  long double exact = 0;
+  for (std::size_t k = 0; k < n; k++) {
+    float v = uniform(gen);
+    x[k] = v;
+    exact += v;
+  }
+
+  auto blocked = reproducible_reduce<grb::blocked_summation>(x);
+  auto pairwise = reproducible_reduce<grb::pairwise_summation>(x);
+  auto kahan = reproducible_reduce<grb::kahan_summation>(x);
+
+  auto error = [&](float sum) {
+    return std::abs((long double)(sum) - exact);
+  };
+  auto eps = std::numeric_limits<float>::epsilon() * exact;
+  REQUIRE(error(kahan) <= eps);
+  REQUIRE(error(pairwise) <= 8 * eps);
+  REQUIRE(error(kahan) <= error(blocked));
+
+  // Compensation recovers what plain sums lose entirely.
+  grb::vector<double, int> cancel(300000);
+  for (int k = 0; k < 300000; k++) {
+    cancel[k] = k % 3 == 0 ? 1e16 : (k % 3 == 1 ? 1.0 : -1e16);
+  }
+  REQUIRE(reproducible_reduce<grb::kahan_summation>(cancel) == 100000);
+
+  // The other built-in monoids, on sparse and partly filled vectors.
+  grb::vector<int, int, grb::sparse> s(n);
+  grb::vector<int, int> d(n);
+  int max = std::numeric_limits<int>::min();
+  int min = std::numeric_limits<int>::max();
+  long sum = 0;
+  std::uniform_int_distribution<int> value(-1000, 1000);
+  for (std::size_t k = 0; k < n; k += 3) {
+    int v = value(gen);
+    s[k] = v;
+    d[k] = v;
+    max = std::max(max, v);
+    min = std::min(min, v);
+    sum += v;
+  }
+  REQUIRE(reproducible_reduce<grb::blocked_summation>(s) == sum);
+  REQUIRE(reproducible_reduce<grb::blocked_summation>(d) == sum);
+  REQUIRE(reproducible_reduce<grb::kahan_summation>(s, grb::max{}) == max);
+  REQUIRE(reproducible_reduce<grb::blocked_summation>(d, grb::min{}) == min);
+
+  grb::vector<int, int> flags(n);
+  for (std::size_t k = 0; k < n; k++) {
+    flags[k] = 0;
+  }
+  REQUIRE(!reproducible_reduce<grb::blocked_summation>(flags,
+                                                       grb::logical_or{}));
+  flags[n - 5] = 1;
+  REQUIRE(reproducible_reduce<grb::blocked_summation>(flags,
+                                                      grb::logical_or{}));
+
+  // Other monoids fold in order.
+  grb::vector<long, int> small(40);
+  long product = 1;
+  for (int k = 0; k < 40; k++) {
+    small[k] = 1 + k % 3;
+    product *= 1 + k % 3;
+  }
+  REQUIRE(grb::reduce_to_scalar(small, grb::times{}) == product);
+
+  // Matrices reduce their stored values; empty inputs give the identity.
+  grb::matrix<float, int> a({100, 100});
+  REQUIRE(grb::reduce_to_scalar(a) == 0);
+  REQUIRE(grb::reduce_to_scalar(a, grb::min{}) ==
+          std::numeric_limits<float>::infinity());
+  for (int i = 0; i < 100; i++) {
+    a[{i, (i * 37) % 100}] = float(i);
+  }
+  a.wait();
+  REQUIRE(grb::reduce_to_scalar(std::execution::par, a) == 4950);
+  REQUIRE(grb::reduce_to_scalar(a, grb::max{}) == 99);
+}
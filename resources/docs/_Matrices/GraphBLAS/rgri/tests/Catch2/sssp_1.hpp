@@ -0,0 +1,120 @@
+#pragma once
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <execution>
+#include <functional>
+#include <grb/grb.hpp>
+#include <map>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Dijkstra's algorithm on adjacency lists built from the matrix.
+template <typename M>
+auto reference_sssp(const M& a, std::size_t source) {
+  using T = grb::matrix_scalar_t<M>;
+
+  std::vector<std::vector<std::pair<std::size_t, T>>> edges(a.shape()[0]);
+  for (auto&& [index, w] : a) {
+    auto&& [i, j] = index;
+    edges[i].push_back({j, w});
+  }
+
+  std::map<std::size_t, T> dist;
+  using entry = std::pair<T, std::size_t>;
+  std::priority_queue<entry, std::vector<entry>, std::greater<entry>> queue;
+  queue.push({T(0), source});
+  while (!queue.empty()) {
+    auto [d, v] = queue.top();
+    queue.pop();
+    if (dist.contains(v)) {
+      continue;
+    }
+    dist[v] = d;
+    for (auto&& [u, w] : edges[v]) {
+      if (!dist.contains(u)) {
+        queue.push({d + w, u});
+      }
+    }
+  }
+  return dist;
+}
+
+template <typename V>
+auto distance_elements(V&& v) {
+  std::map<std::size_t, grb::vector_scalar_t<V>> elements;
+  for (auto&& [index, value] : v) {
+    elements[index] = value;
+  }
+  return elements;
+}
+
+} // namespace
+
+TEMPLATE_TEST_CASE("delta-stepping sssp matches Dijkstra",
+                   "[sssp][template]", int, float) {
+  using T = TestType;
+
+  // Whole-number weights, so float path lengths are exact.
+  auto a = grb::generate_rmat<T, std::size_t>(11, 8, 4);
+  std::mt19937 gen(5);
+  std::uniform_int_distribution<int> weight(1, 100);
+  for (auto&& [_, w] : a) {
+    w = T(weight(gen));
+  }
+  // A few zero-weight edges.
+  a[{0, 1}] = 0;
+  a[{1, 2}] = 0;
+
+  for (std::size_t source : {0, 1, 17, 1000}) {
+    auto expected = reference_sssp(a, source);
+
+    // Automatic delta, every edge light, almost every edge heavy, mixed.
+    for (T delta : {T(0), T(1000), T(1), T(30)}) {
+      REQUIRE(distance_elements(grb::sssp(a, source, delta)) == expected);
+    }
+
+    for (std::size_t threads : {1, 3}) {
+      grb::set_max_threads(threads);
+      REQUIRE(distance_elements(grb::sssp(std::execution::par, a, source)) ==
+              expected);
+    }
+    grb::set_max_threads(0);
+  }
+
+  // Views are gathered first; reversing the edges gives distances to the
+  // source.
+  auto reversed = grb::transpose(a);
+  REQUIRE(distance_elements(grb::sssp(reversed, 5)) ==
+          reference_sssp(reversed, 5));
+}
+
+TEST_CASE("sssp on small graphs", "[sssp]") {
+  // 0 -> 1 -> 2 -> 3, with a heavy shortcut 0 -> 3 and an unreachable 4.
+  grb::matrix<int, int> a({5, 5});
+  a[{0, 1}] = 2;
+  a[{1, 2}] = 3;
+  a[{2, 3}] = 1;
+  a[{0, 3}] = 10;
+  a[{4, 0}] = 1;
+
+  auto dist = grb::sssp(a, 0);
+  std::map<std::size_t, int> expected = {{0, 0}, {1, 2}, {2, 5}, {3, 6}};
+  REQUIRE(distance_elements(dist) == expected);
+  REQUIRE(dist.shape() == 5);
+
+  REQUIRE(distance_elements(grb::sssp(a, 4)) ==
+          std::map<std::size_t, int>{{4, 0}, {0, 1}, {1, 3}, {2, 6}, {3, 7}});
+
+  REQUIRE_THROWS_AS(grb::sssp(a, 5), grb::out_of_range);
+
+  a[{3, 2}] = -1;
+  REQUIRE_THROWS_AS(grb::sssp(a, 0), grb::invalid_argument);
+
+  grb::matrix<int, int> rectangular({3, 4});
+  REQUIRE_THROWS_AS(grb::sssp(rectangular, 0), grb::invalid_argument);
+}
@@ -7,5 +7,20 @@
 #include "matrix_methods_2.hpp"
 #include "matrix_methods_3.hpp"
 // #include "algorithms_1.hpp"
+#include "multiply_1.hpp"
+#include "parallel_1.hpp"
+#include "find_1.hpp"
+#include "pending_1.hpp"
+#include "io_1.hpp"
+#include "vector_backends_1.hpp"
+#include "push_pull_1.hpp"
+#include "fused_1.hpp"
+#include "ewise_merge_1.hpp"
+#include "compact_index_1.hpp"
+#include "sssp_1.hpp"
+#include "betweenness_1.hpp"
+#include "dia_1.hpp"
+#include "permute_1.hpp"
+#include "reduce_1.hpp"
 
 #include "test_ops_1.hpp"
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <grb/grb.hpp>
+#include <map>
+#include <random>
+#include <utility>
+
+namespace {
+
+using sparse_or_bitmap = grb::compose<grb::sparse, grb::bitmap>;
+
+// The vector iterates over exactly the elements of `reference`, in index
+// order, and finds each of them.
+template <typename V, typename T>
+bool vector_matches(V&& v, const std::map<std::size_t, T>& reference) {
+  if (v.size() != reference.size()) {
+    return false;
+  }
+
+  auto ref = reference.begin();
+  for (auto&& [index, value] : v) {
+    if (ref == reference.end() || ref->first != index ||
+        ref->second != value) {
+      return false;
+    }
+    ++ref;
+  }
+
+  for (auto&& [index, value] : reference) {
+    auto iter = v.find(index);
+    if (iter == v.end() || grb::get<1>(*iter) != value) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+TEMPLATE_PRODUCT_TEST_CASE(
+    "vector backends", "[vector][template]", (grb::vector),
+    ((int, int, grb::dense), (int, std::size_t, grb::dense),
+     (int, int, grb::sparse), (int, std::size_t, grb::sparse),
+     (int, int, grb::bitmap), (int, std::size_t, grb::bitmap),
+     (int, int, sparse_or_bitmap), (int, std::size_t, sparse_or_bitmap))) {
+  using I = typename TestType::index_type;
+  using T = int;
+
+  static_assert(std::forward_iterator<typename TestType::iterator>);
+  static_assert(std::forward_iterator<typename TestType::const_iterator>);
+
+  // Not a multiple of 64, so the last bitmap word is partial.
+  I n = 1000;
+
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<I> index(0, n - 1);
+  std::uniform_int_distribution<T> value(-100, 100);
+
+  GIVEN("Elements added in random order") {
+    TestType v(n);
+    std::map<std::size_t, T> reference;
+    REQUIRE(v.shape() == n);
+    REQUIRE(v.empty());
+
+    for (std::size_t k = 0; k < 300; k++) {
+      I i = index(gen);
+      T x = value(gen);
+      switch (k % 3) {
+      case 0:
+        v[i] += x;
+        reference[i] += x;
+        break;
+      case 1: {
+        auto [iter, inserted] = v.insert({i, x});
+        REQUIRE(inserted == reference.insert({i, x}).second);
+        REQUIRE(grb::get<1>(*iter) == reference[i]);
+        break;
+      }
+      default: {
+        auto [iter, inserted] = v.insert_or_assign(i, x);
+        REQUIRE(inserted == (reference.find(i) == reference.end()));
+        reference[i] = x;
+        REQUIRE(grb::get<1>(*iter) == x);
+      }
+      }
+    }
+    REQUIRE(vector_matches(v, reference));
+    REQUIRE(vector_matches(std::as_const(v), reference));
+
+    for (std::size_t k = 0; k < 1000; k++) {
+      I i = index(gen);
+      REQUIRE((v.find(i) != v.end()) == (reference.count(i) > 0));
+    }
+
+    THEN("Copies and moves keep the elements") {
+      TestType w = v;
+      REQUIRE(vector_matches(w, reference));
+      TestType x = std::move(v);
+      REQUIRE(vector_matches(x, reference));
+    }
+
+    THEN("Shrinking drops elements past the new shape") {
+      v.reshape(100);
+      std::erase_if(reference, [](auto&& e) { return e.first >= 100; });
+      REQUIRE(v.shape() == 100);
+      REQUIRE(vector_matches(v, reference));
+
+      v.reshape(n);
+      v[n - 1] = 5;
+      reference[n - 1] = 5;
+      REQUIRE(vector_matches(v, reference));
+    }
+
+    THEN("Kernels give the same result as with a dense vector") {
+      auto a = grb::generate_random<T, I>({n, n}, 0.01, 4);
+      grb::vector<T, I, grb::dense> d(n);
+      for (auto&& [i, x] : v) {
+        d[i] = x;
+      }
+      auto c = grb::multiply(a, v);
+      auto e = grb::multiply(a, d);
+      REQUIRE(c.size() == e.size());
+      for (auto&& [i, x] : e) {
+        auto iter = c.find(i);
+        REQUIRE(iter != c.end());
+        REQUIRE(grb::get<1>(*iter) == x);
+      }
+    }
+  }
+
+  GIVEN("Elements at word boundaries") {
+    TestType v(n);
+    std::map<std::size_t, T> reference;
+    for (I i : {I(0), I(63), I(64), I(127), I(128), I(n - 1)}) {
+      v[i] = T(i) + 1;
+      reference[i] = T(i) + 1;
+    }
+    REQUIRE(vector_matches(v, reference));
+  }
+}
+
+TEST_CASE("adaptive vector switches representation by fill ratio",
+          "[vector]") {
+  using backend = grb::adaptive_vector<int, int, std::allocator<int>>;
+  grb::vector<int, int, sparse_or_bitmap> v(1600);
+  std::map<std::size_t, int> reference;
+
+  // Up to 1600 / 16 elements stay sparse.
+  for (int i = 1599; i >= 1600 - 100; i--) {
+    v[i] = i;
+    reference[i] = i;
+  }
+  REQUIRE(!v.backend().is_bitmap());
+  REQUIRE(vector_matches(v, reference));
+
+  v.insert({0, 7});
+  reference[0] = 7;
+  REQUIRE(v.backend().is_bitmap());
+  REQUIRE(vector_matches(v, reference));
+
+  // Shrinking leaves 1 element in 100, below 1 / 64 of the shape.
+  v.reshape(100);
+  reference = {{0, 7}};
+  REQUIRE(!v.backend().is_bitmap());
+  REQUIRE(vector_matches(v, reference));
+  REQUIRE(backend::bitmap_switch < backend::sparse_switch);
+}